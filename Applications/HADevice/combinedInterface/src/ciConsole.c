@@ -50,7 +50,7 @@
 #include <nwkAttributes.h>
 #include <ezModeManager.h>
 #include <sysTaskManager.h>
-#ifdef BOARD_PC
+#if defined BOARD_PC && defined WIN
   #include <conio.h>
 #endif
 #ifdef ZAPPSI_HOST
@@ -16,14 +16,59 @@
     30.09.13 N. Fomin - Created.
 ******************************************************************************/
 
-#if defined ZAPPSI_HOST && defined WIN
+#if defined ZAPPSI_HOST && (defined WIN || defined LINUX)
 /*******************************************************************************
                     Includes section
 *******************************************************************************/
 #include <keyboardPoll.h>
-#include <conio.h>
 #include <console.h>
 #include <stdio.h>
+#if defined WIN
+#include <conio.h>
+#else
+#include <termios.h>
+#include <unistd.h>
+#include <poll.h>
+#include <stdlib.h>
+#endif
+
+#if defined LINUX
+/*******************************************************************************
+                    Static variables section
+*******************************************************************************/
+static bool terminalConfigured = false;
+static struct termios savedTerminal;
+
+/*******************************************************************************
+                    Static functions section
+*******************************************************************************/
+/**************************************************************************//**
+\brief Restores terminal settings on application exit
+******************************************************************************/
+static void restoreTerminal(void)
+{
+  tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+}
+
+/**************************************************************************//**
+\brief Switches stdin to non-canonical mode without echo (like _getch())
+******************************************************************************/
+static void configureTerminal(void)
+{
+  struct termios raw;
+
+  terminalConfigured = true;
+  if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedTerminal))
+    return;
+
+  raw = savedTerminal;
+  raw.c_lflag &= ~(ICANON | ECHO);
+  raw.c_cc[VMIN] = 0;
+  raw.c_cc[VTIME] = 0;
+  if (0 == tcsetattr(STDIN_FILENO, TCSANOW, &raw))
+    atexit(restoreTerminal);
+}
+#endif // defined LINUX
 
 /*******************************************************************************
                     Implementation section
@@ -35,6 +80,7 @@ void pollKeyboard(void)
 {
   int ch;
 
+#if defined WIN
   if (0 != _kbhit())
   {
     ch = _getch();
@@ -46,7 +92,30 @@ void pollKeyboard(void)
       consoleRx('\n');
     }
   }
+#else
+  struct pollfd pfd = {.fd = STDIN_FILENO, .events = POLLIN};
+  unsigned char byte;
+
+  if (!terminalConfigured)
+    configureTerminal();
+
+  if (poll(&pfd, 1, 0) <= 0 || 1 != read(STDIN_FILENO, &byte, 1))
+    return;
+
+  ch = byte;
+  // Console expects DOS-like line endings
+  if ('\n' == ch)
+    ch = '\r';
+  putchar(ch);
+  consoleRx(ch);
+  if ('\r' == ch)
+  {
+    putchar('\n');
+    consoleRx('\n');
+  }
+  fflush(stdout);
+#endif
 }
 
-#endif // defined ZAPPSI_HOST && defined WIN
+#endif // defined ZAPPSI_HOST && (defined WIN || defined LINUX)
 // eof keyboardPoll.c
@@ -25,14 +25,14 @@
 #include <zclSecurityManager.h>
 #include <pdsDataServer.h>
 #include <identifyCluster.h>
-#include <ezModeManager.H>
+#include <ezModeManager.h>
 #include <sysTaskManager.h>
 #include <resetReason.h>
 #include <bspUid.h>
 #ifdef ZAPPSI_HOST
 #include <zsiNotify.h>
 #endif
-#if defined ZAPPSI_HOST && defined WIN
+#if defined ZAPPSI_HOST && (defined WIN || defined LINUX)
 #include <keyboardPoll.h>
 #endif
 
@@ -463,7 +463,7 @@ int main(void)
   for (;;)
   {
     SYS_RunTask();
-#if defined ZAPPSI_HOST && defined WIN
+#if defined ZAPPSI_HOST && (defined WIN || defined LINUX)
     pollKeyboard();
 #endif
   }
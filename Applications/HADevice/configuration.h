@@ -325,16 +325,37 @@
 #ifdef BOARD_PC
   // Defines USART interface name to be used by ZAppSI.
   #undef APP_ZAPPSI_MEDIUM_CHANNEL
-  #define APP_ZAPPSI_MEDIUM_CHANNEL COM1
+  #if defined LINUX
+    #define APP_ZAPPSI_MEDIUM_CHANNEL TTYACM0
+  #else
+    #define APP_ZAPPSI_MEDIUM_CHANNEL COM1
+  #endif
   
   // Defines primary serial interface type to be used by ZAppSI.
   #undef APP_ZAPPSI_INTERFACE
   #define APP_ZAPPSI_INTERFACE APP_INTERFACE_USART
+  //#define APP_ZAPPSI_INTERFACE APP_INTERFACE_SPI
   
   // Defines primary serial interface type to be used by application.
   #define APP_INTERFACE APP_INTERFACE_USART
   //#define APP_INTERFACE APP_INTERFACE_STDIO
   
+  //-----------------------------------------------
+  //APP_ZAPPSI_INTERFACE == APP_INTERFACE_SPI
+  //-----------------------------------------------
+  #if (APP_ZAPPSI_INTERFACE == APP_INTERFACE_SPI) && defined(LINUX)
+    // Defines SPI interface mode.
+    #define APP_ZAPPSI_SPI_MASTER_MODE 1
+    
+    // Defines SPI interface name to be used by ZAppSI.
+    #undef APP_ZAPPSI_MEDIUM_CHANNEL
+    #define APP_ZAPPSI_MEDIUM_CHANNEL SPIDEV0_0
+    //#define APP_ZAPPSI_MEDIUM_CHANNEL SPI_CHANNEL_LOOPBACK
+    
+    // Defines SPI clock rate in Hz.
+    #define APP_ZAPPSI_SPI_CLOCK_RATE 8000000ul
+  #endif
+  
   //-----------------------------------------------
   //APP_INTERFACE == APP_INTERFACE_STDIO
   //-----------------------------------------------
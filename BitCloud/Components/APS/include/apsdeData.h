@@ -406,6 +406,28 @@ extern void APS_ZdoDataInd(APS_DataInd_t *ind);
  ******************************************************************************/
 void APS_CalculateTimes(void);
 
+#ifdef ZAPPSI_HOST
+/**************************************************************************//**
+  \brief Keeps the indication being delivered after the indication callback
+         returns. Must be called from the APS_DataInd callback only.
+
+  \ingroup aps_data
+  \param[in] ind - indication passed to the APS_DataInd callback
+  \return none
+ ******************************************************************************/
+void APS_KeepDataInd(APS_DataInd_t *ind);
+
+/**************************************************************************//**
+  \brief Releases the indication kept by APS_KeepDataInd(). The indication
+         and its asdu must not be accessed anymore.
+
+  \ingroup aps_data
+  \param[in] ind - kept indication
+  \return none
+ ******************************************************************************/
+void APS_ReleaseDataInd(APS_DataInd_t *ind);
+#endif /* ZAPPSI_HOST */
+
 #endif /* _APSDE_DATA_H */
 /** eof apsdeData.h */
 
@@ -66,6 +66,17 @@ typedef enum _CS_MemoryItemId_t
 #undef MEMORY_REGION
 #undef DUMMY_MEMORY_REGION
 
+#if defined(ZAPPSI_HOST) && defined(_CS_MIRROR_STATS_)
+/*! Usage of the host's mirror of a network processor's parameter */
+typedef struct _CS_MirrorStats_t
+{
+  /*! Reads served from the mirror */
+  uint16_t hits;
+  /*! Reads sent to the network processor */
+  uint16_t misses;
+} CS_MirrorStats_t;
+#endif /* ZAPPSI_HOST && _CS_MIRROR_STATS_ */
+
 /******************************************************************************
                     Defines section
 ******************************************************************************/
@@ -167,6 +178,69 @@ void CS_PdsDefaultValue(void);
 ******************************************************************************/
 uint16_t CS_GetItemSize(CS_MemoryItemId_t itemId);
 
+#ifdef ZAPPSI_HOST
+/******************************************************************************
+\brief Requests values of all network processor's parameters, which may be
+       mirrored on the host, so subsequent reads are served locally.
+******************************************************************************/
+void CS_PopulateMirror(void);
+
+/******************************************************************************
+\brief Marks mirrored parameter as changed by the network processor.
+
+\param[in] parameterId - ID of the changed parameter.
+******************************************************************************/
+void CS_InvalidateMirroredParameter(CS_MemoryItemId_t parameterId);
+
+/******************************************************************************
+\brief Marks all mirrored parameters as changed by the network processor.
+       Network processor reports changes of its RAM parameters since then,
+       so they are mirrored too.
+******************************************************************************/
+void CS_InvalidateMirror(void);
+
+#ifdef _CS_MIRROR_STATS_
+/******************************************************************************
+\brief Gets usage statistics of the parameter's mirror.
+
+\param[in] parameterId - ID of the parameter.
+\param[out] stats - statistics, zeroed for parameters which aren't mirrored.
+******************************************************************************/
+void CS_GetMirrorStats(CS_MemoryItemId_t parameterId, CS_MirrorStats_t *stats);
+
+/******************************************************************************
+\brief Resets usage statistics of all mirrored parameters.
+******************************************************************************/
+void CS_ResetMirrorStats(void);
+#endif /* _CS_MIRROR_STATS_ */
+#endif /* ZAPPSI_HOST */
+
+#ifdef ZAPPSI_NP
+/******************************************************************************
+\brief Considers current values of RAM parameters as reported to the host.
+       Parameters written by CS_WriteParameter() are tracked since then.
+******************************************************************************/
+void CS_StartParametersTracking(void);
+
+/******************************************************************************
+\brief Finds RAM parameters written since they were reported to the host.
+       Found changes are considered as reported.
+
+\param[out] parameterIds - IDs of the changed parameters.
+\param[in] maxAmount - maximum amount of IDs to be written.
+
+\return amount of changed parameters, which may exceed maxAmount.
+******************************************************************************/
+uint8_t CS_CollectChangedParameters(CS_MemoryItemId_t *parameterIds, uint8_t maxAmount);
+
+/******************************************************************************
+\brief Considers current value of the parameter as known to the host.
+
+\param[in] parameterId - ID of the RAM parameter.
+******************************************************************************/
+void CS_AcceptParameterChange(CS_MemoryItemId_t parameterId);
+#endif /* ZAPPSI_NP */
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
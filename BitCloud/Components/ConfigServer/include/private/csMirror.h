@@ -0,0 +1,50 @@
+/******************************************************************************
+  \file csMirror.h
+
+  \brief
+    Configuration Server parameters mirror for ZAppSI
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+#ifndef _CSMIRROR_H_
+#define _CSMIRROR_H_
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <configServer.h>
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+#ifdef ZAPPSI_HOST
+/**//**
+ * \brief Host's record about parameter mirrored from the network processor.
+ *        Values themselves are kept in the separate array.
+ */
+typedef struct _CsMirrorItem_t
+{
+  /* Offset of the value in the mirror values array */
+  uint16_t offset;
+  /* Size of the value, zero if parameter is not mirrored */
+  uint8_t  size;
+  /* Mirrored value is equal to the network processor's one */
+  bool     valid;
+#ifdef _CS_MIRROR_STATS_
+  CS_MirrorStats_t stats;
+#endif /* _CS_MIRROR_STATS_ */
+} CsMirrorItem_t;
+#endif /* ZAPPSI_HOST */
+
+#endif /* _CSMIRROR_H_ */
+/* eof csMirror.h */
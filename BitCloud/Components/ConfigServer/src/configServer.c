@@ -24,6 +24,7 @@
 #include <csSIB.h>
 #include <csDbg.h>
 #include <csBuffers.h>
+#include <csMirror.h>
 #include <sysAssert.h>
 #ifdef _ENABLE_PERSISTENT_SERVER_
 #include <pdsDataServer.h>
@@ -60,6 +61,18 @@ extern CS_MemoryItem_t PROGMEM_DECLARE(csVarItems[]);
 extern CS_MemoryItem_t PROGMEM_DECLARE(csConstItems[]);
 extern CS_MemoryItem_t PROGMEM_DECLARE(csMemItems[]);
 
+#if defined(ZAPPSI_HOST) || defined(ZAPPSI_NP)
+extern const uint8_t csVarItemsAmount;
+#endif /* ZAPPSI_HOST || ZAPPSI_NP */
+#ifdef ZAPPSI_HOST
+extern const uint8_t csConstItemsAmount;
+extern CsMirrorItem_t csVarMirrorItems[];
+extern CsMirrorItem_t csConstMirrorItems[];
+extern uint8_t csMirrorValues[];
+#elif defined(ZAPPSI_NP)
+extern uint8_t csChangedParameters[];
+#endif /* ZAPPSI_NP */
+
 #if defined(_USE_KF_MAC_)
 extern uint64_t tal_pib_IeeeAddress;
 #if defined(_MAC_BAN_NODE_)
@@ -67,10 +80,49 @@ extern CS_ReadOnlyItems_t PROGMEM_DECLARE(csReadOnlyItems);
 #endif
 #endif
 
+#ifdef ZAPPSI_HOST
+/******************************************************************************
+                    Types section
+******************************************************************************/
+/* Non-blocking read of the parameter to be mirrored */
+typedef struct _CsMirrorRead_t
+{
+  ZsiSreq_t         sreq;
+  CS_MemoryItemId_t parameterId;
+  uint8_t           invalidations;
+  bool              busy;
+  uint8_t           value[CS_MAX_PARAMETER_SIZE];
+} CsMirrorRead_t;
+
+/* Host's mirror of the network processor's parameters state */
+typedef struct _CsMirror_t
+{
+  /* Network processor reports changes of its RAM parameters */
+  bool           ramMirrored;
+  /* Counter of invalidations, values read before invalidation are dropped */
+  uint8_t        invalidations;
+  /* Index of the next parameter to be read during mirror population */
+  uint8_t        populationIndex;
+  CsMirrorRead_t reads[ZSI_MAX_SREQS_IN_FLIGHT];
+} CsMirror_t;
+#endif /* ZAPPSI_HOST */
+
 /******************************************************************************
                     Prototypes section
 ******************************************************************************/
 static CS_MemoryItem_t csGetItem(CS_MemoryItemId_t itemId);
+#ifdef ZAPPSI_HOST
+static bool csIsHostParameter(CS_MemoryItemId_t parameterId);
+static void csResetMirror(void);
+static CsMirrorItem_t *csGetMirrorItem(CS_MemoryItemId_t parameterId);
+static bool csReadMirror(CS_MemoryItemId_t parameterId, void *parameterValue);
+static void csUpdateMirror(CS_MemoryItemId_t parameterId, const void *parameterValue,
+  uint8_t invalidations);
+static void csPopulateNextParameter(CsMirrorRead_t *read);
+static void csMirrorReadDone(ZsiSreq_t *sreq);
+#elif defined(ZAPPSI_NP)
+static void csSetParameterChanged(CS_MemoryItemId_t parameterId, bool changed);
+#endif /* ZAPPSI_HOST */
 #if !defined(ZAPPSI_HOST) || defined(ZCL_SUPPORT)
 static void csReadInternalParameter(CS_MemoryItemId_t parameterId,
   void *parameterValue);
@@ -78,6 +130,13 @@ static void csWriteParameterInternal(CS_MemoryItemId_t parameterId,
   const void *parameterValue);
 #endif /* !ZAPPSI_HOST || ZCL_SUPPORT */
 
+#ifdef ZAPPSI_HOST
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static CsMirror_t csMirror;
+#endif /* ZAPPSI_HOST */
+
 /******************************************************************************
                     Implementation section
 ******************************************************************************/
@@ -101,6 +160,9 @@ uint16_t CS_GetItemSize(CS_MemoryItemId_t itemId)
 void CS_Init(void)
 {
   csSetToDefault();
+#ifdef ZAPPSI_HOST
+  csResetMirror();
+#endif /* ZAPPSI_HOST */
 #ifdef _ENABLE_PERSISTENT_SERVER_
   PDS_Init();
 #endif /* _ENABLE_PERSISTENT_SERVER_ */
@@ -141,37 +203,22 @@ void CS_ReadParameter(CS_MemoryItemId_t parameterId, void *parameterValue)
   /* Read parameter depending of it's location: from internal memory or external
      one (for ZAppSI HOST device). */
 #ifdef ZAPPSI_HOST
-  switch (parameterId)
-  {
 #if ZCL_SUPPORT == 1
-    case CS_ZCL_MEMORY_BUFFERS_AMOUNT_ID:
-    case CS_ZCL_BUFFERS_ID:
-    case CS_ZCL_BUFFER_SIZE_ID:
-#if APP_USE_OTAU == 1
-    case CS_ZCL_OTAU_DEFAULT_UPGRADE_SERVER_IEEE_ADDRESS_ID:
-    case CS_ZCL_OTAU_DEFAULT_SERVER_DISCOVERY_PERIOD_ID:
-    case CS_ZCL_OTAU_QUERY_INTERVAL_ID:
-    case CS_ZCL_OTAU_MAX_RETRY_COUNT_ID:
-    case CS_ZCL_OTAU_IMAGE_PAGE_REQUEST_ENABLE_ID:
-    case CS_ZCL_OTAU_DISCOVERED_SERVER_AMOUNT_ID:
-    case CS_ZCL_OTAU_CLIENT_SESSION_AMOUNT_ID:
-    case CS_ZCL_OTAU_IMAGE_PAGE_REQUEST_RESPONSE_SPACING_ID:
-    case CS_ZCL_OTAU_IMAGE_PAGE_REQUEST_PAGE_SIZE_ID:
-    case CS_ZCL_OTAU_MISSED_BLOCKS_BUFFER_SIZE_ID:
-    case CS_ZCL_OTAU_DISCOVERED_SERVER_RESULT_ID:
-    case CS_ZCL_OTAU_CLIENT_SESSION_MEMORY_ID:
-    case CS_ZCL_OTAU_MISSED_BLOCKS_BUFFER_ID:
-    case CS_ZCL_OTAU_PAGE_REQUEST_PAGE_BUFFER_ID:
-#endif /* APP_USE_OTAU == 1 */
-      csReadInternalParameter(parameterId, parameterValue);
-      break;
+  if (csIsHostParameter(parameterId))
+  {
+    csReadInternalParameter(parameterId, parameterValue);
+    return;
+  }
 #endif /* ZCL_SUPPORT == 1 */
 
-    default:
-      zsiProcessCommand(ZSI_SREQ_CMD, &parameterId, zsiSerializeCS_ReadParameterReq,
-        parameterValue);
-      return;
-      break;
+  /* Network processor is asked only if mirror doesn't keep actual value */
+  if (!csReadMirror(parameterId, parameterValue))
+  {
+    uint8_t invalidations = csMirror.invalidations;
+
+    zsiProcessCommand(ZSI_SREQ_CMD, &parameterId, zsiSerializeCS_ReadParameterReq,
+      parameterValue);
+    csUpdateMirror(parameterId, parameterValue, invalidations);
   }
 #else
   csReadInternalParameter(parameterId, parameterValue);
@@ -223,6 +270,68 @@ void CS_WriteParameter(CS_MemoryItemId_t parameterId, const void *parameterValue
   /* Write parameter depending of it's location: to internal memory or external
      one (for ZAppSI HOST device). */
 #ifdef ZAPPSI_HOST
+#if ZCL_SUPPORT == 1
+  if (csIsHostParameter(parameterId))
+  {
+    csWriteParameterInternal(parameterId, parameterValue);
+    return;
+  }
+#endif /* ZCL_SUPPORT == 1 */
+
+  {
+    ZsiCsParameter_t zsiCsParameter;
+    uint8_t invalidations = csMirror.invalidations;
+
+    zsiCsParameter.parameterId = parameterId;
+    zsiCsParameter.size = CS_GetItemSize(parameterId);
+    memcpy(zsiCsParameter.payload, parameterValue, zsiCsParameter.size);
+
+    zsiProcessCommand(ZSI_SREQ_CMD, &zsiCsParameter, zsiSerializeCS_WriteParameterReq,
+      NULL);
+    /* Written value is the actual one, network processor doesn't report it */
+    csUpdateMirror(parameterId, parameterValue, invalidations);
+  }
+#else
+  csWriteParameterInternal(parameterId, parameterValue);
+#ifdef ZAPPSI_NP
+  /* Host mirrors the parameter, so the change is reported to it */
+  csSetParameterChanged(parameterId, true);
+#endif /* ZAPPSI_NP */
+#endif /* ZAPPSI_HOST */
+}
+
+#if !defined(ZAPPSI_HOST) || defined(ZCL_SUPPORT)
+/******************************************************************************
+\brief Sets the parameter specified by it's identifier to internal or external
+       memory.
+
+\param[in] parameterId - ID of the parameter being written
+\param[out] parameterValue - pointer to the parameter
+
+******************************************************************************/
+static void csWriteParameterInternal(CS_MemoryItemId_t parameterId,
+  const void *parameterValue)
+{
+  CS_MemoryItem_t item = csGetItem(parameterId);
+
+  SYS_E_ASSERT_FATAL(parameterValue, CS_WRITE_PARAM0);
+  SYS_E_ASSERT_FATAL(((parameterId & CS_TYPE_MASK) == CS_RAM_PARAM_TYPE), CS_WRITE_PARAM1);
+
+  memcpy(item.value.ramValue, parameterValue, item.size);
+}
+#endif /* !defined(ZAPPSI_HOST) || defined(ZCL_SUPPORT) */
+
+#ifdef ZAPPSI_HOST
+/******************************************************************************
+\brief Checks if parameter is kept by the host itself rather than by the
+       network processor.
+
+\param[in] parameterId - ID of the parameter
+
+\return true if parameter is kept by the host, false otherwise
+******************************************************************************/
+static bool csIsHostParameter(CS_MemoryItemId_t parameterId)
+{
   switch (parameterId)
   {
 #if ZCL_SUPPORT == 1
@@ -245,48 +354,321 @@ void CS_WriteParameter(CS_MemoryItemId_t parameterId, const void *parameterValue
     case CS_ZCL_OTAU_MISSED_BLOCKS_BUFFER_ID:
     case CS_ZCL_OTAU_PAGE_REQUEST_PAGE_BUFFER_ID:
 #endif /* APP_USE_OTAU == 1 */
-      csWriteParameterInternal(parameterId, parameterValue);
-      break;
-#endif /* ZCL_SUPPORT == 1*/
+      return true;
+#endif /* ZCL_SUPPORT == 1 */
+
     default:
-      {
-        ZsiCsParameter_t zsiCsParameter;
+      return false;
+  }
+}
+
+/******************************************************************************
+\brief Invalidates whole mirror and assigns places for mirrored values.
+******************************************************************************/
+static void csResetMirror(void)
+{
+  uint16_t offset = 0U;
+
+  for (uint8_t i = 0U; i < csVarItemsAmount + csConstItemsAmount; i++)
+  {
+    CsMirrorItem_t *mirrorItem = (i < csVarItemsAmount) ?
+      &csVarMirrorItems[i] : &csConstMirrorItems[i - csVarItemsAmount];
+    CS_MemoryItemId_t parameterId = (i < csVarItemsAmount) ?
+      RAM_PARAM_ID(i) : FLASH_PARAM_ID(i - csVarItemsAmount);
+    CS_MemoryItem_t item = csGetItem(parameterId);
+
+    memset(mirrorItem, 0x00, sizeof(CsMirrorItem_t));
+    mirrorItem->offset = offset;
+    /* Values of dummy parameters are never requested, host's parameters are
+       read locally */
+    if (!csIsHostParameter(parameterId))
+      mirrorItem->size = item.size;
+    offset += item.size;
+  }
+
+  csMirror.ramMirrored = false;
+  csMirror.invalidations++;
+  csMirror.populationIndex = csVarItemsAmount + csConstItemsAmount;
+}
+
+/******************************************************************************
+\brief Returns mirror record of the parameter
+
+\param[in] parameterId - ID of the parameter
+
+\return mirror record or NULL if parameter is not mirrored
+******************************************************************************/
+static CsMirrorItem_t *csGetMirrorItem(CS_MemoryItemId_t parameterId)
+{
+  uint8_t itemInternalId = parameterId & CS_ID_MASK;
+  CsMirrorItem_t *mirrorItem = NULL;
 
-        zsiCsParameter.parameterId = parameterId;
-        zsiCsParameter.size = CS_GetItemSize(parameterId);
-        memcpy(zsiCsParameter.payload, parameterValue, zsiCsParameter.size);
+  switch (parameterId & CS_TYPE_MASK)
+  {
+    case CS_RAM_PARAM_TYPE:
+      if (itemInternalId < csVarItemsAmount)
+        mirrorItem = &csVarMirrorItems[itemInternalId];
+      break;
 
-        zsiProcessCommand(ZSI_SREQ_CMD, &zsiCsParameter, zsiSerializeCS_WriteParameterReq,
-          NULL);
-        return;
-      }
+    case CS_FLASH_PARAM_TYPE:
+      if (itemInternalId < csConstItemsAmount)
+        mirrorItem = &csConstMirrorItems[itemInternalId];
+      break;
+
+    default:
       break;
   }
-#else
-  csWriteParameterInternal(parameterId, parameterValue);
+
+  if (mirrorItem && !mirrorItem->size)
+    mirrorItem = NULL;
+
+  return mirrorItem;
+}
+
+/******************************************************************************
+\brief Reads the parameter from the mirror
+
+\param[in] parameterId - ID of the parameter being read
+\param[out] parameterValue - pointer to the memory
+
+\return true if mirror keeps actual value, false otherwise
+******************************************************************************/
+static bool csReadMirror(CS_MemoryItemId_t parameterId, void *parameterValue)
+{
+  CsMirrorItem_t *mirrorItem = csGetMirrorItem(parameterId);
+
+  if (!mirrorItem)
+    return false;
+
+  if (!mirrorItem->valid)
+  {
+#ifdef _CS_MIRROR_STATS_
+    mirrorItem->stats.misses++;
+#endif /* _CS_MIRROR_STATS_ */
+    return false;
+  }
+
+  SYS_E_ASSERT_FATAL(parameterValue, CS_READ_PARAM2);
+  memcpy(parameterValue, &csMirrorValues[mirrorItem->offset], mirrorItem->size);
+#ifdef _CS_MIRROR_STATS_
+  mirrorItem->stats.hits++;
+#endif /* _CS_MIRROR_STATS_ */
+  return true;
+}
+
+/******************************************************************************
+\brief Puts actual value of the parameter to the mirror
+
+\param[in] parameterId - ID of the parameter
+\param[in] parameterValue - value obtained from or written to the network
+                             processor
+\param[in] invalidations - invalidations counter at the time the value
+                            was requested
+******************************************************************************/
+static void csUpdateMirror(CS_MemoryItemId_t parameterId, const void *parameterValue,
+  uint8_t invalidations)
+{
+  CsMirrorItem_t *mirrorItem = csGetMirrorItem(parameterId);
+
+  /* Value may be changed by the network processor after it was obtained */
+  if (!mirrorItem || invalidations != csMirror.invalidations)
+    return;
+  /* Changes of RAM parameters are not reported by old network processors */
+  if (CS_RAM_PARAM_TYPE == (parameterId & CS_TYPE_MASK) && !csMirror.ramMirrored)
+    return;
+
+  memcpy(&csMirrorValues[mirrorItem->offset], parameterValue, mirrorItem->size);
+  mirrorItem->valid = true;
+}
+
+/******************************************************************************
+\brief Requests values of all network processor's parameters, which may be
+       mirrored on the host, so subsequent reads are served locally.
+******************************************************************************/
+void CS_PopulateMirror(void)
+{
+  csMirror.populationIndex = 0U;
+
+  for (uint8_t i = 0U; i < ARRAY_SIZE(csMirror.reads); i++)
+  {
+    if (!csMirror.reads[i].busy)
+      csPopulateNextParameter(&csMirror.reads[i]);
+  }
+}
+
+/******************************************************************************
+\brief Requests the next parameter missing in the mirror.
+
+\param[in] read - read descriptor to be used.
+******************************************************************************/
+static void csPopulateNextParameter(CsMirrorRead_t *read)
+{
+  while (csMirror.populationIndex < csVarItemsAmount + csConstItemsAmount)
+  {
+    uint8_t i = csMirror.populationIndex++;
+    CS_MemoryItemId_t parameterId = (i < csVarItemsAmount) ?
+      RAM_PARAM_ID(i) : FLASH_PARAM_ID(i - csVarItemsAmount);
+    CsMirrorItem_t *mirrorItem = csGetMirrorItem(parameterId);
+
+    if (!mirrorItem || mirrorItem->valid)
+      continue;
+    if (CS_RAM_PARAM_TYPE == (parameterId & CS_TYPE_MASK) && !csMirror.ramMirrored)
+      continue;
+
+    read->busy = true;
+    read->parameterId = parameterId;
+    read->invalidations = csMirror.invalidations;
+    read->sreq.dataIn = &read->parameterId;
+    read->sreq.serialize = zsiSerializeCS_ReadParameterReq;
+    read->sreq.dataOut = read->value;
+    read->sreq.callback = csMirrorReadDone;
+    zsiProcessSreq(&read->sreq);
+    return;
+  }
+
+  read->busy = false;
+}
+
+/******************************************************************************
+\brief Non-blocking parameter read completion.
+
+\param[in] sreq - completed request.
+******************************************************************************/
+static void csMirrorReadDone(ZsiSreq_t *sreq)
+{
+  CsMirrorRead_t *read = GET_PARENT_BY_FIELD(CsMirrorRead_t, sreq, sreq);
+
+  csUpdateMirror(read->parameterId, read->value, read->invalidations);
+  csPopulateNextParameter(read);
+}
+
+/******************************************************************************
+\brief Marks mirrored parameter as changed by the network processor.
+
+\param[in] parameterId - ID of the changed parameter.
+******************************************************************************/
+void CS_InvalidateMirroredParameter(CS_MemoryItemId_t parameterId)
+{
+  CsMirrorItem_t *mirrorItem = csGetMirrorItem(parameterId);
+
+  csMirror.invalidations++;
+  if (mirrorItem)
+    mirrorItem->valid = false;
+}
+
+/******************************************************************************
+\brief Marks all mirrored parameters as changed by the network processor.
+       Network processor reports changes of its RAM parameters since then,
+       so they are mirrored too.
+******************************************************************************/
+void CS_InvalidateMirror(void)
+{
+  for (uint8_t i = 0U; i < csVarItemsAmount; i++)
+    csVarMirrorItems[i].valid = false;
+  for (uint8_t i = 0U; i < csConstItemsAmount; i++)
+    csConstMirrorItems[i].valid = false;
+
+  csMirror.invalidations++;
+  csMirror.ramMirrored = true;
+}
+
+#ifdef _CS_MIRROR_STATS_
+/******************************************************************************
+\brief Gets usage statistics of the parameter's mirror.
+
+\param[in] parameterId - ID of the parameter.
+\param[out] stats - statistics, zeroed for parameters which aren't mirrored.
+******************************************************************************/
+void CS_GetMirrorStats(CS_MemoryItemId_t parameterId, CS_MirrorStats_t *stats)
+{
+  CsMirrorItem_t *mirrorItem = csGetMirrorItem(parameterId);
+
+  if (mirrorItem)
+    *stats = mirrorItem->stats;
+  else
+    memset(stats, 0x00, sizeof(CS_MirrorStats_t));
+}
+
+/******************************************************************************
+\brief Resets usage statistics of all mirrored parameters.
+******************************************************************************/
+void CS_ResetMirrorStats(void)
+{
+  for (uint8_t i = 0U; i < csVarItemsAmount; i++)
+    memset(&csVarMirrorItems[i].stats, 0x00, sizeof(CS_MirrorStats_t));
+  for (uint8_t i = 0U; i < csConstItemsAmount; i++)
+    memset(&csConstMirrorItems[i].stats, 0x00, sizeof(CS_MirrorStats_t));
+}
+#endif /* _CS_MIRROR_STATS_ */
 #endif /* ZAPPSI_HOST */
+
+#ifdef ZAPPSI_NP
+/******************************************************************************
+\brief Marks RAM parameter as changed or reported to the host.
+
+\param[in] parameterId - ID of the parameter.
+\param[in] changed - true if the parameter is changed, false if reported.
+******************************************************************************/
+static void csSetParameterChanged(CS_MemoryItemId_t parameterId, bool changed)
+{
+  uint8_t itemInternalId = parameterId & CS_ID_MASK;
+  uint8_t mask = 1U << (itemInternalId & 0x07U);
+
+  if (CS_RAM_PARAM_TYPE != (parameterId & CS_TYPE_MASK) ||
+      itemInternalId >= csVarItemsAmount)
+    return;
+
+  if (changed)
+    csChangedParameters[itemInternalId >> 3U] |= mask;
+  else
+    csChangedParameters[itemInternalId >> 3U] &= ~mask;
 }
 
-#if !defined(ZAPPSI_HOST) || defined(ZCL_SUPPORT)
 /******************************************************************************
-\brief Sets the parameter specified by it's identifier to internal or external
-       memory.
+\brief Considers current values of RAM parameters as reported to the host.
+******************************************************************************/
+void CS_StartParametersTracking(void)
+{
+  memset(csChangedParameters, 0x00, CEIL(csVarItemsAmount, 8U));
+}
 
-\param[in] parameterId - ID of the parameter being written
-\param[out] parameterValue - pointer to the parameter
+/******************************************************************************
+\brief Finds RAM parameters written since they were reported to the host.
+       Found changes are considered as reported.
 
+\param[out] parameterIds - IDs of the changed parameters.
+\param[in] maxAmount - maximum amount of IDs to be written.
+
+\return amount of changed parameters, which may exceed maxAmount.
 ******************************************************************************/
-static void csWriteParameterInternal(CS_MemoryItemId_t parameterId,
-  const void *parameterValue)
+uint8_t CS_CollectChangedParameters(CS_MemoryItemId_t *parameterIds, uint8_t maxAmount)
 {
-  CS_MemoryItem_t item = csGetItem(parameterId);
+  uint8_t amount = 0U;
 
-  SYS_E_ASSERT_FATAL(parameterValue, CS_WRITE_PARAM0);
-  SYS_E_ASSERT_FATAL(((parameterId & CS_TYPE_MASK) == CS_RAM_PARAM_TYPE), CS_WRITE_PARAM1);
+  for (uint8_t i = 0U; i < csVarItemsAmount; i++)
+  {
+    if (csChangedParameters[i >> 3U] & (1U << (i & 0x07U)))
+    {
+      if (amount < maxAmount)
+        parameterIds[amount] = (CS_MemoryItemId_t)RAM_PARAM_ID(i);
+      amount++;
+    }
+  }
+  memset(csChangedParameters, 0x00, CEIL(csVarItemsAmount, 8U));
 
-  memcpy(item.value.ramValue, parameterValue, item.size);
+  return amount;
 }
-#endif /* !defined(ZAPPSI_HOST) || defined(ZCL_SUPPORT) */
+
+/******************************************************************************
+\brief Considers current value of the parameter as known to the host.
+
+\param[in] parameterId - ID of the RAM parameter.
+******************************************************************************/
+void CS_AcceptParameterChange(CS_MemoryItemId_t parameterId)
+{
+  csSetParameterChanged(parameterId, false);
+}
+#endif /* ZAPPSI_NP */
 
 #ifndef ZAPPSI_HOST
 /******************************************************************************
@@ -26,6 +26,7 @@
 #endif
 #include <csSIB.h>
 #include <configServer.h>
+#include <csMirror.h>
 
 /******************************************************************************
                     External variables section
@@ -315,6 +316,39 @@ CS_MemoryItem_t PROGMEM_DECLARE(csMemItems[]) =
 #undef MEMORY_REGION
 #undef DUMMY_MEMORY_REGION
 
+#if defined(ZAPPSI_HOST) || defined(ZAPPSI_NP)
+/*
+ * \brief Copies of parameters values shared by ZAppSI host and network processor.
+ *        Each parameter keeps its value at its own offset, so the arrays are
+ *        sized as the sum of all parameters sizes.
+ */
+#define RAM_PARAMETER(label, id, addr) + sizeof(addr)
+#define DUMMY_RAM_PARAMETER(label, id)
+#define FLASH_PARAMETER(label, id, addr) + sizeof(addr)
+#define DUMMY_FLASH_PARAMETER(label, id)
+
+const uint8_t csVarItemsAmount = ARRAY_SIZE(csVarItems);
+#ifdef ZAPPSI_HOST
+const uint8_t csConstItemsAmount = ARRAY_SIZE(csConstItems);
+
+/* Host's mirror of the network processor's RAM and FLASH parameters */
+CsMirrorItem_t csVarMirrorItems[ARRAY_SIZE(csVarItems)];
+CsMirrorItem_t csConstMirrorItems[ARRAY_SIZE(csConstItems)];
+uint8_t csMirrorValues[0U
+  #include "csVarTable.h"
+  #include "csConstTable.h"
+];
+#else
+/* Network processor's RAM parameters changed since they were reported to the host */
+uint8_t csChangedParameters[CEIL(ARRAY_SIZE(csVarItems), 8U)];
+#endif /* ZAPPSI_HOST */
+
+#undef RAM_PARAMETER
+#undef DUMMY_RAM_PARAMETER
+#undef FLASH_PARAMETER
+#undef DUMMY_FLASH_PARAMETER
+#endif /* ZAPPSI_HOST || ZAPPSI_NP */
+
 /******************************************************************************
                     Implementation section
 ******************************************************************************/
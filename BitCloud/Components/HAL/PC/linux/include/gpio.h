@@ -0,0 +1,23 @@
+/**************************************************************************//**
+\file  gpio.h
+
+\brief Stub of gpio interface for the Linux host platform.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+******************************************************************************/
+#ifndef _GPIO_H
+#define _GPIO_H
+
+
+#endif /* _GPIO_H*/
+
+// eof gpio.h
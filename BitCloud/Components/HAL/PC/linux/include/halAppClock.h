@@ -0,0 +1,50 @@
+/**********************************************************************//**
+  \file halAppClock.h
+  \brief Declarations of the timerfd based application clock.
+
+  \author
+
+  \internal
+  History:
+    17/10/26 - Linux port
+**************************************************************************/
+#ifndef _HALAPPCLOCK_H
+#define _HALAPPCLOCK_H
+
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+/* Application clock tick in ms */
+#define HAL_APPTIMERINTERVAL 10ul
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+/**************************************************************************//**
+\brief Configures, enables and starts timer
+******************************************************************************/
+void halStartAppClock(void);
+
+/**************************************************************************//**
+\brief Returns time of timer
+
+\return time in ms.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimer(void);
+
+/**************************************************************************//**
+\brief Returns time of timer with microsecond resolution
+
+\return time in us, wraps around every 2^32 us.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimerUs(void);
+
+
+#endif /* _HALAPPCLOCK_H */
+
+//eof halAppClock.h
@@ -0,0 +1,40 @@
+/*****************************************************************************//**
+\file  halAtomic.h
+
+\brief Declarations of hal atomic module.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+**********************************************************************************/
+#ifndef _HAL_ATOMIC_H
+#define _HAL_ATOMIC_H
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+/******************************************************************************
+\brief Initializes critical section
+******************************************************************************/
+void halInitCriticalSection(void);
+
+/******************************************************************************
+\brief Enters atomic section. Sections are recursive within one thread and
+exclusive between the main loop and the HAL interrupt thread.
+******************************************************************************/
+void halStartAtomic(void);
+
+/******************************************************************************
+\brief Exits atomic section
+******************************************************************************/
+void halEndAtomic(void);
+
+#endif //_HAL_ATOMIC_H
+//eof halAtomic.h
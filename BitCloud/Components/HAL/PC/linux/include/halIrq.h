@@ -0,0 +1,93 @@
+/**************************************************************************//**
+\file  halIrq.h
+
+\brief Declarations of the HAL interrupt emulation thread.
+       All asynchronous sources of the Linux HAL (app clock timerfd, serial
+       ports) are multiplexed by one epoll thread which plays the role of
+       the interrupt context of the embedded platforms.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+******************************************************************************/
+#ifndef _HAL_IRQ_H
+#define _HAL_IRQ_H
+
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+                   Types section
+******************************************************************************/
+/** \brief Handler of the interrupt source. Called from the interrupt thread
+with the epoll events that fired on the file descriptor. */
+typedef void (* HalIrqHandler_t)(uint32_t events);
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+/**************************************************************************//**
+\brief Creates epoll instance, idle wakeup event and starts interrupt thread.
+******************************************************************************/
+void halInitIrq(void);
+
+/**************************************************************************//**
+\brief Registers file descriptor as an interrupt source.
+
+\param[in] fd      - file descriptor to be watched;
+\param[in] events  - epoll events mask (EPOLLIN, EPOLLOUT...);
+\param[in] handler - handler to be called from the interrupt thread
+\return 0 on success, -1 otherwise
+******************************************************************************/
+int halRegisterIrq(int fd, uint32_t events, HalIrqHandler_t handler);
+
+/**************************************************************************//**
+\brief Changes events mask of the registered interrupt source.
+
+\param[in] fd     - file descriptor registered by halRegisterIrq();
+\param[in] events - new epoll events mask
+\return 0 on success, -1 otherwise
+******************************************************************************/
+int halModifyIrq(int fd, uint32_t events);
+
+/**************************************************************************//**
+\brief Removes file descriptor from the interrupt sources.
+
+\param[in] fd - file descriptor registered by halRegisterIrq()
+******************************************************************************/
+void halUnregisterIrq(int fd);
+
+/**************************************************************************//**
+\brief Wakes up the main loop if it waits in HAL_IdleMode().
+******************************************************************************/
+void halWakeUpFromIdle(void);
+
+/**************************************************************************//**
+\brief Blocks the main loop until an interrupt source fires or timeout expires.
+
+\param[in] timeoutMs - maximum time to wait in ms
+******************************************************************************/
+void halWaitForIrq(uint32_t timeoutMs);
+
+/**************************************************************************//**
+\brief Changes level of the external interrupt line which is not backed by
+sysfs gpio. Registered handler is called from the caller context if the
+change matches the line mode. Intended for loopback tests.
+\param[in] irqNumber - IRQ_n line number
+\param[in] high      - new level of the line
+******************************************************************************/
+void halSetLoopbackIrqLine(uint8_t irqNumber, bool high);
+
+#endif /* _HAL_IRQ_H */
+
+// eof halIrq.h
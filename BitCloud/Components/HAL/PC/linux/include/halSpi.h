@@ -0,0 +1,90 @@
+/**************************************************************************//**
+\file  halSpi.h
+
+\brief Declarations of spi hardware-dependent module for the Linux host.
+       Master channels are backed by the spidev driver, the loopback channel
+       is not backed by any device and is intended for tests.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Created
+******************************************************************************/
+#ifndef _HAL_SPI_H
+#define _HAL_SPI_H
+
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <sysTypes.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+/* Channel numbering: high byte is the spidev bus, low byte is the chip select. */
+#define HAL_SPI_CHANNEL(bus, cs)        (((bus) << 8) | (cs))
+#define HAL_SPI_CHANNEL_BUS(channel)    (((channel) >> 8) & 0x00FF)
+#define HAL_SPI_CHANNEL_CS(channel)     ((channel) & 0x00FF)
+
+/******************************************************************************
+                   Types section
+******************************************************************************/
+typedef enum
+{
+  SPIDEV0_0 = HAL_SPI_CHANNEL(0, 0), //!< /dev/spidev0.0
+  SPIDEV0_1 = HAL_SPI_CHANNEL(0, 1), //!< /dev/spidev0.1
+  SPIDEV1_0 = HAL_SPI_CHANNEL(1, 0), //!< /dev/spidev1.0
+  SPIDEV1_1 = HAL_SPI_CHANNEL(1, 1), //!< /dev/spidev1.1
+  /* Channel without a device: MISO is wired to MOSI unless a peer is set
+     by HAL_SetSpiLoopbackPeer() */
+  SPI_CHANNEL_LOOPBACK = 0xFFFF
+} SpiChannel_t;
+
+// types of the clock mode, values match spidev SPI_MODE_n
+typedef enum
+{
+  // leading edge sample RX bit (rising), trailing edge setup TX bit (falling).
+  SPI_CLOCK_MODE0 = 0,
+  // leading edge setup TX bit (rising), trailing edge sample RX bit (falling).
+  SPI_CLOCK_MODE1 = 1,
+  // leading edge sample RX bit (falling), trailing edge setup TX bit (rising).
+  SPI_CLOCK_MODE2 = 2,
+  // leading edge setup TX bit (falling), trailing edge sample RX bit (rising).
+  SPI_CLOCK_MODE3 = 3
+} SpiClockMode_t;
+
+// Data order
+typedef enum
+{
+  SPI_DATA_MSB_FIRST, // data with MSB first
+  SPI_DATA_LSB_FIRST  // data with LSB first
+} SpiDataOrder_t;
+
+/** \brief Device emulated behind the loopback channel. */
+typedef struct
+{
+  /** \brief Called when the chip select is changed by HAL_SelectSpi(). */
+  void (* select)(bool active);
+  /** \brief Exchanges length bytes: tx is clocked out by the master,
+  rx is filled with the bytes clocked in. */
+  void (* transfer)(const uint8_t *tx, uint8_t *rx, uint16_t length);
+} HAL_SpiLoopbackPeer_t;
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+/**************************************************************************//**
+\brief Sets device emulated behind the loopback channel.
+
+\param[in] peer - emulated device, NULL to wire MISO to MOSI
+******************************************************************************/
+void HAL_SetSpiLoopbackPeer(const HAL_SpiLoopbackPeer_t *peer);
+
+#endif /* _HAL_SPI_H */
+// eof halSpi.h
@@ -0,0 +1,175 @@
+/*****************************************************************************//**
+\file  halUsart.h
+
+\brief Declarations of usart hardware-dependent module for the Linux host.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+**********************************************************************************/
+#ifndef _HAL_USART_H
+#define _HAL_USART_H
+
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <sysTypes.h>
+#include <termios.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+/* Channel which is not backed by a tty: writes go to stdout. */
+#define USART_CHANNEL_FAKE 0
+
+/* Channel numbering: low byte is the tty index, high byte is the device family. */
+#define HAL_USART_TTYS_BASE   0x0100
+#define HAL_USART_TTYUSB_BASE 0x0200
+#define HAL_USART_TTYACM_BASE 0x0300
+
+#define HAL_USART_CHANNEL_FAMILY(channel) ((channel) & 0xFF00)
+#define HAL_USART_CHANNEL_INDEX(channel)  ((channel) & 0x00FF)
+
+/******************************************************************************
+                   Types section
+******************************************************************************/
+typedef struct
+{
+  volatile uint16_t rxPointOfRead;
+  volatile uint16_t rxPointOfWrite;
+  volatile uint16_t rxBytesInBuffer;
+} HalUsartService_t;
+
+typedef enum
+{
+  TTYS0   = HAL_USART_TTYS_BASE + 0,   //!< /dev/ttyS0
+  TTYS1   = HAL_USART_TTYS_BASE + 1,   //!< /dev/ttyS1
+  TTYS2   = HAL_USART_TTYS_BASE + 2,   //!< /dev/ttyS2
+  TTYS3   = HAL_USART_TTYS_BASE + 3,   //!< /dev/ttyS3
+  TTYUSB0 = HAL_USART_TTYUSB_BASE + 0, //!< /dev/ttyUSB0
+  TTYUSB1 = HAL_USART_TTYUSB_BASE + 1, //!< /dev/ttyUSB1
+  TTYUSB2 = HAL_USART_TTYUSB_BASE + 2, //!< /dev/ttyUSB2
+  TTYUSB3 = HAL_USART_TTYUSB_BASE + 3, //!< /dev/ttyUSB3
+  TTYACM0 = HAL_USART_TTYACM_BASE + 0, //!< /dev/ttyACM0 (Xplained Pro EDBG)
+  TTYACM1 = HAL_USART_TTYACM_BASE + 1, //!< /dev/ttyACM1
+  TTYACM2 = HAL_USART_TTYACM_BASE + 2, //!< /dev/ttyACM2
+  TTYACM3 = HAL_USART_TTYACM_BASE + 3, //!< /dev/ttyACM3
+  /* Windows names are kept for configurations shared with the Win build */
+  COM1    = TTYS0,
+  COM2    = TTYS1,
+  COM3    = TTYS2,
+  COM4    = TTYS3
+} UsartChannel_t;
+
+typedef enum
+{
+  USART_MODE_ASYNC = 1
+} UsartMode_t;
+typedef enum
+{
+  USART_BAUDRATE_1200   = B1200,
+  USART_BAUDRATE_2400   = B2400,
+  USART_BAUDRATE_4800   = B4800,
+  USART_BAUDRATE_9600   = B9600,
+  USART_BAUDRATE_19200  = B19200,
+  USART_BAUDRATE_38400  = B38400,
+  USART_BAUDRATE_57600  = B57600,
+  USART_BAUDRATE_115200 = B115200,
+  USART_BAUDRATE_230400 = B230400,
+  USART_BAUDRATE_460800 = B460800,
+  USART_BAUDRATE_921600 = B921600
+} UsartBaudRate_t;
+typedef enum
+{
+  USART_DATA5 = CS5,
+  USART_DATA6 = CS6,
+  USART_DATA7 = CS7,
+  USART_DATA8 = CS8
+} UsartData_t;
+typedef enum
+{
+  USART_PARITY_NONE = 0,
+  USART_PARITY_EVEN = PARENB,
+  USART_PARITY_ODD  = PARENB | PARODD
+} UsartParity_t;
+typedef enum
+{
+  USART_STOPBIT_1 = 0,
+  USART_STOPBIT_2 = CSTOPB
+} UsartStopBits_t;
+typedef enum
+{
+  USART_EDGE_MODE_FALLING = 0,
+  USART_EDGE_MODE_RISING  = 1
+} UsartEdgeMode_t;
+typedef uint8_t UsartClkMode_t;
+typedef enum
+{
+  HAL_USART_TASK_USART_TXC,
+  HAL_USART_TASK_USART_RXC,
+  HAL_USART_TASKS_NUMBER
+} HalUsartTaskId_t;
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+/**************************************************************************//**
+\brief Opens Usart interface
+
+\param[in] baud     - usart's baud rate;
+\param[in] size     - amount of bits in a byte;
+\param[in] stopBits - amount of stopbits;
+\param[in] parity   - usart's parity
+\param[in] channel  - usart's channel
+******************************************************************************/
+void halOpenUsart(UsartBaudRate_t baud, UsartData_t size, UsartStopBits_t stopBits, UsartParity_t parity, UsartChannel_t channel);
+
+/**************************************************************************//**
+\brief Closes Usart interface
+******************************************************************************/
+void halCloseUsart(void);
+
+/**************************************************************************//**
+\brief Writes data to Usart interface
+
+\param[in] buffer - pointer to buffer with data to be sent;
+\param[in] length - amount of bytes in a buffer
+******************************************************************************/
+void halWriteUsartData(uint8_t *buffer, uint16_t length);
+
+/**************************************************************************//**
+\brief Puts received bytes to the cyclic buffer
+
+\param[in] data   - data to put;
+\param[in] length - amount of bytes to put
+******************************************************************************/
+void halUsartRxBufferFiller(uint8_t *data, uint16_t length);
+
+/**************************************************************************//**
+\brief Returns amount of free bytes in the cyclic buffer
+
+\return free space of the cyclic buffer, 0 if there is no buffer
+******************************************************************************/
+uint16_t halUsartRxBufferSpace(void);
+
+/**************************************************************************//**
+\brief Restarts reading of the tty after space has been freed in the cyclic
+buffer
+******************************************************************************/
+void halUsartRxResume(void);
+
+/**************************************************************************//**
+\brief Posts usart task to be processed by HAL task manager
+
+\param[in] taskId - usart task
+******************************************************************************/
+void halPostUsartTask(HalUsartTaskId_t taskId);
+#endif //_HAL_USART_H
+//eof halUsart.h
@@ -0,0 +1,128 @@
+/**********************************************************************//**
+  \file halAppClock.c
+  \brief Application clock driven by CLOCK_MONOTONIC timerfd.
+
+  \author
+
+  \internal
+  History:
+    17/10/26 - Linux port
+**************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <halAppClock.h>
+#include <halTaskManager.h>
+#include <halIrq.h>
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/******************************************************************************
+                     Global variables section
+******************************************************************************/
+uint8_t halAppTimeOvfw = 0;
+
+/******************************************************************************
+                     Local variables section
+******************************************************************************/
+static volatile uint32_t halAppIrqCount = 0;
+static uint32_t halAppTime = 0ul;
+static int appClockFd = -1;
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+static void halAppClockFired(uint32_t events);
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief Configures, enables and starts timer
+******************************************************************************/
+void halStartAppClock(void)
+{
+  struct itimerspec period =
+  {
+    .it_interval = {.tv_sec = 0, .tv_nsec = HAL_APPTIMERINTERVAL * 1000000l},
+    .it_value    = {.tv_sec = 0, .tv_nsec = HAL_APPTIMERINTERVAL * 1000000l}
+  };
+
+  appClockFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (appClockFd < 0)
+  {
+    perror("Error occured while creating application clock");
+    exit(1);
+  }
+  if (0 != timerfd_settime(appClockFd, 0, &period, NULL))
+  {
+    perror("Error occured while starting application clock");
+    exit(1);
+  }
+  if (0 != halRegisterIrq(appClockFd, EPOLLIN, halAppClockFired))
+  {
+    fprintf(stderr, "Error occured while registering application clock");
+    exit(1);
+  }
+}
+
+/**************************************************************************//**
+\brief Returns time of timer
+
+\return time in ms.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimer(void)
+{
+  uint32_t tmpCounter;
+  uint32_t tmpValue;
+
+  ATOMIC_SECTION_ENTER
+  tmpCounter = halAppIrqCount;
+  halAppIrqCount = 0;
+  ATOMIC_SECTION_LEAVE
+  tmpValue = tmpCounter * HAL_APPTIMERINTERVAL;
+  halAppTime += tmpValue;
+  if (halAppTime < tmpValue)
+    halAppTimeOvfw++;
+
+  return halAppTime;
+}
+
+/**************************************************************************//**
+\brief Returns time of timer with microsecond resolution
+
+\return time in us.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimerUs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)now.tv_sec * 1000000ul + (uint32_t)(now.tv_nsec / 1000l);
+}
+
+/**************************************************************************//**
+\brief Application clock has fired. Runs in the interrupt thread.
+The timerfd counter keeps expirations missed while the thread was descheduled,
+so no tick is lost under load.
+
+\param[in] events - epoll events
+******************************************************************************/
+static void halAppClockFired(uint32_t events)
+{
+  uint64_t expirations;
+  (void)events;
+
+  if (sizeof(expirations) != read(appClockFd, &expirations, sizeof(expirations)))
+    return;
+
+  ATOMIC_SECTION_ENTER
+  halAppIrqCount += (uint32_t)expirations;
+  ATOMIC_SECTION_LEAVE
+  halPostTask(HAL_APPTIMER);
+}
+//eof halAppClock.c
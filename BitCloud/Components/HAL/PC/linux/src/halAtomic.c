@@ -0,0 +1,77 @@
+/**********************************************************************//**
+  \file halAtomic.c
+  \brief Atomic sections for the Linux host built on C11 atomics.
+
+  The main loop and the HAL interrupt thread (halIrq.c) are the only two
+  contexts touching shared stack data, so a spin lock with thread-local
+  nesting is enough: the contended path is short and the lock is recursive
+  like the Win32 CRITICAL_SECTION used by the Windows port.
+
+  \author
+
+  \internal
+  History:
+    17/10/26 - Linux port
+**************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <halAtomic.h>
+#include <stdatomic.h>
+#include <sched.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+#define HAL_ATOMIC_SPINS_BEFORE_YIELD 64u
+
+/******************************************************************************
+                     Local variables section
+******************************************************************************/
+static atomic_flag halAtomicLock = ATOMIC_FLAG_INIT;
+static _Thread_local unsigned halAtomicNesting = 0u;
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/******************************************************************************
+\brief Initializes critical section
+******************************************************************************/
+void halInitCriticalSection(void)
+{
+  atomic_flag_clear_explicit(&halAtomicLock, memory_order_release);
+  halAtomicNesting = 0u;
+}
+
+/******************************************************************************
+ Enter atomic section.
+******************************************************************************/
+void halStartAtomic(void)
+{
+  unsigned spins = 0u;
+
+  if (halAtomicNesting++)
+    return;
+
+  while (atomic_flag_test_and_set_explicit(&halAtomicLock, memory_order_acquire))
+  {
+    if (++spins >= HAL_ATOMIC_SPINS_BEFORE_YIELD)
+    {
+      spins = 0u;
+      sched_yield();
+    }
+  }
+}
+
+/******************************************************************************
+ Exit atomic section
+******************************************************************************/
+void halEndAtomic(void)
+{
+  if (--halAtomicNesting)
+    return;
+
+  atomic_flag_clear_explicit(&halAtomicLock, memory_order_release);
+}
+
+//eof halAtomic.c
@@ -0,0 +1,37 @@
+/**********************************************************************//**
+\file  halInit.c
+
+\brief HAL start up module.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+**************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <halAppClock.h>
+#include <halAtomic.h>
+#include <halIrq.h>
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/******************************************************************************
+Performs start up HAL initialization.
+******************************************************************************/
+void HAL_Init(void)
+{
+  halInitCriticalSection();
+  halInitIrq();
+  // start application clock
+  halStartAppClock();
+}
+// eof halInit.c
@@ -0,0 +1,223 @@
+/**************************************************************************//**
+\file  halIrq.c
+
+\brief Interrupt emulation thread of the Linux host HAL.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+*******************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <halIrq.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+#define HAL_IRQ_MAX_SOURCES 12
+#define HAL_IRQ_MAX_EVENTS  HAL_IRQ_MAX_SOURCES
+
+/******************************************************************************
+                   Types section
+******************************************************************************/
+typedef struct
+{
+  int fd;
+  HalIrqHandler_t handler;
+} HalIrqSource_t;
+
+/******************************************************************************
+                    Local variables
+******************************************************************************/
+static int epollFd = -1;
+static int idleEventFd = -1;
+static pthread_t irqThread;
+static HalIrqSource_t irqSources[HAL_IRQ_MAX_SOURCES];
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+static void *halIrqThread(void *arg);
+static HalIrqSource_t *halFindIrqSource(int fd);
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief Creates epoll instance, idle wakeup event and starts interrupt thread.
+******************************************************************************/
+void halInitIrq(void)
+{
+  for (uint8_t i = 0; i < HAL_IRQ_MAX_SOURCES; i++)
+    irqSources[i].fd = -1;
+
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  idleEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (epollFd < 0 || idleEventFd < 0)
+  {
+    perror("Error occured while creating interrupt sources");
+    exit(1);
+  }
+
+  if (0 != pthread_create(&irqThread, NULL, halIrqThread, NULL))
+  {
+    fprintf(stderr, "Error occured while starting interrupt thread");
+    exit(1);
+  }
+}
+
+/**************************************************************************//**
+\brief Registers file descriptor as an interrupt source.
+
+\param[in] fd      - file descriptor to be watched;
+\param[in] events  - epoll events mask (EPOLLIN, EPOLLOUT...);
+\param[in] handler - handler to be called from the interrupt thread
+\return 0 on success, -1 otherwise
+******************************************************************************/
+int halRegisterIrq(int fd, uint32_t events, HalIrqHandler_t handler)
+{
+  HalIrqSource_t *source = halFindIrqSource(-1);
+  struct epoll_event event;
+
+  if (!source || !handler)
+    return -1;
+
+  source->fd = fd;
+  source->handler = handler;
+  event.events = events;
+  event.data.ptr = source;
+  if (0 != epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event))
+  {
+    source->fd = -1;
+    return -1;
+  }
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Changes events mask of the registered interrupt source.
+
+\param[in] fd     - file descriptor registered by halRegisterIrq();
+\param[in] events - new epoll events mask
+\return 0 on success, -1 otherwise
+******************************************************************************/
+int halModifyIrq(int fd, uint32_t events)
+{
+  HalIrqSource_t *source = halFindIrqSource(fd);
+  struct epoll_event event;
+
+  if (!source)
+    return -1;
+
+  event.events = events;
+  event.data.ptr = source;
+  return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+}
+
+/**************************************************************************//**
+\brief Removes file descriptor from the interrupt sources.
+
+\param[in] fd - file descriptor registered by halRegisterIrq()
+******************************************************************************/
+void halUnregisterIrq(int fd)
+{
+  HalIrqSource_t *source = halFindIrqSource(fd);
+
+  if (!source)
+    return;
+
+  epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+  source->fd = -1;
+}
+
+/**************************************************************************//**
+\brief Wakes up the main loop if it waits in HAL_IdleMode().
+******************************************************************************/
+void halWakeUpFromIdle(void)
+{
+  uint64_t one = 1;
+
+  if (sizeof(one) != write(idleEventFd, &one, sizeof(one)) && EAGAIN != errno)
+    perror("Error occured while waking up main loop");
+}
+
+/**************************************************************************//**
+\brief Blocks the main loop until an interrupt source fires or timeout expires.
+
+\param[in] timeoutMs - maximum time to wait in ms
+******************************************************************************/
+void halWaitForIrq(uint32_t timeoutMs)
+{
+  struct pollfd pfd = {.fd = idleEventFd, .events = POLLIN};
+  uint64_t counter;
+
+  if (poll(&pfd, 1, (int)timeoutMs) > 0)
+    (void)!read(idleEventFd, &counter, sizeof(counter));
+}
+
+/**************************************************************************//**
+\brief Finds registered interrupt source.
+
+\param[in] fd - file descriptor, -1 to find free slot
+\return pointer to the source or NULL
+******************************************************************************/
+static HalIrqSource_t *halFindIrqSource(int fd)
+{
+  for (uint8_t i = 0; i < HAL_IRQ_MAX_SOURCES; i++)
+    if (fd == irqSources[i].fd)
+      return &irqSources[i];
+  return NULL;
+}
+
+/**************************************************************************//**
+\brief Interrupt thread. Dispatches fired sources to their handlers and wakes
+up the main loop afterwards.
+******************************************************************************/
+static void *halIrqThread(void *arg)
+{
+  struct epoll_event events[HAL_IRQ_MAX_EVENTS];
+  (void)arg;
+
+  for (;;)
+  {
+    int fired = epoll_wait(epollFd, events, HAL_IRQ_MAX_EVENTS, -1);
+
+    if (fired < 0)
+    {
+      if (EINTR == errno)
+        continue;
+      perror("Error occured while waiting for interrupts");
+      exit(1);
+    }
+
+    for (int i = 0; i < fired; i++)
+    {
+      HalIrqSource_t *source = (HalIrqSource_t *)events[i].data.ptr;
+
+      if (source->fd >= 0)
+        source->handler(events[i].events);
+    }
+
+    if (fired)
+      halWakeUpFromIdle();
+  }
+  return NULL;
+}
+
+// eof halIrq.c
@@ -0,0 +1,66 @@
+/**************************************************************************//**
+\file  halTaskManager.c
+
+\brief Implemenattion of HAL task manager for the Linux host.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Created
+*******************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <halTaskManager.h>
+#include <atomic.h>
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+void halAppTimerHandler(void);
+void halSigUsartHandler(void);
+
+/******************************************************************************
+                   Global variables section
+******************************************************************************/
+volatile HalTaskBitMask_t halTaskFlags = 0;
+volatile HalTaskBitMask_t halAcceptedTasks = HAL_ALL_TASKS_ACCEPTED_MASK;
+HalTask_t PROGMEM_DECLARE(halHandlers[HAL_MAX_TASKS_ID]) =
+{
+  halAppTimerHandler,
+  halSigUsartHandler
+};
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief HAL task handler.
+******************************************************************************/
+void HAL_TaskHandler(void)
+{
+  HalTaskBitMask_t  mask = 1;
+  uint8_t           index = 0;
+  HalTaskBitMask_t  tmpFlags;
+
+  ATOMIC_SECTION_ENTER
+  tmpFlags = halTaskFlags & halAcceptedTasks;
+  halTaskFlags ^= tmpFlags;
+  ATOMIC_SECTION_LEAVE
+
+  for ( ; tmpFlags && index < (uint8_t)HAL_MAX_TASKS_ID; index++, mask <<= 1)
+  {
+    if (tmpFlags & mask)
+    {
+      tmpFlags ^= mask;
+      halHandlers[index]();
+    }
+  }
+}
+// eof halTaskManager.c
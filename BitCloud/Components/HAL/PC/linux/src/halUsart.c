@@ -0,0 +1,262 @@
+/**************************************************************************//**
+\file  halUsart.c
+
+\brief Implementation of usart hardware-dependent module for the Linux host.
+       The tty is opened non-blocking and watched by the HAL interrupt thread
+       through epoll, received blocks are moved to the cyclic buffer as a whole.
+       When the cyclic buffer is full the tty is not read any more until the
+       stack frees some space, so the data stays in the kernel buffer instead
+       of being dropped.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Linux port
+*******************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <halUsart.h>
+#include <halIrq.h>
+#include <atomic.h>
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+#define HAL_USART_RX_CHUNK_SIZE 4096
+
+/******************************************************************************
+                    Local variables
+******************************************************************************/
+static int ttyFd = -1;
+static char ttyName[sizeof("/dev/ttyUSB255")];
+static uint8_t *txPointer;
+static uint16_t txLeft;
+static uint8_t rxBuffer[HAL_USART_RX_CHUNK_SIZE];
+static bool rxThrottled;
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+static void halUsartIrqHandler(uint32_t events);
+static bool halTransmitPendingData(void);
+static uint32_t halUsartIrqEvents(void);
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief Opens Usart interface
+
+\param[in] baud     - usart's baud rate
+\param[in] size     - amount of bits in a byte
+\param[in] stopBits - amount of stopbits
+\param[in] parity   - usart's parity
+\param[in] channel  - usart's channel
+******************************************************************************/
+void halOpenUsart(UsartBaudRate_t baud, UsartData_t size, UsartStopBits_t stopBits, UsartParity_t parity, UsartChannel_t channel)
+{
+  struct termios tty;
+  const char *family;
+
+  switch (HAL_USART_CHANNEL_FAMILY(channel))
+  {
+    case HAL_USART_TTYUSB_BASE: family = "/dev/ttyUSB"; break;
+    case HAL_USART_TTYACM_BASE: family = "/dev/ttyACM"; break;
+    default:                    family = "/dev/ttyS";   break;
+  }
+  snprintf(ttyName, sizeof(ttyName), "%s%u", family, HAL_USART_CHANNEL_INDEX(channel));
+
+  ttyFd = open(ttyName, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (ttyFd < 0)
+  {
+    fprintf(stderr, "Failed to open serial port %s. Error %d", ttyName, errno);
+    exit(1);
+  }
+
+  if (0 != tcgetattr(ttyFd, &tty))
+  {
+    fprintf(stderr, "Error ocurred while getting port parameters");
+    exit(1);
+  }
+  cfmakeraw(&tty);
+  tty.c_cflag &= ~(CSIZE | CSTOPB | PARENB | PARODD | CRTSCTS);
+  tty.c_cflag |= size | stopBits | parity | CLOCAL | CREAD;
+  tty.c_cc[VMIN]  = 0;
+  tty.c_cc[VTIME] = 0;
+  cfsetispeed(&tty, baud);
+  cfsetospeed(&tty, baud);
+  if (0 != tcsetattr(ttyFd, TCSANOW, &tty))
+  {
+    fprintf(stderr, "Error occured while setting port parameters");
+    exit(1);
+  }
+  tcflush(ttyFd, TCIOFLUSH);
+
+  rxThrottled = false;
+  if (0 != halRegisterIrq(ttyFd, EPOLLIN, halUsartIrqHandler))
+  {
+    fprintf(stderr, "Error occured while registering serial port");
+    exit(1);
+  }
+}
+
+/**************************************************************************//**
+\brief Closes Usart interface
+******************************************************************************/
+void halCloseUsart(void)
+{
+  if (ttyFd < 0)
+    return;
+
+  halUnregisterIrq(ttyFd);
+  close(ttyFd);
+  ttyFd = -1;
+}
+
+/**************************************************************************//**
+\brief Writes data to Usart interface
+
+\param[in] buffer - pointer to buffer with data to be sent;
+\param[in] length - amount of bytes in a buffer
+******************************************************************************/
+void halWriteUsartData(uint8_t *buffer, uint16_t length)
+{
+  bool done;
+
+  ATOMIC_SECTION_ENTER
+  txPointer = buffer;
+  txLeft = length;
+  done = halTransmitPendingData();
+  if (!done)
+    halModifyIrq(ttyFd, halUsartIrqEvents());
+  ATOMIC_SECTION_LEAVE
+
+  if (done)
+    halPostUsartTask(HAL_USART_TASK_USART_TXC);
+}
+
+/**************************************************************************//**
+\brief Restarts reading of the tty after space has been freed in the cyclic
+buffer
+******************************************************************************/
+void halUsartRxResume(void)
+{
+  ATOMIC_SECTION_ENTER
+  if (rxThrottled)
+  {
+    rxThrottled = false;
+    halModifyIrq(ttyFd, halUsartIrqEvents());
+  }
+  ATOMIC_SECTION_LEAVE
+}
+
+/**************************************************************************//**
+\brief Returns epoll events the tty should be watched for.
+Must be called inside an atomic section.
+
+\return epoll events mask
+******************************************************************************/
+static uint32_t halUsartIrqEvents(void)
+{
+  return (rxThrottled ? 0 : EPOLLIN) | (txLeft ? EPOLLOUT : 0);
+}
+
+/**************************************************************************//**
+\brief Writes as much of the pending data as the tty accepts.
+Must be called inside an atomic section.
+
+\return true if all the data has been written
+******************************************************************************/
+static bool halTransmitPendingData(void)
+{
+  while (txLeft)
+  {
+    ssize_t written = write(ttyFd, txPointer, txLeft);
+
+    if (written < 0)
+    {
+      if (EAGAIN == errno || EINTR == errno)
+        return false;
+      fprintf(stderr, "Serial port writing error");
+      exit(1);
+    }
+    txPointer += written;
+    txLeft -= (uint16_t)written;
+  }
+  return true;
+}
+
+/**************************************************************************//**
+\brief Serial port events handler. Runs in the interrupt thread.
+
+\param[in] events - epoll events
+******************************************************************************/
+static void halUsartIrqHandler(uint32_t events)
+{
+  if (events & EPOLLIN)
+  {
+    ssize_t bytesRead = 0;
+    uint16_t space;
+
+    /* Read no more than fits into the cyclic buffer */
+    while ((space = halUsartRxBufferSpace()) &&
+           (bytesRead = read(ttyFd, rxBuffer,
+                              space < sizeof(rxBuffer) ? space : sizeof(rxBuffer))) > 0)
+    {
+      halUsartRxBufferFiller(rxBuffer, (uint16_t)bytesRead);
+      halPostUsartTask(HAL_USART_TASK_USART_RXC);
+    }
+    if (bytesRead < 0 && EAGAIN != errno && EINTR != errno)
+    {
+      fprintf(stderr, "Serial port reading error");
+      exit(1);
+    }
+
+    /* Stop watching the tty for input until HAL_ReadUsart() frees some space */
+    if (!space)
+    {
+      ATOMIC_SECTION_ENTER
+      if (!halUsartRxBufferSpace())
+      {
+        rxThrottled = true;
+        halModifyIrq(ttyFd, halUsartIrqEvents());
+      }
+      ATOMIC_SECTION_LEAVE
+    }
+  }
+
+  if (events & EPOLLOUT)
+  {
+    bool done;
+
+    ATOMIC_SECTION_ENTER
+    done = halTransmitPendingData();
+    if (done)
+      halModifyIrq(ttyFd, halUsartIrqEvents());
+    ATOMIC_SECTION_LEAVE
+
+    if (done)
+      halPostUsartTask(HAL_USART_TASK_USART_TXC);
+  }
+
+  if (events & (EPOLLERR | EPOLLHUP))
+  {
+    fprintf(stderr, "Serial port %s has been disconnected", ttyName);
+    exit(1);
+  }
+}
+
+// eof halUsart.c
@@ -0,0 +1,302 @@
+/**************************************************************************//**
+\file  irq.c
+
+\brief Implementation of the external interrupts for the Linux host.
+       IRQ_n lines are backed by sysfs gpio value files watched by the HAL
+       interrupt thread. Lines without a gpio are driven by
+       halSetLoopbackIrqLine(). Level modes fire when the line becomes active
+       and when an active line is enabled.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Created
+*******************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <irq.h>
+#include <halIrq.h>
+#include <atomic.h>
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+/* sysfs gpio numbers IRQ_0..IRQ_7 are wired to, -1 for loopback lines.
+   Gpios must be exported and configured as inputs beforehand. */
+#ifndef HAL_IRQ_GPIO_LINES
+  #define HAL_IRQ_GPIO_LINES {-1, -1, -1, -1, -1, -1, -1, -1}
+#endif
+
+#define HAL_IRQ_GPIO_HANDLER(n) \
+  static void halIrq##n##GpioHandler(uint32_t events) { halIrqGpioEvent(IRQ_##n, events); }
+
+/******************************************************************************
+                   Types section
+******************************************************************************/
+typedef struct
+{
+  void (*handler)(void);
+  HAL_IrqMode_t mode;
+  bool enabled;
+  bool low;
+  int fd;
+} HalIrqLine_t;
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+static void halIrqGpioEvent(HAL_IrqNumber_t irqNumber, uint32_t events);
+
+/******************************************************************************
+                    Local variables
+******************************************************************************/
+static const int halIrqGpios[IRQ_LIMIT] = HAL_IRQ_GPIO_LINES;
+static HalIrqLine_t halIrqLines[IRQ_LIMIT];
+
+HAL_IRQ_GPIO_HANDLER(0)
+HAL_IRQ_GPIO_HANDLER(1)
+HAL_IRQ_GPIO_HANDLER(2)
+HAL_IRQ_GPIO_HANDLER(3)
+HAL_IRQ_GPIO_HANDLER(4)
+HAL_IRQ_GPIO_HANDLER(5)
+HAL_IRQ_GPIO_HANDLER(6)
+HAL_IRQ_GPIO_HANDLER(7)
+
+static const HalIrqHandler_t halIrqGpioHandlers[IRQ_LIMIT] =
+{
+  halIrq0GpioHandler, halIrq1GpioHandler, halIrq2GpioHandler, halIrq3GpioHandler,
+  halIrq4GpioHandler, halIrq5GpioHandler, halIrq6GpioHandler, halIrq7GpioHandler
+};
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief Updates the line level and calls the handler if the change fires the
+interrupt.
+
+\param[in] irqNumber - IRQ number
+\param[in] low - new level of the line
+******************************************************************************/
+static void halIrqLineChanged(HAL_IrqNumber_t irqNumber, bool low)
+{
+  HalIrqLine_t *line = &halIrqLines[irqNumber];
+  bool fire = false;
+
+  ATOMIC_SECTION_ENTER
+  if (line->handler && line->enabled)
+  {
+    switch (line->mode)
+    {
+      case IRQ_LOW_LEVEL:    fire = low;                  break;
+      case IRQ_HIGH_LEVEL:   fire = !low;                 break;
+      case IRQ_ANY_EDGE:     fire = (low != line->low);   break;
+      case IRQ_FALLING_EDGE: fire = (low && !line->low);  break;
+      case IRQ_RISING_EDGE:  fire = (!low && line->low);  break;
+      default:                                            break;
+    }
+  }
+  line->low = low;
+  /* Handler is called inside the atomic section like an interrupt routine */
+  if (fire)
+    line->handler();
+  ATOMIC_SECTION_LEAVE
+}
+
+/**************************************************************************//**
+\brief Reads the level of the gpio backed line.
+
+\param[in] fd - opened value file of the gpio
+\return true if the line is low
+******************************************************************************/
+static bool halReadGpioLineLow(int fd)
+{
+  char value = '1';
+
+  if (lseek(fd, 0, SEEK_SET) < 0 || read(fd, &value, sizeof(value)) != sizeof(value))
+    perror("Error occured while reading interrupt line");
+  return '0' == value;
+}
+
+/**************************************************************************//**
+\brief Gpio value file events handler. Runs in the interrupt thread.
+
+\param[in] irqNumber - IRQ number
+\param[in] events - epoll events
+******************************************************************************/
+static void halIrqGpioEvent(HAL_IrqNumber_t irqNumber, uint32_t events)
+{
+  int fd = halIrqLines[irqNumber].fd;
+
+  (void)events;
+  if (fd >= 0)
+    halIrqLineChanged(irqNumber, halReadGpioLineLow(fd));
+}
+
+/**************************************************************************//**
+\brief Opens the value file of the gpio backed line and starts watching it.
+
+\param[in] irqNumber - IRQ number
+\return file descriptor or -1 on failure
+******************************************************************************/
+static int halOpenGpioLine(HAL_IrqNumber_t irqNumber)
+{
+  char path[sizeof("/sys/class/gpio/gpio-2147483648/value")];
+  int fd;
+
+  snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/edge", halIrqGpios[irqNumber]);
+  fd = open(path, O_WRONLY | O_CLOEXEC);
+  if (fd < 0 || write(fd, "both", 4) != 4)
+  {
+    fprintf(stderr, "Failed to configure %s\n", path);
+    if (fd >= 0)
+      close(fd);
+    return -1;
+  }
+  close(fd);
+
+  snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", halIrqGpios[irqNumber]);
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Failed to open %s\n", path);
+    return -1;
+  }
+  /* Reading clears the pending edge and gives the initial level */
+  halIrqLines[irqNumber].low = halReadGpioLineLow(fd);
+  if (0 != halRegisterIrq(fd, EPOLLPRI | EPOLLERR, halIrqGpioHandlers[irqNumber]))
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**************************************************************************//**
+\brief Registers user external interrupt
+
+\param[in] irqNumber - IRQ number
+\param[in] irqMode - IRQ mode
+\param[in] f - user callback on IRQ firing
+\return -1 if irqNumber is out of range or such interrupt has been registered
+  already, or handler is NULL. 0 otherwise.
+******************************************************************************/
+int HAL_RegisterIrq(HAL_IrqNumber_t irqNumber, HAL_IrqMode_t irqMode, void (*f)(void))
+{
+  HalIrqLine_t *line;
+  int fd = -1;
+
+  if (irqNumber >= IRQ_LIMIT || irqMode > IRQ_RISING_EDGE || !f)
+    return -1;
+
+  line = &halIrqLines[irqNumber];
+  if (line->handler)
+    return -1;
+
+  if (halIrqGpios[irqNumber] >= 0 && (fd = halOpenGpioLine(irqNumber)) < 0)
+    return -1;
+
+  ATOMIC_SECTION_ENTER
+  line->fd = fd;
+  line->mode = irqMode;
+  line->enabled = false;
+  line->handler = f;
+  ATOMIC_SECTION_LEAVE
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Enables the irqNumber interrupt. Active level interrupt fires at once.
+
+\param[in] irqNumber - IRQ number
+\return -1 if irqNumber is out of range or has not been registered yet.
+  0 otherwise.
+******************************************************************************/
+int HAL_EnableIrq(HAL_IrqNumber_t irqNumber)
+{
+  HalIrqLine_t *line;
+
+  if (irqNumber >= IRQ_LIMIT || !halIrqLines[irqNumber].handler)
+    return -1;
+
+  line = &halIrqLines[irqNumber];
+  ATOMIC_SECTION_ENTER
+  line->enabled = true;
+  halIrqLineChanged(irqNumber, (line->fd >= 0) ? halReadGpioLineLow(line->fd) : line->low);
+  ATOMIC_SECTION_LEAVE
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Disables the irqNumber interrupt.
+
+\param[in] irqNumber - IRQ number
+\return -1 if irqNumber is out of range or has not been registered yet.
+  0 otherwise.
+******************************************************************************/
+int HAL_DisableIrq(HAL_IrqNumber_t irqNumber)
+{
+  if (irqNumber >= IRQ_LIMIT || !halIrqLines[irqNumber].handler)
+    return -1;
+
+  halIrqLines[irqNumber].enabled = false;
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Unregisters the user's irqNumber interrupt.
+
+\param[in] irqNumber - IRQ number
+\return -1 if irqNumber is out of range or has not been registered yet.
+  0 otherwise.
+******************************************************************************/
+int HAL_UnregisterIrq(HAL_IrqNumber_t irqNumber)
+{
+  HalIrqLine_t *line;
+
+  if (irqNumber >= IRQ_LIMIT || !halIrqLines[irqNumber].handler)
+    return -1;
+
+  line = &halIrqLines[irqNumber];
+  ATOMIC_SECTION_ENTER
+  line->enabled = false;
+  line->handler = NULL;
+  ATOMIC_SECTION_LEAVE
+
+  if (line->fd >= 0)
+  {
+    halUnregisterIrq(line->fd);
+    close(line->fd);
+    line->fd = -1;
+  }
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Changes level of the external interrupt line which is not backed by
+sysfs gpio. Registered handler is called from the caller context if the
+change matches the line mode. Intended for loopback tests.
+
+\param[in] irqNumber - IRQ_n line number
+\param[in] high      - new level of the line
+******************************************************************************/
+void halSetLoopbackIrqLine(uint8_t irqNumber, bool high)
+{
+  if (irqNumber >= IRQ_LIMIT || halIrqGpios[irqNumber] >= 0)
+    return;
+
+  halIrqLineChanged((HAL_IrqNumber_t)irqNumber, !high);
+}
+
+// eof irq.c
@@ -0,0 +1,247 @@
+/**************************************************************************//**
+\file  spi.c
+
+\brief Implementation of the master spi for the Linux host.
+       Channels are backed by the spidev driver, transfers are synchronous
+       and move the whole buffer with one ioctl call. The loopback channel
+       passes transfers to the emulated peer or wires MISO to MOSI.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Created
+*******************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <spi.h>
+/* linux/spi/spi.h is skipped by spidev.h because of the same include guard
+   as HAL spi.h, so mode flags used are defined below */
+#include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+/* Default buffer size of the spidev driver */
+#define HAL_SPIDEV_MAX_TRANSFER_SIZE 4096u
+/* Mode flag of spidev */
+#define HAL_SPIDEV_LSB_FIRST 0x08u
+
+/******************************************************************************
+                    Local variables
+******************************************************************************/
+static HAL_SpiDescriptor_t *halSpiOpened;
+static int spiFd = -1;
+static bool spiSelected;
+static const HAL_SpiLoopbackPeer_t *spiLoopbackPeer;
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief Sets device emulated behind the loopback channel.
+
+\param[in] peer - emulated device, NULL to wire MISO to MOSI
+******************************************************************************/
+void HAL_SetSpiLoopbackPeer(const HAL_SpiLoopbackPeer_t *peer)
+{
+  spiLoopbackPeer = peer;
+}
+
+/**************************************************************************//**
+\brief Open the SPI interface.
+
+\param[in] descriptor - pointer to the spi descriptor.
+\return -1 - the channel is opened already or the device is not accessible.
+         0 - SPI channel is ready.
+******************************************************************************/
+int HAL_OpenSpi(HAL_SpiDescriptor_t *descriptor)
+{
+  char devName[sizeof("/dev/spidev255.255")];
+  uint8_t mode, bits = 8;
+
+  if (!descriptor || halSpiOpened)
+    return -1;
+
+  if (SPI_CHANNEL_LOOPBACK != descriptor->tty)
+  {
+    snprintf(devName, sizeof(devName), "/dev/spidev%u.%u",
+             HAL_SPI_CHANNEL_BUS(descriptor->tty), HAL_SPI_CHANNEL_CS(descriptor->tty));
+    spiFd = open(devName, O_RDWR | O_CLOEXEC);
+    if (spiFd < 0)
+    {
+      fprintf(stderr, "Failed to open spi device %s. Error %d\n", devName, errno);
+      return -1;
+    }
+
+    mode = (uint8_t)descriptor->clockMode;
+    if (SPI_DATA_LSB_FIRST == descriptor->dataOrder)
+      mode |= HAL_SPIDEV_LSB_FIRST;
+    if (ioctl(spiFd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(spiFd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(spiFd, SPI_IOC_WR_MAX_SPEED_HZ, &descriptor->baudRate) < 0)
+    {
+      fprintf(stderr, "Error occured while setting spi parameters of %s\n", devName);
+      close(spiFd);
+      spiFd = -1;
+      return -1;
+    }
+  }
+
+  spiSelected = false;
+  halSpiOpened = descriptor;
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Close the SPI channel.
+
+\param[in] descriptor - pointer to the spi descriptor.
+\return Returns 0 on success or -1 if channel was not opened.
+******************************************************************************/
+int HAL_CloseSpi(HAL_SpiDescriptor_t *descriptor)
+{
+  if (!descriptor || descriptor != halSpiOpened)
+    return -1;
+
+  if (spiFd >= 0)
+    close(spiFd);
+  spiFd = -1;
+  halSpiOpened = NULL;
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Exchanges data with the slave. Chip select is left active after the
+last chunk if the slave is selected by HAL_SelectSpi().
+
+\param[in] tx - data to be clocked out, NULL to clock out zeros
+\param[in] rx - buffer for clocked in data, NULL to drop it
+\param[in] length - number of bytes
+\return length on success, -1 otherwise
+******************************************************************************/
+static int halSpiTransfer(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+  uint16_t done = 0;
+
+  if (SPI_CHANNEL_LOOPBACK == halSpiOpened->tty)
+  {
+    if (spiLoopbackPeer)
+      spiLoopbackPeer->transfer(tx, rx, length);
+    else if (rx && tx)
+      memmove(rx, tx, length);
+    else if (rx)
+      memset(rx, 0, length);
+    return length;
+  }
+
+  while (done < length)
+  {
+    struct spi_ioc_transfer transfer;
+    uint16_t chunk = length - done;
+
+    if (chunk > HAL_SPIDEV_MAX_TRANSFER_SIZE)
+      chunk = HAL_SPIDEV_MAX_TRANSFER_SIZE;
+
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.tx_buf = tx ? (uintptr_t)(tx + done) : 0;
+    transfer.rx_buf = rx ? (uintptr_t)(rx + done) : 0;
+    transfer.len = chunk;
+    transfer.speed_hz = halSpiOpened->baudRate;
+    transfer.bits_per_word = 8;
+    /* Keep the slave selected between chunks and selected transfers */
+    transfer.cs_change = (done + chunk < length) || spiSelected;
+
+    if (ioctl(spiFd, SPI_IOC_MESSAGE(1), &transfer) < 0)
+    {
+      fprintf(stderr, "Spi transfer error %d\n", errno);
+      return -1;
+    }
+    done += chunk;
+  }
+  return length;
+}
+
+/**************************************************************************//**
+\brief Keeps the chip select of the master channel active between transfers.
+
+\param[in] descriptor - pointer to the spi descriptor.
+\param[in] active - true to select the slave, false to release it.
+\return Returns 0 on success or -1 if channel was not opened.
+******************************************************************************/
+int HAL_SelectSpi(HAL_SpiDescriptor_t *descriptor, bool active)
+{
+  if (!descriptor || descriptor != halSpiOpened)
+    return -1;
+
+  if (SPI_CHANNEL_LOOPBACK == descriptor->tty)
+  {
+    spiSelected = active;
+    if (spiLoopbackPeer && spiLoopbackPeer->select)
+      spiLoopbackPeer->select(active);
+    return 0;
+  }
+
+  if (spiSelected && !active)
+  {
+    struct spi_ioc_transfer release;
+
+    /* Empty transfer without cs_change deactivates the chip select */
+    memset(&release, 0, sizeof(release));
+    spiSelected = false;
+    if (ioctl(spiFd, SPI_IOC_MESSAGE(1), &release) < 0)
+      return -1;
+  }
+  spiSelected = active;
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Writes a length bytes to the SPI. Synchronous only, callback is not
+used.
+
+\param[in] descriptor - pointer to spi descriptor
+\param[in] buffer - pointer to application data buffer;
+\param[in] length - number bytes for transfer;
+\return -1 - spi module was not opened, pointer to the data or the length
+  are zero; number of written bytes otherwise.
+******************************************************************************/
+int HAL_WriteSpi(HAL_SpiDescriptor_t *descriptor, uint8_t *buffer, uint16_t length)
+{
+  if (!descriptor || descriptor != halSpiOpened || !buffer || !length)
+    return -1;
+
+  return halSpiTransfer(buffer, NULL, length);
+}
+
+/**************************************************************************//**
+\brief Writes a number of bytes from the buffer to the spi and places the
+read data to the same buffer. Synchronous only, callback is not used.
+
+\param[in] descriptor - pointer to HAL_SpiDescriptor_t structure
+\param[in] buffer - pointer to the application data buffer
+\param[in] length - number of bytes to transfer
+\return -1 - spi module was not opened, pointer to the data or the length
+  are zero; number of transferred bytes otherwise.
+******************************************************************************/
+int HAL_ReadSpi(HAL_SpiDescriptor_t *descriptor, uint8_t *buffer, uint16_t length)
+{
+  if (!descriptor || descriptor != halSpiOpened || !buffer || !length)
+    return -1;
+
+  return halSpiTransfer(buffer, buffer, length);
+}
+
+// eof spi.c
@@ -0,0 +1,361 @@
+/**************************************************************************//**
+\file  usart.c
+
+\brief Usart implementation for the Linux host.
+       One channel is backed by the host serial port (halUsart.c), the fake
+       channel is routed to the standard output.
+
+\author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+\internal
+  History:
+    17/10/26 - Created
+*******************************************************************************/
+/******************************************************************************
+                   Includes section
+******************************************************************************/
+#include <usart.h>
+#include <halTaskManager.h>
+#include <stdio.h>
+
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+#define HAL_USART_FAKE_TXC (1u << HAL_USART_TASKS_NUMBER)
+
+/******************************************************************************
+                    Local variables
+******************************************************************************/
+static HAL_UsartDescriptor_t *halSerialDescriptor;
+static HAL_UsartDescriptor_t *halFakeDescriptor;
+static volatile uint8_t halUsartTaskFlags;
+static volatile bool halFakeTasksHeld;
+
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+void halSigUsartHandler(void);
+
+/******************************************************************************
+                   Implementations section
+******************************************************************************/
+/**************************************************************************//**
+\brief Registers usart's event handlers and opens the host serial port.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure
+\return Returns positive usart descriptor on success or -1 in case of
+  bad usart channel or if the channel is already opened.
+******************************************************************************/
+int HAL_OpenUsart(HAL_UsartDescriptor_t *descriptor)
+{
+  if (!descriptor)
+    return -1;
+
+  descriptor->service.rxPointOfRead = 0;
+  descriptor->service.rxPointOfWrite = 0;
+  descriptor->service.rxBytesInBuffer = 0;
+
+  if (USART_CHANNEL_FAKE == descriptor->tty)
+  {
+    if (halFakeDescriptor)
+      return -1;
+    halFakeDescriptor = descriptor;
+    return (int)descriptor->tty;
+  }
+
+  if (halSerialDescriptor)
+    return -1;
+
+  halSerialDescriptor = descriptor;
+  halOpenUsart(descriptor->baudrate, descriptor->dataLength, descriptor->stopbits,
+               descriptor->parity, descriptor->tty);
+  return (int)descriptor->tty;
+}
+
+/*************************************************************************//**
+\brief Releases the usart channel.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure
+\return -1 - bad descriptor or channel is already closed; \n
+         0 - success.
+*****************************************************************************/
+int HAL_CloseUsart(HAL_UsartDescriptor_t *descriptor)
+{
+  if (!descriptor)
+    return -1;
+
+  if (descriptor == halFakeDescriptor)
+  {
+    halFakeDescriptor = NULL;
+    return 0;
+  }
+  if (descriptor != halSerialDescriptor)
+    return -1;
+
+  halCloseUsart();
+  ATOMIC_SECTION_ENTER
+  halSerialDescriptor = NULL;
+  ATOMIC_SECTION_LEAVE
+  return 0;
+}
+
+/**************************************************************************//**
+\brief Writes a number of bytes to usart channel.
+txCallback function will be used to notify when the transmission is finished.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\param[in] buffer - pointer to the application data buffer;
+\param[in] length - number of bytes to transfer;
+\return -1 - bad descriptor; \n
+        Number of bytes placed to the buffer - success.
+******************************************************************************/
+int HAL_WriteUsart(HAL_UsartDescriptor_t *descriptor, uint8_t *buffer, uint16_t length)
+{
+  if (!descriptor || !buffer || !length)
+    return -1;
+
+  if (descriptor == halFakeDescriptor)
+  {
+    fwrite(buffer, 1, length, stdout);
+    fflush(stdout);
+    ATOMIC_SECTION_ENTER
+    halUsartTaskFlags |= HAL_USART_FAKE_TXC;
+    ATOMIC_SECTION_LEAVE
+    halPostTask(HAL_TASK_USART);
+    return length;
+  }
+  if (descriptor != halSerialDescriptor)
+    return -1;
+
+  halWriteUsartData(buffer, length);
+  return length;
+}
+
+/*************************************************************************//**
+\brief Reads a number of bytes from usart and places them to the buffer.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\param[in] buffer - pointer to the application buffer;
+\param[in] length - number of bytes to be placed to the buffer;
+\return -1 - bad descriptor, or bad number of bytes to read; \n
+        Number of bytes placed to the buffer - success.
+*****************************************************************************/
+int HAL_ReadUsart(HAL_UsartDescriptor_t *descriptor, uint8_t *buffer, uint16_t length)
+{
+  HalUsartService_t *service;
+  uint16_t wasRead = 0;
+  uint16_t chunk;
+
+  if (!descriptor || !buffer || !length)
+    return -1;
+  if (descriptor == halFakeDescriptor)
+    return 0;
+  if (descriptor != halSerialDescriptor || !descriptor->rxBuffer)
+    return -1;
+
+  service = &descriptor->service;
+  ATOMIC_SECTION_ENTER
+  if (length > service->rxBytesInBuffer)
+    length = service->rxBytesInBuffer;
+  /* Copy at most two contiguous pieces of the cyclic buffer */
+  while (wasRead < length)
+  {
+    chunk = descriptor->rxBufferLength - service->rxPointOfRead;
+    if (chunk > length - wasRead)
+      chunk = length - wasRead;
+    memcpy(buffer + wasRead, descriptor->rxBuffer + service->rxPointOfRead, chunk);
+    wasRead += chunk;
+    service->rxPointOfRead += chunk;
+    if (service->rxPointOfRead == descriptor->rxBufferLength)
+      service->rxPointOfRead = 0;
+  }
+  service->rxBytesInBuffer -= wasRead;
+  ATOMIC_SECTION_LEAVE
+
+  if (wasRead)
+    halUsartRxResume();
+  return wasRead;
+}
+
+/**************************************************************************//**
+\brief Puts received bytes to the cyclic buffer. Bytes which do not fit
+into the buffer are dropped.
+
+\param[in] data   - data to put;
+\param[in] length - amount of bytes to put
+******************************************************************************/
+void halUsartRxBufferFiller(uint8_t *data, uint16_t length)
+{
+  HalUsartService_t *service;
+  uint16_t chunk;
+
+  ATOMIC_SECTION_ENTER
+  if (halSerialDescriptor && halSerialDescriptor->rxBuffer)
+  {
+    service = &halSerialDescriptor->service;
+    if (length > halSerialDescriptor->rxBufferLength - service->rxBytesInBuffer)
+      length = halSerialDescriptor->rxBufferLength - service->rxBytesInBuffer;
+    service->rxBytesInBuffer += length;
+
+    while (length)
+    {
+      chunk = halSerialDescriptor->rxBufferLength - service->rxPointOfWrite;
+      if (chunk > length)
+        chunk = length;
+      memcpy(halSerialDescriptor->rxBuffer + service->rxPointOfWrite, data, chunk);
+      data += chunk;
+      length -= chunk;
+      service->rxPointOfWrite += chunk;
+      if (service->rxPointOfWrite == halSerialDescriptor->rxBufferLength)
+        service->rxPointOfWrite = 0;
+    }
+  }
+  ATOMIC_SECTION_LEAVE
+}
+
+/**************************************************************************//**
+\brief Returns amount of free bytes in the cyclic buffer
+
+\return free space of the cyclic buffer, 0 if there is no buffer
+******************************************************************************/
+uint16_t halUsartRxBufferSpace(void)
+{
+  uint16_t space = 0;
+
+  ATOMIC_SECTION_ENTER
+  if (halSerialDescriptor && halSerialDescriptor->rxBuffer)
+    space = halSerialDescriptor->rxBufferLength - halSerialDescriptor->service.rxBytesInBuffer;
+  ATOMIC_SECTION_LEAVE
+
+  return space;
+}
+
+/**************************************************************************//**
+\brief Posts usart task to be processed by HAL task manager
+
+\param[in] taskId - usart task
+******************************************************************************/
+void halPostUsartTask(HalUsartTaskId_t taskId)
+{
+  ATOMIC_SECTION_ENTER
+  halUsartTaskFlags |= (uint8_t)(1u << taskId);
+  ATOMIC_SECTION_LEAVE
+  halPostTask(HAL_TASK_USART);
+}
+
+/**************************************************************************//**
+\brief Usart task handler. Calls registered callbacks.
+******************************************************************************/
+void halSigUsartHandler(void)
+{
+  uint8_t flags;
+  uint16_t bytesInBuffer = 0;
+
+  ATOMIC_SECTION_ENTER
+  flags = halUsartTaskFlags;
+  if (halFakeTasksHeld)
+    flags &= (uint8_t)~HAL_USART_FAKE_TXC;
+  halUsartTaskFlags &= (uint8_t)~flags;
+  if (halSerialDescriptor)
+    bytesInBuffer = halSerialDescriptor->service.rxBytesInBuffer;
+  ATOMIC_SECTION_LEAVE
+
+  if ((flags & HAL_USART_FAKE_TXC) && halFakeDescriptor && halFakeDescriptor->txCallback)
+    halFakeDescriptor->txCallback();
+
+  if (!halSerialDescriptor)
+    return;
+
+  if ((flags & (1u << HAL_USART_TASK_USART_TXC)) && halSerialDescriptor->txCallback)
+    halSerialDescriptor->txCallback();
+
+  if ((flags & (1u << HAL_USART_TASK_USART_RXC)) && bytesInBuffer && halSerialDescriptor->rxCallback)
+    halSerialDescriptor->rxCallback(bytesInBuffer);
+}
+
+/**************************************************************************//**
+\brief Checks the status of tx buffer. Only callback mode is supported.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\return -1 - bad descriptor, no tx buffer
+******************************************************************************/
+int HAL_IsTxEmpty(HAL_UsartDescriptor_t *descriptor)
+{
+  (void)descriptor;
+  return -1;
+}
+
+/**************************************************************************//**
+\brief Hardware flow control lines are not available on the host.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\return -1 - unsupported mode
+******************************************************************************/
+int HAL_OnUsartCts(HAL_UsartDescriptor_t *descriptor)
+{
+  (void)descriptor;
+  return -1;
+}
+
+/**************************************************************************//**
+\brief Hardware flow control lines are not available on the host.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\return -1 - unsupported mode
+******************************************************************************/
+int HAL_OffUsartCts(HAL_UsartDescriptor_t *descriptor)
+{
+  (void)descriptor;
+  return -1;
+}
+
+/**************************************************************************//**
+\brief Hardware flow control lines are not available on the host.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\return -1 - unsupported mode
+******************************************************************************/
+int HAL_ReadUsartRts(HAL_UsartDescriptor_t *descriptor)
+{
+  (void)descriptor;
+  return -1;
+}
+
+/**************************************************************************//**
+\brief Hardware flow control lines are not available on the host.
+
+\param[in] descriptor - pointer to HAL_UsartDescriptor_t structure;
+\return -1 - unsupported mode
+******************************************************************************/
+int HAL_ReadUsartDtr(HAL_UsartDescriptor_t *descriptor)
+{
+  (void)descriptor;
+  return -1;
+}
+
+/**************************************************************************//**
+\brief Holds execution of all tasks except related to reqiured channel.
+
+\param[in] tty - channel to accept tasks for
+******************************************************************************/
+void HAL_HoldOnOthersUsartTasks(UsartChannel_t tty)
+{
+  halFakeTasksHeld = (USART_CHANNEL_FAKE != tty);
+}
+
+/**************************************************************************//**
+\brief Accepts execution of previously holded tasks.
+******************************************************************************/
+void HAL_ReleaseAllHeldUsartTasks(void)
+{
+  halFakeTasksHeld = false;
+  if (halUsartTaskFlags)
+    halPostTask(HAL_TASK_USART);
+}
+
+// eof usart.c
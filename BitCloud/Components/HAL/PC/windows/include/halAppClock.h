@@ -36,6 +36,13 @@ void halStartAppClock(void);
 ******************************************************************************/
 uint32_t halGetTimeOfAppTimer(void);
 
+/**************************************************************************//**
+\brief Returns time of timer with microsecond resolution
+
+\return time in us, wraps around every 2^32 us.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimerUs(void);
+
 
 #endif /* _HALAPPCLOCK_H */
 
@@ -80,6 +80,22 @@ uint32_t halGetTimeOfAppTimer(void)
   return halAppTime;
 }
 
+/**************************************************************************//**
+\brief Returns time of timer with microsecond resolution
+
+\return time in us.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimerUs(void)
+{
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (uint32_t)(counter.QuadPart / frequency.QuadPart * 1000000ull +
+                    counter.QuadPart % frequency.QuadPart * 1000000ull / frequency.QuadPart);
+}
+
 /**************************************************************************//**
 \brief System timer has fired
 
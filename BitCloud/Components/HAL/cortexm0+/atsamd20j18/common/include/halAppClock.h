@@ -69,6 +69,14 @@ void halAppSystemTimeSynchronize(void);
 ******************************************************************************/
 uint32_t halGetTimeOfAppTimer(void);
 
+/**************************************************************************//**
+\brief Return time of the application clock with microsecond resolution.
+
+\return
+  time in us, wraps around every 2^32 us.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimerUs(void);
+
 /**************************************************************************//**
 \brief Delay in microseconds.
 
@@ -94,6 +94,8 @@ INLINE void halInterruptAppClock(void)
 void halAdjustSleepInterval(uint32_t interval)
 {
   halAppTime += interval;
+  if (halAppTime < interval)
+    halAppTimeOvfw++;
   halPostTask(HAL_APPTIMER);
 }
 
@@ -207,6 +209,31 @@ uint32_t halGetTimeOfAppTimer(void)
   return halAppTime;
 }
 
+/******************************************************************************
+Return time of application clock with microsecond resolution. Ticks not
+synchronized yet and a compare match not served yet are taken into account.
+
+Returns:
+  time in us.
+******************************************************************************/
+uint32_t halGetTimeOfAppTimerUs(void)
+{
+  uint32_t ms;
+  uint16_t counter;
+
+  ATOMIC_SECTION_ENTER
+    counter = TC3_16_COUNT;
+    ms = halAppTime + halAppIrqCount * HAL_APPTIMERINTERVAL;
+    if (TC3_16_INTFLAG_s.mc0)
+    { // counter has been restarted, read it again after the match
+      counter = TC3_16_COUNT;
+      ms += HAL_APPTIMERINTERVAL;
+    }
+  ATOMIC_SECTION_LEAVE
+
+  return ms * 1000ul + counter / (AMOUNT_TIMER_CLOCK_IN_ONE_USEC);
+}
+
 /**************************************************************************//**
 \brief System clock.
 
@@ -23,7 +23,6 @@
 ******************************************************************************/
 #include <appTimer.h>
 #include <halAppClock.h>
-#include <halSleepTimerClock.h>
 #include <halTaskManager.h>
 #include <atomic.h>
 #include <halDbg.h>
@@ -37,7 +36,8 @@ extern uint8_t halAppTimeOvfw;
 /******************************************************************************
                    Global variables section
 ******************************************************************************/
-static HAL_AppTimer_t *halAppTimerHead = NULL; // head of appTimer list
+static HalTimerQueue_t halAppTimerQueue; // appTimer queue
+static HAL_AppEventTimerHandler_t halAppEventTimerHandler;
 
 /******************************************************************************
                    Implementations section
@@ -48,18 +48,7 @@ static HAL_AppTimer_t *halAppTimerHead = NULL; // head of appTimer list
 ******************************************************************************/
 uint32_t halGetTimeToNextAppTimer(void)
 {
-  uint32_t timeToFire = ~0UL;
-  uint32_t currentTime = halGetTimeOfAppTimer();
-
-  if (halAppTimerHead)
-  {
-    if ((uint64_t)(halAppTimerHead->service.sysTimeLabel) + halAppTimerHead->interval > currentTime)
-      timeToFire = (uint64_t)(halAppTimerHead->service.sysTimeLabel) + halAppTimerHead->interval - currentTime;
-    else
-      timeToFire = 0;
-  }
-
-  return timeToFire;
+  return halGetTimeToNextTimer(&halAppTimerQueue, halGetTimeOfAppTimer());
 }
 
 /******************************************************************************
@@ -68,17 +57,24 @@ Interrupt handler of appTimer clock.
 void halAppTimerHandler(void)
 {
   uint32_t sysTime;
+  HAL_AppTimer_t *p;
+  bool eventTimer;
 
   // search for expired timers and call their callbacks
-  while (halAppTimerHead
-      && ((sysTime = halGetTimeOfAppTimer()) - halAppTimerHead->service.sysTimeLabel) >= halAppTimerHead->interval)
+  while (NULL != (p = halGetExpiredTimer(&halAppTimerQueue, sysTime = halGetTimeOfAppTimer(), &eventTimer)))
   {
-    HAL_AppTimer_t *p = halAppTimerHead;
-    halRemoveTimer(&halAppTimerHead, NULL, p);
+    // event timers have no mode and callback fields
+    if (eventTimer)
+    {
+      SYS_E_ASSERT_FATAL(halAppEventTimerHandler, APPTIMER_HANDLER_0);
+      halAppEventTimerHandler(p);
+      continue;
+    }
+
     if (TIMER_REPEAT_MODE == p->mode)
     {
       p->service.sysTimeLabel = sysTime;
-      halAddTimer(&halAppTimerHead, p, sysTime);
+      halAddTimer(&halAppTimerQueue, p);
     }
 
     SYS_E_ASSERT_FATAL(p->callback, APPTIMER_HANDLER_0);
@@ -96,20 +92,13 @@ Returns:
 ******************************************************************************/
 static bool isTimerAlreadyStarted(HAL_AppTimer_t *appTimer)
 {
-  bool result = false;
-  Timer_t *p; // p is bottom of list
-  p = halAppTimerHead;
-
-  while (NULL != p)
+  // next field of a timer which was never started may be not initialized
+  if (halIsTimerQueued(appTimer) && halIsTimerInQueue(&halAppTimerQueue, appTimer))
   {
-    if (p == appTimer)
-    {
-      SYS_E_ASSERT_ERROR(false, APPTIMER_MISTAKE);
-      return true;
-    }
-    p = (Timer_t *)p->service.next;
+    SYS_E_ASSERT_ERROR(false, APPTIMER_MISTAKE);
+    return true;
   }
-  return result;
+  return false;
 }
 
 /******************************************************************************
@@ -131,12 +120,55 @@ int HAL_StartAppTimer(HAL_AppTimer_t *appTimer)
     return 0;
 
   sysTime = halGetTimeOfAppTimer();
-  appTimer->service.next = NULL;
   appTimer->service.sysTimeLabel = sysTime;
-  halAddTimer((Timer_t**)(&halAppTimerHead), (Timer_t*)appTimer, sysTime);
+  halAddTimer(&halAppTimerQueue, appTimer);
   return 0;
 }
 
+/******************************************************************************
+Starts an event timer.
+Parameters:
+  appTimer - pointer to HAL_AppTimer_t, service.sysTimeLabel and interval are set.
+Returns:
+  -1 - pointer is NULL.
+  0 - success
+******************************************************************************/
+int HAL_StartAppEventTimer(HAL_AppTimer_t *appTimer)
+{
+  if (!appTimer)
+    return -1;
+
+  if (true == isTimerAlreadyStarted(appTimer))
+    return 0;
+
+  halAddEventTimer(&halAppTimerQueue, appTimer);
+  return 0;
+}
+
+/******************************************************************************
+Sets the handler of expired event timers.
+Parameters:
+  handler - handler of expired event timers.
+******************************************************************************/
+void HAL_SetAppEventTimerHandler(HAL_AppEventTimerHandler_t handler)
+{
+  halAppEventTimerHandler = handler;
+}
+
+/******************************************************************************
+Searches for a started event timer.
+Parameters:
+  match - returns true for the timer searched for.
+  context - passed to match.
+Returns:
+  found timer or NULL.
+******************************************************************************/
+HAL_AppTimer_t *HAL_FindAppEventTimer(bool (*match)(const HAL_AppTimer_t *appTimer, const void *context),
+  const void *context)
+{
+  return halFindEventTimer(&halAppTimerQueue, match, context);
+}
+
 /******************************************************************************
 Stops the timer.
 Parameters:
@@ -147,20 +179,27 @@ Returns:
 ******************************************************************************/
 int HAL_StopAppTimer(HAL_AppTimer_t *appTimer)
 {
-  Timer_t *prev = 0;
-  Timer_t **t = &appTimer;
-
   if (!appTimer)
     return -1;
-  if (halAppTimerHead != *t)
-  {
-    if (!(prev = halFindPrevTimer((Timer_t**)(&halAppTimerHead), appTimer)))
-      return -1;  // This timer is not in the list
-  }
-  halRemoveTimer((Timer_t**)(&halAppTimerHead), prev, appTimer);
+  if (!halIsTimerQueued(appTimer) || !halRemoveTimer(&halAppTimerQueue, appTimer))
+    return -1;  // This timer is not in the queue
+
   return 0;
 }
 
+/******************************************************************************
+Checks if the timer is started.
+Parameters:
+  appTimer - pointer to HAL_AppTimer_t.
+Returns:
+  true - the timer presents in the system timers queue
+  false - otherwise
+******************************************************************************/
+bool HAL_IsAppTimerStarted(const HAL_AppTimer_t *appTimer)
+{
+  return appTimer && halIsTimerQueued(appTimer);
+}
+
 /**************************************************************************//**
 \brief Gets system time.
 
@@ -176,4 +215,15 @@ BcTime_t HAL_GetSystemTime(void)
   return sysTime;
 }
 
+/**************************************************************************//**
+\brief Gets system time with microsecond resolution.
+
+\return
+  time since power up in microseconds, wraps around every 2^32 us.
+******************************************************************************/
+uint32_t HAL_GetSystemTimeUs(void)
+{
+  return halGetTimeOfAppTimerUs();
+}
+
 // eof appTimer.c
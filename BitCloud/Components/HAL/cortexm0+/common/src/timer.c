@@ -1,7 +1,7 @@
 /**************************************************************************//**
   \file  timer.c
 
-  \brief Functions to manipulate by timers list.
+  \brief Functions to manipulate by timers queue.
 
   \author
       Atmel Corporation: http://www.atmel.com \n
@@ -24,94 +24,399 @@
 ******************************************************************************/
 #include <bcTimer.h>
 
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+// terminates the list of waiting timers, so next of a queued timer is never NULL
+#define QUEUE_END          (&halTimerQueueEnd)
+// marks event timers in the service next field, timers are aligned to pointers
+#define EVENT_TIMER_TAG    ((uintptr_t)1U)
+#define HEAP_PARENT(index) (((index) - 1U) / 2U)
+#define HEAP_CHILD(index)  (2U * (index) + 1U)
+
+/******************************************************************************
+                   Static variables section
+******************************************************************************/
+static Timer_t halTimerQueueEnd;
+
 /******************************************************************************
                    Implementations section
 ******************************************************************************/
 /******************************************************************************
-Adds timer to the timer's list.
+Checks whether the list of queued timers is empty.
+Parameters:
+  timer - the first timer of the list.
+Returns:
+  true if there are no timers in the list.
+******************************************************************************/
+INLINE bool isListEnd(const Timer_t *timer)
+{
+  return (NULL == timer) || (QUEUE_END == timer);
+}
+
+/******************************************************************************
+Gets the service next field of the timer without the event timer mark.
+Parameters:
+  timer - address of the timer.
+Returns:
+  heap cell of the timer or the next waiting timer.
+******************************************************************************/
+INLINE Timer_t *getNext(const Timer_t *timer)
+{
+  return (Timer_t *)((uintptr_t)timer->service.next & ~EVENT_TIMER_TAG);
+}
+
+/******************************************************************************
+Sets the service next field of the timer keeping the event timer mark.
 Parameters:
-  head - address of pointer to head of the timers list.
-  timer - address of timer that must be added to the list.
+  timer - address of the timer.
+  next - heap cell of the timer or the next waiting timer.
+******************************************************************************/
+INLINE void setNext(Timer_t *timer, Timer_t *next)
+{
+  timer->service.next = (Timer_t *)((uintptr_t)next | ((uintptr_t)timer->service.next & EVENT_TIMER_TAG));
+}
+
+/******************************************************************************
+Checks whether the queued timer is an event timer.
+Parameters:
+  timer - address of the timer.
+Returns:
+  true if the timer was added by halAddEventTimer().
+******************************************************************************/
+INLINE bool isEventTimer(const Timer_t *timer)
+{
+  return 0U != ((uintptr_t)timer->service.next & EVENT_TIMER_TAG);
+}
+
+/******************************************************************************
+Checks whether the timer is expired.
+Parameters:
+  timer - address of the timer.
   sysTime - current time.
 Returns:
-  none.
+  true if the timer is expired.
+******************************************************************************/
+INLINE bool isTimerExpired(const Timer_t *timer, uint32_t sysTime)
+{
+  return (sysTime - timer->service.sysTimeLabel) >= timer->interval;
+}
+
+/******************************************************************************
+Compares expiration times of timers. Intervals are less than 2^31 ms, so
+the difference of expiration times is wrap-safe.
+Parameters:
+  timer, other - addresses of the timers.
+Returns:
+  true if the timer expires before the other one.
+******************************************************************************/
+INLINE bool isTimerEarlier(const Timer_t *timer, const Timer_t *other)
+{
+  return (int32_t)((timer->service.sysTimeLabel + timer->interval) -
+    (other->service.sysTimeLabel + other->interval)) < 0;
+}
+
+/******************************************************************************
+Gets position of the timer in the heap.
+Parameters:
+  queue - timers queue.
+  timer - address of the timer.
+Returns:
+  index of the heap cell, HAL_TIMER_HEAP_SIZE if the timer is not in the heap.
+******************************************************************************/
+static uint16_t getHeapIndex(const HalTimerQueue_t *queue, const Timer_t *timer)
+{
+  uintptr_t offset = (uintptr_t)getNext(timer) - (uintptr_t)queue->heap;
+  uint16_t index = (uint16_t)(offset / sizeof(queue->heap[0]));
+
+  if ((offset < sizeof(queue->heap)) && (index < queue->amount) && (queue->heap[index] == timer))
+    return index;
+  return HAL_TIMER_HEAP_SIZE;
+}
+
+/******************************************************************************
+Puts the timer to the heap cell.
+Parameters:
+  queue - timers queue.
+  index - index of the heap cell.
+  timer - address of the timer.
 ******************************************************************************/
-void halAddTimer(Timer_t **head, Timer_t *newTimer, uint32_t sysTime)
+INLINE void setHeapCell(HalTimerQueue_t *queue, uint16_t index, Timer_t *timer)
 {
-  if (!*head)
+  queue->heap[index] = timer;
+  setNext(timer, (Timer_t *)(void *)&queue->heap[index]);
+}
+
+/******************************************************************************
+Moves the timer from the heap cell towards the root until the heap order is
+restored.
+Parameters:
+  queue - timers queue.
+  index - index of the heap cell to start from.
+  timer - address of the timer.
+******************************************************************************/
+static void siftUp(HalTimerQueue_t *queue, uint16_t index, Timer_t *timer)
+{
+  while (index && isTimerEarlier(timer, queue->heap[HEAP_PARENT(index)]))
   {
-    *head = newTimer;
-    return;
+    setHeapCell(queue, index, queue->heap[HEAP_PARENT(index)]);
+    index = HEAP_PARENT(index);
   }
+  setHeapCell(queue, index, timer);
+}
+
+/******************************************************************************
+Moves the timer from the heap cell towards the leaves until the heap order is
+restored.
+Parameters:
+  queue - timers queue.
+  index - index of the heap cell to start from.
+  timer - address of the timer.
+******************************************************************************/
+static void siftDown(HalTimerQueue_t *queue, uint16_t index, Timer_t *timer)
+{
+  uint16_t child;
 
-  Timer_t *it, *prev = NULL;
-  for (it = *head; it; it = it->service.next)
+  while ((child = HEAP_CHILD(index)) < queue->amount)
   {
-    uint64_t remain;
-    if (it->service.sysTimeLabel <= sysTime)
-      remain = (uint64_t)(it->service.sysTimeLabel) + it->interval - sysTime;
-    else
-      remain = (uint64_t)it->interval - (~it->service.sysTimeLabel + 1) - sysTime;
-    if ((remain <= UINT32_MAX) && (remain >= newTimer->interval))
+    if ((child + 1U < queue->amount) && isTimerEarlier(queue->heap[child + 1U], queue->heap[child]))
+      child++;
+    if (!isTimerEarlier(queue->heap[child], timer))
       break;
-    prev = it;
+    setHeapCell(queue, index, queue->heap[child]);
+    index = child;
   }
-  if (it == *head)
+  setHeapCell(queue, index, timer);
+}
+
+/******************************************************************************
+Adds timer to the timers queue.
+Parameters:
+  queue - timers queue.
+  timer - address of timer that must be added to the queue.
+  tag - event timer mark or 0.
+Returns:
+  none.
+******************************************************************************/
+static void addTimer(HalTimerQueue_t *queue, Timer_t *timer, uintptr_t tag)
+{
+  Timer_t *previous = NULL;
+  Timer_t *waiting = queue->overflow;
+
+  timer->service.next = (Timer_t *)tag;
+
+  if (queue->amount < HAL_TIMER_HEAP_SIZE)
   {
-    newTimer->service.next = *head;
-    *head = newTimer;
+    siftUp(queue, queue->amount++, timer);
+    return;
   }
-  else
+
+  // heap is full, the timer waits in order of expiration, the first added on equality
+  while (!isListEnd(waiting) && !isTimerEarlier(timer, waiting))
   {
-    prev->service.next = newTimer;
-    newTimer->service.next = it;
+    previous = waiting;
+    waiting = getNext(waiting);
   }
+  setNext(timer, isListEnd(waiting) ? QUEUE_END : waiting);
+  if (previous)
+    setNext(previous, timer);
+  else
+    queue->overflow = timer;
+}
+
+/******************************************************************************
+Adds timer to the timers queue.
+Parameters:
+  queue - timers queue.
+  timer - address of timer that must be added to the queue.
+Returns:
+  none.
+******************************************************************************/
+void halAddTimer(HalTimerQueue_t *queue, Timer_t *timer)
+{
+  addTimer(queue, timer, 0U);
 }
 
 /******************************************************************************
-Removes timer from the timers list.
+Adds event timer to the timers queue.
 Parameters:
-  head - address of pointer to head of the timers list.
-  prev - address of the timer before the timer that must be removed from the list.
-  p - address of timer that must be removed from the list.
+  queue - timers queue.
+  timer - address of timer that must be added to the queue.
 Returns:
-  pointer to next cell or pointer to head if deleting is head
+  none.
 ******************************************************************************/
-Timer_t* halRemoveTimer(Timer_t **head, Timer_t *prev, Timer_t *p)
+void halAddEventTimer(HalTimerQueue_t *queue, Timer_t *timer)
 {
-  Timer_t *t;
-  if (p == *head)
-  {// removing first element of list
-    t = p->service.next;
-    p->service.next = 0;
-    *head = t;
-    return *head;
+  addTimer(queue, timer, EVENT_TIMER_TAG);
+}
+
+/******************************************************************************
+Removes timer from the heap cell. The earliest waiting timer takes the room.
+Parameters:
+  queue - timers queue.
+  index - index of the heap cell.
+Returns:
+  none.
+******************************************************************************/
+static void removeHeapCell(HalTimerQueue_t *queue, uint16_t index)
+{
+  Timer_t *last = queue->heap[--queue->amount];
+
+  if (index < queue->amount)
+  {
+    if (index && isTimerEarlier(last, queue->heap[HEAP_PARENT(index)]))
+      siftUp(queue, index, last);
+    else
+      siftDown(queue, index, last);
   }
-  else
+
+  if (!isListEnd(queue->overflow))
   {
-    prev->service.next = p->service.next;
-    p->service.next = 0;
-    return prev->service.next;
+    Timer_t *waiting = queue->overflow;
+
+    queue->overflow = getNext(waiting);
+    siftUp(queue, queue->amount++, waiting);
   }
 }
 
 /******************************************************************************
-The search of the timer in the timers list before one.
+Removes timer from the timers queue.
 Parameters:
-  head - address of pointer to head of the timers list.
+  queue - timers queue.
+  timer - address of timer that must be removed from the queue.
 Returns:
-  pointer to saerching timer
+  true if the timer was in the queue.
 ******************************************************************************/
-Timer_t *halFindPrevTimer(Timer_t **head,  Timer_t *p)
+bool halRemoveTimer(HalTimerQueue_t *queue, Timer_t *timer)
 {
-  Timer_t *t = *head;
+  uint16_t index = getHeapIndex(queue, timer);
+  bool found = true;
 
-  for (; t ;)
+  if (index < HAL_TIMER_HEAP_SIZE)
+    removeHeapCell(queue, index);
+  else
   {
-    if (t->service.next == p)
-      return t;
-    t = t->service.next;
+    Timer_t *previous = NULL;
+    Timer_t *waiting = queue->overflow;
+
+    while (!isListEnd(waiting) && (waiting != timer))
+    {
+      previous = waiting;
+      waiting = getNext(waiting);
+    }
+
+    found = !isListEnd(waiting);
+    if (found && previous)
+      setNext(previous, getNext(timer));
+    else if (found)
+      queue->overflow = getNext(timer);
   }
+
+  timer->service.next = NULL;
+  return found;
+}
+
+/******************************************************************************
+Gets the earliest timer of the queue.
+Parameters:
+  queue - timers queue.
+Returns:
+  the earliest timer or NULL if the queue is empty.
+******************************************************************************/
+static Timer_t *getEarliestTimer(const HalTimerQueue_t *queue)
+{
+  if (!queue->amount)
+    return NULL;
+  // a waiting timer may be added after the heap has been filled with later ones
+  if (!isListEnd(queue->overflow) && isTimerEarlier(queue->overflow, queue->heap[0]))
+    return queue->overflow;
+  return queue->heap[0];
+}
+
+/******************************************************************************
+Removes the earliest expired timer from the queue.
+Parameters:
+  queue - timers queue.
+  sysTime - current time.
+  eventTimer - set to true if the expired timer is an event timer.
+Returns:
+  expired timer or NULL.
+******************************************************************************/
+Timer_t *halGetExpiredTimer(HalTimerQueue_t *queue, uint32_t sysTime, bool *eventTimer)
+{
+  Timer_t *timer = getEarliestTimer(queue);
+
+  if (!timer || !isTimerExpired(timer, sysTime))
+    return NULL;
+
+  *eventTimer = isEventTimer(timer);
+  halRemoveTimer(queue, timer);
+  return timer;
+}
+
+/******************************************************************************
+Gets time left to expiration of the earliest timer in the queue.
+Parameters:
+  queue - timers queue.
+  sysTime - current time.
+Returns:
+  time left, 0 if a timer is expired, UINT32_MAX if queue is empty.
+******************************************************************************/
+uint32_t halGetTimeToNextTimer(const HalTimerQueue_t *queue, uint32_t sysTime)
+{
+  const Timer_t *timer = getEarliestTimer(queue);
+
+  if (!timer)
+    return UINT32_MAX;
+  if (isTimerExpired(timer, sysTime))
+    return 0U;
+  return timer->interval - (sysTime - timer->service.sysTimeLabel);
+}
+
+/******************************************************************************
+Checks if the timer is in the timers queue.
+Parameters:
+  queue - timers queue.
+  timer - address of the timer.
+Returns:
+  true if the timer is in the queue.
+******************************************************************************/
+bool halIsTimerInQueue(const HalTimerQueue_t *queue, const Timer_t *timer)
+{
+  const Timer_t *waiting;
+
+  if (getHeapIndex(queue, timer) < HAL_TIMER_HEAP_SIZE)
+    return true;
+
+  for (waiting = queue->overflow; !isListEnd(waiting); waiting = getNext(waiting))
+    if (waiting == timer)
+      return true;
+
+  return false;
+}
+
+/******************************************************************************
+Searches for a queued event timer.
+Parameters:
+  queue - timers queue.
+  match - returns true for the timer searched for.
+  context - passed to match.
+Returns:
+  found timer or NULL.
+******************************************************************************/
+Timer_t *halFindEventTimer(const HalTimerQueue_t *queue,
+  bool (*match)(const Timer_t *timer, const void *context), const void *context)
+{
+  Timer_t *timer;
+
+  for (uint16_t index = 0U; index < queue->amount; index++)
+    if (isEventTimer(queue->heap[index]) && match(queue->heap[index], context))
+      return queue->heap[index];
+
+  for (timer = queue->overflow; !isListEnd(timer); timer = getNext(timer))
+    if (isEventTimer(timer) && match(timer, context))
+      return timer;
+
   return NULL;
 }
 
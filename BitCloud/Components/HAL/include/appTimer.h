@@ -44,6 +44,9 @@
 */
 typedef Timer_t HAL_AppTimer_t;
 
+/** \brief Handler of expired event timers, see HAL_StartAppEventTimer(). */
+typedef void (*HAL_AppEventTimerHandler_t)(HAL_AppTimer_t *appTimer);
+
 /******************************************************************************
                    Prototypes section
 ******************************************************************************/
@@ -65,6 +68,52 @@ extern "C" {
 ******************************************************************************/
 int HAL_StartAppTimer(HAL_AppTimer_t *appTimer);
 
+/**************************************************************************//**
+\brief Starts an event timer. Event timers are one shot timers without
+  the mode and callback fields: only service and interval fields are accessed,
+  so a structure with the same leading fields may be passed. Expiration is
+  reported to the handler set by HAL_SetAppEventTimerHandler(). The timer is
+  stopped by HAL_StopAppTimer().
+
+\ingroup hal_misc
+
+\param[in]
+  appTimer - pointer to the timer structure. The interval is counted from
+  service.sysTimeLabel set by the caller, a start time in the past makes
+  the timer expire earlier.
+
+\return
+ -1 - pointer is NULL
+  0 - success
+******************************************************************************/
+int HAL_StartAppEventTimer(HAL_AppTimer_t *appTimer);
+
+/**************************************************************************//**
+\brief Sets the handler of expired event timers.
+
+\ingroup hal_misc
+
+\param[in]
+  handler - called with the expired event timer, which is already stopped.
+******************************************************************************/
+void HAL_SetAppEventTimerHandler(HAL_AppEventTimerHandler_t handler);
+
+/**************************************************************************//**
+\brief Searches for a started event timer. Complexity is O(n).
+
+\ingroup hal_misc
+
+\param[in]
+  match - returns true for the timer searched for, called for event timers only.
+\param[in]
+  context - passed to match.
+
+\return
+  found timer or NULL.
+******************************************************************************/
+HAL_AppTimer_t *HAL_FindAppEventTimer(bool (*match)(const HAL_AppTimer_t *appTimer, const void *context),
+  const void *context);
+
 /**************************************************************************//**
 \brief Stops the user timer.
 
@@ -79,6 +128,21 @@ int HAL_StartAppTimer(HAL_AppTimer_t *appTimer);
 ******************************************************************************/
 int HAL_StopAppTimer(HAL_AppTimer_t *appTimer);
 
+/**************************************************************************//**
+\brief Checks if the user timer is started. Timer which was never started
+must be zero initialized.
+
+\ingroup hal_misc
+
+\param[in]
+  appTimer - pointer to the timer structure.
+
+\return
+  true - the timer is started and has not fired yet (for one shot timers)
+  false - otherwise
+******************************************************************************/
+bool HAL_IsAppTimerStarted(const HAL_AppTimer_t *appTimer);
+
 /**************************************************************************//**
 \brief Gets system time.
 
@@ -89,6 +153,17 @@ int HAL_StopAppTimer(HAL_AppTimer_t *appTimer);
 ******************************************************************************/
 BcTime_t HAL_GetSystemTime(void);
 
+/**************************************************************************//**
+\brief Gets system time with microsecond resolution. Suitable for measuring
+  short intervals as a difference of two readings.
+
+\ingroup hal_misc
+
+\return
+  time since power up in microseconds, wraps around every 2^32 us.
+******************************************************************************/
+uint32_t HAL_GetSystemTimeUs(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -31,7 +31,7 @@
   #include <inttypes.h>
 #elif defined(ATMEGA1281) || defined(ATMEGA2561) || defined(ATMEGA1284) || defined(AT90USB1287) \
    || defined(ATXMEGA128A1) || defined(ATXMEGA256A3) || defined(ATXMEGA128B1) || defined(ATXMEGA256D3) \
-   || defined(ATMEGA128RFA1) || defined(ATMEGA256RFR2) || defined(ATMEGA2564RFR2) || defined(WIN)
+   || defined(ATMEGA128RFA1) || defined(ATMEGA256RFR2) || defined(ATMEGA2564RFR2) || defined(WIN) || defined(LINUX)
   #include <halAtomic.h>
 #endif
 
@@ -70,7 +70,7 @@ void halEndAtomic(atomic_t volatile *pAtomic);
   #define ATOMIC_SECTION_ENTER  do {} while (0);
   /** \brief Marks the end of atomic section */
   #define ATOMIC_SECTION_LEAVE  do {} while (0);
-#elif defined(WIN)
+#elif defined(WIN) || defined(LINUX)
   /** \brief Marks the begin of atomic section */
   #define ATOMIC_SECTION_ENTER {halStartAtomic();
   /** \brief Marks the end of atomic section */
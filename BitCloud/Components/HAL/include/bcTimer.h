@@ -27,6 +27,15 @@
 ******************************************************************************/
 #include <sysTypes.h>
 
+/******************************************************************************
+                   Define(s) section
+******************************************************************************/
+/* Amount of timers kept in the heap of a timers queue. Timers started while
+   the heap is full wait in a sorted list until there is room in the heap. */
+#ifndef HAL_TIMER_HEAP_SIZE
+  #define HAL_TIMER_HEAP_SIZE 64U
+#endif
+
 /******************************************************************************
                    Types section
 ******************************************************************************/
@@ -43,8 +52,11 @@ typedef enum
            TIMER_REPEAT_MODE \n
            TIMER_ONE_SHOT_MODE \n
     void (*callback)(void) - pointer to timer callback function (set by user). \n
-    next - pointer to next cell of list \n
-    intervalLeft - absolute fired time */
+    service - timers queue fields, maintained by HAL: next - position of the
+    timer in the queue and its kind, NULL if the timer is not queued;
+    sysTimeLabel - time the timer was started at. The layout is shared with
+    prebuilt libraries and must not be changed. Interval must be less than
+    2^31 ms. Event timers use the service fields and interval only. */
 typedef struct _Timer_t
 {
   struct
@@ -57,41 +69,118 @@ typedef struct _Timer_t
   void (*callback)(void); //!< Must not be set to NULL.
 } Timer_t;
 
+/** \brief Timers queue - binary min-heap of timers by expiration time. The
+    next field of a timer in the heap points to its heap cell, timers which
+    did not fit into the heap are linked in order of expiration. The lowest
+    bit of the next field marks event timers. Must be zero initialized. */
+typedef struct
+{
+  Timer_t *heap[HAL_TIMER_HEAP_SIZE];
+  Timer_t *overflow; // timers waiting for room in the heap
+  uint16_t amount;   // amount of timers in the heap, the heap is full if any timer waits
+} HalTimerQueue_t;
+
 /******************************************************************************
                    Prototypes section
 ******************************************************************************/
 /**************************************************************************//**
-\brief Adds timer to the timer's list. Timers sorted by remaining time.
+\brief Adds timer to the timers queue. Complexity is O(log n) while the heap
+  has room.
+\param[in]
+  queue - timers queue.
+\param[in]
+  timer - address of timer that must be added to the queue. Its service
+  sysTimeLabel and interval must be set.
+******************************************************************************/
+void halAddTimer(HalTimerQueue_t *queue, Timer_t *timer);
+
+/**************************************************************************//**
+\brief Adds event timer to the timers queue. An event timer has no mode and
+  callback fields, its expiration is reported by halGetExpiredTimer().
+\param[in]
+  queue - timers queue.
+\param[in]
+  timer - address of timer that must be added to the queue. Its service
+  sysTimeLabel and interval must be set.
+******************************************************************************/
+void halAddEventTimer(HalTimerQueue_t *queue, Timer_t *timer);
+
+/**************************************************************************//**
+\brief Removes timer from the timers queue. Complexity is O(log n) for a timer
+  in the heap.
+\param[in]
+  queue - timers queue.
+\param[in]
+  timer - address of timer that must be removed from the queue.
+
+\return true if the timer was in the queue.
+******************************************************************************/
+bool halRemoveTimer(HalTimerQueue_t *queue, Timer_t *timer);
+
+/**************************************************************************//**
+\brief Removes the earliest expired timer from the queue. Complexity is
+  O(log n).
+\param[in]
+  queue - timers queue.
 \param[in]
-  head - address of pointer to head of the timers list.
+  sysTime - current time.
+\param[out]
+  eventTimer - set to true if the expired timer was added by halAddEventTimer().
+
+\return expired timer or NULL if there are no expired timers.
+******************************************************************************/
+Timer_t *halGetExpiredTimer(HalTimerQueue_t *queue, uint32_t sysTime, bool *eventTimer);
+
+/**************************************************************************//**
+\brief Gets time left to expiration of the earliest timer in the queue.
+  Complexity is O(1).
 \param[in]
-  timer - address of timer that must be added to the list.
+  queue - timers queue.
 \param[in]
-  sysTime - current time, used for sorting.
+  sysTime - current time.
+
+\return time left, 0 if a timer is expired, UINT32_MAX if queue is empty.
 ******************************************************************************/
-void halAddTimer(Timer_t **head, Timer_t *timer, uint32_t sysTime);
+uint32_t halGetTimeToNextTimer(const HalTimerQueue_t *queue, uint32_t sysTime);
 
 /**************************************************************************//**
-\brief Removes timer from the timers list.
+\brief Searches for a queued event timer. Complexity is O(n).
+\param[in]
+  queue - timers queue.
 \param[in]
-  head - address of pointer to head of the timers list.
+  match - returns true for the timer searched for, called for event timers only.
+\param[in]
+  context - passed to match.
+
+\return found timer or NULL.
+******************************************************************************/
+Timer_t *halFindEventTimer(const HalTimerQueue_t *queue,
+  bool (*match)(const Timer_t *timer, const void *context), const void *context);
+
+/**************************************************************************//**
+\brief Checks if the timer is in the timers queue. Complexity is O(1) for
+  a timer in the heap.
 \param[in]
-  prev - address of the timer before the timer that must be removed from the list.
+  queue - timers queue.
 \param[in]
-  p - address of timer that must be removed from the list.
+  timer - address of the timer. Its service next field may be not initialized.
 
-\return pointer to next cell or pointer to head if deleting is head
+\return true if the timer is in the queue.
 ******************************************************************************/
-Timer_t* halRemoveTimer(Timer_t **head, Timer_t *prev, Timer_t *p);
+bool halIsTimerInQueue(const HalTimerQueue_t *queue, const Timer_t *timer);
 
 /**************************************************************************//**
-\brief The search of the timer in the timers list before one.
+\brief Checks if the timer is in a timers queue.
 \param[in]
-  head - address of pointer to head of the timers list.
+  timer - address of the timer.
 
-\return pointer to saerching timer
+\return true if the timer is queued, false otherwise. Timers which were never
+  started must be zero initialized.
 ******************************************************************************/
-Timer_t *halFindPrevTimer(Timer_t **head,  Timer_t *p);
+INLINE bool halIsTimerQueued(const Timer_t *timer)
+{
+  return NULL != timer->service.next;
+}
 
 #endif /* _MNHALTIMER_H */
 
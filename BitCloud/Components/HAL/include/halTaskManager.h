@@ -83,7 +83,7 @@ typedef enum
 
 typedef volatile uint16_t HalTaskBitMask_t;
 
-#elif defined(AT32UC3A0512) || defined(WIN)
+#elif defined(AT32UC3A0512) || defined(WIN) || defined(LINUX)
 
 #define HAL_ALL_TASKS_ACCEPTED_MASK 0xFFU
 
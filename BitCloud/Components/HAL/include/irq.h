@@ -125,6 +125,17 @@ typedef enum
   IRQ_EIC_EXTINT13,
   IRQ_EIC_EXTINT14,
   IRQ_EIC_EXTINT15,
+#endif
+#if defined(LINUX)
+/** \brief lines backed by sysfs gpio or driven by halSetLoopbackIrqLine(). */
+  IRQ_0 = 0,
+  IRQ_1 = 1,
+  IRQ_2 = 2,
+  IRQ_3 = 3,
+  IRQ_4 = 4,
+  IRQ_5 = 5,
+  IRQ_6 = 6,
+  IRQ_7 = 7,
 #endif
   IRQ_LIMIT
 } HAL_IrqNumber_t;
@@ -154,6 +165,9 @@ typedef uint8_t HAL_IrqMode_t[32];
 #if defined(ATSAMD20J18) || defined(ATSAMD21J18A) || defined(ATSAMR21G18A) || defined(ATSAMR21E18A)
 typedef uint8_t HAL_IrqMode_t;
 #endif
+#if defined(LINUX)
+typedef uint8_t HAL_IrqMode_t;
+#endif
 /******************************************************************************
                    Prototypes section
 ******************************************************************************/
@@ -151,7 +151,7 @@
     /** \brief This bit is set if a system reset request has been performed. */
     WARM_RESET                = (1U << 6),
   } HAL_ResetReason_t;
-#elif defined(WIN)
+#elif defined(WIN) || defined(LINUX)
   typedef enum
   {
     /** \brief Fake reset reason */
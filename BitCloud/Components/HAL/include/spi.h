@@ -34,6 +34,8 @@
       defined(ATXMEGA256D3) || defined(ATMEGA2564RFR2) || defined(ATSAMR21G18A) || \
       defined(ATSAMR21E18A)
   #include <halSpi.h>
+#elif defined(LINUX)
+  #include <halSpi.h>
 #endif
 
 /******************************************************************************
@@ -129,6 +131,14 @@ typedef struct
     SPI_CLOCK_RATE_8000  (16, 32 MHz)         \n
     SPI_CLOCK_RATE_16000 (32 MHz) */
   SpiBaudRate_t  baudRate;
+#elif defined(LINUX)
+  /** \brief parameters are valid only for the Linux host: */
+  /** \brief spi data order (set by user). Must be chosen from: \n
+    SPI_DATA_MSB_FIRST \n
+    SPI_DATA_LSB_FIRST \n */
+  SpiDataOrder_t dataOrder;
+  /** \brief spi clock rate in Hz (set by user). */
+  uint32_t baudRate;
 #endif
   union
   {
@@ -218,5 +228,23 @@ int HAL_ReadSpi(HAL_SpiDescriptor_t *descriptor, uint8_t *buffer, uint16_t lengt
 #if defined(ATSAMR21G18A) || defined(ATSAMR21E18A)
 void BSP_BoardSpecificSpiPinInit(SpiChannel_t tty);
 #endif
+
+#if defined(LINUX)
+/**************************************************************************//**
+\brief Keeps the chip select of the master channel active between transfers.
+ Transfers made while the chip select is not active select the slave for
+ their duration only.
+
+\ingroup hal_spi
+
+\param[in]
+  descriptor - pointer to the spi descriptor.
+\param[in]
+  active - true to select the slave, false to release it.
+\return
+  Returns 0 on success or -1 if channel was not opened.
+******************************************************************************/
+int HAL_SelectSpi(HAL_SpiDescriptor_t *descriptor, bool active);
+#endif
 #endif /* _SPI_H */
 // eof spi.h
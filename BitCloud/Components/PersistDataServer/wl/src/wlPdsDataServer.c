@@ -30,6 +30,7 @@
 #include <N_ErrH.h>
 #include <D_Nv_Init.h>
 #include <sysEvents.h>
+#include <sysUtils.h>
 #include <wlPdsTypes.h>
 
 /******************************************************************************
@@ -38,6 +39,24 @@
 #define EVENT_TO_MEM_ID_MAPPING(event, id)  {.eventId = event, .itemId = id}
 #define COMPID "wlPdsDataServer"
 
+/* Items are compared with the last stored content in chunks of this size,
+   only the range of changed chunks is written */
+#ifndef PDS_STORE_CHUNK_SIZE
+  #define PDS_STORE_CHUNK_SIZE              64U
+#endif
+
+/* Total amount of chunk digests shared by all items. Items not fitting into
+   the pool are written entirely on each store */
+#ifndef PDS_STORE_DIGESTS_AMOUNT
+  #define PDS_STORE_DIGESTS_AMOUNT          64U
+#endif
+
+#define PDS_NO_DIGESTS                      0xFFU
+
+#if PDS_STORE_DIGESTS_AMOUNT >= PDS_NO_DIGESTS
+  #error PDS_STORE_DIGESTS_AMOUNT must be less than 255
+#endif
+
 /******************************************************************************
                             Types section
 ******************************************************************************/
@@ -49,11 +68,20 @@ typedef struct _EventToMemoryIdMapping_t
 
 typedef uint8_t PDS_MemMask_t[PDS_ITEM_MASK_SIZE];
 
+/* Part of the digests pool assigned to an item */
+typedef struct _PdsItemDigests_t
+{
+  uint8_t first;   // index of the first digest, PDS_NO_DIGESTS if not assigned
+  uint8_t amount;  // amount of chunks
+} PdsItemDigests_t;
+
 /******************************************************************************
                     Prototypes section
 ******************************************************************************/
 static void pdsObserver(SYS_EventId_t eventId, SYS_EventData_t data);
 static void pdsStoreItem(S_Nv_ItemId_t id);
+static void pdsWriteChangedChunks(S_Nv_ItemId_t id, uint16_t itemSize, uint8_t *itemData);
+static void pdsInvalidateDigests(S_Nv_ItemId_t id);
 static bool pdsRestoreItem(S_Nv_ItemId_t id);
 static bool pdsInitItemMask(S_Nv_ItemId_t memoryId, uint8_t *itemMask);
 
@@ -121,6 +149,13 @@ static EventToMemoryIdMapping_t PROGMEM_DECLARE(pdsMemoryMap[]) =
 
 static uint8_t itemsToStore[PDS_ITEM_MASK_SIZE];
 
+/* Digests of the item chunks written last time */
+static uint32_t pdsChunkDigests[PDS_STORE_DIGESTS_AMOUNT];
+static uint8_t pdsChunkDigestsUsed;
+static PdsItemDigests_t pdsItemDigests[PDS_ITEM_MASK_SIZE * 8U];
+/* Items with digests matching the content of non-volatile storage */
+static uint8_t pdsValidDigests[PDS_ITEM_MASK_SIZE];
+
 /******************************************************************************
                    Implementation section
 ******************************************************************************/
@@ -172,7 +207,10 @@ PDS_DataServerState_t PDS_Delete(PDS_MemId_t memoryId)
   for (i = 0U; i < PDS_ITEM_MASK_SIZE; i++)
     for (j = 0U; j < 8U; j++)
       if (itemsToDelete[i] & (1U << j))
+      {
+        pdsInvalidateDigests(((S_Nv_ItemId_t)i << 3U) + j);
         S_Nv_Delete(((S_Nv_ItemId_t)i << 3U) + j);
+      }
 
   return PDS_SUCCESS;
 }
@@ -211,6 +249,7 @@ bool PDS_Store(PDS_MemId_t memoryId)
 ******************************************************************************/
 PDS_DataServerState_t PDS_DeleteAll(bool includingPersistentItems)
 {
+  memset(pdsValidDigests, 0U, sizeof(pdsValidDigests));
   S_Nv_EraseAll(includingPersistentItems);
   return PDS_SUCCESS;
 }
@@ -381,13 +420,121 @@ static void pdsStoreItem(S_Nv_ItemId_t id)
       pdsStoreSecuredItem(id, itemDescr.itemSize, itemDescr.itemData);
     else
 #endif
+      pdsWriteChangedChunks(id, itemDescr.itemSize, itemDescr.itemData);
+  }
+}
+
+/******************************************************************************
+\brief Calculates digest of the item chunk: CRC-16-CCITT and Fletcher-16
+       checksum, so a change is missed with probability about 2^-32
+
+\param[in] data - chunk data
+\param[in] size - chunk size
+
+\return digest of the chunk
+******************************************************************************/
+static uint32_t pdsChunkDigest(const uint8_t *data, uint16_t size)
+{
+  uint16_t crc = 0xFFFFU;
+  uint16_t sum1 = 0U, sum2 = 0U;
+
+  for (uint16_t i = 0U; i < size; i++)
+  {
+    crc = SYS_Crc16Ccitt(crc, data[i]);
+    sum1 = (sum1 + data[i]) % 255U;
+    sum2 = (sum2 + sum1) % 255U;
+  }
+
+  return ((uint32_t)crc << 16U) | (uint16_t)(sum2 << 8U) | sum1;
+}
+
+/******************************************************************************
+\brief Gets digests of the item chunks, assigns them from the pool on the
+       first call
+
+\param[in] id - item id
+\param[in] itemSize - item size
+
+\return digests of the item or NULL if the pool is exhausted
+******************************************************************************/
+static PdsItemDigests_t *pdsGetItemDigests(S_Nv_ItemId_t id, uint16_t itemSize)
+{
+  PdsItemDigests_t *digests = &pdsItemDigests[id];
+  uint16_t amount = (itemSize + PDS_STORE_CHUNK_SIZE - 1U) / PDS_STORE_CHUNK_SIZE;
+
+  if (0U == digests->amount)
+  {
+    digests->amount = (uint8_t)amount;
+    digests->first = PDS_NO_DIGESTS;
+
+    if (amount <= PDS_STORE_DIGESTS_AMOUNT - pdsChunkDigestsUsed)
     {
-      S_Nv_ReturnValue_t ret;
+      digests->first = pdsChunkDigestsUsed;
+      pdsChunkDigestsUsed += amount;
+    }
+  }
+
+  if (PDS_NO_DIGESTS == digests->first || amount != digests->amount)
+    return NULL;
+
+  return digests;
+}
+
+/******************************************************************************
+\brief Writes the range of item chunks changed since the last store. Nothing
+       is written if the item has not changed.
+
+\param[in] id - item id
+\param[in] itemSize - item size
+\param[in] itemData - item data
+******************************************************************************/
+static void pdsWriteChangedChunks(S_Nv_ItemId_t id, uint16_t itemSize, uint8_t *itemData)
+{
+  PdsItemDigests_t *digests = pdsGetItemDigests(id, itemSize);
+  bool valid = pdsValidDigests[id / 8U] & (1U << (id % 8U));
+  uint16_t first = 0U, end = itemSize;
+  S_Nv_ReturnValue_t ret;
+
+  if (digests)
+  {
+    uint32_t *chunkDigest = &pdsChunkDigests[digests->first];
+
+    // find the range of changed chunks
+    first = itemSize;
+    end = 0U;
+    for (uint16_t offset = 0U; offset < itemSize; offset += PDS_STORE_CHUNK_SIZE, chunkDigest++)
+    {
+      uint16_t size = MIN(PDS_STORE_CHUNK_SIZE, (uint16_t)(itemSize - offset));
+      uint32_t digest = pdsChunkDigest(itemData + offset, size);
 
-      ret = S_Nv_Write(id, 0U, itemDescr.itemSize, itemDescr.itemData);
-      N_ERRH_ASSERT_FATAL(ret == S_Nv_ReturnValue_Ok);
+      if (!valid || digest != *chunkDigest)
+      {
+        *chunkDigest = digest;
+        if (first > offset)
+          first = offset;
+        end = offset + size;
+      }
     }
+
+    if (first >= end)
+      return;
   }
+
+  ret = S_Nv_Write(id, first, end - first, itemData + first);
+  N_ERRH_ASSERT_FATAL(ret == S_Nv_ReturnValue_Ok);
+
+  if (digests)
+    pdsValidDigests[id / 8U] |= 1U << (id % 8U);
+}
+
+/******************************************************************************
+\brief Marks digests of the item as not matching the non-volatile storage
+
+\param[in] id - item id
+******************************************************************************/
+static void pdsInvalidateDigests(S_Nv_ItemId_t id)
+{
+  pdsValidDigests[id / 8U] &= ~(1U << (id % 8U));
 }
 
 /******************************************************************************
@@ -409,6 +556,9 @@ static bool pdsRestoreItem(S_Nv_ItemId_t id)
     if (itemDescr.filler)
       itemDescr.filler();
 
+    // restored data may be converted, the next store writes the whole item
+    pdsInvalidateDigests(id);
+
 #ifdef PDS_SECURITY_CONTROL_ENABLE
     if (pdsIsItemUnderSecurityControl(id))
     {
@@ -15,6 +15,7 @@
       2006 - MCherkashin created.
       2006 - VGrybanovsky optimized.
       207.11.29 ALuzhetsky API corrected.
+      2026-10-17 Precomputed S-box, T-table rounds and key schedule cache.
 ******************************************************************************/
 
 /******************************************************************************
@@ -33,29 +34,141 @@
                                 Definitions section.
 ******************************************************************************/
 #define S_BOX_SIZE 256
+// Number of Rounds Nr = 10 (for Nk words = 4 and Nb words = 4).
+#define AES_ROUNDS 10
+#define AES_ROUND_KEY_WORDS (AES_TEMP_BUF_SIZE / sizeof(uint32_t))
+
+/* Number of expanded key schedules kept between requests, about 200 bytes
+   of RAM each. A CCM* frame uses the same key for all its blocks, so one
+   entry is enough. More entries help when frames secured with different
+   keys, e.g. with the network and the link keys, are interleaved. */
+#ifndef SSP_AES_KEY_CACHE_SIZE
+  #define SSP_AES_KEY_CACHE_SIZE 1
+#endif
+
+/* Rounds are computed with a 1 KB table of 32-bit words combining SubBytes
+   and MixColumns. Byte oriented rounds with 256 bytes of the S-box only are
+   used for builds keeping constant data in program memory (8-bit targets). */
+#ifndef SSP_AES_T_TABLE
+  #ifdef _SSP_USE_FLASH_FOR_CONST_DATA
+    #define SSP_AES_T_TABLE 0
+  #else
+    #define SSP_AES_T_TABLE 1
+  #endif
+#endif
+
+#if SSP_AES_KEY_CACHE_SIZE < 1
+  #error At least one key schedule has to be cached
+#endif
+
+#define AES_ROTR8(w) (((w) >> 8) | ((w) << 24))
+#define AES_XTIME(b) ((uint8_t)(((b) << 1) ^ (((b) & 0x80) ? 0x1b : 0x00)))
 
+/******************************************************************************
+                                Types section.
+******************************************************************************/
+typedef union
+{
+  uint8_t  bytes[AES_TEMP_BUF_SIZE];
+  // Round key columns, the first byte of a column is the most significant one.
+  uint32_t words[AES_ROUND_KEY_WORDS];
+} AesRoundKeys_t;
+
+typedef struct
+{
+  uint8_t key[SECURITY_KEY_SIZE];
+  // Number of lookups of other keys since the last use, 0 - not in use.
+  uint8_t age;
+  AesRoundKeys_t roundKeys;
+} AesKeyCacheEntry_t;
+
+/******************************************************************************
+                                Constants section.
+******************************************************************************/
 #ifdef _SSP_USE_FLASH_FOR_CONST_DATA
-  PROGMEM_DECLARE(uint8_t btable[S_BOX_SIZE]) = {
+  PROGMEM_DECLARE(uint8_t aesSboxTable[S_BOX_SIZE]) = {
 #else //_SSP_USE_FLASH_FOR_CONST_DATA
-  const uint8_t btable[S_BOX_SIZE] = {
+  static const uint8_t aesSboxTable[S_BOX_SIZE] = {
 #endif //_SSP_USE_FLASH_FOR_CONST_DATA
-                        0,   1, 141, 246, 203,  82, 123, 209, 232,  79,  41, 192, 176, 225, 229, 199,
-                      116, 180, 170,  75, 153,  43,  96,  95,  88,  63, 253, 204, 255,  64, 238, 178,
-                       58, 110,  90, 241,  85,  77, 168, 201, 193,  10, 152,  21,  48,  68, 162, 194,
-                       44,  69, 146, 108, 243,  57, 102,  66, 242,  53,  32, 111, 119, 187,  89,  25,
-                       29, 254,  55, 103,  45,  49, 245, 105, 167, 100, 171,  19,  84,  37, 233,   9,
-                      237,  92,   5, 202,  76,  36, 135, 191,  24,  62,  34, 240,  81, 236,  97,  23,
-                       22,  94, 175, 211,  73, 166,  54,  67, 244,  71, 145, 223,  51, 147,  33,  59,
-                      121, 183, 151, 133,  16, 181, 186,  60, 182, 112, 208,   6, 161, 250, 129, 130,
-                      131, 126, 127, 128, 150, 115, 190,  86, 155, 158, 149, 217, 247,   2, 185, 164,
-                      222, 106,  50, 109, 216, 138, 132, 114,  42,  20, 159, 136, 249, 220, 137, 154,
-                      251, 124,  46, 195, 143, 184, 101,  72,  38, 200,  18,  74, 206, 231, 210,  98,
-                       12, 224,  31, 239,  17, 117, 120, 113, 165, 142, 118,  61, 189, 188, 134,  87,
-                       11,  40,  47, 163, 218, 212, 228,  15, 169,  39,  83,   4,  27, 252, 172, 230,
-                      122,   7, 174,  99, 197, 219, 226, 234, 148, 139, 196, 213, 157, 248, 144, 107,
-                      177,  13, 214, 235, 198,  14, 207, 173,   8,  78, 215, 227,  93,  80,  30, 179,
-                       91,  35,  56,  52, 104,  70,   3, 140, 221, 156, 125, 160, 205,  26,  65,  28
-                      };
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+#if SSP_AES_T_TABLE
+/* Column of MixColumns applied to the S-box output: {02}s, s, s, {03}s.
+   Tables for other rows are obtained by rotation. */
+#ifdef _SSP_USE_FLASH_FOR_CONST_DATA
+  PROGMEM_DECLARE(uint32_t aesTeTable[S_BOX_SIZE]) = {
+#else //_SSP_USE_FLASH_FOR_CONST_DATA
+  static const uint32_t aesTeTable[S_BOX_SIZE] = {
+#endif //_SSP_USE_FLASH_FOR_CONST_DATA
+  0xc66363a5u, 0xf87c7c84u, 0xee777799u, 0xf67b7b8du, 0xfff2f20du, 0xd66b6bbdu,
+  0xde6f6fb1u, 0x91c5c554u, 0x60303050u, 0x02010103u, 0xce6767a9u, 0x562b2b7du,
+  0xe7fefe19u, 0xb5d7d762u, 0x4dababe6u, 0xec76769au, 0x8fcaca45u, 0x1f82829du,
+  0x89c9c940u, 0xfa7d7d87u, 0xeffafa15u, 0xb25959ebu, 0x8e4747c9u, 0xfbf0f00bu,
+  0x41adadecu, 0xb3d4d467u, 0x5fa2a2fdu, 0x45afafeau, 0x239c9cbfu, 0x53a4a4f7u,
+  0xe4727296u, 0x9bc0c05bu, 0x75b7b7c2u, 0xe1fdfd1cu, 0x3d9393aeu, 0x4c26266au,
+  0x6c36365au, 0x7e3f3f41u, 0xf5f7f702u, 0x83cccc4fu, 0x6834345cu, 0x51a5a5f4u,
+  0xd1e5e534u, 0xf9f1f108u, 0xe2717193u, 0xabd8d873u, 0x62313153u, 0x2a15153fu,
+  0x0804040cu, 0x95c7c752u, 0x46232365u, 0x9dc3c35eu, 0x30181828u, 0x379696a1u,
+  0x0a05050fu, 0x2f9a9ab5u, 0x0e070709u, 0x24121236u, 0x1b80809bu, 0xdfe2e23du,
+  0xcdebeb26u, 0x4e272769u, 0x7fb2b2cdu, 0xea75759fu, 0x1209091bu, 0x1d83839eu,
+  0x582c2c74u, 0x341a1a2eu, 0x361b1b2du, 0xdc6e6eb2u, 0xb45a5aeeu, 0x5ba0a0fbu,
+  0xa45252f6u, 0x763b3b4du, 0xb7d6d661u, 0x7db3b3ceu, 0x5229297bu, 0xdde3e33eu,
+  0x5e2f2f71u, 0x13848497u, 0xa65353f5u, 0xb9d1d168u, 0x00000000u, 0xc1eded2cu,
+  0x40202060u, 0xe3fcfc1fu, 0x79b1b1c8u, 0xb65b5bedu, 0xd46a6abeu, 0x8dcbcb46u,
+  0x67bebed9u, 0x7239394bu, 0x944a4adeu, 0x984c4cd4u, 0xb05858e8u, 0x85cfcf4au,
+  0xbbd0d06bu, 0xc5efef2au, 0x4faaaae5u, 0xedfbfb16u, 0x864343c5u, 0x9a4d4dd7u,
+  0x66333355u, 0x11858594u, 0x8a4545cfu, 0xe9f9f910u, 0x04020206u, 0xfe7f7f81u,
+  0xa05050f0u, 0x783c3c44u, 0x259f9fbau, 0x4ba8a8e3u, 0xa25151f3u, 0x5da3a3feu,
+  0x804040c0u, 0x058f8f8au, 0x3f9292adu, 0x219d9dbcu, 0x70383848u, 0xf1f5f504u,
+  0x63bcbcdfu, 0x77b6b6c1u, 0xafdada75u, 0x42212163u, 0x20101030u, 0xe5ffff1au,
+  0xfdf3f30eu, 0xbfd2d26du, 0x81cdcd4cu, 0x180c0c14u, 0x26131335u, 0xc3ecec2fu,
+  0xbe5f5fe1u, 0x359797a2u, 0x884444ccu, 0x2e171739u, 0x93c4c457u, 0x55a7a7f2u,
+  0xfc7e7e82u, 0x7a3d3d47u, 0xc86464acu, 0xba5d5de7u, 0x3219192bu, 0xe6737395u,
+  0xc06060a0u, 0x19818198u, 0x9e4f4fd1u, 0xa3dcdc7fu, 0x44222266u, 0x542a2a7eu,
+  0x3b9090abu, 0x0b888883u, 0x8c4646cau, 0xc7eeee29u, 0x6bb8b8d3u, 0x2814143cu,
+  0xa7dede79u, 0xbc5e5ee2u, 0x160b0b1du, 0xaddbdb76u, 0xdbe0e03bu, 0x64323256u,
+  0x743a3a4eu, 0x140a0a1eu, 0x924949dbu, 0x0c06060au, 0x4824246cu, 0xb85c5ce4u,
+  0x9fc2c25du, 0xbdd3d36eu, 0x43acacefu, 0xc46262a6u, 0x399191a8u, 0x319595a4u,
+  0xd3e4e437u, 0xf279798bu, 0xd5e7e732u, 0x8bc8c843u, 0x6e373759u, 0xda6d6db7u,
+  0x018d8d8cu, 0xb1d5d564u, 0x9c4e4ed2u, 0x49a9a9e0u, 0xd86c6cb4u, 0xac5656fau,
+  0xf3f4f407u, 0xcfeaea25u, 0xca6565afu, 0xf47a7a8eu, 0x47aeaee9u, 0x10080818u,
+  0x6fbabad5u, 0xf0787888u, 0x4a25256fu, 0x5c2e2e72u, 0x381c1c24u, 0x57a6a6f1u,
+  0x73b4b4c7u, 0x97c6c651u, 0xcbe8e823u, 0xa1dddd7cu, 0xe874749cu, 0x3e1f1f21u,
+  0x964b4bddu, 0x61bdbddcu, 0x0d8b8b86u, 0x0f8a8a85u, 0xe0707090u, 0x7c3e3e42u,
+  0x71b5b5c4u, 0xcc6666aau, 0x904848d8u, 0x06030305u, 0xf7f6f601u, 0x1c0e0e12u,
+  0xc26161a3u, 0x6a35355fu, 0xae5757f9u, 0x69b9b9d0u, 0x17868691u, 0x99c1c158u,
+  0x3a1d1d27u, 0x279e9eb9u, 0xd9e1e138u, 0xebf8f813u, 0x2b9898b3u, 0x22111133u,
+  0xd26969bbu, 0xa9d9d970u, 0x078e8e89u, 0x339494a7u, 0x2d9b9bb6u, 0x3c1e1e22u,
+  0x15878792u, 0xc9e9e920u, 0x87cece49u, 0xaa5555ffu, 0x50282878u, 0xa5dfdf7au,
+  0x038c8c8fu, 0x59a1a1f8u, 0x09898980u, 0x1a0d0d17u, 0x65bfbfdau, 0xd7e6e631u,
+  0x844242c6u, 0xd06868b8u, 0x824141c3u, 0x299999b0u, 0x5a2d2d77u, 0x1e0f0f11u,
+  0x7bb0b0cbu, 0xa85454fcu, 0x6dbbbbd6u, 0x2c16163au
+};
+#endif // SSP_AES_T_TABLE
+
+// Round constants of the key expansion.
+static const uint8_t aesRcon[AES_ROUNDS] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+/******************************************************************************
+                                Static variables section.
+******************************************************************************/
+static AesKeyCacheEntry_t aesKeyCache[SSP_AES_KEY_CACHE_SIZE];
 
 /******************************************************************************
                             Global functions declaration section.
@@ -65,12 +178,8 @@ void sspAesReqHandler(void);
 /******************************************************************************
                             Static functions declaration section.
 ******************************************************************************/
+static const AesRoundKeys_t *aesGetRoundKeys(const uint8_t *key);
 static void aesExpandKey(uint8_t *in/*[AES_TEMP_BUF_SIZE]*/);
-static void aesAddRoundKey(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/, uint8_t *key/*[SECURITY_KEY_SIZE]*/);
-static void aesSubBytes(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/);
-static void aesShiftRows(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/);
-static void aesMixColumns(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/);
-static void aesMixColumn(uint8_t *state/*[4]*/);
 void sspAesEncrypt(SspAesEncryptReq_t *reqParam);
 
 /******************************************************************************
@@ -104,212 +213,334 @@ void sspAesReqHandler(void)
 #endif  //defined(_SSP_SW_AES_)
 
 /**************************************************************************//**
-  \brief
-  \param
-  \return
+  \brief Looks up the S-box.
+
+  \param in - byte to be substituted
+  \return substituted byte
 ******************************************************************************/
-//void aesEncrypt(uint8_t key[ /*SECURITY_KEY_SIZE*/ ], uint8_t buf[ /*AES_TEXT_SIZE*/ ], uint8_t temp[ /*AES_TEMP_BUF_SIZE*/ ])
-void sspAesEncrypt(SspAesEncryptReq_t *reqParam)
+INLINE uint8_t aesSbox(uint8_t in)
 {
-  uint8_t round = 0;
+#ifdef _SSP_USE_FLASH_FOR_CONST_DATA
+  uint8_t out;
 
-  memcpy(reqParam->temp, reqParam->key, SECURITY_KEY_SIZE);
-  aesExpandKey(reqParam->temp);
-  // Number of Rounds Nr = 10 (for Nk words = 4 and Nb words = 4).
-  for (round = 0; round < 9; round++)
-  {
-    aesAddRoundKey(reqParam->text, (uint8_t *)reqParam->temp + 16 * round);
-    aesSubBytes(reqParam->text);
-    aesShiftRows(reqParam->text);
-    aesMixColumns(reqParam->text);
-  }
-  aesAddRoundKey(reqParam->text, (uint8_t *)reqParam->temp + 144);
-  aesSubBytes(reqParam->text);
-  aesShiftRows(reqParam->text);
-  aesAddRoundKey(reqParam->text, (uint8_t *)reqParam->temp + 160);
+  memcpy_P(&out, &aesSboxTable[in], sizeof(uint8_t));
+  return out;
+#else //_SSP_USE_FLASH_FOR_CONST_DATA
+  return aesSboxTable[in];
+#endif //_SSP_USE_FLASH_FOR_CONST_DATA
 }
 
 /**************************************************************************//**
   \brief Calculate the s-box for a given number
 
-  \param TBD
-  \return TBD
+  \param in - byte to be substituted
+  \return substituted byte
 ******************************************************************************/
 uint8_t sbox(uint8_t in)
 {
-  uint8_t c;
-  uint8_t s;
-  uint8_t x;
+  return aesSbox(in);
+}
 
+#if SSP_AES_T_TABLE
+/**************************************************************************//**
+  \brief Looks up the combined SubBytes and MixColumns table.
+
+  \param in - state byte
+  \return column contribution of the byte in the first row
+******************************************************************************/
+INLINE uint32_t aesTe(uint8_t in)
+{
 #ifdef _SSP_USE_FLASH_FOR_CONST_DATA
-  memcpy_P(&x, &btable[in], sizeof(uint8_t));
-  s = x;
+  uint32_t out;
+
+  memcpy_P(&out, &aesTeTable[in], sizeof(uint32_t));
+  return out;
 #else //_SSP_USE_FLASH_FOR_CONST_DATA
-  s = x = btable[in];
+  return aesTeTable[in];
 #endif //_SSP_USE_FLASH_FOR_CONST_DATA
-  for (c = 0; c < 4; c++)
-  {
-    /* One bit circular rotate to the left */
-    s = (s << 1) | (s >> 7);
-    /* xor with x */
-    x ^= s;
-  }
-  x ^= 99; /* 0x63 */
-  return x;
 }
 
 /**************************************************************************//**
-  \brief Expanding 128-bit key.
+  \brief Loads the state column, the first byte is the most significant one.
 
-  \param TBD
-  \return TBD
+  \param in - column bytes
+  \return column
 ******************************************************************************/
-static void aesExpandKey(uint8_t *in/*[AES_TEMP_BUF_SIZE]*/)
+INLINE uint32_t aesLoadColumn(const uint8_t *in)
 {
-  uint8_t t[4];
-  uint8_t c = 16; // c is 16 because the first sub-key is the user-supplied key
-  uint8_t i = 1;
-  uint8_t a;
+  return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+/**************************************************************************//**
+  \brief Stores the state column.
+
+  \param out - column bytes
+  \param column - column
+******************************************************************************/
+INLINE void aesStoreColumn(uint8_t *out, uint32_t column)
+{
+  out[0] = (uint8_t)(column >> 24);
+  out[1] = (uint8_t)(column >> 16);
+  out[2] = (uint8_t)(column >> 8);
+  out[3] = (uint8_t)column;
+}
 
-  /* We need 11 sets of sixteen bytes each for 128-bit mode */
-  while(c < AES_TEMP_BUF_SIZE)
+/**************************************************************************//**
+  \brief Computes a column of the SubBytes, ShiftRows and MixColumns output.
+   Row r of the column is taken from the state column (c + r) mod 4.
+
+  \return column without the round key
+******************************************************************************/
+INLINE uint32_t aesRoundColumn(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+  uint32_t t;
+
+  t = aesTe((uint8_t)d);
+  t = AES_ROTR8(t) ^ aesTe((uint8_t)(c >> 8));
+  t = AES_ROTR8(t) ^ aesTe((uint8_t)(b >> 16));
+  return AES_ROTR8(t) ^ aesTe((uint8_t)(a >> 24));
+}
+
+/**************************************************************************//**
+  \brief Computes a column of the final round (SubBytes and ShiftRows).
+
+  \return column without the round key
+******************************************************************************/
+INLINE uint32_t aesFinalColumn(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+  return ((uint32_t)aesSbox((uint8_t)(a >> 24)) << 24) |
+         ((uint32_t)aesSbox((uint8_t)(b >> 16)) << 16) |
+         ((uint32_t)aesSbox((uint8_t)(c >> 8)) << 8) |
+         aesSbox((uint8_t)d);
+}
+
+/**************************************************************************//**
+  \brief Encrypts the block in place.
+
+  \param text - block to be encrypted
+  \param roundKeys - expanded key
+******************************************************************************/
+static void aesEncryptBlock(uint8_t *text/*[SECURITY_BLOCK_SIZE]*/, const AesRoundKeys_t *roundKeys)
+{
+  const uint32_t *rk = roundKeys->words;
+  uint32_t s0 = aesLoadColumn(text) ^ rk[0];
+  uint32_t s1 = aesLoadColumn(text + 4) ^ rk[1];
+  uint32_t s2 = aesLoadColumn(text + 8) ^ rk[2];
+  uint32_t s3 = aesLoadColumn(text + 12) ^ rk[3];
+  uint32_t t0, t1, t2, t3;
+  uint8_t round;
+
+  for (round = 1; round < AES_ROUNDS; round++)
   {
-    /* Copy the temporary variable over from the last 4-byte
-     * block */
-    for (a = 0; a < 4; a++)
-            t[a] = in[a + c - 4];
-    /* Every four blocks (of four bytes),
-     * do a complex calculation */
-    if(c % 16 == 0)
-    {
-      a = t[0];
-      t[0] = t[1];
-      t[1] = t[2];
-      t[2] = t[3];
-      t[3] = a;
-      for (a = 0; a < 4; a++)
-        t[a] = sbox(t[a]);
-      if (i != 0)
-      {
-        uint8_t cc = 1;
-        uint8_t j = i;
-
-        while(j != 1)
-        {
-          uint8_t bb;
-
-          bb = cc & 0x80;
-          cc <<= 1;
-          if ( bb == 0x80 )
-            cc ^= 0x1b;
-          j--;
-        }
-        t[0] ^= cc;
-      }
-      i++;
-    }
-    for (a = 0; a < 4; a++)
-    {
-      in[c] = in[c - 16] ^ t[a];
-      c++;
-    }
+    rk += 4;
+    t0 = aesRoundColumn(s0, s1, s2, s3) ^ rk[0];
+    t1 = aesRoundColumn(s1, s2, s3, s0) ^ rk[1];
+    t2 = aesRoundColumn(s2, s3, s0, s1) ^ rk[2];
+    t3 = aesRoundColumn(s3, s0, s1, s2) ^ rk[3];
+    s0 = t0; s1 = t1; s2 = t2; s3 = t3;
   }
+  rk += 4;
+  aesStoreColumn(text, aesFinalColumn(s0, s1, s2, s3) ^ rk[0]);
+  aesStoreColumn(text + 4, aesFinalColumn(s1, s2, s3, s0) ^ rk[1]);
+  aesStoreColumn(text + 8, aesFinalColumn(s2, s3, s0, s1) ^ rk[2]);
+  aesStoreColumn(text + 12, aesFinalColumn(s3, s0, s1, s2) ^ rk[3]);
+}
+
+#else // SSP_AES_T_TABLE
+
+/**************************************************************************//**
+  \brief Applies SubBytes and ShiftRows to the state. The state is stored
+   column by column.
+
+  \param state - current state
+******************************************************************************/
+static void aesSubBytesShiftRows(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/)
+{
+  uint8_t t;
+
+  // Row 0 is not shifted.
+  state[0] = aesSbox(state[0]);
+  state[4] = aesSbox(state[4]);
+  state[8] = aesSbox(state[8]);
+  state[12] = aesSbox(state[12]);
+  // Row 1 is shifted by one column.
+  t = state[1];
+  state[1] = aesSbox(state[5]);
+  state[5] = aesSbox(state[9]);
+  state[9] = aesSbox(state[13]);
+  state[13] = aesSbox(t);
+  // Row 2 is shifted by two columns.
+  t = state[2];
+  state[2] = aesSbox(state[10]);
+  state[10] = aesSbox(t);
+  t = state[6];
+  state[6] = aesSbox(state[14]);
+  state[14] = aesSbox(t);
+  // Row 3 is shifted by three columns.
+  t = state[15];
+  state[15] = aesSbox(state[11]);
+  state[11] = aesSbox(state[7]);
+  state[7] = aesSbox(state[3]);
+  state[3] = aesSbox(t);
 }
 
 /**************************************************************************//**
-  \brief TBD.
+  \brief Adds the round key to the state.
 
-  \param TBD
-  \return TBD
+  \param state - current state
+  \param key - round key
 ******************************************************************************/
-static void aesAddRoundKey(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/, uint8_t *key/*[SECURITY_KEY_SIZE]*/)
+static void aesAddRoundKey(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/, const uint8_t *key/*[SECURITY_KEY_SIZE]*/)
 {
   uint8_t l;
 
-  for (l = 0; l < 16; l++)
+  for (l = 0; l < SECURITY_BLOCK_SIZE; l++)
     state[l] ^= key[l];
 }
 
 /**************************************************************************//**
-  \brief TBD.
+  \brief Applies MixColumns to the state.
 
-  \param TBD
-  \return TBD
+  \param state - current state
 ******************************************************************************/
-static void aesSubBytes(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/)
+static void aesMixColumns(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/)
 {
   uint8_t l;
 
-  for (l = 0; l < 16; l++)
-    state[l] = sbox(state[l]);
+  for (l = 0; l < SECURITY_BLOCK_SIZE; l += 4)
+  {
+    uint8_t a0 = state[l];
+    uint8_t a1 = state[l + 1];
+    uint8_t a2 = state[l + 2];
+    uint8_t a3 = state[l + 3];
+    uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+
+    state[l] ^= all ^ AES_XTIME(a0 ^ a1);
+    state[l + 1] ^= all ^ AES_XTIME(a1 ^ a2);
+    state[l + 2] ^= all ^ AES_XTIME(a2 ^ a3);
+    state[l + 3] ^= all ^ AES_XTIME(a3 ^ a0);
+  }
 }
 
-
 /**************************************************************************//**
-  \brief TBD.
+  \brief Encrypts the block in place.
 
-  \param TBD
-  \return TBD
+  \param text - block to be encrypted
+  \param roundKeys - expanded key
 ******************************************************************************/
-static void aesShiftRows(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/)
+static void aesEncryptBlock(uint8_t *text/*[SECURITY_BLOCK_SIZE]*/, const AesRoundKeys_t *roundKeys)
 {
-  uint8_t l;
-  uint8_t m;
-  uint8_t s;
+  const uint8_t *rk = roundKeys->bytes;
+  uint8_t round;
 
-  for (l = 0; l < 4; l++)
+  aesAddRoundKey(text, rk);
+  for (round = 1; round < AES_ROUNDS; round++)
   {
-    for (s = 0; s < l; s++)
-    {
-      uint8_t a = state[l];
-
-      for (m = 0; m < 12; m += 4)
-        state[m + l] = state[m + l + 4];
-      state[12 + l] = a;
-    }
+    rk += SECURITY_KEY_SIZE;
+    aesSubBytesShiftRows(text);
+    aesMixColumns(text);
+    aesAddRoundKey(text, rk);
   }
+  aesSubBytesShiftRows(text);
+  aesAddRoundKey(text, rk + SECURITY_KEY_SIZE);
 }
+#endif // SSP_AES_T_TABLE
 
+/**************************************************************************//**
+  \brief AES function without callback. Key schedule is taken from the cache
+  of recently used keys, temp buffer of the request is not used.
+
+  \param reqParam - AES algorithm params.
+******************************************************************************/
+//void aesEncrypt(uint8_t key[ /*SECURITY_KEY_SIZE*/ ], uint8_t buf[ /*AES_TEXT_SIZE*/ ], uint8_t temp[ /*AES_TEMP_BUF_SIZE*/ ])
+void sspAesEncrypt(SspAesEncryptReq_t *reqParam)
+{
+  aesEncryptBlock(reqParam->text, aesGetRoundKeys(reqParam->key));
+}
 
 /**************************************************************************//**
-  \brief TBD.
+  \brief Finds the expanded key in the cache. Expands the key into the least
+  recently used entry if it is not found. Entries are matched by the key value,
+  so a key changed in place is never served with the schedule of the old one.
 
-  \param TBD
-  \return TBD
+  \param key - AES-128 key
+  \return expanded key
 ******************************************************************************/
-static void aesMixColumn(uint8_t *state/*[4]*/)
+static const AesRoundKeys_t *aesGetRoundKeys(const uint8_t *key/*[SECURITY_KEY_SIZE]*/)
 {
-  uint8_t a[4];
-  uint8_t b[4];
-  uint8_t c;
-  uint8_t h;
+  AesKeyCacheEntry_t *entry = NULL;
+  AesKeyCacheEntry_t *lru = aesKeyCache;
+  uint8_t i;
+
+  for (i = 0; i < SSP_AES_KEY_CACHE_SIZE; i++)
+  {
+    AesKeyCacheEntry_t *current = &aesKeyCache[i];
 
-  for (c = 0; c < 4; c++)
+    if (current->age && !memcmp(current->key, key, SECURITY_KEY_SIZE))
+      entry = current;
+    else
+    {
+      if (current->age < UINT8_MAX && current->age)
+        current->age++;
+      if (!current->age || (lru->age && current->age > lru->age))
+        lru = current;
+    }
+  }
+
+  if (!entry)
   {
-    a[c] = state[c];
-    h = state[c] & 0x80; /* hi bit */
-    b[c] = state[c] << 1;
-    if(h == 0x80)
-      b[c] ^= 0x1b; /* Rijndael's Galois field */
+    entry = lru;
+    // Evicted key material is cleared rather than partly overwritten
+    memset(entry, 0x00, sizeof(AesKeyCacheEntry_t));
+    memcpy(entry->key, key, SECURITY_KEY_SIZE);
+    memcpy(entry->roundKeys.bytes, key, SECURITY_KEY_SIZE);
+    aesExpandKey(entry->roundKeys.bytes);
+#if SSP_AES_T_TABLE
+    for (i = 0; i < AES_ROUND_KEY_WORDS; i++)
+      entry->roundKeys.words[i] = aesLoadColumn(&entry->roundKeys.bytes[i * sizeof(uint32_t)]);
+#endif // SSP_AES_T_TABLE
   }
-  state[0] = b[0] ^ a[3] ^ a[2] ^ b[1] ^ a[1];
-  state[1] = b[1] ^ a[0] ^ a[3] ^ b[2] ^ a[2];
-  state[2] = b[2] ^ a[1] ^ a[0] ^ b[3] ^ a[3];
-  state[3] = b[3] ^ a[2] ^ a[1] ^ b[0] ^ a[0];
+  entry->age = 1;
+  return &entry->roundKeys;
 }
 
 /**************************************************************************//**
-  \brief TBD.
+  \brief Clears all expanded keys, so key material isn't kept in RAM after
+   security is reset.
+******************************************************************************/
+void sspAesResetKeyCache(void)
+{
+  memset(aesKeyCache, 0x00, sizeof(aesKeyCache));
+}
 
-  \param TBD
-  \return TBD
+/**************************************************************************//**
+  \brief Expanding 128-bit key.
+
+  \param in - buffer with the key in the first SECURITY_KEY_SIZE bytes
 ******************************************************************************/
-static void aesMixColumns(uint8_t *state/*[SECURITY_BLOCK_SIZE]*/)
+static void aesExpandKey(uint8_t *in/*[AES_TEMP_BUF_SIZE]*/)
 {
-  uint8_t l;
+  uint8_t t[4];
+  uint8_t c;
+  uint8_t a;
+
+  // c starts at 16 because the first sub-key is the user-supplied key
+  for (c = SECURITY_KEY_SIZE; c < AES_TEMP_BUF_SIZE; c += 4)
+  {
+    if (0 == c % SECURITY_KEY_SIZE)
+    {
+      // RotWord, SubWord and the round constant
+      t[0] = aesSbox(in[c - 3]) ^ aesRcon[c / SECURITY_KEY_SIZE - 1];
+      t[1] = aesSbox(in[c - 2]);
+      t[2] = aesSbox(in[c - 1]);
+      t[3] = aesSbox(in[c - 4]);
+    }
+    else
+      memcpy(t, &in[c - 4], sizeof(t));
 
-  for (l = 0; l < 16; l += 4)
-    aesMixColumn((uint8_t *)state + l);
+    for (a = 0; a < 4; a++)
+      in[c + a] = in[c + a - SECURITY_KEY_SIZE] ^ t[a];
+  }
 }
 
 // eof sspAesHandler.c
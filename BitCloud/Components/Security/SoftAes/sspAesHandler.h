@@ -28,7 +28,7 @@
   #define AES_ENCRYPT_REQ   RF_EncryptReq
   #define AES_SET_KEY_REQ_T RF_EncryptReq_t
   #define AES_SET_KEY_REQ   RF_EncryptReq
-  #define AES_RESET  
+  #define AES_RESET         sspAesResetKeyCache()
 
 #elif defined(_HAL_HW_AES_)
   #include <halSecurityModule.h>
@@ -42,7 +42,7 @@
   #define AES_ENCRYPT_REQ_T SspAesEncryptReq_t
   #define AES_SET_KEY_REQ_T uint8_t
   #define AES_ENCRYPT_REQ   sspAesEncryptReq
-  #define AES_RESET
+  #define AES_RESET         sspAesResetKeyCache()
 #endif
 
 /******************************************************************************
@@ -70,6 +70,8 @@ typedef struct
 {
   uint8_t *key/*[SECURITY_KEY_SIZE]*/;
   uint8_t *text/*[SECURITY_BLOCK_SIZE]*/;
+  // Not used by the software AES: expanded keys are cached by sspAesHandler.c.
+  // Kept to preserve the request layout.
   uint8_t temp[AES_TEMP_BUF_SIZE];
   void (*sspAesEncryptConf)(void);//(SspAesEncryptConf_t *confirm);
 } SspAesEncryptReq_t;
@@ -113,6 +115,11 @@ void sspAesReqHandler(void);
 ******************************************************************************/
 void sspAesEncrypt(SspAesEncryptReq_t *reqParam);
 
+/**************************************************************************//**
+  \brief Clears the cache of expanded keys used by sspAesEncrypt().
+******************************************************************************/
+void sspAesResetKeyCache(void);
+
 #endif // _SSPAES_H
 
 //eof sspAesHandler.h
@@ -35,7 +35,8 @@ typedef enum
   SYSMUTEX_MUTEXUNLOCK1                      = 0x8009,
   SYSMUTEX_MUTEXUNLOCK2                      = 0x800A,
   SYSMUTEX_MUTEXUNLOCK3                      = 0x800B,
-  SYSMUTEX_ISMUTEXLOCKED0                    = 0x800C
+  SYSMUTEX_ISMUTEXLOCKED0                    = 0x800C,
+  SYS_TASKMANAGER_INVALIDPRIORITY            = 0x800D
 } SysAssertId_t;
 
 #endif /* _SYSDBG_H_ */
@@ -30,6 +30,14 @@ Any event ID must not be greater than this value.*/
 
 #define SYS_EVENTS_MASK_SIZE CEIL(SYS_MAX_EVENTS, sizeof(sysEvWord_t) * 8U)
 
+/*! The maximum number of subscriptions (pairs of a receiver and an event) kept
+in the per-event subscriber lists. An event whose subscription does not fit is
+delivered by checking all registered receivers until it loses all subscribers.
+May be redefined in the compiler options; must be less than 255.*/
+#ifndef SYS_MAX_EVENT_SUBSCRIPTIONS
+  #define SYS_MAX_EVENT_SUBSCRIPTIONS 32U
+#endif
+
 /******************************************************************************
                    Types section
 ******************************************************************************/
@@ -75,6 +83,15 @@ typedef struct _SYS_EventReceiver_t
   void (*func)(SYS_EventId_t id, SYS_EventData_t data);
 } SYS_EventReceiver_t;
 
+#ifdef _SYS_EVENT_STATS_
+/*! Delivery statistics of an event */
+typedef struct
+{
+  uint32_t postCount;     //!< Number of SYS_PostEvent() calls for the event
+  uint32_t deliveryCount; //!< Number of receiver callbacks called for the event
+} SYS_EventStats_t;
+#endif // _SYS_EVENT_STATS_
+
 /******************************************************************************
                    Prototypes section
 ******************************************************************************/
@@ -133,6 +150,26 @@ bool SYS_IsEventDeliverable(SYS_EventId_t id);
 ******************************************************************************/
 bool SYS_IsEventSubscriber(SYS_EventId_t id, SYS_EventReceiver_t *recv);
 
+#ifdef _SYS_EVENT_STATS_
+/**************************************************************************//**
+\brief Gets delivery statistics of an event
+
+\ingroup sys
+
+\param[in] id - event ID
+\param[out] stats - pointer to the statistics to be filled
+
+\return false if id is not a valid event ID, true otherwise
+******************************************************************************/
+bool SYS_GetEventStats(SYS_EventId_t id, SYS_EventStats_t *stats);
+
+/**************************************************************************//**
+\brief Resets delivery statistics of all events
+
+\ingroup sys
+******************************************************************************/
+void SYS_ResetEventStats(void);
+#endif // _SYS_EVENT_STATS_
 
 #endif  // _SYS_EVENTS_HANDLER_H
 //eof sysEventsHandler.h
@@ -44,6 +44,37 @@ typedef struct
   QueueElement_t *head;
 } QueueDescriptor_t;
 
+/***************************************************************************
+  Declare a linked queue and reset to the default state.
+  Linked queue keeps a tail pointer and its elements know their owner, so
+  putting, removing and membership checking take constant time.
+  Any element passed to linked queue functions should have
+  LinkedQueueElement_t as the first field.
+  Parameters:
+    queue - the name of object.
+  Returns:
+    None
+****************************************************************************/
+#define DECLARE_LINKED_QUEUE(queue) LinkedQueueDescriptor_t queue = {.head = NULL, .tail = NULL}
+
+struct _LinkedQueueDescriptor_t;
+
+// Type of linked queue element. Field next must be the first one for
+// compatibility with getNextQueueElem().
+typedef struct _LinkedQueueElement_t
+{
+  struct _LinkedQueueElement_t *next;
+  struct _LinkedQueueElement_t *prev;
+  struct _LinkedQueueDescriptor_t *owner;
+} LinkedQueueElement_t;
+
+// Linked queue descriptor
+typedef struct _LinkedQueueDescriptor_t
+{
+  LinkedQueueElement_t *head;
+  LinkedQueueElement_t *tail;
+} LinkedQueueDescriptor_t;
+
 /***************************************************************************
   Reset a queue
   Parameters:
@@ -88,5 +119,38 @@ bool putQueueElem(QueueDescriptor_t *queue, void *element);
 void *deleteHeadQueueElem(QueueDescriptor_t *queue);
 bool  deleteQueueElem(QueueDescriptor_t *queue, void *element);
 
+/***************************************************************************
+  Get an element from a linked queue. Element is got from the head
+  Parameters:
+    queue - pointer to a linked queue descriptor
+  Returns:
+    NULL     - queue is empty
+    NOT NULL - head element
+****************************************************************************/
+INLINE void *getLinkedQueueElem(const LinkedQueueDescriptor_t *queue)
+{
+  return queue->head;
+}
+
+/***************************************************************************
+  Get next element of linked queue after current element.
+  Parameters:
+    currElement - current element
+  Returns:
+    NULL     - no next element
+    NOT NULL - next element is got
+****************************************************************************/
+INLINE void *getNextLinkedQueueElem(const void *currElem)
+{
+  return currElem? ((const LinkedQueueElement_t*) currElem)->next: NULL;
+}
+
+void resetLinkedQueue(LinkedQueueDescriptor_t *queue);
+bool isLinkedQueueElem(const LinkedQueueDescriptor_t *const queue, const void *const element);
+bool putLinkedQueueElem(LinkedQueueDescriptor_t *queue, void *element);
+bool putHeadLinkedQueueElem(LinkedQueueDescriptor_t *queue, void *element);
+void *deleteHeadLinkedQueueElem(LinkedQueueDescriptor_t *queue);
+bool deleteLinkedQueueElem(LinkedQueueDescriptor_t *queue, void *element);
+
 #endif
 //eof sysQueue.h
@@ -41,6 +41,29 @@ typedef enum
   PDS_TASK_ID         = 1 << 0x0D, //!< Task ID of the Persistent Data Server component
 } SYS_TaskId_t;
 
+/*! Priority levels of the tasks. A task of a higher level is always processed
+before a task of a lower level. Tasks of the same level are processed in order
+of their IDs. All tasks have ::SYS_TASK_PRIORITY_NORMAL level by default. */
+typedef enum
+{
+  SYS_TASK_PRIORITY_HIGH,   //!< Tasks processed before all others
+  SYS_TASK_PRIORITY_NORMAL, //!< Default priority level
+  SYS_TASK_PRIORITY_LOW,    //!< Tasks processed only when nothing else is pending
+  SYS_TASK_PRIORITY_LEVELS_AMOUNT
+} SYS_TaskPriority_t;
+
+#ifdef _SYS_TASK_STATS_
+/*! Run-time statistics of a task handler. Time units are defined by
+SYS_TASK_STATS_TIMESTAMP() (microseconds of HAL_GetSystemTimeUs() by default;
+it may be redefined to a cycle counter of the platform). */
+typedef struct
+{
+  uint32_t runCount;  //!< Number of task handler calls
+  uint32_t totalTime; //!< Overall time spent in the task handler
+  uint32_t worstTime; //!< Longest single call of the task handler
+} SYS_TaskStats_t;
+#endif // _SYS_TASK_STATS_
+
 /*! \brief Possible results of system's initialization */
 typedef enum
 {
@@ -150,11 +173,43 @@ INLINE void SYS_EnableTask(SYS_TaskId_t taskId)
   SYS_taskMask |= taskId;
 }
 
+/**************************************************************************//**
+\brief Sets priority level of the specified tasks.
+
+\ingroup sys
+
+\param[in] taskIds - bitmask of task IDs (for example, NWK_TASK_ID | MAC_HWI_TASK_ID);
+\param[in] priority - new priority level of the tasks.
+******************************************************************************/
+void SYS_SetTaskPriority(uint16_t taskIds, SYS_TaskPriority_t priority);
+
+#ifdef _SYS_TASK_STATS_
+/**************************************************************************//**
+\brief Gets run-time statistics of the task handler.
+
+\ingroup sys
+
+\param[in] taskId - ID of the task;
+\param[out] stats - pointer to the statistics to be filled.
+
+\return false if taskId is not a valid task ID, true otherwise.
+******************************************************************************/
+bool SYS_GetTaskStats(SYS_TaskId_t taskId, SYS_TaskStats_t *stats);
+
+/**************************************************************************//**
+\brief Resets run-time statistics of all task handlers.
+
+\ingroup sys
+******************************************************************************/
+void SYS_ResetTaskStats(void);
+#endif // _SYS_TASK_STATS_
+
 /**************************************************************************************//**
 \brief  This function is called by the stack or from the \c main() function to process tasks.
 
 If several tasks have been posted by the moment of the function's call, they are executed
 in order of layers' priority: a task of the layer with the highest priority is executed first.
+Priority is defined by the level set with SYS_SetTaskPriority() and then by the task ID.
 
 \ingroup sys
 ***************************************************************************************/
@@ -203,7 +203,7 @@
     #define ENABLE_CHANGE_PROTECTION_REGISTER   CCP = 0xD8
   #endif
 
-#elif defined(WIN)
+#elif defined(WIN) || defined(LINUX)
   #define PROGMEM_DECLARE(x) const x
   #define FLASH_VAR
   #define FLASH_PTR
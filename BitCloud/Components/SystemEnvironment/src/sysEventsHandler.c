@@ -23,13 +23,45 @@
 #include <sysEvents.h>
 #include <sysAssert.h>
 
+/******************************************************************************
+                   Prototypes section
+******************************************************************************/
+static bool isEventReceiverIdle(const SYS_EventReceiver_t *recv);
+static void dequeueIdleEventReceivers(void);
+static void addSubscription(SYS_EventId_t id, SYS_EventReceiver_t *recv);
+static void releaseSubscriptions(SYS_EventId_t id);
+static void releaseStaleSubscriptions(void);
+static void deliverEvent(const SYS_EventReceiver_t *recv, SYS_EventId_t id, SYS_EventData_t data);
+
 /******************************************************************************
                     Static variables section
 ******************************************************************************/
-// Queue of registered event receivers
+// Queue of registered event receivers in order of registration
 static DECLARE_QUEUE(eventReceivers);
-// Mask for fast query if event have at least one subscriber
-static sysEvWord_t subscribed[SYS_EVENTS_MASK_SIZE];
+// Number of receivers subscribed to each event
+static uint8_t eventSubscribersAmount[SYS_MAX_EVENTS];
+// Nesting level of SYS_PostEvent() calls
+static uint8_t deliveryDepth;
+// At least one receiver has lost all subscriptions during event delivery
+static bool idleReceiversPending;
+
+// Subscriptions are numbered from 1, 0 terminates a list. Each event keeps
+// the list of its subscriptions in order of subscribing.
+static uint8_t eventSubscriptions[SYS_MAX_EVENTS];
+static SYS_EventReceiver_t *subscriptionReceiver[SYS_MAX_EVENT_SUBSCRIPTIONS];
+static uint8_t subscriptionNext[SYS_MAX_EVENT_SUBSCRIPTIONS];
+// List of released subscriptions and number of subscriptions ever taken
+static uint8_t freeSubscriptions;
+static uint8_t usedSubscriptionsAmount;
+// Events delivered by checking all receivers as their subscriptions did not fit
+static sysEvWord_t overflowedEvents[SYS_EVENTS_MASK_SIZE];
+// Events which have lost subscribers during event delivery
+static sysEvWord_t staleEvents[SYS_EVENTS_MASK_SIZE];
+static bool staleSubscriptionsPending;
+
+#ifdef _SYS_EVENT_STATS_
+static SYS_EventStats_t eventStats[SYS_MAX_EVENTS];
+#endif
 
 static const unsigned int evWordNBits = sizeof(sysEvWord_t) * 8U;
 
@@ -51,24 +83,25 @@ void SYS_SubscribeToEvent(SYS_EventId_t id, SYS_EventReceiver_t *recv)
 
   SYS_E_ASSERT_FATAL((id <  SYS_MAX_EVENTS), SYS_ASSERT_WRONG_EVENT_SUBSCRIBE);
 
-  // Stop processing, if receiver is already subscribed.
-  if (SYS_IsEventSubscriber(id, recv))
-    return;
-
   if (!isQueueElem(&eventReceivers, recv))
   {
     // Clear events mask (we're not in queue and therefore not subscribed to any event)
     memset(recv->service.evmask, 0U, sizeof(recv->service.evmask));
     putQueueElem(&eventReceivers, recv);
   }
+  // Stop processing, if receiver is already subscribed.
+  else if (recv->service.evmask[pos] & mask)
+    return;
 
-  // Update receiver's mask and fast query mask
+  // Update receiver's mask and amount of event's subscribers
   recv->service.evmask[pos] |= mask;
-  subscribed[pos] |= mask;
+  eventSubscribersAmount[id]++;
+  addSubscription(id, recv);
 }
 
 /**************************************************************************//**
-\brief Unsubscribe receiver from event
+\brief Unsubscribe receiver from event. May be called from the receiver's
+callback function, also for other receivers of the event being delivered.
 
 \param[in] id - event id
 \param[in] recv - receiver description
@@ -77,42 +110,36 @@ void SYS_UnsubscribeFromEvent(SYS_EventId_t id, SYS_EventReceiver_t *recv)
 {
   const int pos = id / evWordNBits;
   const sysEvWord_t mask = 1U << (id % evWordNBits);
-  bool more_subscribers = false;
 
   SYS_E_ASSERT_FATAL((id < SYS_MAX_EVENTS), SYS_ASSERT_WRONG_EVENT_SUBSCRIBE);
 
-  // Stop processing, if receiver wasn't subscribed.
+  // Stop processing, if receiver is not subscribed.
   if (!SYS_IsEventSubscriber(id, recv))
     return;
 
-  // Update receiver's mask
+  // Update receiver's mask and amount of event's subscribers
   recv->service.evmask[pos] &= ~mask;
+  eventSubscribersAmount[id]--;
 
-  // Look if there is more subscribers for event
-  for (const SYS_EventReceiver_t *hnd = getQueueElem(&eventReceivers); hnd; hnd = getNextQueueElem(hnd))
+  // Subscriptions of the event may be being walked, so they are released
+  // after the delivery is finished.
+  if (deliveryDepth)
   {
-    if (hnd->service.evmask[pos] & mask)
-    {
-      more_subscribers = true;
-      break;
-    }
+    staleEvents[pos] |= mask;
+    staleSubscriptionsPending = true;
   }
+  else
+    releaseSubscriptions(id);
 
-  // No more subscribers for event. Update fast query mask.
-  if (!more_subscribers)
-    subscribed[pos] &= ~mask;
+  if (!isEventReceiverIdle(recv))
+    return;
 
-// Dequeuing receiver is dangerous since user could unsubscribe and modify queue
-// while being called by PostEvent's event delivery loop. Disabled for now.
-#if 0
-  for (int i = ARRAY_SIZE(recv->service.evlist), i, i--)
-  {
-    if (recv->service.evlist[i])
-      return;
-  }
-  // No more subscriptions, dequeue receiver
-  deleteQueueElem(eventReceivers, recv);
-#endif
+  // No more subscriptions, dequeue receiver. The queue is being walked during
+  // event delivery, so dequeuing is postponed until the delivery is finished.
+  if (deliveryDepth)
+    idleReceiversPending = true;
+  else
+    deleteQueueElem(&eventReceivers, recv);
 }
 
 /**************************************************************************//**
@@ -128,17 +155,43 @@ void SYS_PostEvent(SYS_EventId_t id, SYS_EventData_t data)
 
   SYS_E_ASSERT_FATAL((id <  SYS_MAX_EVENTS), SYS_ASSERT_WRONG_EVENT_POST);
 
-  if (!(subscribed[pos] & mask))  // There is no one listening
+#ifdef _SYS_EVENT_STATS_
+  eventStats[id].postCount++;
+#endif
+
+  if (!eventSubscribersAmount[id])  // There is no one listening
     return;
 
-  for (const SYS_EventReceiver_t *hnd = getQueueElem(&eventReceivers); hnd; hnd = getNextQueueElem(hnd))
+  deliveryDepth++;
+
+  // Receivers unsubscribed during the delivery are still listed, so the
+  // subscription is checked before the call.
+  if (overflowedEvents[pos] & mask)
+  {
+    for (const SYS_EventReceiver_t *hnd = getQueueElem(&eventReceivers); hnd; hnd = getNextQueueElem(hnd))
+    {
+      if (hnd->service.evmask[pos] & mask)
+        deliverEvent(hnd, id, data);
+    }
+  }
+  else
   {
-    if (hnd->service.evmask[pos] & mask)
+    for (uint8_t sub = eventSubscriptions[id]; sub; sub = subscriptionNext[sub - 1U])
     {
-      SYS_E_ASSERT_FATAL(hnd->func, SYS_POSTEVENT_NULLCALLBACK0);
-      hnd->func(id, data);
+      const SYS_EventReceiver_t *hnd = subscriptionReceiver[sub - 1U];
+
+      if (hnd->service.evmask[pos] & mask)
+        deliverEvent(hnd, id, data);
     }
   }
+
+  if (!--deliveryDepth)
+  {
+    if (staleSubscriptionsPending)
+      releaseStaleSubscriptions();
+    if (idleReceiversPending)
+      dequeueIdleEventReceivers();
+  }
 }
 
 /**************************************************************************//**
@@ -149,7 +202,7 @@ void SYS_PostEvent(SYS_EventId_t id, SYS_EventData_t data)
 ******************************************************************************/
 bool SYS_IsEventDeliverable(SYS_EventId_t id)
 {
-  return subscribed[id / evWordNBits] & (1U << (id % evWordNBits));
+  return (id < SYS_MAX_EVENTS) && eventSubscribersAmount[id];
 }
 
 /**************************************************************************//**
@@ -168,4 +221,181 @@ bool SYS_IsEventSubscriber(SYS_EventId_t id, SYS_EventReceiver_t *recv)
   return recv->service.evmask[pos] & mask;
 }
 
+#ifdef _SYS_EVENT_STATS_
+/**************************************************************************//**
+\brief Gets delivery statistics of an event
+
+\param[in] id - event id
+\param[out] stats - pointer to the statistics to be filled
+
+\return false if id is not a valid event id, true otherwise
+******************************************************************************/
+bool SYS_GetEventStats(SYS_EventId_t id, SYS_EventStats_t *stats)
+{
+  if (id >= SYS_MAX_EVENTS)
+    return false;
+
+  *stats = eventStats[id];
+  return true;
+}
+
+/**************************************************************************//**
+\brief Resets delivery statistics of all events
+******************************************************************************/
+void SYS_ResetEventStats(void)
+{
+  memset(eventStats, 0U, sizeof(eventStats));
+}
+#endif // _SYS_EVENT_STATS_
+
+/**************************************************************************//**
+\brief Check if receiver is not subscribed to any event
+
+\param[in] recv - receiver description
+\return result
+******************************************************************************/
+static bool isEventReceiverIdle(const SYS_EventReceiver_t *recv)
+{
+  for (uint8_t i = 0U; i < ARRAY_SIZE(recv->service.evmask); i++)
+  {
+    if (recv->service.evmask[i])
+      return false;
+  }
+
+  return true;
+}
+
+/**************************************************************************//**
+\brief Calls receiver's callback function
+
+\param[in] recv - receiver description
+\param[in] id - event id
+\param[in] data - associated data
+******************************************************************************/
+static void deliverEvent(const SYS_EventReceiver_t *recv, SYS_EventId_t id, SYS_EventData_t data)
+{
+  SYS_E_ASSERT_FATAL(recv->func, SYS_POSTEVENT_NULLCALLBACK0);
+  recv->func(id, data);
+
+#ifdef _SYS_EVENT_STATS_
+  eventStats[id].deliveryCount++;
+#endif
+}
+
+/**************************************************************************//**
+\brief Appends receiver to the subscriptions of event. If there is no free
+subscription, event is delivered by checking all receivers from now on.
+
+\param[in] id - event id
+\param[in] recv - receiver description
+******************************************************************************/
+static void addSubscription(SYS_EventId_t id, SYS_EventReceiver_t *recv)
+{
+  const int pos = id / evWordNBits;
+  const sysEvWord_t mask = 1U << (id % evWordNBits);
+  uint8_t *link = &eventSubscriptions[id];
+  uint8_t sub;
+
+  if (overflowedEvents[pos] & mask)
+    return;
+
+  // Subscription of a receiver unsubscribed during event delivery may be
+  // still listed, it is taken again then.
+  while (*link)
+  {
+    if (subscriptionReceiver[*link - 1U] == recv)
+      return;
+    link = &subscriptionNext[*link - 1U];
+  }
+
+  if (freeSubscriptions)
+  {
+    sub = freeSubscriptions;
+    freeSubscriptions = subscriptionNext[sub - 1U];
+  }
+  else if (usedSubscriptionsAmount < SYS_MAX_EVENT_SUBSCRIPTIONS)
+    sub = ++usedSubscriptionsAmount;
+  else
+  {
+    overflowedEvents[pos] |= mask;
+    return;
+  }
+
+  subscriptionReceiver[sub - 1U] = recv;
+  subscriptionNext[sub - 1U] = 0U;
+  *link = sub;
+}
+
+/**************************************************************************//**
+\brief Releases subscriptions of event which receivers are not subscribed to
+the event anymore
+
+\param[in] id - event id
+******************************************************************************/
+static void releaseSubscriptions(SYS_EventId_t id)
+{
+  const int pos = id / evWordNBits;
+  const sysEvWord_t mask = 1U << (id % evWordNBits);
+  uint8_t *link = &eventSubscriptions[id];
+
+  while (*link)
+  {
+    uint8_t sub = *link;
+
+    if (subscriptionReceiver[sub - 1U]->service.evmask[pos] & mask)
+    {
+      link = &subscriptionNext[sub - 1U];
+      continue;
+    }
+    *link = subscriptionNext[sub - 1U];
+    subscriptionNext[sub - 1U] = freeSubscriptions;
+    freeSubscriptions = sub;
+  }
+
+  // Event without subscribers has no receivers to be checked anymore
+  if (!eventSubscribersAmount[id])
+    overflowedEvents[pos] &= ~mask;
+}
+
+/**************************************************************************//**
+\brief Releases subscriptions of the events which have lost subscribers
+during event delivery
+******************************************************************************/
+static void releaseStaleSubscriptions(void)
+{
+  staleSubscriptionsPending = false;
+
+  for (SYS_EventId_t id = 0U; id < SYS_MAX_EVENTS; id++)
+  {
+    const int pos = id / evWordNBits;
+    const sysEvWord_t mask = 1U << (id % evWordNBits);
+
+    if (staleEvents[pos] & mask)
+    {
+      staleEvents[pos] &= ~mask;
+      releaseSubscriptions(id);
+    }
+  }
+}
+
+/**************************************************************************//**
+\brief Dequeues receivers which have lost all subscriptions during event
+delivery
+******************************************************************************/
+static void dequeueIdleEventReceivers(void)
+{
+  SYS_EventReceiver_t *hnd = getQueueElem(&eventReceivers);
+
+  idleReceiversPending = false;
+
+  while (hnd)
+  {
+    SYS_EventReceiver_t *next = getNextQueueElem(hnd);
+
+    if (isEventReceiverIdle(hnd))
+      deleteQueueElem(&eventReceivers, hnd);
+    hnd = next;
+  }
+}
+
 // eof sysEventsHandler.c
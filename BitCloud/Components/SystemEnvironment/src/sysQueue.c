@@ -123,4 +123,155 @@ bool isQueueElem(const QueueDescriptor_t *const queue, const void *const element
   return false;
 }
 
+/***************************************************************************
+  Reset a linked queue. Elements, which were in the queue, are released.
+  Parameters:
+    queue - pointer to a linked queue descriptor
+  Returns:
+    None
+****************************************************************************/
+void resetLinkedQueue(LinkedQueueDescriptor_t *queue)
+{
+  LinkedQueueElement_t *it = queue->head;
+
+  while (it)
+  {
+    LinkedQueueElement_t *next = it->next;
+
+    it->next = NULL;
+    it->prev = NULL;
+    it->owner = NULL;
+    it = next;
+  }
+  queue->head = NULL;
+  queue->tail = NULL;
+}
+
+/***************************************************************************
+  Check if element is a member of specified linked queue. Takes constant time.
+  Parameters:
+    queue - pointer to a linked queue descriptor
+    element - pointer to an element
+  Returns:
+    True - if element is a queue member, false - otherwise.
+****************************************************************************/
+bool isLinkedQueueElem(const LinkedQueueDescriptor_t *const queue, const void *const element)
+{
+  const LinkedQueueElement_t *elem = element;
+
+  if (!elem || elem->owner != queue)
+    return false;
+
+  // Owner tag may be stale if the queue was reset, so check the links too
+  if (elem->prev)
+    return elem->prev->next == elem;
+  return queue->head == elem;
+}
+
+/***************************************************************************
+  Put an element to a linked queue. Element is added to the tail
+  Parameters:
+    queue   - pointer to a linked queue descriptor
+    element - pointer to new element
+  Returns:
+    True - succesfully queued, False - not queued
+****************************************************************************/
+bool putLinkedQueueElem(LinkedQueueDescriptor_t *queue, void *element)
+{
+  LinkedQueueElement_t *elem = element;
+
+  if (isLinkedQueueElem(queue, element))
+  {
+    SYS_E_ASSERT_ERROR(false, SYS_ASSERT_ID_DOUBLE_QUEUE_PUT);
+    return false;
+  }
+
+  elem->next = NULL;
+  elem->prev = queue->tail;
+  elem->owner = queue;
+  if (queue->tail)
+    queue->tail->next = elem;
+  else
+    queue->head = elem;
+  queue->tail = elem;
+  return true;
+}
+
+/***************************************************************************
+  Put an element to a linked queue. Element is added to the head
+  Parameters:
+    queue   - pointer to a linked queue descriptor
+    element - pointer to new element
+  Returns:
+    True - succesfully queued, False - not queued
+****************************************************************************/
+bool putHeadLinkedQueueElem(LinkedQueueDescriptor_t *queue, void *element)
+{
+  LinkedQueueElement_t *elem = element;
+
+  if (isLinkedQueueElem(queue, element))
+  {
+    SYS_E_ASSERT_ERROR(false, SYS_ASSERT_ID_DOUBLE_QUEUE_PUT);
+    return false;
+  }
+
+  elem->next = queue->head;
+  elem->prev = NULL;
+  elem->owner = queue;
+  if (queue->head)
+    queue->head->prev = elem;
+  else
+    queue->tail = elem;
+  queue->head = elem;
+  return true;
+}
+
+/***************************************************************************
+  Delete a head element from a linked queue.
+  Parameters:
+    queue - pointer to a linked queue descriptor
+  Returns:
+    NULL     - queue is empty
+    NOT NULL - removed element
+****************************************************************************/
+void *deleteHeadLinkedQueueElem(LinkedQueueDescriptor_t *queue)
+{
+  LinkedQueueElement_t *elem = queue->head;
+
+  if (elem)
+    deleteLinkedQueueElem(queue, elem);
+  return elem;
+}
+
+/***************************************************************************
+  Delete the certain element of a linked queue. Takes constant time.
+  Parameters:
+    element - element to be deleted
+    queue   - pointer to a linked queue descriptor
+  Returns:
+    true if element was removed otherwise false
+****************************************************************************/
+bool deleteLinkedQueueElem(LinkedQueueDescriptor_t *queue, void *element)
+{
+  LinkedQueueElement_t *elem = element;
+
+  if (!isLinkedQueueElem(queue, element))
+    return false;
+
+  if (elem->prev)
+    elem->prev->next = elem->next;
+  else
+    queue->head = elem->next;
+
+  if (elem->next)
+    elem->next->prev = elem->prev;
+  else
+    queue->tail = elem->prev;
+
+  elem->next = NULL;
+  elem->prev = NULL;
+  elem->owner = NULL;
+  return true;
+}
+
 //eof sysQueue.c
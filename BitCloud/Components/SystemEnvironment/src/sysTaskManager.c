@@ -23,6 +23,7 @@
 #include <sysEvents.h>
 #include <sysIdleHandler.h>
 #include <sysAssert.h>
+#include <sysUtils.h>
 
 #if defined(_USE_KF_MAC_)
 #include <mac_api.h>
@@ -37,10 +38,33 @@
 #include <zsiMem.h>
 #include <sysInit.h>
 #endif
+#ifdef _SYS_TASK_STATS_
+#include <appTimer.h>
+#endif
+
+/******************************************************************************
+                             Definitions section
+******************************************************************************/
+#define SYS_TASKS_AMOUNT ARRAY_SIZE(taskHandlers)
+#define SYS_ALL_TASKS_MASK 0xFFFFU
+/* Bits of SYS_taskFlag which correspond to existing task handlers */
+#define SYS_VALID_TASKS_MASK ((uint16_t)((1UL << SYS_TASKS_AMOUNT) - 1U))
+
+#ifdef _SYS_TASK_STATS_
+/* Time source for task statistics, microseconds by default. May be redefined
+   (e.g. in the compiler options) to a cycle counter of the platform. Must not
+   wrap more often than once per task handler call. */
+#ifndef SYS_TASK_STATS_TIMESTAMP
+  #define SYS_TASK_STATS_TIMESTAMP() HAL_GetSystemTimeUs()
+#endif
+#endif // _SYS_TASK_STATS_
+
 /******************************************************************************
                              Prototypes section
 ******************************************************************************/
 static void processManagerTask(void);
+static uint8_t getFirstBitSetIndex(uint16_t bitmask);
+static uint8_t getPendingTaskId(void);
 
 /******************************************************************************
                              External variables section
@@ -137,6 +161,24 @@ static void (*taskHandlers[])() = {
 #endif
 };
 
+/* Bitmasks of tasks assigned to each priority level */
+static uint16_t taskPriorityMasks[SYS_TASK_PRIORITY_LEVELS_AMOUNT] =
+{
+  [SYS_TASK_PRIORITY_NORMAL] = SYS_ALL_TASKS_MASK
+};
+
+#if !defined(__GNUC__)
+/* Index of the lowest set bit of a nibble. Entry 0 is unused. */
+static const uint8_t firstBitSetInNibble[16] =
+{
+  0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0
+};
+#endif
+
+#ifdef _SYS_TASK_STATS_
+static SYS_TaskStats_t taskStats[SYS_TASKS_AMOUNT];
+#endif
+
 /******************************************************************************
                              Implementation section
 ******************************************************************************/
@@ -231,30 +273,157 @@ void SYS_ForcePdsHandler(void)
 }
 
 /***************************************************************************//**
-\brief Task processing handler
+\brief Sets priority level of the specified tasks.
+
+\param[in] taskIds - bitmask of task IDs;
+\param[in] priority - new priority level of the tasks.
+*******************************************************************************/
+void SYS_SetTaskPriority(uint16_t taskIds, SYS_TaskPriority_t priority)
+{
+  uint8_t level;
+
+  SYS_E_ASSERT_ERROR((priority < SYS_TASK_PRIORITY_LEVELS_AMOUNT), SYS_TASKMANAGER_INVALIDPRIORITY);
+  if (priority >= SYS_TASK_PRIORITY_LEVELS_AMOUNT)
+    return;
+
+  for (level = 0; level < SYS_TASK_PRIORITY_LEVELS_AMOUNT; level++)
+    taskPriorityMasks[level] &= ~taskIds;
+  taskPriorityMasks[priority] |= taskIds;
+}
+
+#ifdef _SYS_TASK_STATS_
+/***************************************************************************//**
+\brief Gets run-time statistics of the task handler.
+
+\param[in] taskId - ID of the task;
+\param[out] stats - pointer to the statistics to be filled.
+
+\return false if taskId is not a valid task ID, true otherwise.
+*******************************************************************************/
+bool SYS_GetTaskStats(SYS_TaskId_t taskId, SYS_TaskStats_t *stats)
+{
+  uint8_t index;
+
+  // Exactly one bit must be set
+  if (!taskId || (taskId & (taskId - 1)))
+    return false;
+
+  index = getFirstBitSetIndex(taskId);
+  if (index >= SYS_TASKS_AMOUNT)
+    return false;
+
+  *stats = taskStats[index];
+  return true;
+}
+
+/***************************************************************************//**
+\brief Resets run-time statistics of all task handlers.
+*******************************************************************************/
+void SYS_ResetTaskStats(void)
+{
+  memset(taskStats, 0, sizeof(taskStats));
+}
+#endif // _SYS_TASK_STATS_
+
+/***************************************************************************//**
+\brief Gets index of the least significant set bit.
+
+\param[in] bitmask - non-zero bitmask.
+\return index of the bit.
+*******************************************************************************/
+static uint8_t getFirstBitSetIndex(uint16_t bitmask)
+{
+#if defined(__GNUC__)
+  return (uint8_t)__builtin_ctz(bitmask);
+#else
+  uint8_t offset = 0;
+
+  if (!(bitmask & 0x00FFU))
+  {
+    bitmask >>= 8;
+    offset = 8;
+  }
+  if (!(bitmask & 0x000FU))
+  {
+    bitmask >>= 4;
+    offset += 4;
+  }
+  return offset + firstBitSetInNibble[bitmask & 0x000FU];
+#endif
+}
+
+/***************************************************************************//**
+\brief Selects the pending task to be run next.
+
+\return ID of the first pending task of the highest priority level or
+  SYS_TASKS_AMOUNT if there are no pending tasks.
+*******************************************************************************/
+static uint8_t getPendingTaskId(void)
+{
+  // Bits without a task handler are ignored not to hide tasks of lower levels
+  uint16_t pending = SYS_taskFlag & SYS_taskMask & SYS_VALID_TASKS_MASK;
+  uint8_t level;
+
+  if (!pending)
+    return SYS_TASKS_AMOUNT;
+
+  for (level = 0; level < SYS_TASK_PRIORITY_LEVELS_AMOUNT; level++)
+  {
+    if (pending & taskPriorityMasks[level])
+      return getFirstBitSetIndex(pending & taskPriorityMasks[level]);
+  }
+  return SYS_TASKS_AMOUNT;
+}
+
+/***************************************************************************//**
+\brief Task processing handler. Runs the handler of one pending task with the
+highest priority.
 *******************************************************************************/
 static void processManagerTask(void)
 {
   uint8_t taskId;
+#ifdef _SYS_TASK_STATS_
+  uint32_t startTime;
+  uint32_t duration;
+#endif
 
-  for (taskId = 0; taskId < (sizeof(taskHandlers) / sizeof(taskHandlers[0])); taskId++)
-  {
 #if defined(_USE_KF_MAC_)
-    wpan_task();
-#endif // defined(_USE_KF_MAC_)
-    SYS_INFINITY_LOOP_MONITORING
-    if ((1 << taskId) & (SYS_taskFlag & SYS_taskMask))
+  {
+    uint8_t scanned = 0;
+
+    // MAC is polled once per task ID up to the selected one, as often as
+    // the dispatcher scanning task IDs one by one did
+    do
     {
-      ATOMIC_SECTION_ENTER
-        SYS_taskFlag &= ~(1 << taskId);
-      ATOMIC_SECTION_LEAVE
+      wpan_task();
+      SYS_INFINITY_LOOP_MONITORING
+      taskId = getPendingTaskId();
+    } while ((taskId > scanned) && (++scanned < SYS_TASKS_AMOUNT));
+  }
+#else
+  SYS_INFINITY_LOOP_MONITORING
+  taskId = getPendingTaskId();
+#endif // defined(_USE_KF_MAC_)
 
-      SYS_E_ASSERT_FATAL(taskHandlers[taskId], SYS_TASKHANDLER_NULLCALLBACK0);
-      taskHandlers[taskId]();
+  if (taskId >= SYS_TASKS_AMOUNT)
+    return;
 
-      break;
-    }
-  }
+  ATOMIC_SECTION_ENTER
+    SYS_taskFlag &= ~(1U << taskId);
+  ATOMIC_SECTION_LEAVE
+
+  SYS_E_ASSERT_FATAL(taskHandlers[taskId], SYS_TASKHANDLER_NULLCALLBACK0);
+#ifdef _SYS_TASK_STATS_
+  startTime = SYS_TASK_STATS_TIMESTAMP();
+#endif
+  taskHandlers[taskId]();
+#ifdef _SYS_TASK_STATS_
+  duration = SYS_TASK_STATS_TIMESTAMP() - startTime;
+  taskStats[taskId].runCount++;
+  taskStats[taskId].totalTime += duration;
+  if (duration > taskStats[taskId].worstTime)
+    taskStats[taskId].worstTime = duration;
+#endif
 }
 
 #if defined(_USE_KF_MAC_)
@@ -80,6 +80,14 @@ ZsiProcessingRoutine_t zsiApsFindProcessingRoutine(uint8_t commandId);
  ******************************************************************************/
 APS_RegisterEndpointReq_t* zsiApsFindEndpoint(Endpoint_t endpoint);
 
+/**************************************************************************//**
+  \brief Checks if receiver of the delivered indication keeps it, and clears
+         the mark.
+
+  \return True, if indication and its command frame shall not be freed.
+ ******************************************************************************/
+bool zsiApsIsDataIndKept(void);
+
 /**************************************************************************//**
   \brief APS-RegisterEndpoint request primitive serialization routine.
 
@@ -29,6 +29,11 @@
 #define ZSI_SYS_READ_PARAMETER_CONFIRM  0x01U
 #define ZSI_SYS_WRITE_PARAMETER_REQUEST 0x02U
 #define ZSI_SYS_WRITE_PARAMETER_CONFIRM 0x03U
+#define ZSI_SYS_PARAMETERS_CHANGED_INDICATION 0x04U
+#define ZSI_SYS_GET_LINK_STATS_REQUEST  0x05U
+#define ZSI_SYS_GET_LINK_STATS_CONFIRM  0x06U
+#define ZSI_SYS_GET_MEMORY_STATS_REQUEST 0x07U
+#define ZSI_SYS_GET_MEMORY_STATS_CONFIRM 0x08U
 
 /* APS domain */
 #define ZSI_APS_REGISTER_ENDPOINT_REQUEST              0x00U
@@ -42,6 +42,11 @@ typedef enum _ZSI_DbgCodeId_t
   ZSIDRIVER_ZSIDRIVERTASKHANDLER1                  = 0xA004,
   ZSIDRIVER_ZSIDRIVERTASKHANDLER2                  = 0xA005,
   ZSIDRIVER_ZSISRSP_OUTSIDE_BLOCKING               = 0xA006,
+  ZSIDRIVER_ZSISRSPRECEIVED0                       = 0xA007,
+  ZSIDRIVER_ZSISRSPTIMEOUT0                        = 0xA008,
+  ZSIDRIVER_ZSIPROCESSSREQ0                        = 0xA009,
+  ZSIDRIVER_ZSIBATCHRECEIVED0                      = 0xA00A,
+  ZSIDRIVER_ZSIWAITSREQMEMORY0                     = 0xA00B,
 
   ZSISERIALCONTROLLER_ZSISERIALSEND0               = 0xA010,
   ZSISERIALCONTROLLER_ZSISERIALACKTIMERFIRED0      = 0xA011,
@@ -57,6 +62,7 @@ typedef enum _ZSI_DbgCodeId_t
   ZSISERIALCONTROLLER_ZSISERIALCOMMANDRECEIVED1    = 0xA01B,
   ZSISERIALCONTROLLER_ZSISERIALCOMMANDRECEIVED2    = 0xA01C,
   ZSISERIALCONTROLLER_ZSISERIALRECEIVE0            = 0xA01D,
+  ZSISERIALCONTROLLER_ZSISERIALWINDOWTIMEOUT0      = 0xA01E,
 
   ZSIMEMORYMANAGER_MEMORYCORRUPTION0               = 0xA020,
   ZSIMEMORYMANAGER_MEMORYCORRUPTION1               = 0xA021,
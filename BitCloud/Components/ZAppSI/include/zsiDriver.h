@@ -35,6 +35,13 @@
 #define ZSI_ENTER_SYNCHRONOUS_MODE() zsiMediumPerformHalHoldTasks()
 #define ZSI_LEAVE_SYNCHRONOUS_MODE() zsiMediumReleaseAllHeldTasks()
 
+/* Maximum amount of SREQs waiting for SRSP at the same time. Stop-and-wait
+   link always keeps single SREQ in flight, since legacy network processors
+   can't process next SREQ before SRSP on previous one is sent. */
+#ifndef ZSI_MAX_SREQS_IN_FLIGHT
+  #define ZSI_MAX_SREQS_IN_FLIGHT 2U
+#endif
+
 /******************************************************************************
                               Types section
 ******************************************************************************/
@@ -52,9 +59,18 @@ typedef struct _ZsiDriver_t
   uint8_t            sequenceNumber;
   QueueDescriptor_t  bearingEntities;
   QueueDescriptor_t  postponedAreqs;
-  QueueDescriptor_t  commandsToReceive;
+  LinkedQueueDescriptor_t commandsToReceive;
   QueueDescriptor_t  completedAreqs;
-  ZsiCommandFrame_t  *srsp;
+  /* SREQs waiting for memory or free place in pipeline */
+  QueueDescriptor_t  postponedSreqs;
+  /* SREQs sent to remote device and waiting for SRSP */
+  QueueDescriptor_t  pendingSreqs;
+  /* SREQs with received SRSP waiting for callback */
+  QueueDescriptor_t  completedSreqs;
+  uint8_t            sreqsInFlight;
+  HAL_AppTimer_t     srspTimer;
+  /* Offset of the next record to unpack from the received batch frame */
+  uint16_t           batchOffset;
 } ZsiDriver_t;
 
 typedef struct _ZsiEntityService_t
@@ -100,6 +116,31 @@ typedef ZsiProcessingResult_t (*ZsiProcessingRoutine_t)(void *, ZsiCommandFrame_
 
 typedef ZsiProcessingRoutine_t (*ZsiDomainProcessingRoutine_t)(uint8_t);
 
+/* Synchronous request processed without blocking of the caller */
+typedef struct _ZsiSreq_t
+{
+  /* Service fields - for internal needs */
+  struct
+  {
+    /* Link to next element for queue support. */
+    QueueElement_t next;
+    /* Time, SRSP shall be received until */
+    BcTime_t       srspDeadline;
+    /* Sequence number to identify SREQ-SRSP pair. */
+    uint8_t        sequenceNumber;
+    /* SRSP is received and deserialized to dataOut */
+    bool           completed;
+  } service;
+  /* Request parameters. Shall stay valid until callback is called. */
+  void                  *dataIn;
+  /* SREQ serialization routine */
+  ZsiSerializeRoutine_t serialize;
+  /* Memory to deserialize SRSP into */
+  void                  *dataOut;
+  /* Called from ZAppSI task when SRSP is deserialized into dataOut */
+  void (*callback)(struct _ZsiSreq_t *sreq);
+} ZsiSreq_t;
+
 /******************************************************************************
                              Prototypes section
  ******************************************************************************/
@@ -151,11 +192,27 @@ INLINE void zsiMemoryAvailableNtfy(void)
   \param[in] serialize - pointer to serialization routine.
   \param[out] dataOut - pointer to execution result.
 
-  \return None.
+  \return False, if SREQ isn't completed: there is no memory for the frame
+          or SRSP doesn't come in time. dataOut isn't written then and lost
+          synchronization is indicated. True - otherwise.
  ******************************************************************************/
-void zsiProcessCommand(uint8_t cmdType, void *const dataIn,
+bool zsiProcessCommand(uint8_t cmdType, void *const dataIn,
   ZsiSerializeRoutine_t serialize, void *const dataOut);
 
+/**************************************************************************//**
+  \brief Non-blocking SREQ processing. Request is serialized and sent as soon
+         as memory and free place in SREQs pipeline are available. Caller isn't
+         blocked till SRSP, several requests may wait for SRSP at the same time.
+
+  \param[in] sreq - request descriptor with dataIn, serialize, dataOut and
+                    callback fields filled. Callback isn't called if SRSP
+                    doesn't come in time, lost synchronization is indicated
+                    instead.
+
+  \return None.
+ ******************************************************************************/
+void zsiProcessSreq(ZsiSreq_t *const sreq);
+
 /******************************************************************************
   \brief Pass command for transmission to HOST or NP.
 
@@ -196,9 +253,9 @@ uint8_t zsiGetSequenceNumber(void);
   \param[in] cmdFrame - frame, which keeps serialized command.
   \param[out] dataOut - pointer to memory to put returned value in case of SREQ.
 
-  \return None.
+  \return False, if SRSP on SREQ doesn't come in time, true - otherwise.
  ******************************************************************************/
-void zsiDriverSendCommand(ZsiCommandFrame_t *const cmdFrame, void *const dataOut);
+bool zsiDriverSendCommand(ZsiCommandFrame_t *const cmdFrame, void *const dataOut);
 
 /******************************************************************************
   \brief ZAppSI Driver received command processing routine.
@@ -38,23 +38,41 @@
 /* ZAppSI command frame fields size excluding SOF, LENGTH and PAYLOAD fields.
    FRAME_SEQ_NUM + COMMAND_HEADER + FCS */
 #define ZSI_COMMAND_FRAME_OVERHEAD 4U
+/* Size of CRC-16 FCS field. Frames protected by CRC-16 are one byte longer,
+   than the command frame overhead assumes. */
+#define ZSI_CRC_FCS_SIZE 2U
+/* CRC-16/CCITT (reflected, as SYS_Crc16Ccitt()) initial value. CRC of the
+   whole frame including its FCS field, transmitted LSB first, is zero. */
+#define ZSI_CRC_FCS_INIT 0xFFFFU
 
 /* ZAppSI frame control field description.
-   Bits 0-3 determine transmission status, bits 4-5 are reserved
-   and bits 6-7 determine ZAppSI command frame types. */
+   Bits 0-1 determine transmission status, bit 2 is the CRC-16 FCS flag,
+   bit 3 of ACK frames advertises batch frame support, bits 4-5 keep
+   ACK window and bits 6-7 determine ZAppSI command frame types. */
 
 /* Remote device received a corrupted frame. */
 #define ZSI_INVALID_FCS_STATUS      (1U << 0U)
 /* Remote device have no memory for current frame processing. */
 #define ZSI_OVERFLOW_STATUS         (1U << 1U)
-/* Received frame is a part of a larger one.  */
-#define ZSI_FRAGMENTED_FRAME_STATUS (1U << 2U)
-/* There is one more frame pending on the remote side. */
-#define ZSI_FRAME_PENDING_STATUS    (1U << 3U)
+/* Bit 2 of successful ACK frames is set by devices which verify CRC-16 FCS.
+   In command frames it means that FCS field keeps CRC-16 instead of XOR of
+   frame bytes. ACK frames are always protected by XOR FCS. */
+#define ZSI_CRC_FCS_FLAG            (1U << 2U)
+/* Bit 3 of successful ACK frames is set by devices which accept batch frames.
+   Legacy devices never set it and ignore it. It used to be the never used
+   frame pending status. */
+#define ZSI_BATCH_SUPPORTED_FLAG    (1U << 3U)
 /* Remote device received frame successfully */
 #define ZSI_NO_ERROR_STATUS         ((0U << 0U) & (0U << 1U))
 
-/* Bits 4-5 are reserved for future use. */
+/* Bits 4-5 of successful ACK frames advertise the sender's receive window:
+   0 - stop-and-wait only (legacy devices never set these bits),
+   1, 2, 3 - up to 2, 4 or 8 unacknowledged frames respectively.
+   Command frames keep these bits zeroed. */
+#define ZSI_WINDOW_FIELD_POS  4U
+#define ZSI_WINDOW_FIELD_MASK ((1U << 4U) | (1U << 5U))
+#define ZSI_GET_ACK_WINDOW(ackFrame) \
+  (1U << (((ackFrame)->frameControl & ZSI_WINDOW_FIELD_MASK) >> ZSI_WINDOW_FIELD_POS))
 
 /* Command is a syncronous request, one which requires immediate response.
    For example function wich returnes int value.*/
@@ -83,6 +101,8 @@
   (((ackFrame)->frameControl & ZSI_STATUS_FIELD_MASK) == ZSI_INVALID_FCS_STATUS)
 #define IS_OVERFLOW_STATUS(ackFrame) \
   (((ackFrame)->frameControl & ZSI_STATUS_FIELD_MASK) == ZSI_OVERFLOW_STATUS)
+#define IS_CRC_FCS_CMD_FRAME(cmdFrame) \
+  (!IS_ACK_CMD_FRAME(cmdFrame) && ((cmdFrame)->frameControl & ZSI_CRC_FCS_FLAG))
 
 /* ZAppSI command domains. */
 #define ZSI_CMD_SYS 0x00U
@@ -95,6 +115,13 @@
 #define ZSI_CMD_SEC 0x07U
 #define ZSI_CMD_KE  0x08U
 #define ZSI_CMD_BSP 0x09U
+/* Several AREQs packed to a single frame. The payload is a sequence of
+   records, each keeps payload length, sequence number, domain, command ID
+   and payload of a packed command. */
+#define ZSI_CMD_BATCH 0x0AU
+#define ZSI_BATCH_RECORD_HEADER_SIZE 4U
+#define IS_BATCH_CMD_FRAME(cmdFrame) \
+  (IS_AREQ_CMD_FRAME(cmdFrame) && (ZSI_CMD_BATCH == (cmdFrame)->commandHeader.domain))
 
 /*****************************************************************************
                               Types section
@@ -126,7 +153,7 @@ typedef struct PACK _ZsiCommandFrame_t
   /* Frame payload. */
   uint8_t                   payload[ZSI_MAX_FRAME_PAYLOAD];
   /* Frame check sequence. Only for marking purposes, direct access denied. */
-  uint8_t                   fcs;
+  uint8_t                   fcs[ZSI_CRC_FCS_SIZE];
 } ZsiCommandFrame_t;
 
 /* ZAppSI ACK frame format. */
@@ -33,12 +33,22 @@
 /******************************************************************************
                               Defines section
 ******************************************************************************/
+/* Amount of buffers reserved for SREQ/SRSP processing in addition to
+   ZSI_SYNC0/1 ones. Allows to keep several SREQs in flight. */
+#ifndef ZSI_SREQ_POOL_SIZE
+  #ifdef BOARD_PC
+    #define ZSI_SREQ_POOL_SIZE 2U
+  #else
+    #define ZSI_SREQ_POOL_SIZE 0U
+  #endif
+#endif
+
 #ifndef BOARD_PC
-#define ZSI_MEMORY_BUFFERS_AMOUNT 6U
+#define ZSI_MEMORY_BUFFERS_AMOUNT (6U + ZSI_SREQ_POOL_SIZE)
 #else
 #define ZSI_MEMORY_BUFFERS_AMOUNT 128U
 #endif
-#if ZSI_MEMORY_BUFFERS_AMOUNT < 6U
+#if ZSI_MEMORY_BUFFERS_AMOUNT < (6U + ZSI_SREQ_POOL_SIZE)
 #error "Not enough ZAppSI memory buffers: 6 or more required! "
 #endif
 
@@ -46,7 +56,47 @@
 #define ZSI_SYNC0_RESERVED_MEMORY_BUFFER 0U
 #define ZSI_SYNC1_RESERVED_MEMORY_BUFFER 1U
 /* Mutual memory buffers start index */
-#define ZSI_MUTUAL_MEMORY_BUFFERS_START  2U
+#define ZSI_MUTUAL_MEMORY_BUFFERS_START  (2U + ZSI_SREQ_POOL_SIZE)
+#define ZSI_MUTUAL_MEMORY_BUFFERS_AMOUNT \
+  (ZSI_MEMORY_BUFFERS_AMOUNT - ZSI_MUTUAL_MEMORY_BUFFERS_START)
+
+/* Buffers for received frames of up to ZSI_SMALL_MEMORY_BUFFER_SIZE bytes,
+   so short commands don't occupy buffers sized for the longest primitive.
+   Frames are put to mutual buffers when all small ones are busy. */
+#ifndef ZSI_SMALL_MEMORY_BUFFERS_AMOUNT
+  #ifdef BOARD_PC
+    #define ZSI_SMALL_MEMORY_BUFFERS_AMOUNT 32U
+  #else
+    #define ZSI_SMALL_MEMORY_BUFFERS_AMOUNT 0U
+  #endif
+#endif
+#ifndef ZSI_SMALL_MEMORY_BUFFER_SIZE
+  #define ZSI_SMALL_MEMORY_BUFFER_SIZE 48U
+#endif
+
+/* Amount of received AREQs of a single domain, which may occupy memory at the
+   same time. The rest of memory is kept for other domains, so e.g. a burst
+   of APS data indications doesn't block ZDO commands. AREQs above the quota
+   are rejected with overflow status. */
+#define ZSI_RX_MEMORY_BUFFERS_AMOUNT \
+  (ZSI_MUTUAL_MEMORY_BUFFERS_AMOUNT + ZSI_SMALL_MEMORY_BUFFERS_AMOUNT)
+#ifndef ZSI_DEFAULT_MEMORY_QUOTA
+  #define ZSI_DEFAULT_MEMORY_QUOTA \
+    (ZSI_RX_MEMORY_BUFFERS_AMOUNT - ZSI_RX_MEMORY_BUFFERS_AMOUNT / 4U)
+#endif
+#ifndef ZSI_APS_MEMORY_QUOTA
+  #define ZSI_APS_MEMORY_QUOTA ZSI_DEFAULT_MEMORY_QUOTA
+#endif
+/* ZDO and ZDP domains */
+#ifndef ZSI_ZDO_MEMORY_QUOTA
+  #define ZSI_ZDO_MEMORY_QUOTA ZSI_DEFAULT_MEMORY_QUOTA
+#endif
+#ifndef ZSI_NWK_MEMORY_QUOTA
+  #define ZSI_NWK_MEMORY_QUOTA ZSI_DEFAULT_MEMORY_QUOTA
+#endif
+#define ZSI_MEMORY_DOMAINS_AMOUNT (ZSI_CMD_BATCH + 1U)
+/* Buffer isn't counted against any domain quota */
+#define ZSI_NO_MEMORY_DOMAIN 0xFFU
 /* Mutual memory marker */
 #define ZSI_MUTUAL_MEMORY 0x2AU
 #define ZSI_RX_ACK_MEMORY 0x2BU
@@ -55,10 +105,55 @@
 /******************************************************************************
                               Types section
 ******************************************************************************/
+/* Memory buffer classes */
+typedef enum _ZsiMemoryClass_t
+{
+  /* Buffers reserved for SREQ/SRSP processing */
+  ZSI_SYNC_MEMORY_CLASS,
+  /* Mutual buffers */
+  ZSI_LARGE_MEMORY_CLASS,
+  /* Buffers for short received frames */
+  ZSI_SMALL_MEMORY_CLASS,
+  ZSI_MEMORY_CLASSES_AMOUNT
+} ZsiMemoryClass_t;
+
+typedef struct _ZsiMemoryClassStats_t
+{
+  /* Amount of buffers of the class */
+  uint8_t total;
+  /* Amount of currently allocated buffers */
+  uint8_t used;
+  /* The largest amount of buffers allocated at the same time */
+  uint8_t highWaterMark;
+} ZsiMemoryClassStats_t;
+
+/* Memory usage statistics, cleared on memory manager reset */
+typedef struct _ZsiMemoryStats_t
+{
+  ZsiMemoryClassStats_t classes[ZSI_MEMORY_CLASSES_AMOUNT];
+  /* The largest amount of received AREQs of each domain kept at the same time */
+  uint8_t               domainHighWaterMarks[ZSI_MEMORY_DOMAINS_AMOUNT];
+  /* Allocations failed because there was no free buffer */
+  uint16_t              allocationFailures;
+  /* Received AREQs rejected because of domain quota */
+  uint16_t              quotaRejections;
+} ZsiMemoryStats_t;
+
+/* Alignment of the memory kept by buffers of all classes */
+typedef union _ZsiMemoryAlignment_t
+{
+  void     *pointer;
+  uint32_t u32;
+  uint64_t u64;
+} ZsiMemoryAlignment_t;
+
 typedef struct _ZsiMemoryBuffer_t
 {
-  QueueElement_t next;
+  /* Links buffer to queues when it is busy and to free list otherwise */
+  LinkedQueueElement_t next;
   bool busy;
+  /* Domain which quota the buffer is counted against */
+  uint8_t domain;
   TOP_GUARD
   union
   {
@@ -74,10 +169,28 @@ typedef struct _ZsiMemoryBuffer_t
     ZsiEccKeyBitGenerate_t          zsiEccKeyBitGenerate;
     ZsiEccGenerateKey_t             zsiEccGenerateKey;
 #endif    
+    ZsiMemoryAlignment_t            alignment;
   };
   BOTTOM_GUARD
 } ZsiMemoryBuffer_t;
 
+/* Small buffer has the same layout as ZsiMemoryBuffer_t, so frames kept in
+   both are accessed in the same way */
+typedef struct _ZsiSmallMemoryBuffer_t
+{
+  LinkedQueueElement_t next;
+  bool busy;
+  uint8_t domain;
+  TOP_GUARD
+  union
+  {
+    uint8_t                         memory;
+    uint8_t                         frame[ZSI_SMALL_MEMORY_BUFFER_SIZE];
+    ZsiMemoryAlignment_t            alignment;
+  };
+  BOTTOM_GUARD
+} ZsiSmallMemoryBuffer_t;
+
 typedef struct _ZsiMemoryPool_t
 {
   TOP_GUARD
@@ -85,11 +198,19 @@ typedef struct _ZsiMemoryPool_t
   ZsiAckFrame_t     ackRxFrame;
   BOTTOM_GUARD
   ZsiMemoryBuffer_t buffers[ZSI_MEMORY_BUFFERS_AMOUNT];
+#if ZSI_SMALL_MEMORY_BUFFERS_AMOUNT > 0U
+  ZsiSmallMemoryBuffer_t smallBuffers[ZSI_SMALL_MEMORY_BUFFERS_AMOUNT];
+#endif
 } ZsiMemoryPool_t;
 
 typedef struct _ZsiMemoryManager_t
 {
-  ZsiMemoryPool_t memoryPool;
+  ZsiMemoryPool_t      memoryPool;
+  /* Free buffers of each class */
+  LinkedQueueElement_t *freeLists[ZSI_MEMORY_CLASSES_AMOUNT];
+  /* Amount of received AREQs of each domain kept in memory */
+  uint8_t              domainUsed[ZSI_MEMORY_DOMAINS_AMOUNT];
+  ZsiMemoryStats_t     stats;
 } ZsiMemoryManager_t;
 
 /******************************************************************************
@@ -101,12 +222,37 @@ typedef struct _ZsiMemoryManager_t
 void zsiResetMemoryManager(void);
 
 /******************************************************************************
-  \brief Allocates memory for ZAppSI frames and BitCloud primitives.
+  \brief Allocates memory for ZAppSI frames and BitCloud primitives. SREQ and
+         SRSP memory is taken from reserved buffers first and from mutual
+         ones, if all reserved buffers are busy.
 
-  \return Pointer to memory.
+  \return Pointer to memory, NULL if there is no free buffer.
  ******************************************************************************/
 void *zsiAllocateMemory(uint8_t memoryType);
 
+/******************************************************************************
+  \brief Allocates memory for the frame being received. Frames, which fit,
+         are put to small buffers, except SREQs which memory is reused for
+         SRSP. Other frames are allocated as by zsiAllocateMemory().
+
+  \param[in] memoryType - memory type as for zsiAllocateMemory().
+  \param[in] frameSize - size of the whole frame.
+
+  \return Pointer to memory, NULL if there is no free buffer.
+ ******************************************************************************/
+void *zsiAllocateFrameMemory(uint8_t memoryType, uint16_t frameSize);
+
+/******************************************************************************
+  \brief Counts memory keeping received AREQ against its domain quota.
+         Buffer is released from the quota when it is freed.
+
+  \param[in] memory - memory keeping the frame.
+  \param[in] domain - command domain of the frame.
+
+  \return True, if domain quota allows to keep the frame, false - otherwise.
+ ******************************************************************************/
+bool zsiChargeMemoryQuota(const void *const memory, uint8_t domain);
+
 /******************************************************************************
   \brief Free memory allocated for ZAppSI command frames and BitCloud
          primitives.
@@ -124,5 +270,35 @@ void zsiFreeMemory(const void *const memory);
  ******************************************************************************/
 bool zsiIsMemoryAvailable(void);
 
+/******************************************************************************
+  \brief Returns amount of free buffers, which could receive frames.
+
+  \return Amount of free mutual and small buffers.
+ ******************************************************************************/
+uint8_t zsiFreeRxMemoryAmount(void);
+
+/******************************************************************************
+  \brief Returns memory usage statistics of the local device.
+
+  \param[out] stats - statistics.
+
+  \return None.
+ ******************************************************************************/
+void zsiGetMemoryStats(ZsiMemoryStats_t *const stats);
+
+#ifdef ZAPPSI_HOST
+/**************************************************************************//**
+  \brief Returns memory usage statistics of the host and the network processor.
+
+  \param[out] localStats - host's statistics, may be NULL.
+  \param[out] remoteStats - network processor's statistics, may be NULL.
+                            Requested synchronously.
+
+  \return None.
+ ******************************************************************************/
+void ZSI_GetMemoryStats(ZsiMemoryStats_t *const localStats,
+  ZsiMemoryStats_t *const remoteStats);
+#endif /* ZAPPSI_HOST */
+
 #endif /* _ZSIMEMORYMANAGER_H */
 /* eof zsiMemoryManager.h */
@@ -30,7 +30,43 @@
 /******************************************************************************
                               Defines section
 ******************************************************************************/
-#define ZSI_MEDIUM_RX_BUFFER_LENGTH sizeof(ZsiCommandFrame_t)
+/* Size of medium cyclic receive buffer. The host reads serial port in big
+   blocks, so the buffer is larger there. */
+#ifdef BOARD_PC
+  #define ZSI_MEDIUM_RX_BUFFER_LENGTH 4096U
+#else
+  #define ZSI_MEDIUM_RX_BUFFER_LENGTH sizeof(ZsiCommandFrame_t)
+#endif
+
+/* Maximum amount of AREQ and SRSP frames which may stay unacknowledged on the
+   link. It is advertised to the remote device in ACK frames, the actual window
+   is the smaller of the local and the remote values. 1 keeps the link in
+   stop-and-wait mode. */
+#ifndef ZSI_SERIAL_WINDOW_SIZE
+  #ifdef BOARD_PC
+    #define ZSI_SERIAL_WINDOW_SIZE 8U
+  #else
+    #define ZSI_SERIAL_WINDOW_SIZE 4U
+  #endif
+#endif
+#if (ZSI_SERIAL_WINDOW_SIZE != 1U) && (ZSI_SERIAL_WINDOW_SIZE != 2U) && \
+    (ZSI_SERIAL_WINDOW_SIZE != 4U) && (ZSI_SERIAL_WINDOW_SIZE != 8U)
+  #error "ZSI_SERIAL_WINDOW_SIZE should be 1, 2, 4 or 8"
+#endif
+
+/* AREQs waiting for the medium are packed to a single batch frame, which is
+   acknowledged once, if remote device accepts batch frames. 0 disables
+   batching and its advertisement in ACK frames. */
+#ifndef ZSI_SERIAL_BATCHING
+  #define ZSI_SERIAL_BATCHING 1
+#endif
+
+/* Command frames are protected by CRC-16 instead of XOR FCS, if remote device
+   verifies CRC-16. 0 keeps XOR FCS in both directions, though received CRC-16
+   frames are verified anyway. */
+#ifndef ZSI_SERIAL_CRC_FCS
+  #define ZSI_SERIAL_CRC_FCS 1
+#endif
                               
 /* Collision types to be resolved. */
 #define ZSI_NO_COLLISIONS 0U
@@ -67,7 +103,6 @@ typedef enum _ZsiSerialState_t
   ZSI_SERIAL_STATE_IDLE               = 0x01,
   ZSI_SERIAL_STATE_SENDING            = 0x02,
   ZSI_SERIAL_STATE_WAITING_ACK        = 0x03,
-  ZSI_SERIAL_STATE_WAITING_SRSP       = 0x04,
   ZSI_SERIAL_STATE_OVERFLOW_RESOLVING = 0x05
 } ZsiSerialState_t;
 
@@ -77,16 +112,74 @@ typedef struct _ZsiSerialSynchroModeTimer_t
   bool     started;
 } ZsiSerialSynchroModeTimer_t;
 
+/* Frame transmitted in windowed mode and waiting for its own ACK */
+typedef struct _ZsiSerialWindowSlot_t
+{
+  ZsiCommandFrame_t *frame;
+  BcTime_t          ackDeadline;
+  uint8_t           ackRetries;
+  uint8_t           flags;
+} ZsiSerialWindowSlot_t;
+
+/* ACK postponed in windowed mode until the medium is free */
+typedef struct _ZsiSerialPendingAck_t
+{
+  uint8_t status;
+  uint8_t sequenceNumber;
+} ZsiSerialPendingAck_t;
+
+typedef struct _ZsiSerialWindow_t
+{
+  /* Negotiated window size, 0 or 1 means stop-and-wait mode */
+  uint8_t               size;
+  /* Window size advertised by the remote device */
+  uint8_t               remoteSize;
+  uint8_t               used;
+  uint8_t               pendingAckHead;
+  uint8_t               pendingAcksAmount;
+  ZsiSerialWindowSlot_t slots[ZSI_SERIAL_WINDOW_SIZE];
+  ZsiSerialPendingAck_t pendingAcks[ZSI_SERIAL_WINDOW_SIZE];
+  HAL_AppTimer_t        timer;
+} ZsiSerialWindow_t;
+
+/* Link errors counters, cleared on serial controller reset */
+typedef struct _ZsiLinkStats_t
+{
+  /* Frames received with invalid FCS */
+  uint32_t fcsFailures;
+  /* Frames rejected because of lack of memory */
+  uint32_t overflowAcksSent;
+  /* Frames rejected by remote device because of lack of memory */
+  uint32_t overflowAcksReceived;
+  /* Frames sent again after an error or ACK timeout */
+  uint32_t retransmissions;
+} ZsiLinkStats_t;
+
+/* Running FCS of the frame being received by medium adapter */
+typedef struct _ZsiRxFcs_t
+{
+  uint16_t value;
+  bool     crc;
+} ZsiRxFcs_t;
+
 typedef struct _ZsiSerialController_t
 {
   ZsiSerialState_t            state;
   uint8_t                     collisionStatus;
   uint8_t                     ackRetries;
   void                        *currentTransmission;
+  /* Frame currently passed to the medium, NULL if medium is free */
+  void                        *mediumFrame;
+  /* Remote device accepts batch frames */
+  bool                        remoteBatching;
+  /* Remote device verifies CRC-16 FCS */
+  bool                        remoteCrcFcs;
   HAL_AppTimer_t              ackWaitTimer;
   HAL_AppTimer_t              overflowTimer;
   ZsiSerialSynchroModeTimer_t synchroModeTimer;
-  QueueDescriptor_t           txQueue;
+  LinkedQueueDescriptor_t     txQueue;
+  ZsiSerialWindow_t           window;
+  ZsiLinkStats_t              stats;
 } ZsiSerialController_t;
 
 /******************************************************************************
@@ -118,6 +211,13 @@ void zsiSerialTaskHandler(void);
  ******************************************************************************/
 bool zsiSerialIsBusy(void);
 
+/******************************************************************************
+  \brief Checks if frames are transmitted in windowed mode.
+
+  \return True, if windowed mode was negotiated, false - for stop-and-wait.
+ ******************************************************************************/
+bool zsiSerialIsWindowed(void);
+
 /******************************************************************************
   \brief Send frame to ZAppSI serial controller for further transmisson.
 
@@ -148,8 +248,11 @@ int zsiMediumInit(void);
 /******************************************************************************
   \brief Indication of new frame received from remote device.
 
-  \param[in] status - reception status:
-                      ZSI_NO_ERROR_STATUS or ZSI_OVERFLOW_STATUS.
+  \param[in] status - reception status: ZSI_NO_ERROR_STATUS,
+                      ZSI_OVERFLOW_STATUS or ZSI_INVALID_FCS_STATUS.
+                      FCS is verified by medium adapter with zsiRxFcsStart(),
+                      zsiRxFcsUpdate() and zsiRxFcsIsValid() while frame is
+                      being received.
   \param[in] sequenceNumber - sequnece number associated with frame.
   \param[in] frame - pointer to received frame.
 
@@ -157,6 +260,51 @@ int zsiMediumInit(void);
  ******************************************************************************/
 void zsiMediumReceive(uint8_t status, uint8_t sequenceNumber, void *const frame);
 
+/******************************************************************************
+  \brief Starts FCS calculation of the frame being received. Frame control
+         field determines FCS type, so calculation starts after it is received.
+
+  \param[out] fcs - running FCS of the frame.
+  \param[in] frameControl - frame control field of the frame.
+
+  \return None.
+ ******************************************************************************/
+void zsiRxFcsStart(ZsiRxFcs_t *const fcs, uint8_t frameControl);
+
+/******************************************************************************
+  \brief Updates FCS of the frame being received by the next received bytes.
+         All bytes following frame control field, including FCS field, should
+         be passed.
+
+  \param[in, out] fcs - running FCS of the frame.
+  \param[in] data - received bytes.
+  \param[in] length - amount of received bytes.
+
+  \return None.
+ ******************************************************************************/
+void zsiRxFcsUpdate(ZsiRxFcs_t *const fcs, const uint8_t *data, uint16_t length);
+
+/******************************************************************************
+  \brief Checks FCS of completely received frame.
+
+  \param[in] fcs - running FCS of the frame.
+
+  \return True, if frame received with no errors, false - otherwise.
+ ******************************************************************************/
+INLINE bool zsiRxFcsIsValid(const ZsiRxFcs_t *const fcs)
+{
+  return 0U == fcs->value;
+}
+
+/******************************************************************************
+  \brief Returns link errors counters of the local device.
+
+  \param[out] stats - counters.
+
+  \return None.
+ ******************************************************************************/
+void zsiSerialGetLinkStats(ZsiLinkStats_t *const stats);
+
 /******************************************************************************
   \brief Callback for medium transmission finished.
 
@@ -26,10 +26,31 @@
 #include <configServer.h>
 #include <zsiFrames.h>
 #include <zsiDriver.h>
+#include <zsiSerialController.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+/* Maximum amount of parameters IDs in single changes indication */
+#define ZSI_CS_CHANGED_PARAMETERS_MAX_AMOUNT 16U
+/* Indication amount value meaning that all parameters should be considered
+   as changed */
+#define ZSI_CS_ALL_PARAMETERS_CHANGED 0xFFU
 
 /******************************************************************************
                     Types section
 ******************************************************************************/
+/* Network processor's parameters changes indication */
+typedef struct _ZsiCsParametersChangedInd_t
+{
+  ZsiEntityService_t service;
+  /* Indication is queued for transmission */
+  bool               pending;
+  /* Amount of changed parameters or ZSI_CS_ALL_PARAMETERS_CHANGED */
+  uint8_t            amount;
+  CS_MemoryItemId_t  parameterIds[ZSI_CS_CHANGED_PARAMETERS_MAX_AMOUNT];
+} ZsiCsParametersChangedInd_t;
+
 typedef struct _ZsiCsParameter_t
 {
   CS_MemoryItemId_t parameterId;
@@ -49,7 +70,85 @@ typedef struct _ZsiCsParameter_t
  ******************************************************************************/
 ZsiProcessingRoutine_t zsiSysFindProcessingRoutine(uint8_t commandId);
 
+#ifdef ZAPPSI_NP
+/**************************************************************************//**
+  \brief Reports changes of parameters to the host. Called before commands,
+         which may depend on the changed parameters, are sent to the host.
+
+  \return None.
+ ******************************************************************************/
+void zsiSysReportParametersChanges(void);
+
+/**************************************************************************//**
+  \brief Notifies that the host has accessed network processor's parameter.
+         Changes of parameters are tracked since the first access.
+
+  \param[in] parameterId - ID of the accessed parameter.
+  \param[in] written - true if the host has written the parameter.
+
+  \return None.
+ ******************************************************************************/
+void zsiSysParameterAccessed(CS_MemoryItemId_t parameterId, bool written);
+#endif /* ZAPPSI_NP */
+
 #ifdef ZAPPSI_HOST
+/**************************************************************************//**
+  \brief Returns link errors counters of the host and the network processor.
+
+  \param[out] localStats - host's counters, may be NULL.
+  \param[out] remoteStats - network processor's counters, may be NULL.
+                            Requested synchronously.
+
+  \return None.
+ ******************************************************************************/
+void ZSI_GetLinkStats(ZsiLinkStats_t *const localStats,
+  ZsiLinkStats_t *const remoteStats);
+
+/**************************************************************************//**
+  \brief Link errors counters request serialization routine.
+
+  \param[in] req - request parameters, unused.
+  \param[out] cmdFrame - frame, which keeps serialized data.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiSerializeZSI_GetLinkStatsReq(const void *const req,
+  ZsiCommandFrame_t *const cmdFrame);
+
+/**************************************************************************//**
+  \brief Link errors counters confirm deserialization and processing routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetLinkStatsConf(void *memory,
+  ZsiCommandFrame_t *const cmdFrame);
+
+/**************************************************************************//**
+  \brief Memory usage statistics request serialization routine.
+
+  \param[in] req - request parameters, unused.
+  \param[out] cmdFrame - frame, which keeps serialized data.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiSerializeZSI_GetMemoryStatsReq(const void *const req,
+  ZsiCommandFrame_t *const cmdFrame);
+
+/**************************************************************************//**
+  \brief Memory usage statistics confirm deserialization and processing
+         routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetMemoryStatsConf(void *memory,
+  ZsiCommandFrame_t *const cmdFrame);
+
 /**************************************************************************//**
   \brief CS_ReadParameter request primitive serialization routine.
 
@@ -129,6 +228,18 @@ ZsiProcessingResult_t zsiDeserializeCS_WriteParameterConf(void *memory,
 ZsiProcessingResult_t zsiDeserializeCS_ReadParameterConf(void *memory,
   ZsiCommandFrame_t *const cmdFrame);
 
+/**************************************************************************//**
+  \brief Parameters changes indication deserialization and processing
+         routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+    \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeCS_ParametersChangedInd(void *memory,
+  ZsiCommandFrame_t *const cmdFrame);
+
 #elif defined(ZAPPSI_NP)
 ;/**************************************************************************//**
   \brief CS_ReadParameter request primitive deserialization and processing
@@ -186,15 +297,90 @@ zsiCS_WriteParameterConfLength(const void *const conf)
   return ZSI_COMMAND_FRAME_OVERHEAD;
 }
 
+/**************************************************************************//**
+  \brief Parameters changes indication frame size calculation routine.
+         SOF and LENGTH fields are dismissed.
+
+  \param[in] ind - indication parameters.
+
+  \return Parameters changes indication frame size.
+ ******************************************************************************/
+INLINE uint16_t
+zsiCS_ParametersChangedIndLength(const ZsiCsParametersChangedInd_t *const ind)
+{
+  return ZSI_COMMAND_FRAME_OVERHEAD +
+         sizeof(uint8_t) + /* amount */
+         ((ZSI_CS_ALL_PARAMETERS_CHANGED == ind->amount) ?
+           0U : ind->amount * sizeof(uint16_t)); /* parameterIds */
+}
+
+/**************************************************************************//**
+  \brief Parameters changes indication serialization routine.
+
+  \param[in] ind - indication parameters.
+  \param[out] cmdFrame - frame, which keeps serialized data.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiSerializeCS_ParametersChangedInd(const void *const ind,
+  ZsiCommandFrame_t *const cmdFrame);
+
+/**************************************************************************//**
+  \brief Link errors counters request deserialization and processing routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetLinkStatsReq(void *memory,
+  ZsiCommandFrame_t *const cmdFrame);
+
+/**************************************************************************//**
+  \brief Memory usage statistics request deserialization and processing
+         routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetMemoryStatsReq(void *memory,
+  ZsiCommandFrame_t *const cmdFrame);
+
+/**************************************************************************//**
+  \brief Link errors counters confirm frame size calculation routine.
+         SOF and LENGTH fields are dismissed.
+
+  \param[in] conf - confirm parameters.
+
+  \return Link errors counters confirm frame size.
+ ******************************************************************************/
+INLINE uint16_t
+zsiZSI_GetLinkStatsConfLength(const ZsiLinkStats_t *const conf)
+{
+  (void)conf;
+  return ZSI_COMMAND_FRAME_OVERHEAD +
+         sizeof(uint32_t) + /* fcsFailures */
+         sizeof(uint32_t) + /* overflowAcksSent */
+         sizeof(uint32_t) + /* overflowAcksReceived */
+         sizeof(uint32_t);  /* retransmissions */
+}
+
 #endif /* ZAPPSI_NP */
 
 #ifdef ZAPPSI_HOST
 #define zsiDeserializeCS_WriteParameterReq NULL
 #define zsiDeserializeCS_ReadParameterReq  NULL
+#define zsiDeserializeZSI_GetLinkStatsReq  NULL
+#define zsiDeserializeZSI_GetMemoryStatsReq NULL
 
 #elif defined(ZAPPSI_NP)
 #define zsiDeserializeCS_WriteParameterConf NULL
 #define zsiDeserializeCS_ReadParameterConf  NULL
+#define zsiDeserializeCS_ParametersChangedInd NULL
+#define zsiDeserializeZSI_GetLinkStatsConf NULL
+#define zsiDeserializeZSI_GetMemoryStatsConf NULL
 
 #endif /* ZAPPSI_NP */
 
@@ -0,0 +1,123 @@
+/**************************************************************************//**
+  \file zsiTrafficLog.h
+
+  \brief ZAppSI link traffic recorder and replay interface.
+         Frames passed to zsiMediumSend() and indicated by zsiMediumReceive()
+         are written to a binary log, which is replayed by the replay medium
+         adapter against a host build without a network processor.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+   History:
+    2026-10-17  Created.
+ ******************************************************************************/
+
+#ifndef _ZSITRAFFICLOG_H
+#define _ZSITRAFFICLOG_H
+
+/*****************************************************************************
+                              Includes section
+******************************************************************************/
+#include <sysTypes.h>
+
+/******************************************************************************
+                              Defines section
+******************************************************************************/
+/* 1 - frames passing the medium are recorded to ZSI_TRAFFIC_LOG_FILE. */
+#ifndef ZSI_TRAFFIC_RECORDER
+  #define ZSI_TRAFFIC_RECORDER 0
+#endif
+
+/* Replay medium adapter takes place of the USART one and plays the role of
+   network processor, reading its frames from ZSI_TRAFFIC_REPLAY_FILE. */
+#define ZSI_TRAFFIC_REPLAY_DISABLED         0
+/* Network processor's frames are passed to the host as fast as possible */
+#define ZSI_TRAFFIC_REPLAY_FAST             1
+/* Network processor's frames keep intervals they were recorded with */
+#define ZSI_TRAFFIC_REPLAY_ORIGINAL_TIMING  2
+
+#ifndef ZSI_TRAFFIC_REPLAY
+  #define ZSI_TRAFFIC_REPLAY ZSI_TRAFFIC_REPLAY_DISABLED
+#endif
+
+#if ((ZSI_TRAFFIC_RECORDER == 1) || (ZSI_TRAFFIC_REPLAY != ZSI_TRAFFIC_REPLAY_DISABLED)) && \
+    !(defined(BOARD_PC) && defined(LINUX))
+  #error "ZAppSI traffic recorder and replay are supported on Linux host only"
+#endif
+
+#ifndef ZSI_TRAFFIC_LOG_FILE
+  #define ZSI_TRAFFIC_LOG_FILE "zsiTraffic.log"
+#endif
+
+#ifndef ZSI_TRAFFIC_REPLAY_FILE
+  #define ZSI_TRAFFIC_REPLAY_FILE ZSI_TRAFFIC_LOG_FILE
+#endif
+
+/* Log starts with magic and version bytes followed by records. Each record
+   is ZsiTrafficRecord_t header followed by the frame bytes. */
+#define ZSI_TRAFFIC_LOG_MAGIC       "ZSIT"
+#define ZSI_TRAFFIC_LOG_MAGIC_SIZE  4U
+#define ZSI_TRAFFIC_LOG_VERSION     1U
+
+/* Record flags: bit 7 is set for frames received from the remote device,
+   bits 0-1 keep reception status passed to zsiMediumReceive(). */
+#define ZSI_TRAFFIC_RECEIVED_FLAG   (1U << 7U)
+#define ZSI_TRAFFIC_STATUS_MASK     ((1U << 0U) | (1U << 1U))
+
+/******************************************************************************
+                              Types section
+******************************************************************************/
+BEGIN_PACK
+typedef struct PACK _ZsiTrafficRecord_t
+{
+  /* Microseconds since the previous record, little-endian */
+  uint32_t delta;
+  /* ZSI_TRAFFIC_RECEIVED_FLAG and reception status */
+  uint8_t  flags;
+  /* Sequence number as indicated by zsiMediumReceive() or of the sent frame */
+  uint8_t  sequenceNumber;
+  /* Amount of frame bytes following the record, little-endian. Frames
+     received with overflow status have no bytes. */
+  uint16_t length;
+} ZsiTrafficRecord_t;
+END_PACK
+
+/******************************************************************************
+                             Prototypes section
+ ******************************************************************************/
+/******************************************************************************
+  \brief Returns monotonic time used to timestamp log records.
+
+  \return Time in microseconds.
+ ******************************************************************************/
+uint64_t zsiTrafficTime(void);
+
+#if ZSI_TRAFFIC_RECORDER == 1
+/******************************************************************************
+  \brief Writes frame passing the medium to the traffic log. The log file is
+         created on the first call.
+
+  \param[in] flags - ZSI_TRAFFIC_RECEIVED_FLAG and reception status.
+  \param[in] sequenceNumber - sequence number of the frame.
+  \param[in] frame - frame, NULL if it was not received because of overflow.
+  \param[in] length - frame size.
+
+  \return None.
+ ******************************************************************************/
+void zsiTrafficRecord(uint8_t flags, uint8_t sequenceNumber,
+  const void *const frame, uint16_t length);
+
+  #define ZSI_TRAFFIC_RECORD(flags, sequenceNumber, frame, length) \
+    zsiTrafficRecord(flags, sequenceNumber, frame, length)
+#else
+  #define ZSI_TRAFFIC_RECORD(flags, sequenceNumber, frame, length) {}
+#endif /* ZSI_TRAFFIC_RECORDER == 1 */
+
+#endif /* _ZSITRAFFICLOG_H */
+/* eof zsiTrafficLog.h */
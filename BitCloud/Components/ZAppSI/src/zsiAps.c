@@ -23,6 +23,7 @@
 #include <apsdeEndpoint.h>
 #include <zsiApsSerialization.h>
 #include <zsiDriver.h>
+#include <zsiMemoryManager.h>
 #include <zsiDbg.h>
 #include <sysQueue.h>
 
@@ -70,6 +71,8 @@ static PROGMEM_DECLARE(ZsiProcessingRoutine_t zsiApsProcessingRoutines[]) =
 /* Queue of registered endpoints */
 static ApsBindingEntry_t nextEntry;
 static DECLARE_QUEUE(apsEndpointsQueue);
+/* Indication being delivered is kept by its receiver */
+static bool apsDataIndKept;
 #ifdef _LINK_SECURITY_
 static uint8_t zsiLinkKey[SECURITY_KEY_SIZE];
 static ExtAddr_t zsiDeviceAddr;
@@ -132,6 +135,48 @@ void zsiApsclearEndPointQueue(void)
 {
   resetQueue(&apsEndpointsQueue);
 }
+
+/**************************************************************************//**
+  \brief Checks if receiver of the delivered indication keeps it, and clears
+         the mark.
+
+  \return True, if indication and its command frame shall not be freed.
+ ******************************************************************************/
+bool zsiApsIsDataIndKept(void)
+{
+  bool kept = apsDataIndKept;
+
+  apsDataIndKept = false;
+  return kept;
+}
+
+/**************************************************************************//**
+  \brief Keeps the indication being delivered after the indication callback
+         returns.
+
+  \param[in] ind - indication passed to the APS_DataInd callback.
+
+  \return None.
+ ******************************************************************************/
+void APS_KeepDataInd(APS_DataInd_t *ind)
+{
+  (void)ind;
+  apsDataIndKept = true;
+}
+
+/**************************************************************************//**
+  \brief Releases the indication kept by APS_KeepDataInd().
+
+  \param[in] ind - kept indication.
+
+  \return None.
+ ******************************************************************************/
+void APS_ReleaseDataInd(APS_DataInd_t *ind)
+{
+  /* asdu points to the payload of the received command frame */
+  zsiFreeMemory(ind->asdu);
+  zsiFreeMemory(ind);
+}
 /**************************************************************************//**
   \brief New endpoint registration wrapper routine.
 
@@ -142,8 +187,9 @@ void zsiApsclearEndPointQueue(void)
  ******************************************************************************/
 void APS_RegisterEndpointReq(APS_RegisterEndpointReq_t *const req)
 {
-  zsiProcessCommand(ZSI_SREQ_CMD, req, zsiSerializeAPS_RegisterEndpointReq,
-                    &req->status);
+  if (!zsiProcessCommand(ZSI_SREQ_CMD, req, zsiSerializeAPS_RegisterEndpointReq,
+                         &req->status))
+    req->status = APS_INVALID_PARAMETER_STATUS;
 
   if (APS_SUCCESS_STATUS == req->status)
   {
@@ -429,7 +475,7 @@ void APS_SetDefaultKeyPairStatus(APS_KeyPairFlags_t flag)
  ******************************************************************************/
 bool APS_AreKeysAuthorized(const ExtAddr_t *const deviceAddress)
 {
-  bool result;
+  bool result = false;
 
   zsiProcessCommand(ZSI_SREQ_CMD, (void *const)deviceAddress, zsiSerializeAPS_AreKeysAuthorizedReq, &result);
 
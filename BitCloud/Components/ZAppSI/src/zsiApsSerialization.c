@@ -247,6 +247,14 @@ ZsiProcessingResult_t zsiDeserializeAPS_DataInd(void *memory,
   {
     descriptor->APS_DataInd(indication);
   }
+#ifdef ZAPPSI_HOST
+  /* Receiver releases indication with APS_ReleaseDataInd() */
+  if (zsiApsIsDataIndKept())
+  {
+    result.keepMemory = true;
+    result.keepCmdFrame = true;
+  }
+#endif /* ZAPPSI_HOST */
 
   return result;
 }
@@ -24,6 +24,7 @@
 #include <zsiMem.h>
 #include <zsiDbg.h>
 #include <zsiMemoryManager.h>
+#include <zsiSysSerialization.h>
 #include <zsiZdoSerialization.h>
 #include <zsiZdpSerialization.h>
 #include <zsiApsSerialization.h>
@@ -41,6 +42,12 @@
 #define zsiKeFindProcessingRoutine    NULL
 #endif
 
+#if CERTICOM_SUPPORT == 1
+#define ZSI_SRSP_WAIT_PERIOD 10000UL /* 10 seconds */
+#else
+#define ZSI_SRSP_WAIT_PERIOD 2000UL /* 2 seconds */
+#endif
+
 /******************************************************************************
                    External global variables section
 ******************************************************************************/
@@ -68,6 +75,16 @@ static PROGMEM_DECLARE(ZsiDomainProcessingRoutine_t zsiDriverDomainProcessingRou
 ******************************************************************************/
 static ZsiProcessingRoutine_t
 zsiDriverFindProcessingRoutine(ZsiCommandHeader_t cmdHeader);
+static bool zsiDriverSreqPipelineAccepts(void);
+static void zsiDriverSendSreq(ZsiSreq_t *const sreq, ZsiCommandFrame_t *const sreqFrame);
+static void zsiDriverKeepPendingSreq(ZsiSreq_t *const sreq, uint8_t sequenceNumber);
+static void zsiDriverReleaseSreq(ZsiSreq_t *const sreq);
+static void zsiDriverCheckSrspTimeout(void);
+static void zsiDriverArmSrspTimer(void);
+static void zsiDriverSrspTimerFired(void);
+static void zsiDriverForceRunTasks(void);
+static ZsiCommandFrame_t *zsiDriverWaitSreqMemory(void);
+static void zsiDriverReceiveBatchRecord(ZsiMemoryBuffer_t *const batchBuffer);
 
 /******************************************************************************
                                Implementation section
@@ -77,12 +94,18 @@ zsiDriverFindProcessingRoutine(ZsiCommandHeader_t cmdHeader);
  ******************************************************************************/
 void zsiResetDriver(void)
 {
+  HAL_StopAppTimer(&zsiDriver()->srspTimer);
   memset(zsiDriver(), 0x00, sizeof(ZsiDriver_t));
 
   resetQueue(&(zsiDriver()->bearingEntities));
   resetQueue(&(zsiDriver()->postponedAreqs));
-  resetQueue(&(zsiDriver()->commandsToReceive));
+  resetLinkedQueue(&(zsiDriver()->commandsToReceive));
   resetQueue(&(zsiDriver()->completedAreqs));
+  resetQueue(&(zsiDriver()->postponedSreqs));
+  resetQueue(&(zsiDriver()->pendingSreqs));
+  resetQueue(&(zsiDriver()->completedSreqs));
+  zsiDriver()->srspTimer.mode = TIMER_ONE_SHOT_MODE;
+  zsiDriver()->srspTimer.callback = zsiDriverSrspTimerFired;
   zsiDriver()->state = ZSI_DRIVER_STATE_IDLE;
 }
 
@@ -98,31 +121,46 @@ void zsiDriverTaskHandler(void)
     case ZSI_DRIVER_STATE_IDLE:
     {
       ZsiMemoryBuffer_t *buffer;
+      ZsiSreq_t *sreq;
+      ZsiCommandFrame_t *sreqFrame = NULL;
       uint8_t *memory = NULL;
 
+      zsiDriverCheckSrspTimeout();
+
       /* Process AREQs received from remote device with highest priority */
-      if ((NULL != (buffer = getQueueElem(&zsiDriver()->commandsToReceive))) &&
+      if ((NULL != (buffer = getLinkedQueueElem(&zsiDriver()->commandsToReceive))) &&
           ZSI_ACK_TX_QUANTITY(ackTxState))
       {
-        ZSI_ACK_TX_COUNT_DOWN(ackTxState);
-
-        if (IS_AREQ_CMD_FRAME(&buffer->commandFrame))
-        {
-          memory = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
-        }
-        else if (IS_SREQ_CMD_FRAME(&buffer->commandFrame))
+        if (IS_BATCH_CMD_FRAME(&buffer->commandFrame))
         {
-          memory = zsiAllocateMemory(ZSI_SREQ_CMD);
+          /* Batch frame is acknowledged once, so it is counted down after
+             the last packed AREQ is processed. */
+          zsiDriverReceiveBatchRecord(buffer);
         }
         else
         {
-          sysAssert(false, ZSIDRIVER_ZSISRSP_OUTSIDE_BLOCKING);
-        }
+          ZSI_ACK_TX_COUNT_DOWN(ackTxState);
 
-        if (memory)
-        {
-          deleteHeadQueueElem(&zsiDriver()->commandsToReceive);
-          zsiDriverReceiveCommand(memory, &buffer->commandFrame);
+          if (IS_AREQ_CMD_FRAME(&buffer->commandFrame))
+          {
+            memory = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
+          }
+          else if (IS_SREQ_CMD_FRAME(&buffer->commandFrame))
+          {
+            memory = zsiAllocateMemory(ZSI_SREQ_CMD);
+          }
+          else
+          {
+            /* SRSP on SREQ sent without blocking */
+            deleteHeadLinkedQueueElem(&zsiDriver()->commandsToReceive);
+            zsiSrspReceived(&buffer->commandFrame);
+          }
+
+          if (memory)
+          {
+            deleteHeadLinkedQueueElem(&zsiDriver()->commandsToReceive);
+            zsiDriverReceiveCommand(memory, &buffer->commandFrame);
+          }
         }
 
         if (ZSI_ACK_TX_QUANTITY(ackTxState))
@@ -152,11 +190,29 @@ void zsiDriverTaskHandler(void)
         ((ZsiEntityService_t *)memory)->zsi.callback(memory);
       }
 
-      /* Post task if any AREQ is still pending and required memory is available */
+      /* Send SREQs when pipeline has free place and memory is available */
+      else if ((NULL != (sreq = getQueueElem(&zsiDriver()->postponedSreqs))) &&
+               zsiDriverSreqPipelineAccepts() &&
+               (NULL != (sreqFrame = zsiAllocateMemory(ZSI_SREQ_CMD))))
+      {
+        deleteHeadQueueElem(&zsiDriver()->postponedSreqs);
+        zsiDriverSendSreq(sreq, sreqFrame);
+      }
+
+      /* Process completed SREQs */
+      else if (NULL != (sreq = deleteHeadQueueElem(&zsiDriver()->completedSreqs)))
+      {
+        sreq->callback(sreq);
+      }
+
+      /* Post task if any request is still pending and required memory is available */
       if (getQueueElem(&zsiDriver()->completedAreqs) ||
+          getQueueElem(&zsiDriver()->completedSreqs) ||
           (zsiIsMemoryAvailable() &&
-           (getQueueElem(&zsiDriver()->commandsToReceive) ||
-            getQueueElem(&zsiDriver()->postponedAreqs))))
+           (getLinkedQueueElem(&zsiDriver()->commandsToReceive) ||
+            getQueueElem(&zsiDriver()->postponedAreqs) ||
+            (getQueueElem(&zsiDriver()->postponedSreqs) &&
+             zsiDriverSreqPipelineAccepts()))))
       {
         zsiPostTask(ZSI_DRIVER_TASK_ID);
       }
@@ -169,19 +225,19 @@ void zsiDriverTaskHandler(void)
         ZsiMemoryBuffer_t *srspBuffer = NULL;
         uint8_t queueSize = 0;
 
-        curBuffer = getQueueElem(&zsiDriver()->commandsToReceive);
+        curBuffer = getLinkedQueueElem(&zsiDriver()->commandsToReceive);
         while (curBuffer)
         {
           queueSize++;
           if (IS_SRSP_CMD_FRAME(&curBuffer->commandFrame))
             srspBuffer = curBuffer;
-          curBuffer = getNextQueueElem(curBuffer);
+          curBuffer = getNextLinkedQueueElem(curBuffer);
         }
 
         if ((queueSize == ZSI_ACK_TX_QUANTITY(ackTxState)) && srspBuffer)
         {
           ZSI_ACK_TX_COUNT_DOWN(ackTxState);
-          deleteQueueElem(&zsiDriver()->commandsToReceive, srspBuffer);
+          deleteLinkedQueueElem(&zsiDriver()->commandsToReceive, srspBuffer);
           zsiSrspReceived(&srspBuffer->commandFrame);
         }
         zsiPostTask(ZSI_DRIVER_TASK_ID);
@@ -202,16 +258,29 @@ void zsiDriverTaskHandler(void)
   \param[in] serialize - pointer to serialization routine.
   \param[out] dataOut - pointer to execution result.
 
-  \return None.
+  \return False, if SREQ isn't completed: there is no memory for the frame
+          or SRSP doesn't come in time. dataOut isn't written then and lost
+          synchronization is indicated. True - otherwise.
  ******************************************************************************/
-void zsiProcessCommand(uint8_t cmdType, void *const dataIn,
+bool zsiProcessCommand(uint8_t cmdType, void *const dataIn,
   ZsiSerializeRoutine_t serialize, void *const dataOut)
 {
   ZsiProcessingResult_t result;
-  /* Try to allocate memory for new command */
-  ZsiCommandFrame_t *outFrame = zsiAllocateMemory(cmdType);
+  ZsiCommandFrame_t *outFrame;
+  bool completed;
 
   sysAssert(dataIn && serialize, ZSIDRIVER_ZSIPROCESSCOMMAND0);
+#ifdef ZAPPSI_NP
+  /* Host should know parameters changes before it gets the command */
+  if (ZSI_AREQ_CMD == cmdType)
+    zsiSysReportParametersChanges();
+#endif /* ZAPPSI_NP */
+
+  /* Try to allocate memory for new command */
+  outFrame = zsiAllocateMemory(cmdType);
+  /* Caller is blocked by SREQ, so wait till SREQs in flight release memory */
+  if (!outFrame && (ZSI_SREQ_CMD == cmdType))
+    outFrame = zsiDriverWaitSreqMemory();
   if (!outFrame)
   {
     /* Postpone AREQ, if no free memory is available */
@@ -220,8 +289,9 @@ void zsiProcessCommand(uint8_t cmdType, void *const dataIn,
       /* Store pointer to serialization routine. Evil cast.. Ideas? */
       ((ZsiEntityService_t *)dataIn)->zsi.process = (void ( *)(void *))serialize;
       putQueueElem(&zsiDriver()->postponedAreqs, dataIn);
+      return true;
     }
-    return;
+    return false;
   }
 
   /* Serialize command with appropriate routine */
@@ -234,12 +304,32 @@ void zsiProcessCommand(uint8_t cmdType, void *const dataIn,
   }
 #endif /* ZAPPSI_HOST */
 
-  zsiDriverSendCommand(outFrame, dataOut);
+  completed = zsiDriverSendCommand(outFrame, dataOut);
 
   if (!result.keepMemory)
     zsiFreeMemory(dataIn);
   if (!result.keepCmdFrame)
     zsiFreeMemory(outFrame);
+
+  return completed;
+}
+
+/**************************************************************************//**
+  \brief Non-blocking SREQ processing. Request is serialized and sent as soon
+         as memory and free place in SREQs pipeline are available. Caller isn't
+         blocked till SRSP, several requests may wait for SRSP at the same time.
+
+  \param[in] sreq - request descriptor with dataIn, serialize, dataOut and
+                    callback fields filled.
+
+  \return None.
+ ******************************************************************************/
+void zsiProcessSreq(ZsiSreq_t *const sreq)
+{
+  sysAssert(sreq && sreq->dataIn && sreq->serialize, ZSIDRIVER_ZSIPROCESSSREQ0);
+
+  putQueueElem(&zsiDriver()->postponedSreqs, sreq);
+  zsiPostTask(ZSI_DRIVER_TASK_ID);
 }
 
 /**************************************************************************//**
@@ -271,39 +361,38 @@ void zsiPrepareCommand(ZsiCommandFrame_t *const cmdFrame, uint16_t length,
   \param[in] cmdFrame - frame, which keeps serialized command.
   \param[out] dataOut - pointer to memory to put returned value in case of SREQ.
 
-  \return None.
+  \return False, if SRSP on SREQ doesn't come in time, true - otherwise.
  ******************************************************************************/
-void zsiDriverSendCommand(ZsiCommandFrame_t *const cmdFrame, void *const dataOut)
+bool zsiDriverSendCommand(ZsiCommandFrame_t *const cmdFrame, void *const dataOut)
 {
   /* Transfer SREQ in single task */
   if (IS_SREQ_CMD_FRAME(cmdFrame))
   {
+    ZsiSreq_t sreq =
+    {
+      .dataOut = dataOut,
+      .callback = NULL
+    };
+
     zsiDriver()->state = ZSI_DRIVER_STATE_BLOCKED;
     /* Hold on all tasks except required medium one during SREQ sending */
     ZSI_ENTER_SYNCHRONOUS_MODE();
-    /* Block here until current transmission finished */
-    while (zsiSerialIsBusy())
-    {
-      zsiPostTask(ZSI_DRIVER_TASK_ID);
-      SYS_ForceRunTask();
-    }
+    /* Block here until serial controller and SREQs pipeline are able to
+       accept the frame. Non-blocking SREQs stay in flight meanwhile. */
+    while (zsiSerialIsBusy() || !zsiDriverSreqPipelineAccepts())
+      zsiDriverForceRunTasks();
     /* Send frame to serial controller */
+    zsiDriverKeepPendingSreq(&sreq, cmdFrame->sequenceNumber);
     zsiSerialSend(cmdFrame);
-    /* Block here until SRSP received */
-    while (NULL == zsiDriver()->srsp)
-    {
-      /* Force ZAppSI tasks to manage synchronous mode timers */
-      ZSI_TaskHandler();
-      zsiPostTask(ZSI_DRIVER_TASK_ID);
-      /* All ZAppSI states will be changed in HAL serial medium's callbacks */
-      SYS_ForceRunTask();
-    }
-    /* Process SRSP */
-    zsiSerialClearCurTransac();
-    zsiDriverReceiveCommand(dataOut, zsiDriver()->srsp);
-    zsiDriver()->srsp = NULL;
+    /* Block here until SRSP received and deserialized to dataOut */
+    while (isQueueElem(&zsiDriver()->pendingSreqs, &sreq))
+      zsiDriverForceRunTasks();
     ZSI_LEAVE_SYNCHRONOUS_MODE();
     zsiDriver()->state = ZSI_DRIVER_STATE_IDLE;
+    /* Callbacks of SREQs completed meanwhile are called from driver task */
+    zsiPostTask(ZSI_DRIVER_TASK_ID);
+    /* SREQ is released without SRSP on timeout */
+    return sreq.service.completed;
   }
   /* Transfer AREQ and SRSP if serial controller is idle */
   else if (!zsiSerialIsBusy())
@@ -313,6 +402,8 @@ void zsiDriverSendCommand(ZsiCommandFrame_t *const cmdFrame, void *const dataOut
   /* Store command in queue */
   else
     zsiSerialStoreTxCmd(cmdFrame);
+
+  return true;
 }
 
 /******************************************************************************
@@ -347,7 +438,10 @@ void zsiDriverReceiveCommand(uint8_t *memory, ZsiCommandFrame_t *const cmdFrame)
   /* In case of SREQ command SRSP should be returned at the same memory */
   if (processingRoutine)
     if (IS_SRSP_CMD_FRAME(cmdFrame))
+    {
+      zsiSysReportParametersChanges();
       zsiDriverSendCommand(cmdFrame, NULL);
+    }
 #endif /* ZAPPSI_NP */
 
   if (!result.keepMemory)
@@ -356,6 +450,57 @@ void zsiDriverReceiveCommand(uint8_t *memory, ZsiCommandFrame_t *const cmdFrame)
     zsiFreeMemory(cmdFrame);
 }
 
+/******************************************************************************
+  \brief Unpacks the next AREQ from the received batch frame to a separate
+         frame and processes it as an ordinary received command. Batch frame
+         is released after its last record is unpacked.
+
+  \param[in] batchBuffer - buffer, which keeps received batch frame.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverReceiveBatchRecord(ZsiMemoryBuffer_t *const batchBuffer)
+{
+  ZsiCommandFrame_t *const batchFrame = &batchBuffer->commandFrame;
+  uint16_t batchLength = LE16_TO_CPU(batchFrame->length) - ZSI_COMMAND_FRAME_OVERHEAD;
+  const uint8_t *record = &batchFrame->payload[zsiDriver()->batchOffset];
+  ZsiCommandFrame_t *cmdFrame;
+  uint8_t *memory;
+
+  sysAssert((zsiDriver()->batchOffset + ZSI_BATCH_RECORD_HEADER_SIZE <= batchLength) &&
+            (zsiDriver()->batchOffset + ZSI_BATCH_RECORD_HEADER_SIZE + record[0] <= batchLength),
+            ZSIDRIVER_ZSIBATCHRECEIVED0);
+
+  /* Both buffers are required, wait for memory otherwise */
+  if (NULL == (cmdFrame = zsiAllocateFrameMemory(ZSI_MUTUAL_MEMORY,
+                   ZSI_COMMAND_FRAME_PREAMBLE_SIZE + ZSI_COMMAND_FRAME_OVERHEAD + record[0])))
+    return;
+  if (NULL == (memory = zsiAllocateMemory(ZSI_MUTUAL_MEMORY)))
+  {
+    zsiFreeMemory(cmdFrame);
+    return;
+  }
+
+  cmdFrame->sof = ZSI_SOF_SEQUENCE;
+  cmdFrame->frameControl = ZSI_AREQ_CMD;
+  cmdFrame->length = CPU_TO_LE16(record[0] + ZSI_COMMAND_FRAME_OVERHEAD);
+  cmdFrame->sequenceNumber = record[1];
+  cmdFrame->commandHeader.domain = record[2];
+  cmdFrame->commandHeader.commandId = record[3];
+  memcpy(cmdFrame->payload, &record[ZSI_BATCH_RECORD_HEADER_SIZE], record[0]);
+  zsiDriver()->batchOffset += ZSI_BATCH_RECORD_HEADER_SIZE + record[0];
+
+  if (zsiDriver()->batchOffset >= batchLength)
+  {
+    ZSI_ACK_TX_COUNT_DOWN(ackTxState);
+    deleteHeadLinkedQueueElem(&zsiDriver()->commandsToReceive);
+    zsiFreeMemory(batchFrame);
+    zsiDriver()->batchOffset = 0U;
+  }
+
+  zsiDriverReceiveCommand(memory, cmdFrame);
+}
+
 /**************************************************************************//**
   \brief Finds routine for ZDO command deserialization.
 
@@ -396,7 +541,7 @@ void zsiDriverStoreRxCmd(const ZsiCommandFrame_t *const cmdFrame)
 {
   ZsiMemoryBuffer_t *buffer = GET_PARENT_BY_FIELD(ZsiMemoryBuffer_t,
     commandFrame, cmdFrame);
-  putQueueElem(&zsiDriver()->commandsToReceive, buffer);
+  putLinkedQueueElem(&zsiDriver()->commandsToReceive, buffer);
 }
 
 /******************************************************************************
@@ -479,7 +624,196 @@ void *zsiDriverReturnBearingEntity(uint8_t sequenceNumber)
  ******************************************************************************/
 void zsiSrspReceived(ZsiCommandFrame_t *const srsp)
 {
-  zsiDriver()->srsp = srsp;
+  ZsiSreq_t *sreq = getQueueElem(&zsiDriver()->pendingSreqs);
+
+  /* Several SREQs may be in flight, link SRSP by sequence number */
+  while (sreq && (sreq->service.sequenceNumber != srsp->sequenceNumber))
+    sreq = getNextQueueElem(sreq);
+
+  if (!sreq)
+  {
+    /* SRSP on unknown or already timed out SREQ */
+    sysAssert(0U, ZSIDRIVER_ZSISRSPRECEIVED0);
+    zsiFreeMemory(srsp);
+    return;
+  }
+
+  zsiDriverReleaseSreq(sreq);
+  zsiDriverReceiveCommand(sreq->dataOut, srsp);
+  sreq->service.completed = true;
+
+  if (sreq->callback)
+    putQueueElem(&zsiDriver()->completedSreqs, sreq);
+  zsiPostTask(ZSI_DRIVER_TASK_ID);
+}
+
+/******************************************************************************
+  \brief Checks if one more SREQ may wait for SRSP. Legacy network processor
+         processes SREQs one by one, so stop-and-wait link keeps single SREQ
+         in flight.
+
+  \return True, if SREQ may be sent, false - otherwise.
+ ******************************************************************************/
+static bool zsiDriverSreqPipelineAccepts(void)
+{
+  uint8_t limit = zsiSerialIsWindowed() ? ZSI_MAX_SREQS_IN_FLIGHT : 1U;
+
+  return zsiDriver()->sreqsInFlight < limit;
+}
+
+/******************************************************************************
+  \brief Serializes non-blocking SREQ and passes it to serial controller.
+
+  \param[in] sreq - request descriptor.
+  \param[in] sreqFrame - frame allocated for SREQ.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverSendSreq(ZsiSreq_t *const sreq, ZsiCommandFrame_t *const sreqFrame)
+{
+  /* SREQ serialization keeps both frame and memory, frame is released by
+     serial controller as soon as it is acknowledged */
+  sreq->serialize(sreq->dataIn, sreqFrame);
+  zsiDriverKeepPendingSreq(sreq, sreqFrame->sequenceNumber);
+
+  if (!zsiSerialIsBusy())
+    zsiSerialSend(sreqFrame);
+  else
+    zsiSerialStoreTxCmd(sreqFrame);
+}
+
+/******************************************************************************
+  \brief Stores SREQ for further linking with SRSP.
+
+  \param[in] sreq - request descriptor.
+  \param[in] sequenceNumber - sequence number of SREQ frame.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverKeepPendingSreq(ZsiSreq_t *const sreq, uint8_t sequenceNumber)
+{
+  sreq->service.sequenceNumber = sequenceNumber;
+  sreq->service.completed = false;
+  sreq->service.srspDeadline = HAL_GetSystemTime() + ZSI_SRSP_WAIT_PERIOD;
+  putQueueElem(&zsiDriver()->pendingSreqs, sreq);
+  zsiDriver()->sreqsInFlight++;
+
+  if (sreq == getQueueElem(&zsiDriver()->pendingSreqs))
+    zsiDriverArmSrspTimer();
+}
+
+/******************************************************************************
+  \brief Removes SREQ from the pipeline.
+
+  \param[in] sreq - request descriptor.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverReleaseSreq(ZsiSreq_t *const sreq)
+{
+  deleteQueueElem(&zsiDriver()->pendingSreqs, sreq);
+  zsiDriver()->sreqsInFlight--;
+  zsiDriverArmSrspTimer();
+}
+
+/******************************************************************************
+  \brief Checks if the oldest SREQ waits for SRSP too long. Appeals to
+         syncronization lost event in that case.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverCheckSrspTimeout(void)
+{
+  ZsiSreq_t *sreq = getQueueElem(&zsiDriver()->pendingSreqs);
+
+  if (sreq && (HAL_GetSystemTime() >= sreq->service.srspDeadline))
+  {
+    zsiDriverReleaseSreq(sreq);
+    /* If this timer fired - abnormal situation occured.
+       Lost syncronization event must be indicated. Today it is assert(0)   */
+    sysAssert(0U, ZSIDRIVER_ZSISRSPTIMEOUT0);
+    SYS_PostEvent(BC_ZSI_LOST_SYNCHRONIZATION, 0U);
+  }
+}
+
+/******************************************************************************
+  \brief Starts SRSP timer for the oldest SREQ waiting for SRSP. Timer is held
+         in synchronous mode, so blocking SREQ polls deadlines itself.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverArmSrspTimer(void)
+{
+  ZsiSreq_t *sreq = getQueueElem(&zsiDriver()->pendingSreqs);
+  BcTime_t now = HAL_GetSystemTime();
+
+  HAL_StopAppTimer(&zsiDriver()->srspTimer);
+  if (!sreq)
+    return;
+
+  zsiDriver()->srspTimer.interval = (sreq->service.srspDeadline > now) ?
+    (uint32_t)(sreq->service.srspDeadline - now) : 1UL;
+  HAL_StartAppTimer(&zsiDriver()->srspTimer);
+}
+
+/******************************************************************************
+  \brief SRSP timer expiration callback.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverSrspTimerFired(void)
+{
+  zsiPostTask(ZSI_DRIVER_TASK_ID);
+}
+
+/******************************************************************************
+  \brief Runs ZAppSI and HAL tasks while the caller is blocked by SREQ.
+
+  \return None.
+ ******************************************************************************/
+static void zsiDriverForceRunTasks(void)
+{
+  zsiDriverCheckSrspTimeout();
+  /* Force ZAppSI tasks to manage synchronous mode timers */
+  ZSI_TaskHandler();
+  /* Serial controller task resends frames from the window on timeout */
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+  zsiPostTask(ZSI_DRIVER_TASK_ID);
+  /* All ZAppSI states will be changed in HAL serial medium's callbacks */
+  SYS_ForceRunTask();
+}
+
+/******************************************************************************
+  \brief Blocks the caller till memory for SREQ frame is available. Memory is
+         held by SREQs in flight and received SRSPs, which are released by
+         driver in blocked state. Lost syncronization is indicated, if memory
+         isn't released during SRSP wait period.
+
+  \return Memory for SREQ frame, NULL if there is no free buffer.
+ ******************************************************************************/
+static ZsiCommandFrame_t *zsiDriverWaitSreqMemory(void)
+{
+  BcTime_t deadline = HAL_GetSystemTime() + ZSI_SRSP_WAIT_PERIOD;
+  ZsiCommandFrame_t *sreqFrame = NULL;
+
+  zsiDriver()->state = ZSI_DRIVER_STATE_BLOCKED;
+  ZSI_ENTER_SYNCHRONOUS_MODE();
+  while (!sreqFrame && (HAL_GetSystemTime() < deadline))
+  {
+    zsiDriverForceRunTasks();
+    sreqFrame = zsiAllocateMemory(ZSI_SREQ_CMD);
+  }
+  ZSI_LEAVE_SYNCHRONOUS_MODE();
+  zsiDriver()->state = ZSI_DRIVER_STATE_IDLE;
+  zsiPostTask(ZSI_DRIVER_TASK_ID);
+
+  if (!sreqFrame)
+  {
+    sysAssert(0U, ZSIDRIVER_ZSIWAITSREQMEMORY0);
+    SYS_PostEvent(BC_ZSI_LOST_SYNCHRONIZATION, 0U);
+  }
+
+  return sreqFrame;
 }
 
 /* eof zsiDriver.c */
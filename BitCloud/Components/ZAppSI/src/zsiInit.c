@@ -72,6 +72,8 @@ void zsiInitResetNetworkConf(ZDO_ResetNetworkConf_t *conf)
 {
   sysAssert(ZDO_SUCCESS_STATUS == conf->status, ZSIINIT_ZSIINITRESETNETWORKCONF0);
 
+  /* Fill parameters mirror in background, so application reads them locally */
+  CS_PopulateMirror();
   SYS_InitZclLayer();
   SYS_PostTask(APL_TASK_ID);
 }
@@ -88,7 +88,7 @@ ZsiProcessingRoutine_t zsiMacFindProcessingRoutine(uint8_t commandId)
  ******************************************************************************/
 bool MAC_IsOwnExtAddr(const ExtAddr_t *const extAddr)
 {
-  bool result;
+  bool result = false;
 
   zsiProcessCommand(ZSI_SREQ_CMD, (void *const)extAddr, zsiSerializeMAC_IsOwnExtAddrReq, &result);
 
@@ -13,6 +13,7 @@
   \internal
    History:
     2011-08-31  A. Razinkov - Created.
+    2026-10-17  Size-classed buffers with free lists and domain quotas.
    Last change:
     $Id: zsiMemoryManager.c 24441 2013-02-07 12:02:29Z akhromykh $
  ******************************************************************************/
@@ -23,85 +24,215 @@
 #include <zsiMemoryManager.h>
 #include <zsiMem.h>
 
+/******************************************************************************
+                              Static variables section
+******************************************************************************/
+/* Amount of received AREQs of each domain allowed to be kept in memory */
+static PROGMEM_DECLARE(uint8_t zsiMemoryQuotas[ZSI_MEMORY_DOMAINS_AMOUNT]) =
+{
+  [ZSI_CMD_SYS]   = ZSI_DEFAULT_MEMORY_QUOTA,
+  [ZSI_CMD_APS]   = ZSI_APS_MEMORY_QUOTA,
+  [ZSI_CMD_ZDO]   = ZSI_ZDO_MEMORY_QUOTA,
+  [ZSI_CMD_ZDP]   = ZSI_ZDO_MEMORY_QUOTA,
+  [ZSI_CMD_NWK]   = ZSI_NWK_MEMORY_QUOTA,
+  [ZSI_CMD_MAC]   = ZSI_DEFAULT_MEMORY_QUOTA,
+  [ZSI_CMD_HAL]   = ZSI_DEFAULT_MEMORY_QUOTA,
+  [ZSI_CMD_SEC]   = ZSI_DEFAULT_MEMORY_QUOTA,
+  [ZSI_CMD_KE]    = ZSI_DEFAULT_MEMORY_QUOTA,
+  [ZSI_CMD_BSP]   = ZSI_DEFAULT_MEMORY_QUOTA,
+  [ZSI_CMD_BATCH] = ZSI_DEFAULT_MEMORY_QUOTA
+};
+
 /******************************************************************************
                               Implementations section
 ******************************************************************************/
+/******************************************************************************
+  \brief Puts buffer to the free list of its class.
+
+  \param[in] buffer - buffer to put.
+  \param[in] memoryClass - class of the buffer.
+
+  \return None.
+ ******************************************************************************/
+INLINE void zsiPutFreeBuffer(ZsiMemoryBuffer_t *const buffer, ZsiMemoryClass_t memoryClass)
+{
+  buffer->busy = false;
+  buffer->next.next = zsiMemoryManager()->freeLists[memoryClass];
+  zsiMemoryManager()->freeLists[memoryClass] = &buffer->next;
+}
+
+/******************************************************************************
+  \brief Takes buffer from the free list of the class.
+
+  \param[in] memoryClass - class of the buffer.
+
+  \return Memory of the buffer, NULL if there is no free buffer of the class.
+ ******************************************************************************/
+static void *zsiGetFreeBuffer(ZsiMemoryClass_t memoryClass)
+{
+  ZsiMemoryManager_t *const manager = zsiMemoryManager();
+  ZsiMemoryBuffer_t *const buffer = (ZsiMemoryBuffer_t *)manager->freeLists[memoryClass];
+  ZsiMemoryClassStats_t *const stats = &manager->stats.classes[memoryClass];
+
+  if (!buffer)
+    return NULL;
+
+  manager->freeLists[memoryClass] = buffer->next.next;
+  buffer->busy = true;
+  buffer->domain = ZSI_NO_MEMORY_DOMAIN;
+
+  if (++stats->used > stats->highWaterMark)
+    stats->highWaterMark = stats->used;
+
+  return &buffer->memory;
+}
+
 /******************************************************************************
   \brief ZAppSI memory manager reset routine.
  ******************************************************************************/
 void zsiResetMemoryManager(void)
 {
+  ZsiMemoryPool_t *const pool = &zsiMemoryManager()->memoryPool;
+  ZsiMemoryStats_t *const stats = &zsiMemoryManager()->stats;
   uint8_t it;
 
+  /* Frames in small buffers are accessed through ZsiMemoryBuffer_t */
+  assert_static(offsetof(ZsiSmallMemoryBuffer_t, memory) == offsetof(ZsiMemoryBuffer_t, memory));
+
   memset(zsiMemoryManager(), 0x00, sizeof(ZsiMemoryManager_t));
-  INIT_GUARDS(&zsiMemoryManager()->memoryPool);
+  INIT_GUARDS(pool);
+
+  /* Buffers are put in reverse order to be allocated from the first one */
+  for (it = ZSI_MEMORY_BUFFERS_AMOUNT; it--;)
+  {
+    INIT_GUARDS(&pool->buffers[it]);
+    zsiPutFreeBuffer(&pool->buffers[it], (it < ZSI_MUTUAL_MEMORY_BUFFERS_START) ?
+      ZSI_SYNC_MEMORY_CLASS : ZSI_LARGE_MEMORY_CLASS);
+  }
+  stats->classes[ZSI_SYNC_MEMORY_CLASS].total = ZSI_MUTUAL_MEMORY_BUFFERS_START;
+  stats->classes[ZSI_LARGE_MEMORY_CLASS].total = ZSI_MUTUAL_MEMORY_BUFFERS_AMOUNT;
 
-  for (it = 0U; it < ZSI_MEMORY_BUFFERS_AMOUNT; it++)
+#if ZSI_SMALL_MEMORY_BUFFERS_AMOUNT > 0U
+  for (it = ZSI_SMALL_MEMORY_BUFFERS_AMOUNT; it--;)
   {
-    INIT_GUARDS(&zsiMemoryManager()->memoryPool.buffers[it]);
+    INIT_GUARDS(&pool->smallBuffers[it]);
+    zsiPutFreeBuffer((ZsiMemoryBuffer_t *)&pool->smallBuffers[it], ZSI_SMALL_MEMORY_CLASS);
   }
+  stats->classes[ZSI_SMALL_MEMORY_CLASS].total = ZSI_SMALL_MEMORY_BUFFERS_AMOUNT;
+#endif
 }
 
 /******************************************************************************
   \brief Allocates memory for ZAppSI frames and BitCloud objects.
 
-  \param[in] memory - allocated memory to free.
-
-  \return None.
+  \param[in] memoryType - memory type: ZSI_SREQ_CMD, ZSI_SRSP_CMD, ZSI_AREQ_CMD,
+                          ZSI_MUTUAL_MEMORY, ZSI_RX_ACK_MEMORY or
+                          ZSI_TX_ACK_MEMORY.
 
   \return Pointer to memory.
  ******************************************************************************/
 void *zsiAllocateMemory(uint8_t memoryType)
 {
-  ZsiMemoryBuffer_t *buffers = zsiMemoryManager()->memoryPool.buffers;
-  bool allocate = false;
   void *memory = NULL;
-  uint8_t item;
 
   CHECK_GUARDS(&zsiMemoryManager()->memoryPool,
                ZSIMEMORYMANAGER_MEMORYCORRUPTION0);
 
-  for (item = 0U; item < ZSI_MEMORY_BUFFERS_AMOUNT; item++)
-  {
-    CHECK_GUARDS(&buffers[item], ZSIMEMORYMANAGER_MEMORYCORRUPTION2);
-  }
-
   if (ZSI_RX_ACK_MEMORY == memoryType)
     return &zsiMemoryManager()->memoryPool.ackRxFrame;
 
   if (ZSI_TX_ACK_MEMORY == memoryType)
     return &zsiMemoryManager()->memoryPool.ackTxFrame;
 
-  /* Allocate memory for SREQ in reserved buffers. */
+  /* Allocate memory for SREQ in reserved buffers. Several SREQs may be in
+     flight, so mutual buffers are used when reserved ones are exhausted. */
   if ((ZSI_SREQ_CMD == memoryType) || (ZSI_SRSP_CMD == memoryType))
   {
-    /* We have duplicated SREQ or SRSP, if reserved buffers are busy */
-    sysAssert(!buffers[ZSI_SYNC0_RESERVED_MEMORY_BUFFER].busy ||
-           !buffers[ZSI_SYNC1_RESERVED_MEMORY_BUFFER].busy, ZSIMEMORYMANAGER_ZSIALLOCATEMORY0);
-    allocate = true;
-    item = ZSI_SYNC0_RESERVED_MEMORY_BUFFER;
-    if (buffers[item].busy)
-      item = ZSI_SYNC1_RESERVED_MEMORY_BUFFER;
+    memory = zsiGetFreeBuffer(ZSI_SYNC_MEMORY_CLASS);
+    if (!memory)
+      memory = zsiGetFreeBuffer(ZSI_LARGE_MEMORY_CLASS);
   }
   else if (ZSI_AREQ_CMD == memoryType || ZSI_MUTUAL_MEMORY == memoryType)
   {
-    for (item = ZSI_MUTUAL_MEMORY_BUFFERS_START; item < ZSI_MEMORY_BUFFERS_AMOUNT; item++)
+    memory = zsiGetFreeBuffer(ZSI_LARGE_MEMORY_CLASS);
+  }
+
+  if (memory)
+  {
+    CHECK_GUARDS(GET_PARENT_BY_FIELD(ZsiMemoryBuffer_t, memory, memory),
+                 ZSIMEMORYMANAGER_MEMORYCORRUPTION2);
+  }
+  else
+    zsiMemoryManager()->stats.allocationFailures++;
+
+  return memory;
+}
+
+/******************************************************************************
+  \brief Allocates memory for the frame being received. Frames, which fit,
+         are put to small buffers, except SREQs which memory is reused for
+         SRSP. Other frames are allocated as by zsiAllocateMemory().
+
+  \param[in] memoryType - memory type as for zsiAllocateMemory().
+  \param[in] frameSize - size of the whole frame.
+
+  \return Pointer to memory, NULL if there is no free buffer.
+ ******************************************************************************/
+void *zsiAllocateFrameMemory(uint8_t memoryType, uint16_t frameSize)
+{
+#if ZSI_SMALL_MEMORY_BUFFERS_AMOUNT > 0U
+  if ((ZSI_SMALL_MEMORY_BUFFER_SIZE >= frameSize) &&
+      ((ZSI_SRSP_CMD == memoryType) || (ZSI_AREQ_CMD == memoryType) ||
+       (ZSI_MUTUAL_MEMORY == memoryType)))
+  {
+    void *const memory = zsiGetFreeBuffer(ZSI_SMALL_MEMORY_CLASS);
+
+    if (memory)
     {
-      if (!buffers[item].busy)
-      {
-        allocate = true;
-        break;
-      }
+      CHECK_GUARDS(GET_PARENT_BY_FIELD(ZsiSmallMemoryBuffer_t, memory, memory),
+                   ZSIMEMORYMANAGER_MEMORYCORRUPTION4);
+      return memory;
     }
   }
+#else
+  (void)frameSize;
+#endif
+
+  return zsiAllocateMemory(memoryType);
+}
+
+/******************************************************************************
+  \brief Counts memory keeping received AREQ against its domain quota.
+         Buffer is released from the quota when it is freed.
 
-  if (allocate)
+  \param[in] memory - memory keeping the frame.
+  \param[in] domain - command domain of the frame.
+
+  \return True, if domain quota allows to keep the frame, false - otherwise.
+ ******************************************************************************/
+bool zsiChargeMemoryQuota(const void *const memory, uint8_t domain)
+{
+  ZsiMemoryManager_t *const manager = zsiMemoryManager();
+  ZsiMemoryBuffer_t *const buffer =
+    GET_PARENT_BY_FIELD(ZsiMemoryBuffer_t, memory, memory);
+  uint8_t quota;
+
+  /* Unknown domains are rejected by the driver later */
+  if (domain >= ZSI_MEMORY_DOMAINS_AMOUNT)
+    return true;
+
+  memcpy_P(&quota, &zsiMemoryQuotas[domain], sizeof(quota));
+  if (manager->domainUsed[domain] >= quota)
   {
-    memory = &buffers[item].memory;
-    buffers[item].busy = true;
+    manager->stats.quotaRejections++;
+    return false;
   }
 
-  return memory;
+  buffer->domain = domain;
+  if (++manager->domainUsed[domain] > manager->stats.domainHighWaterMarks[domain])
+    manager->stats.domainHighWaterMarks[domain] = manager->domainUsed[domain];
+
+  return true;
 }
 
 /******************************************************************************
@@ -114,28 +245,57 @@ void *zsiAllocateMemory(uint8_t memoryType)
  ******************************************************************************/
 void zsiFreeMemory(const void *const memory)
 {
-  ZsiMemoryBuffer_t *buffers = zsiMemoryManager()->memoryPool.buffers;
-  uint8_t it;
+  ZsiMemoryManager_t *const manager = zsiMemoryManager();
+  ZsiMemoryPool_t *const pool = &manager->memoryPool;
+  ZsiMemoryBuffer_t *buffer;
+  ZsiMemoryClass_t memoryClass;
 
-  CHECK_GUARDS(&zsiMemoryManager()->memoryPool,
-               ZSIMEMORYMANAGER_MEMORYCORRUPTION1);
+  CHECK_GUARDS(pool, ZSIMEMORYMANAGER_MEMORYCORRUPTION1);
 
-  if ((memory == &zsiMemoryManager()->memoryPool.ackTxFrame) || (memory == &zsiMemoryManager()->memoryPool.ackRxFrame))
+  if ((memory == &pool->ackTxFrame) || (memory == &pool->ackRxFrame))
     return;
 
-  for (it = 0U; it < ZSI_MEMORY_BUFFERS_AMOUNT; it++)
+  /* Locate memory buffer which keeps appropriate memory, it may be referred
+     by a pointer to the middle of the kept object */
+  if (((void *)pool->buffers <= memory) &&
+      (memory < (void *)&pool->buffers[ZSI_MEMORY_BUFFERS_AMOUNT]))
   {
-    CHECK_GUARDS(&buffers[it], ZSIMEMORYMANAGER_MEMORYCORRUPTION3);
-    /* Locate and free memory buffer which keeps appropriate memory */
-    if (((void *)&buffers[it] <= memory) && (memory < (void *)&buffers[it + 1U]))
-    {
-      buffers[it].busy = false;
-      zsiMemoryAvailableNtfy();
-      return;
-    }
+    const uint8_t it = ((const uint8_t *)memory - (const uint8_t *)pool->buffers) /
+                       sizeof(ZsiMemoryBuffer_t);
+
+    buffer = &pool->buffers[it];
+    CHECK_GUARDS(buffer, ZSIMEMORYMANAGER_MEMORYCORRUPTION3);
+    memoryClass = (it < ZSI_MUTUAL_MEMORY_BUFFERS_START) ?
+      ZSI_SYNC_MEMORY_CLASS : ZSI_LARGE_MEMORY_CLASS;
+  }
+#if ZSI_SMALL_MEMORY_BUFFERS_AMOUNT > 0U
+  else if (((void *)pool->smallBuffers <= memory) &&
+           (memory < (void *)&pool->smallBuffers[ZSI_SMALL_MEMORY_BUFFERS_AMOUNT]))
+  {
+    const uint8_t it = ((const uint8_t *)memory - (const uint8_t *)pool->smallBuffers) /
+                       sizeof(ZsiSmallMemoryBuffer_t);
+
+    CHECK_GUARDS(&pool->smallBuffers[it], ZSIMEMORYMANAGER_MEMORYCORRUPTION4);
+    buffer = (ZsiMemoryBuffer_t *)&pool->smallBuffers[it];
+    memoryClass = ZSI_SMALL_MEMORY_CLASS;
+  }
+#endif
+  else
+  {
+    /* If we reach this point - invalid memory location was passed */
+    sysAssert(0U, ZSIMEMORYMANAGER_ZSIFREEMEMORY0);
+    return;
   }
-  /* If we reach this point - invalid memory location was passed */
-  sysAssert(0U, ZSIMEMORYMANAGER_ZSIFREEMEMORY0);
+
+  /* Freeing twice would link the buffer to the free list twice */
+  if (!buffer->busy)
+    return;
+
+  if (ZSI_NO_MEMORY_DOMAIN != buffer->domain)
+    manager->domainUsed[buffer->domain]--;
+  manager->stats.classes[memoryClass].used--;
+  zsiPutFreeBuffer(buffer, memoryClass);
+  zsiMemoryAvailableNtfy();
 }
 
 /******************************************************************************
@@ -145,17 +305,32 @@ void zsiFreeMemory(const void *const memory)
  ******************************************************************************/
 bool zsiIsMemoryAvailable(void)
 {
-  ZsiMemoryBuffer_t *buffers = zsiMemoryManager()->memoryPool.buffers;
-  uint8_t it;
+  return zsiMemoryManager()->freeLists[ZSI_LARGE_MEMORY_CLASS] ? true : false;
+}
 
-  for (it = ZSI_MUTUAL_MEMORY_BUFFERS_START; it < ZSI_MEMORY_BUFFERS_AMOUNT; it++)
-  {
-    if (!buffers[it].busy)
-    {
-      return true;
-    }
-  }
-  return false;
+/******************************************************************************
+  \brief Returns amount of free buffers, which could receive frames.
+
+  \return Amount of free mutual and small buffers.
+ ******************************************************************************/
+uint8_t zsiFreeRxMemoryAmount(void)
+{
+  const ZsiMemoryClassStats_t *const classes = zsiMemoryManager()->stats.classes;
+
+  return (classes[ZSI_LARGE_MEMORY_CLASS].total - classes[ZSI_LARGE_MEMORY_CLASS].used) +
+         (classes[ZSI_SMALL_MEMORY_CLASS].total - classes[ZSI_SMALL_MEMORY_CLASS].used);
+}
+
+/******************************************************************************
+  \brief Returns memory usage statistics of the local device.
+
+  \param[out] stats - statistics.
+
+  \return None.
+ ******************************************************************************/
+void zsiGetMemoryStats(ZsiMemoryStats_t *const stats)
+{
+  *stats = zsiMemoryManager()->stats;
 }
 
 /* eof zsiMemoryManager.c */
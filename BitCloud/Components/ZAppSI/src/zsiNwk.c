@@ -189,8 +189,7 @@ bool NWK_SetKey(const uint8_t *const key, const NWK_KeySeqNum_t keySeqNum)
   memcpy(nwkSetKey.key, key, SECURITY_KEY_SIZE);
   nwkSetKey.keySeqNum = keySeqNum;
 
-  zsiProcessCommand(ZSI_SREQ_CMD, &nwkSetKey, zsiSerializeNWK_SetKeyReq, NULL);
-  return true;
+  return zsiProcessCommand(ZSI_SREQ_CMD, &nwkSetKey, zsiSerializeNWK_SetKeyReq, NULL);
 }
 
 /**************************************************************************//**
@@ -203,8 +202,7 @@ bool NWK_ActivateKey(const NWK_KeySeqNum_t keySeqNum)
 {
   uint8_t nwkKeySeqNum = keySeqNum;
   sysAssert(0U, 0xFFFF);
-  zsiProcessCommand(ZSI_SREQ_CMD, &nwkKeySeqNum, zsiSerializeNWK_ActivateKeyReq, NULL);
-  return true;
+  return zsiProcessCommand(ZSI_SREQ_CMD, &nwkKeySeqNum, zsiSerializeNWK_ActivateKeyReq, NULL);
 }
 
 #endif /* _SECURITY_ */
@@ -0,0 +1,475 @@
+/***************************************************************************//**
+  \file zsiReplayAdapter.c
+
+  \brief ZAppSI replay medium adapter implementation.
+         Takes place of the USART adapter and plays the role of network
+         processor: frames received by the host are taken from the traffic
+         log, frames sent by the host are compared against the log.
+         Used for offline host performance testing, terminates the process
+         with summary when the log is over.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+   History:
+    2026-10-17  Created.
+ ******************************************************************************/
+
+/******************************************************************************
+                               Includes section
+ ******************************************************************************/
+#include <zsiSerialController.h>
+#include <zsiMemoryManager.h>
+#include <zsiTaskManager.h>
+#include <zsiTrafficLog.h>
+#include <zsiDriver.h>
+#include <halTaskManager.h>
+#include <appTimer.h>
+
+#if ZSI_TRAFFIC_REPLAY != ZSI_TRAFFIC_REPLAY_DISABLED
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                               Defines section
+ ******************************************************************************/
+/* Amount of sent frames which could wait for matching with the log */
+#define ZSI_REPLAY_SENT_FRAMES_AMOUNT 16U
+/* Frame expected from the host is skipped if it was not sent within this
+   interval after the recorded time */
+#define ZSI_REPLAY_STALL_TIMEOUT 5000000ULL /* 5 s */
+/* Log is polled with this interval while waiting for the host or for
+   the recorded time of the next frame */
+#define ZSI_REPLAY_POLL_INTERVAL 1UL /* 1 ms */
+#define ZSI_REPLAY_LOG_HEADER_SIZE (ZSI_TRAFFIC_LOG_MAGIC_SIZE + 1U)
+
+/******************************************************************************
+                               Types section
+ ******************************************************************************/
+/* Frame sent by the host and not matched with the log yet */
+typedef struct _ZsiReplaySentFrame_t
+{
+  uint8_t            frameControl;
+  uint8_t            sequenceNumber;
+  ZsiCommandHeader_t commandHeader;
+  uint64_t           time;
+} ZsiReplaySentFrame_t;
+
+typedef struct _ZsiReplayStats_t
+{
+  uint32_t delivered;
+  uint32_t matched;
+  uint32_t mismatched;
+  uint32_t missed;
+  uint32_t unexpected;
+  uint32_t sreqs;
+  uint64_t sreqTimeSum;
+  uint64_t sreqTimeMax;
+  uint64_t maxLateness;
+} ZsiReplayStats_t;
+
+/******************************************************************************
+                              Global functions prototypes section
+******************************************************************************/
+void zsiMediumHandler(void);
+
+/******************************************************************************
+                              Static functions prototypes section
+******************************************************************************/
+static void zsiReplayLoad(void);
+static void zsiReplayProcess(void);
+static void zsiReplayPollTimerFired(void);
+static bool zsiReplayDeliver(const ZsiTrafficRecord_t *const record, const uint8_t *frame,
+  uint16_t length);
+static void zsiReplayMatch(const ZsiTrafficRecord_t *const record, const uint8_t *frame,
+  uint16_t length);
+static void zsiReplayFinish(void);
+
+/******************************************************************************
+                              Static variables section
+******************************************************************************/
+static uint8_t *replayLog;
+static size_t replayLogSize;
+static size_t replayPosition;
+static uint64_t replayStartTime;
+/* Time when the previous record was replayed */
+static uint64_t replayEventTime;
+static bool replaySendingDone;
+static ZsiReplaySentFrame_t replaySent[ZSI_REPLAY_SENT_FRAMES_AMOUNT];
+static uint8_t replaySentAmount;
+/* Recorded sequence numbers of host frames to actual ones */
+static uint8_t replaySequenceMap[UINT8_MAX + 1U];
+static uint64_t replaySreqTime[UINT8_MAX + 1U];
+static ZsiReplayStats_t replayStats;
+static HAL_AppTimer_t replayPollTimer =
+{
+  .interval = ZSI_REPLAY_POLL_INTERVAL,
+  .mode = TIMER_ONE_SHOT_MODE,
+  .callback = zsiReplayPollTimerFired
+};
+
+/******************************************************************************
+                              Implementations section
+******************************************************************************/
+/******************************************************************************
+  \brief Replays the log: confirms sending, matches frames sent by the host
+         and passes due recorded frames to serial controller.
+
+  \return None.
+ ******************************************************************************/
+void zsiMediumHandler(void)
+{
+  if (replaySendingDone)
+  {
+    replaySendingDone = false;
+    zsiMediumSendingDone();
+  }
+  zsiReplayProcess();
+}
+
+/******************************************************************************
+  \brief Serial medium initialization routine. Loads the log on the first call,
+         replay position is kept over serial controller resets.
+
+  \return Initialization status.
+ ******************************************************************************/
+int zsiMediumInit(void)
+{
+  if (!replayLog)
+    zsiReplayLoad();
+
+  replaySendingDone = false;
+  HAL_StopAppTimer(&replayPollTimer);
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+  return 0;
+}
+
+/******************************************************************************
+  \brief Pass data for transmission through medium. Frame is kept for matching
+         with the log and sending is confirmed on the next handler call.
+
+  \param[in] frame - frame, which keeps serialized data.
+  \param[in] size - actual frame size.
+
+  \return Transmission status.
+ ******************************************************************************/
+int zsiMediumSend(void *frame, uint16_t size)
+{
+  const ZsiCommandFrame_t *const commandFrame = (const ZsiCommandFrame_t *)frame;
+  ZsiReplaySentFrame_t *sent;
+
+  if (ZSI_REPLAY_SENT_FRAMES_AMOUNT == replaySentAmount)
+  {
+    /* Oldest frame is not in the log at all */
+    replayStats.unexpected++;
+    replaySentAmount--;
+    memmove(replaySent, replaySent + 1U, replaySentAmount * sizeof(replaySent[0]));
+  }
+
+  sent = &replaySent[replaySentAmount++];
+  sent->frameControl = commandFrame->frameControl;
+  sent->sequenceNumber = commandFrame->sequenceNumber;
+  if (IS_ACK_CMD_FRAME(commandFrame))
+    memset(&sent->commandHeader, 0U, sizeof(sent->commandHeader));
+  else
+    sent->commandHeader = commandFrame->commandHeader;
+  sent->time = zsiTrafficTime();
+
+  replaySendingDone = true;
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+  return size;
+}
+
+/******************************************************************************
+  \brief Performs holding of all HAL tasks. Replay is driven by serial task.
+
+  \return None.
+ ******************************************************************************/
+void zsiMediumPerformHalHoldTasks(void)
+{
+  HAL_HoldOnTasks(0U);
+}
+
+/******************************************************************************
+  \brief Releasing all previously held HAL tasks.
+
+  \return None.
+ ******************************************************************************/
+void zsiMediumReleaseAllHeldTasks(void)
+{
+  HAL_ReleaseAllHeldTasks();
+}
+
+/******************************************************************************
+  \brief Reads the whole log to memory.
+
+  \return None.
+ ******************************************************************************/
+static void zsiReplayLoad(void)
+{
+  FILE *file = fopen(ZSI_TRAFFIC_REPLAY_FILE, "rb");
+  long size;
+
+  if (!file)
+  {
+    fprintf(stderr, "Failed to open ZAppSI traffic log %s\n", ZSI_TRAFFIC_REPLAY_FILE);
+    exit(1);
+  }
+
+  fseek(file, 0L, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0L, SEEK_SET);
+  replayLog = (size > 0L) ? malloc((size_t)size) : NULL;
+  if (!replayLog || (1U != fread(replayLog, (size_t)size, 1U, file)) ||
+      ((size_t)size < ZSI_REPLAY_LOG_HEADER_SIZE) ||
+      memcmp(replayLog, ZSI_TRAFFIC_LOG_MAGIC, ZSI_TRAFFIC_LOG_MAGIC_SIZE) ||
+      (ZSI_TRAFFIC_LOG_VERSION != replayLog[ZSI_TRAFFIC_LOG_MAGIC_SIZE]))
+  {
+    fprintf(stderr, "%s is not a ZAppSI traffic log\n", ZSI_TRAFFIC_REPLAY_FILE);
+    exit(1);
+  }
+  fclose(file);
+
+  replayLogSize = (size_t)size;
+  replayPosition = ZSI_REPLAY_LOG_HEADER_SIZE;
+  for (uint16_t i = 0U; i <= UINT8_MAX; i++)
+    replaySequenceMap[i] = (uint8_t)i;
+  replayStartTime = replayEventTime = zsiTrafficTime();
+}
+
+/******************************************************************************
+  \brief Poll timer fired callback. Serial task is not reposted by the handler
+         itself since it has priority over driver task and would starve it.
+
+  \return None.
+ ******************************************************************************/
+static void zsiReplayPollTimerFired(void)
+{
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+}
+
+/******************************************************************************
+  \brief Processes log records: passes due frames to the host and matches
+         sent ones, up to the frame which host has not sent yet or which
+         time has not come.
+
+  \return None.
+ ******************************************************************************/
+static void zsiReplayProcess(void)
+{
+  while (replayPosition < replayLogSize)
+  {
+    const uint8_t *frame = replayLog + replayPosition + sizeof(ZsiTrafficRecord_t);
+    const uint64_t now = zsiTrafficTime();
+    ZsiTrafficRecord_t record;
+    uint16_t length;
+    uint64_t due;
+
+    if (replayLogSize - replayPosition < sizeof(ZsiTrafficRecord_t))
+      break;
+    memcpy(&record, replayLog + replayPosition, sizeof(record));
+    length = LE16_TO_CPU(record.length);
+    if (replayLogSize - replayPosition - sizeof(record) < length)
+      break;
+    due = replayEventTime + LE32_TO_CPU(record.delta);
+
+    if (record.flags & ZSI_TRAFFIC_RECEIVED_FLAG)
+    {
+#if ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_ORIGINAL_TIMING
+      if (now < due)
+        break;
+#endif
+      /* Frame is kept in the log until there is memory to receive it */
+      if (!zsiReplayDeliver(&record, frame, length))
+        break;
+#if ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_ORIGINAL_TIMING
+      if (now - due > replayStats.maxLateness)
+        replayStats.maxLateness = now - due;
+#endif
+      replayPosition += sizeof(record) + length;
+      replayEventTime = now;
+      continue;
+    }
+
+    if (!replaySentAmount)
+    {
+      if (now < due + ZSI_REPLAY_STALL_TIMEOUT)
+        break;
+      replayStats.missed++;
+      replayPosition += sizeof(record) + length;
+      replayEventTime = now;
+      continue;
+    }
+
+    replayPosition += sizeof(record) + length;
+    zsiReplayMatch(&record, frame, length);
+  }
+
+  if (replayPosition < replayLogSize)
+  {
+    HAL_StopAppTimer(&replayPollTimer);
+    HAL_StartAppTimer(&replayPollTimer);
+  }
+  else
+    zsiReplayFinish();
+}
+
+/******************************************************************************
+  \brief Passes recorded network processor's frame to serial controller.
+         Sequence numbers of ACKs and SRSPs are replaced with ones used by
+         the host for the frames they are related to.
+
+  \param[in] record - log record.
+  \param[in] frame - recorded frame.
+  \param[in] length - recorded frame size.
+
+  \return False if there is no memory to receive the frame, true otherwise.
+ ******************************************************************************/
+static bool zsiReplayDeliver(const ZsiTrafficRecord_t *const record, const uint8_t *frame,
+  uint16_t length)
+{
+  const ZsiCommandFrame_t *const recorded = (const ZsiCommandFrame_t *)frame;
+  uint8_t status = record->flags & ZSI_TRAFFIC_STATUS_MASK;
+  uint8_t sequenceNumber = record->sequenceNumber;
+  uint8_t *buffer = NULL;
+
+  if (length)
+  {
+    const bool ack = (sizeof(ZsiAckFrame_t) == length);
+
+    if (ack)
+      buffer = zsiAllocateMemory(ZSI_RX_ACK_MEMORY);
+    else if (IS_SREQ_CMD_FRAME(recorded))
+      buffer = zsiAllocateMemory(ZSI_SREQ_CMD);
+    else if (IS_SRSP_CMD_FRAME(recorded))
+      buffer = zsiAllocateFrameMemory(ZSI_SRSP_CMD, length);
+    else
+      buffer = zsiAllocateFrameMemory(ZSI_MUTUAL_MEMORY, length);
+
+    if (!buffer)
+      return false;
+
+    if (sizeof(ZsiCommandFrame_t) < length)
+    {
+      zsiFreeMemory(buffer);
+      buffer = NULL;
+      status = ZSI_OVERFLOW_STATUS;
+    }
+    else
+    {
+      memcpy(buffer, frame, length);
+      if (ack || IS_SRSP_CMD_FRAME(recorded))
+      {
+        const uint8_t fcsSize = IS_CRC_FCS_CMD_FRAME(recorded) ? ZSI_CRC_FCS_SIZE : 1U;
+        ZsiRxFcs_t fcs;
+
+        sequenceNumber = replaySequenceMap[sequenceNumber];
+        buffer[ZSI_COMMAND_FRAME_PREAMBLE_SIZE] = sequenceNumber;
+        /* Keep the frame valid for the case it is recorded again */
+        zsiRxFcsStart(&fcs, buffer[1]);
+        zsiRxFcsUpdate(&fcs, buffer + 2U, length - 2U - fcsSize);
+        buffer[length - fcsSize] = (uint8_t)fcs.value;
+        if (ZSI_CRC_FCS_SIZE == fcsSize)
+          buffer[length - 1U] = (uint8_t)(fcs.value >> 8U);
+      }
+      if (IS_SRSP_CMD_FRAME(recorded) && !ack && replaySreqTime[sequenceNumber])
+      {
+        const uint64_t roundTrip = zsiTrafficTime() - replaySreqTime[sequenceNumber];
+
+        replaySreqTime[sequenceNumber] = 0U;
+        replayStats.sreqs++;
+        replayStats.sreqTimeSum += roundTrip;
+        if (roundTrip > replayStats.sreqTimeMax)
+          replayStats.sreqTimeMax = roundTrip;
+      }
+    }
+  }
+
+  replayStats.delivered++;
+  zsiMediumReceive(status, sequenceNumber, buffer);
+  return true;
+}
+
+/******************************************************************************
+  \brief Matches recorded host's frame with one of the frames sent by the host.
+
+  \param[in] record - log record.
+  \param[in] frame - recorded frame.
+  \param[in] length - recorded frame size.
+
+  \return None.
+ ******************************************************************************/
+static void zsiReplayMatch(const ZsiTrafficRecord_t *const record, const uint8_t *frame,
+  uint16_t length)
+{
+  const ZsiCommandFrame_t *const recorded = (const ZsiCommandFrame_t *)frame;
+  const bool ack = (sizeof(ZsiAckFrame_t) == length);
+  uint8_t i;
+
+  for (i = 0U; i < replaySentAmount; i++)
+  {
+    const ZsiReplaySentFrame_t *const sent = &replaySent[i];
+
+    if (((sent->frameControl ^ recorded->frameControl) & ZSI_CMD_TYPE_FIELD_MASK))
+      continue;
+    if (ack || ((sent->commandHeader.domain == recorded->commandHeader.domain) &&
+                (sent->commandHeader.commandId == recorded->commandHeader.commandId)))
+      break;
+  }
+
+  if (i < replaySentAmount)
+    replayStats.matched++;
+  else
+  {
+    replayStats.mismatched++;
+    i = 0U;
+  }
+
+  if (!ack)
+  {
+    replaySequenceMap[record->sequenceNumber] = replaySent[i].sequenceNumber;
+    if (IS_SREQ_CMD_FRAME(recorded))
+      replaySreqTime[replaySent[i].sequenceNumber] = replaySent[i].time;
+  }
+  replayEventTime = replaySent[i].time;
+
+  replaySentAmount--;
+  memmove(&replaySent[i], &replaySent[i + 1U], (replaySentAmount - i) * sizeof(replaySent[0]));
+}
+
+/******************************************************************************
+  \brief Prints replay summary and terminates the process. Exit status is
+         nonzero if the host did not send the recorded frames.
+
+  \return None.
+ ******************************************************************************/
+static void zsiReplayFinish(void)
+{
+  const double elapsed = (double)(zsiTrafficTime() - replayStartTime) / 1000000.0;
+  const uint32_t frames = replayStats.delivered + replayStats.matched + replayStats.mismatched;
+
+  replayStats.unexpected += replaySentAmount;
+  printf("ZAppSI replay of %s: %.3f s, %u frames received, %u sent (%.0f frames/s)\n",
+    ZSI_TRAFFIC_REPLAY_FILE, elapsed, replayStats.delivered,
+    replayStats.matched + replayStats.mismatched, elapsed > 0.0 ? frames / elapsed : 0.0);
+  printf("  sent frames: %u matched, %u mismatched, %u missed, %u unexpected\n",
+    replayStats.matched, replayStats.mismatched, replayStats.missed, replayStats.unexpected);
+  printf("  SREQ round trip: %u, average %.1f us, max %llu us\n", replayStats.sreqs,
+    replayStats.sreqs ? (double)replayStats.sreqTimeSum / replayStats.sreqs : 0.0,
+    (unsigned long long)replayStats.sreqTimeMax);
+#if ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_ORIGINAL_TIMING
+  printf("  max lateness: %llu us\n", (unsigned long long)replayStats.maxLateness);
+#endif
+  fflush(stdout);
+
+  free(replayLog);
+  exit((replayStats.mismatched || replayStats.missed || replayStats.unexpected) ? 1 : 0);
+}
+
+#endif /* ZSI_TRAFFIC_REPLAY != ZSI_TRAFFIC_REPLAY_DISABLED */
+/* eof zsiReplayAdapter.c */
@@ -25,36 +25,78 @@
 #include <zsiDbg.h>
 #include <sysUtils.h>
 #include <zsiTest.h>
+#include <zsiTrafficLog.h>
 
 /******************************************************************************
                                Defines section
  ******************************************************************************/
 #define ZSI_ACK_WAIT_PERIOD  500UL  /* 500 ms */
-#if CERTICOM_SUPPORT == 1
-#define ZSI_SRSP_WAIT_PERIOD 10000UL /* 10 seconds */
-#else
-#define ZSI_SRSP_WAIT_PERIOD 2000UL /* 2 seconds */
-#endif
 #define ZSI_OVERFLOW_DELAY   3000UL /* 3 seconds */
 
 #define ZSI_ACK_RETRIES_AMOUNT 3U
 
+/* Window slot flags */
+#define ZSI_WINDOW_SLOT_SEND_PENDING (1U << 0U)
+#define ZSI_WINDOW_SLOT_ON_MEDIUM    (1U << 1U)
+#define ZSI_WINDOW_SLOT_ACKED        (1U << 2U)
+#define ZSI_WINDOW_SLOT_OVERFLOW     (1U << 3U)
+
+/* Local receive window as advertised in ACK frames */
+#if ZSI_SERIAL_WINDOW_SIZE == 8U
+  #define ZSI_LOCAL_WINDOW_FIELD (3U << ZSI_WINDOW_FIELD_POS)
+#elif ZSI_SERIAL_WINDOW_SIZE == 4U
+  #define ZSI_LOCAL_WINDOW_FIELD (2U << ZSI_WINDOW_FIELD_POS)
+#elif ZSI_SERIAL_WINDOW_SIZE == 2U
+  #define ZSI_LOCAL_WINDOW_FIELD (1U << ZSI_WINDOW_FIELD_POS)
+#else
+  #define ZSI_LOCAL_WINDOW_FIELD 0U
+#endif
+
+/* Batch frames reception as advertised in ACK frames */
+#if ZSI_SERIAL_BATCHING == 1
+  #define ZSI_LOCAL_BATCH_FIELD ZSI_BATCH_SUPPORTED_FLAG
+#else
+  #define ZSI_LOCAL_BATCH_FIELD 0U
+#endif
+
+/* CRC-16 FCS as advertised in ACK frames */
+#if ZSI_SERIAL_CRC_FCS == 1
+  #define ZSI_LOCAL_CRC_FCS_FIELD ZSI_CRC_FCS_FLAG
+#else
+  #define ZSI_LOCAL_CRC_FCS_FIELD 0U
+#endif
+
 /******************************************************************************
                                Prototypes section
  ******************************************************************************/
 static void zsiAddFrameFcs(void *const frame);
-static bool zsiCheckFrameFcs(const void *const frame);
+static uint16_t zsiCalculateFrameCrc(const void *const frame);
 static uint8_t *zsiGetFrameFcsField(const void *const frame);
 static uint8_t zsiCalculateFrameFcs(const void *const frame);
 static void zsiPrepareAck(uint8_t status, uint8_t sequenceNumber,
   ZsiAckFrame_t *const ackFrame);
 static void zsiReplyWithAck(uint8_t status, uint8_t sequenceNumber);
 static void zsiSerialAckTimerFired(void);
-static void zsiSerialSrspTimerFired(void);
 static void zsiSerialOverflowTimerFired(void);
 static void zsiSerialAckReceived(const ZsiAckFrame_t *const ackFrame);
 static void zsiSerialCommandReceived(ZsiCommandFrame_t *const cmdFrame);
 static void zsiSerialResolveCollisions(void);
+static void zsiSerialMediumSend(void *const frame);
+static void zsiSerialApplyWindow(void);
+static uint8_t zsiLocalWindowField(void);
+static void zsiSerialAckSent(const ZsiAckFrame_t *const ackFrame);
+static bool zsiSerialWindowAccepts(const ZsiCommandFrame_t *const cmdFrame);
+static void zsiSerialWindowPut(ZsiCommandFrame_t *const cmdFrame);
+static void zsiSerialWindowRelease(uint8_t index);
+static void zsiSerialFillWindow(void);
+static void zsiSerialKickMedium(void);
+static void zsiSerialPostponeAck(uint8_t status, uint8_t sequenceNumber);
+static void zsiSerialWindowSendingDone(void *const frame);
+static void zsiSerialWindowAckReceived(const ZsiAckFrame_t *const ackFrame);
+static void zsiSerialCheckWindowTimeouts(void);
+static void zsiSerialArmWindowTimer(void);
+static void zsiSerialWindowTimerFired(void);
+static void zsiSerialBatchTxQueue(ZsiCommandFrame_t *const cmdFrame);
 
 /******************************************************************************
                                External functions section
@@ -66,6 +108,43 @@ extern void zsiMediumHandler(void);
 ******************************************************************************/
 uint8_t ackTxState;
 
+/* CRC-16/CCITT of single byte, SYS_Crc16Ccitt(0, byte) */
+static PROGMEM_DECLARE(uint16_t zsiCrcFcsTable[256]) =
+{
+  0x0000U, 0x1189U, 0x2312U, 0x329BU, 0x4624U, 0x57ADU, 0x6536U, 0x74BFU,
+  0x8C48U, 0x9DC1U, 0xAF5AU, 0xBED3U, 0xCA6CU, 0xDBE5U, 0xE97EU, 0xF8F7U,
+  0x1081U, 0x0108U, 0x3393U, 0x221AU, 0x56A5U, 0x472CU, 0x75B7U, 0x643EU,
+  0x9CC9U, 0x8D40U, 0xBFDBU, 0xAE52U, 0xDAEDU, 0xCB64U, 0xF9FFU, 0xE876U,
+  0x2102U, 0x308BU, 0x0210U, 0x1399U, 0x6726U, 0x76AFU, 0x4434U, 0x55BDU,
+  0xAD4AU, 0xBCC3U, 0x8E58U, 0x9FD1U, 0xEB6EU, 0xFAE7U, 0xC87CU, 0xD9F5U,
+  0x3183U, 0x200AU, 0x1291U, 0x0318U, 0x77A7U, 0x662EU, 0x54B5U, 0x453CU,
+  0xBDCBU, 0xAC42U, 0x9ED9U, 0x8F50U, 0xFBEFU, 0xEA66U, 0xD8FDU, 0xC974U,
+  0x4204U, 0x538DU, 0x6116U, 0x709FU, 0x0420U, 0x15A9U, 0x2732U, 0x36BBU,
+  0xCE4CU, 0xDFC5U, 0xED5EU, 0xFCD7U, 0x8868U, 0x99E1U, 0xAB7AU, 0xBAF3U,
+  0x5285U, 0x430CU, 0x7197U, 0x601EU, 0x14A1U, 0x0528U, 0x37B3U, 0x263AU,
+  0xDECDU, 0xCF44U, 0xFDDFU, 0xEC56U, 0x98E9U, 0x8960U, 0xBBFBU, 0xAA72U,
+  0x6306U, 0x728FU, 0x4014U, 0x519DU, 0x2522U, 0x34ABU, 0x0630U, 0x17B9U,
+  0xEF4EU, 0xFEC7U, 0xCC5CU, 0xDDD5U, 0xA96AU, 0xB8E3U, 0x8A78U, 0x9BF1U,
+  0x7387U, 0x620EU, 0x5095U, 0x411CU, 0x35A3U, 0x242AU, 0x16B1U, 0x0738U,
+  0xFFCFU, 0xEE46U, 0xDCDDU, 0xCD54U, 0xB9EBU, 0xA862U, 0x9AF9U, 0x8B70U,
+  0x8408U, 0x9581U, 0xA71AU, 0xB693U, 0xC22CU, 0xD3A5U, 0xE13EU, 0xF0B7U,
+  0x0840U, 0x19C9U, 0x2B52U, 0x3ADBU, 0x4E64U, 0x5FEDU, 0x6D76U, 0x7CFFU,
+  0x9489U, 0x8500U, 0xB79BU, 0xA612U, 0xD2ADU, 0xC324U, 0xF1BFU, 0xE036U,
+  0x18C1U, 0x0948U, 0x3BD3U, 0x2A5AU, 0x5EE5U, 0x4F6CU, 0x7DF7U, 0x6C7EU,
+  0xA50AU, 0xB483U, 0x8618U, 0x9791U, 0xE32EU, 0xF2A7U, 0xC03CU, 0xD1B5U,
+  0x2942U, 0x38CBU, 0x0A50U, 0x1BD9U, 0x6F66U, 0x7EEFU, 0x4C74U, 0x5DFDU,
+  0xB58BU, 0xA402U, 0x9699U, 0x8710U, 0xF3AFU, 0xE226U, 0xD0BDU, 0xC134U,
+  0x39C3U, 0x284AU, 0x1AD1U, 0x0B58U, 0x7FE7U, 0x6E6EU, 0x5CF5U, 0x4D7CU,
+  0xC60CU, 0xD785U, 0xE51EU, 0xF497U, 0x8028U, 0x91A1U, 0xA33AU, 0xB2B3U,
+  0x4A44U, 0x5BCDU, 0x6956U, 0x78DFU, 0x0C60U, 0x1DE9U, 0x2F72U, 0x3EFBU,
+  0xD68DU, 0xC704U, 0xF59FU, 0xE416U, 0x90A9U, 0x8120U, 0xB3BBU, 0xA232U,
+  0x5AC5U, 0x4B4CU, 0x79D7U, 0x685EU, 0x1CE1U, 0x0D68U, 0x3FF3U, 0x2E7AU,
+  0xE70EU, 0xF687U, 0xC41CU, 0xD595U, 0xA12AU, 0xB0A3U, 0x8238U, 0x93B1U,
+  0x6B46U, 0x7ACFU, 0x4854U, 0x59DDU, 0x2D62U, 0x3CEBU, 0x0E70U, 0x1FF9U,
+  0xF78FU, 0xE606U, 0xD49DU, 0xC514U, 0xB1ABU, 0xA022U, 0x92B9U, 0x8330U,
+  0x7BC7U, 0x6A4EU, 0x58D5U, 0x495CU, 0x3DE3U, 0x2C6AU, 0x1EF1U, 0x0F78U
+};
+
 /******************************************************************************
                               Implementations section
 ******************************************************************************/
@@ -108,6 +187,23 @@ INLINE void zsiSerialCollisionResolved(uint8_t status)
   COLLISION_STATUS_LOGGING(zsiSerial()->collisionStatus);
 }
 
+/******************************************************************************
+  \brief Updates CRC-16 by the next byte. Same as SYS_Crc16Ccitt(), but
+         table-driven.
+
+  \param[in] crc - current CRC value.
+  \param[in] byte - next byte.
+
+  \return Updated CRC value.
+ ******************************************************************************/
+INLINE uint16_t zsiCrcFcsUpdate(uint16_t crc, uint8_t byte)
+{
+  uint16_t entry;
+
+  memcpy_P(&entry, &zsiCrcFcsTable[(uint8_t)(crc ^ byte)], sizeof(entry));
+  return (crc >> 8U) ^ entry;
+}
+
 /******************************************************************************
   \brief Start synchronous mode timer.
 
@@ -143,19 +239,24 @@ INLINE void zsiSerialStopSynchroModeTimer(void)
  ******************************************************************************/
 void zsiResetSerial(void)
 {
+  /* Timers are stopped before their queue links are cleared */
+  HAL_StopAppTimer(&zsiSerial()->ackWaitTimer);
+  HAL_StopAppTimer(&zsiSerial()->overflowTimer);
+  HAL_StopAppTimer(&zsiSerial()->window.timer);
   memset(zsiSerial(), 0x00, sizeof(ZsiSerialController_t));
 
-  HAL_StopAppTimer(&zsiSerial()->ackWaitTimer);
   zsiSerial()->ackWaitTimer.mode = TIMER_ONE_SHOT_MODE;
   zsiSerial()->ackWaitTimer.interval = ZSI_ACK_WAIT_PERIOD;
   zsiSerial()->ackWaitTimer.callback = zsiSerialAckTimerFired;
   zsiSerial()->ackRetries = ZSI_ACK_RETRIES_AMOUNT;
 
-  HAL_StopAppTimer(&zsiSerial()->overflowTimer);
   zsiSerial()->overflowTimer.mode = TIMER_ONE_SHOT_MODE;
   zsiSerial()->overflowTimer.interval = ZSI_OVERFLOW_DELAY;
   zsiSerial()->overflowTimer.callback = zsiSerialOverflowTimerFired;
-  
+
+  zsiSerial()->window.timer.mode = TIMER_ONE_SHOT_MODE;
+  zsiSerial()->window.timer.callback = zsiSerialWindowTimerFired;
+
   zsiMediumInit();
   zsiSerialChangeState(ZSI_SERIAL_STATE_IDLE);
 }
@@ -167,9 +268,25 @@ void zsiResetSerial(void)
  ******************************************************************************/
 bool zsiSerialIsBusy(void)
 {
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+
+  if (zsiSerialIsWindowed())
+    return (window->used >= window->size) ||
+           getLinkedQueueElem(&zsiSerial()->txQueue);
+
   return (zsiSerial()->currentTransmission) ? true : false;
 }
 
+/******************************************************************************
+  \brief Checks if frames are transmitted in windowed mode.
+
+  \return True, if windowed mode was negotiated, false - for stop-and-wait.
+ ******************************************************************************/
+bool zsiSerialIsWindowed(void)
+{
+  return zsiSerial()->window.size > 1U;
+}
+
 /******************************************************************************
   \brief Transaction has been finished. Clear pointer and memory.
 *******************************************************************************/
@@ -180,6 +297,10 @@ void zsiSerialClearCurTransac(void)
   zsiFreeMemory(frame);
   zsiSerial()->currentTransmission = NULL;
   zsiSerialChangeState(ZSI_SERIAL_STATE_IDLE);
+
+  /* Frames postponed during the transaction may be sent now */
+  if (getLinkedQueueElem(&zsiSerial()->txQueue))
+    zsiPostTask(ZSI_SERIAL_TASK_ID);
 }
 
 /******************************************************************************
@@ -190,6 +311,10 @@ void zsiSerialClearCurTransac(void)
 void zsiSerialTaskHandler(void)
 {
   zsiMediumHandler();
+  zsiSerialApplyWindow();
+
+  if (zsiSerial()->window.used)
+    zsiSerialCheckWindowTimeouts();
 
   switch (zsiSerial()->state)
   {
@@ -197,18 +322,20 @@ void zsiSerialTaskHandler(void)
     {
       ZsiMemoryBuffer_t *buffer;
 
+      if (zsiSerialIsWindowed())
+        zsiSerialFillWindow();
       /* Process frames to transmit with highest priority */
-      if (NULL != (buffer = getQueueElem(&zsiSerial()->txQueue)))
+      else if (NULL != (buffer = getLinkedQueueElem(&zsiSerial()->txQueue)))
         if (!zsiSerialIsBusy())
         {
-          deleteHeadQueueElem(&zsiSerial()->txQueue);
+          deleteHeadLinkedQueueElem(&zsiSerial()->txQueue);
+          zsiSerialBatchTxQueue(&buffer->commandFrame);
           zsiSerialSend(&buffer->commandFrame);
         }
     }
     break;
 
     case ZSI_SERIAL_STATE_WAITING_ACK:
-    case ZSI_SERIAL_STATE_WAITING_SRSP:
     {
       /* Process synchroModeTimer if started */
       ZsiSerialSynchroModeTimer_t *timer = &zsiSerial()->synchroModeTimer;
@@ -218,11 +345,7 @@ void zsiSerialTaskHandler(void)
         if (HAL_GetSystemTime() > timer->expirationTime)
         {
           timer->started = false;
-
-          if (ZSI_SERIAL_STATE_WAITING_ACK == zsiSerial()->state)
-            zsiSerialAckTimerFired();
-          else
-            zsiSerialSrspTimerFired();
+          zsiSerialAckTimerFired();
         }
         else
         {
@@ -238,8 +361,9 @@ void zsiSerialTaskHandler(void)
       break;
   }
 
-  /* Post task if any command is still pending */
-  if (getQueueElem(&zsiSerial()->txQueue))
+  /* Post task if any command is still pending. In windowed mode the task is
+     posted as soon as window slot is released. */
+  if (!zsiSerialIsWindowed() && getLinkedQueueElem(&zsiSerial()->txQueue))
     zsiPostTask(ZSI_SERIAL_TASK_ID);
 }
 
@@ -252,6 +376,21 @@ void zsiSerialTaskHandler(void)
  ******************************************************************************/
 void zsiSerialSend(ZsiCommandFrame_t *const cmdFrame)
 {
+  /* Frames don't wait for previous frames' ACKs in windowed mode */
+  if (zsiSerialIsWindowed())
+  {
+    if (!zsiSerialWindowAccepts(cmdFrame))
+    {
+      zsiSerialStoreTxCmd(cmdFrame);
+      return;
+    }
+
+    zsiAddFrameFcs(cmdFrame);
+    zsiSerialWindowPut(cmdFrame);
+    zsiSerialKickMedium();
+    return;
+  }
+
   sysAssert(ZSI_SERIAL_STATE_IDLE == zsiSerial()->state,
          ZSISERIALCONTROLLER_ZSISERIALSEND0);
 
@@ -262,7 +401,7 @@ void zsiSerialSend(ZsiCommandFrame_t *const cmdFrame)
   zsiAddFrameFcs(cmdFrame);
 
   /* Start command sending through medium */
-  zsiMediumSend(cmdFrame, zsiActualFrameLength(cmdFrame));
+  zsiSerialMediumSend(cmdFrame);
 }
 
 /******************************************************************************
@@ -272,6 +411,16 @@ void zsiSerialSend(ZsiCommandFrame_t *const cmdFrame)
  ******************************************************************************/
 void zsiMediumSendingDone(void)
 {
+  void *const frame = zsiSerial()->mediumFrame;
+
+  zsiSerial()->mediumFrame = NULL;
+
+  if (zsiSerialIsWindowed())
+  {
+    zsiSerialWindowSendingDone(frame);
+    return;
+  }
+
   /* Resolve collision, if occured */
   if (zsiSerial()->collisionStatus)
     zsiSerialResolveCollisions();
@@ -279,8 +428,7 @@ void zsiMediumSendingDone(void)
   if (ZSI_ACK_TX_IS_IN_PROGRESS(ackTxState))
   {
     ZSI_ACK_TX_COMPLETE(ackTxState);
-    ZSI_ACK_TX_COUNT_UP(ackTxState);
-    zsiPostTask(ZSI_DRIVER_TASK_ID);
+    zsiSerialAckSent(frame);
   }
 
   /* If serial controller is idle - release current transmission */
@@ -315,28 +463,72 @@ void zsiMediumReceive(uint8_t status, uint8_t sequenceNumber, void *const frame)
   bool ackRequired = true;
 
   RECEIVE_FRAME_LOGGING(frame);
+  ZSI_TRAFFIC_RECORD(ZSI_TRAFFIC_RECEIVED_FLAG | status, sequenceNumber, frame,
+                     frame ? zsiActualFrameLength(frame) : 0U);
 
   /* Send ACK in case of overflow or invalid FCS */
   if (ZSI_OVERFLOW_STATUS == status)
   {
-    status = status;
+    zsiSerial()->stats.overflowAcksSent++;
   }
-  /* If FCS is incorrect - reply with corresponding ACK */
-  else if (!zsiCheckFrameFcs(frame))
+  /* FCS is verified by medium adapter while frame is received. If FCS is
+     incorrect - reply with corresponding ACK */
+  else if (ZSI_INVALID_FCS_STATUS == status)
   {
-    status = ZSI_INVALID_FCS_STATUS;
+    zsiSerial()->stats.fcsFailures++;
     zsiFreeMemory(frame);
   }
   /* Process frames received without errors */
   else if (IS_ACK_CMD_FRAME((ZsiCommandFrame_t *)frame))
   {
+    const ZsiAckFrame_t *const ackFrame = (const ZsiAckFrame_t *)frame;
+
+    /* Remote device advertises its receive window and batch frames support
+       in successful ACKs */
+    if (IS_NO_ERROR_STATUS(ackFrame))
+    {
+      if (zsiSerial()->window.remoteSize != ZSI_GET_ACK_WINDOW(ackFrame))
+      {
+        zsiSerial()->window.remoteSize = ZSI_GET_ACK_WINDOW(ackFrame);
+        zsiPostTask(ZSI_SERIAL_TASK_ID);
+      }
+      zsiSerial()->remoteBatching =
+        (ackFrame->frameControl & ZSI_BATCH_SUPPORTED_FLAG) ? true : false;
+      zsiSerial()->remoteCrcFcs =
+        (ackFrame->frameControl & ZSI_CRC_FCS_FLAG) ? true : false;
+    }
+    else if (IS_OVERFLOW_STATUS(ackFrame))
+      zsiSerial()->stats.overflowAcksReceived++;
+
     /* Received ACK processing. No ACK should be sent on ACK frames. */
-    if (zsiSerial()->currentTransmission)
-      zsiSerialAckReceived(frame);
+    if (zsiSerialIsWindowed())
+      zsiSerialWindowAckReceived(ackFrame);
+    else if (zsiSerial()->currentTransmission)
+      zsiSerialAckReceived(ackFrame);
     else
       sysAssert(false, ZSISERIALCONTROLLER_ZSISERIALRECEIVE0);
     ackRequired = false;
   }
+  /* Upper layers get CRC-16 frames in the usual format with one byte FCS */
+  else if (IS_CRC_FCS_CMD_FRAME((ZsiCommandFrame_t *)frame))
+  {
+    ZsiCommandFrame_t *const cmdFrame = (ZsiCommandFrame_t *)frame;
+
+    cmdFrame->frameControl &= ~ZSI_CRC_FCS_FLAG;
+    cmdFrame->length =
+      CPU_TO_LE16(LE16_TO_CPU(cmdFrame->length) - (ZSI_CRC_FCS_SIZE - 1U));
+  }
+
+  /* Received AREQs are counted against the quota of their domain. Frames
+     above the quota are rejected with overflow, so the remote device resends
+     them when memory is freed. */
+  if ((ZSI_NO_ERROR_STATUS == status) && IS_AREQ_CMD_FRAME((ZsiCommandFrame_t *)frame) &&
+      !zsiChargeMemoryQuota(frame, ((ZsiCommandFrame_t *)frame)->commandHeader.domain))
+  {
+    zsiFreeMemory(frame);
+    zsiSerial()->stats.overflowAcksSent++;
+    status = ZSI_OVERFLOW_STATUS;
+  }
 
   /* Send ACK if required */
   if (ackRequired)
@@ -364,8 +556,18 @@ void zsiMediumReceive(uint8_t status, uint8_t sequenceNumber, void *const frame)
  ******************************************************************************/
 static void zsiReplyWithAck(uint8_t status, uint8_t sequenceNumber)
 {
-  ZsiAckFrame_t *const ackFrame = zsiAllocateMemory(ZSI_TX_ACK_MEMORY);
+  ZsiAckFrame_t *ackFrame;
+
+  /* There may be several frames to acknowledge in windowed mode, so ACKs are
+     queued and sent when medium is free */
+  if (zsiSerialIsWindowed())
+  {
+    zsiSerialPostponeAck(status, sequenceNumber);
+    zsiSerialKickMedium();
+    return;
+  }
 
+  ackFrame = zsiAllocateMemory(ZSI_TX_ACK_MEMORY);
   /* Prepare ACK frame */
   zsiPrepareAck(status, sequenceNumber, ackFrame);
   /* Send ACK. Raise collision, if current transaction inprogress. */
@@ -380,7 +582,7 @@ static void zsiReplyWithAck(uint8_t status, uint8_t sequenceNumber)
   {
     zsiSerial()->currentTransmission = ackFrame;
     ZSI_ACK_TX_IN_PROGRESS(ackTxState);
-    zsiMediumSend(ackFrame, zsiActualFrameLength(ackFrame));
+    zsiSerialMediumSend(ackFrame);
   }
 }
 
@@ -418,9 +620,51 @@ static void zsiPrepareAck(uint8_t status, uint8_t sequenceNumber,
   ackFrame->length = sizeof(ZsiAckFrame_t) - ZSI_COMMAND_FRAME_PREAMBLE_SIZE;
   ackFrame->sequenceNumber = sequenceNumber;
   ackFrame->frameControl = ZSI_ACK_CMD | status;
+  /* Legacy devices compare error statuses with the whole frame control field,
+     so the window is advertised in successful ACKs only */
+  if (ZSI_NO_ERROR_STATUS == status)
+    ackFrame->frameControl |= zsiLocalWindowField() | ZSI_LOCAL_BATCH_FIELD |
+                              ZSI_LOCAL_CRC_FCS_FIELD;
   zsiAddFrameFcs(ackFrame);
 }
 
+/******************************************************************************
+  \brief Calculates receive window to be advertised. Window is limited by
+         the amount of free buffers, so the remote device doesn't send frames
+         which would be rejected with overflow. It is never reduced below two
+         frames to avoid switching link mode.
+
+  \return Window field of ACK frame control.
+ ******************************************************************************/
+static uint8_t zsiLocalWindowField(void)
+{
+  uint8_t field = ZSI_LOCAL_WINDOW_FIELD >> ZSI_WINDOW_FIELD_POS;
+  const uint8_t freeBuffers = zsiFreeRxMemoryAmount();
+
+  while ((field > 1U) && ((1U << field) > freeBuffers))
+    field--;
+
+  return field << ZSI_WINDOW_FIELD_POS;
+}
+
+/******************************************************************************
+  \brief ACK transmission finished. Frames acknowledged successfully may be
+         processed by the driver. Frames rejected with error ACKs were not
+         queued, so they aren't counted.
+
+  \param[in] ackFrame - ACK frame which has been sent.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialAckSent(const ZsiAckFrame_t *const ackFrame)
+{
+  if (ackFrame && !IS_NO_ERROR_STATUS(ackFrame))
+    return;
+
+  ZSI_ACK_TX_COUNT_UP(ackTxState);
+  zsiPostTask(ZSI_DRIVER_TASK_ID);
+}
+
 #ifdef ZSI_TEST
 /******************************************************************************
   \brief Wrapper to prepare ACK frame.
@@ -480,10 +724,11 @@ static void zsiSerialAckReceived(const ZsiAckFrame_t *const ackFrame)
     if (IS_INVALID_FCS_STATUS(ackFrame))
     {
       /* Resend if there is no ACK transmission raised from collision resolving */
+      zsiSerial()->stats.retransmissions++;
       if (collision)
         zsiSerialRaiseCollision(ZSI_SERIAL_IMMIDIATE_CMD_SEND_REQUIRED);
       else
-        zsiMediumSend(frame, zsiActualFrameLength(frame));
+        zsiSerialMediumSend(frame);
     }
     /* If overflow occured on the remote device - wait appropriate period and
        resend frame */
@@ -499,13 +744,7 @@ static void zsiSerialAckReceived(const ZsiAckFrame_t *const ackFrame)
      collision */
   if (collision)
     zsiSerialRaiseCollision(ZSI_SERIAL_CMD_TRANSMISSION_FINISHED);
-  /* Start SRSP waiting for SREQ */
-  else if (IS_SREQ_CMD_FRAME(frame))
-  {
-    zsiSerialChangeState(ZSI_SERIAL_STATE_WAITING_SRSP);
-    zsiSerialStartSynchroModeTimer(ZSI_SRSP_WAIT_PERIOD);
-  }
-  /* Release memory reserved for AREQ and SRSP */
+  /* Release memory reserved for the frame. SRSP waiting is up to driver. */
   else
   {
     zsiSerialClearCurTransac();
@@ -524,23 +763,7 @@ static void zsiSerialAckReceived(const ZsiAckFrame_t *const ackFrame)
  ******************************************************************************/
 static void zsiSerialCommandReceived(ZsiCommandFrame_t *const cmdFrame)
 {
-  ZsiCommandFrame_t *frame =
-    (ZsiCommandFrame_t *)zsiSerial()->currentTransmission;
-
-  if (IS_SRSP_CMD_FRAME(cmdFrame))
-  {
-    sysAssert((ZSI_SERIAL_STATE_WAITING_SRSP == zsiSerial()->state) &&
-           zsiSerial()->synchroModeTimer.started,
-           ZSISERIALCONTROLLER_ZSISERIALCOMMANDRECEIVED0);
-
-    if (cmdFrame->sequenceNumber != frame->sequenceNumber)
-    {
-      sysAssert(false, ZSISERIALCONTROLLER_ZSISERIALCOMMANDRECEIVED1);
-      return;
-    }
-
-    zsiSerialStopSynchroModeTimer();
-  }
+  /* SRSPs are linked with pending SREQs by driver */
   // store to queue till ack will be received
   zsiDriverStoreRxCmd(cmdFrame);
 }
@@ -556,17 +779,12 @@ void zsiSerialStoreTxCmd(const ZsiCommandFrame_t *const cmdFrame)
 {
   ZsiMemoryBuffer_t *buffer = GET_PARENT_BY_FIELD(ZsiMemoryBuffer_t,
     commandFrame, cmdFrame);
-  ZsiMemoryBuffer_t *topElement = getQueueElem(&zsiSerial()->txQueue);
 
   /* SRSP frames should be transmitted first */
-  if (IS_SRSP_CMD_FRAME(cmdFrame) && topElement)
-  {
-    zsiSerial()->txQueue.head = NULL;
-    putQueueElem(&zsiSerial()->txQueue, buffer);
-    putQueueElem(&zsiSerial()->txQueue, topElement);
-  }
+  if (IS_SRSP_CMD_FRAME(cmdFrame))
+    putHeadLinkedQueueElem(&zsiSerial()->txQueue, buffer);
   else
-    putQueueElem(&zsiSerial()->txQueue, buffer);
+    putLinkedQueueElem(&zsiSerial()->txQueue, buffer);
 
   zsiPostTask(ZSI_SERIAL_TASK_ID);
 }
@@ -590,7 +808,7 @@ static void zsiSerialResolveCollisions(void)
     zsiSerial()->currentTransmission = ackFrame;
     zsiSerialCollisionResolved(ZSI_SERIAL_IMMIDIATE_ACK_REQUIRED);
     ZSI_ACK_TX_IN_PROGRESS(ackTxState);
-    zsiMediumSend(ackFrame, zsiActualFrameLength(ackFrame));
+    zsiSerialMediumSend(ackFrame);
     zsiSerial()->currentTransmission = tmpPtr;
     return;
   }
@@ -601,7 +819,7 @@ static void zsiSerialResolveCollisions(void)
   /* Immediate command sending */
   if (ZSI_SERIAL_IMMIDIATE_CMD_SEND_REQUIRED & zsiSerial()->collisionStatus)
   {
-    zsiMediumSend(frame, zsiActualFrameLength(frame));
+    zsiSerialMediumSend(frame);
     zsiSerialCollisionResolved(ZSI_SERIAL_IMMIDIATE_CMD_SEND_REQUIRED);
   }
 
@@ -625,6 +843,7 @@ static void zsiSerialAckTimerFired(void)
   if (zsiSerial()->ackRetries)
   {
     zsiSerial()->ackRetries--;
+    zsiSerial()->stats.retransmissions++;
     sysAssert(ZSI_SERIAL_STATE_WAITING_ACK == zsiSerial()->state,
            ZSISERIALCONTROLLER_ZSISERIALACKTIMERFIRED0);
     /* Change state to retransmit frame */
@@ -639,7 +858,7 @@ static void zsiSerialAckTimerFired(void)
     {
       ZsiCommandFrame_t *cmdFrame =
         (ZsiCommandFrame_t *)zsiSerial()->currentTransmission;
-      zsiMediumSend(cmdFrame, zsiActualFrameLength(cmdFrame));
+      zsiSerialMediumSend(cmdFrame);
     }
   }
   /* All attempts are failed - raise LOST_SYNCHRONIZATION event */
@@ -650,22 +869,6 @@ static void zsiSerialAckTimerFired(void)
   }
 }
 
-/******************************************************************************
-  \brief SRSP timer expiration callback. No SRSP was received from remote device
-         in appropriated time. Appeals to syncronization lost event.
-
-  \return None.
- ******************************************************************************/
-static void zsiSerialSrspTimerFired(void)
-{
-  /* If this timer fired - abnormal situation occured.
-     Lost syncronization event must be indicated. Today it is assert(0)   */
-  sysAssert(ZSI_SERIAL_STATE_WAITING_SRSP == zsiSerial()->state,
-         ZSISERIALCONTROLLER_ZSISERIALSRSPTIMERFIRED0);
-  sysAssert(0U, ZSISERIALCONTROLLER_ZSISERIALSRSPTIMERFIRED1);
-  SYS_PostEvent(BC_ZSI_LOST_SYNCHRONIZATION, 0U);
-}
-
 /******************************************************************************
   \brief Overflow timer expiration callback. Retransmission can be performed.
 
@@ -681,15 +884,456 @@ static void zsiSerialOverflowTimerFired(void)
          ZSISERIALCONTROLLER_ZSISERIALOVERFLOWTIMERFIRED0);
 
   zsiSerialChangeState(ZSI_SERIAL_STATE_SENDING);
+  zsiSerial()->stats.retransmissions++;
   /* Resend if there is no ACK transmission raised from collision resolving */
   if (IS_ACK_CMD_FRAME(frame))
     zsiSerialRaiseCollision(ZSI_SERIAL_IMMIDIATE_CMD_SEND_REQUIRED);
   else
-    zsiMediumSend(frame, zsiActualFrameLength(frame));
+    zsiSerialMediumSend(frame);
+}
+
+/******************************************************************************
+  \brief Passes frame to the medium and keeps it until sending is done.
+
+  \param[in] frame - frame, which keeps serialized data.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialMediumSend(void *const frame)
+{
+  const uint16_t size = zsiActualFrameLength((ZsiCommandFrame_t *)frame);
+
+  zsiSerial()->mediumFrame = frame;
+  ZSI_TRAFFIC_RECORD(0U, ((ZsiCommandFrame_t *)frame)->sequenceNumber, frame, size);
+  zsiMediumSend(frame, size);
+}
+
+/******************************************************************************
+  \brief Switches the link to the window size negotiated with remote device.
+         Mode is changed only when there is no transmission in progress,
+         window size within windowed mode is changed at once.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialApplyWindow(void)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  uint8_t size = MIN(ZSI_SERIAL_WINDOW_SIZE, window->remoteSize);
+
+  if (size == window->size)
+    return;
+
+  /* Frames above the new size stay in the window until acknowledged */
+  if ((size > 1U) && (window->size > 1U))
+  {
+    window->size = size;
+    return;
+  }
+
+  if (zsiSerial()->currentTransmission || zsiSerial()->mediumFrame ||
+      zsiSerial()->collisionStatus || window->used || window->pendingAcksAmount)
+    return;
+
+  window->size = size;
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+}
+
+/******************************************************************************
+  \brief Checks if frame can be put to the window. Frames with equal sequence
+         numbers (e.g. SRSP and own AREQ) shall not be unacknowledged at
+         the same time, otherwise ACKs can't be distinguished.
+
+  \param[in] cmdFrame - frame to be sent.
+
+  \return True, if frame can be sent right now, false - otherwise.
+ ******************************************************************************/
+static bool zsiSerialWindowAccepts(const ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  uint8_t it;
+
+  if (window->used >= window->size)
+    return false;
+
+  for (it = 0U; it < window->used; it++)
+    if (window->slots[it].frame->sequenceNumber == cmdFrame->sequenceNumber)
+      return false;
+
+  return true;
+}
+
+/******************************************************************************
+  \brief Puts frame to the window. Slots are kept in the transmission order.
+
+  \param[in] cmdFrame - frame to be sent.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialWindowPut(ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  ZsiSerialWindowSlot_t *const slot = &window->slots[window->used++];
+
+  slot->frame = cmdFrame;
+  slot->ackRetries = ZSI_ACK_RETRIES_AMOUNT;
+  slot->flags = ZSI_WINDOW_SLOT_SEND_PENDING;
+}
+
+/******************************************************************************
+  \brief Releases acknowledged frame and its window slot.
+
+  \param[in] index - slot index.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialWindowRelease(uint8_t index)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+
+  zsiFreeMemory(window->slots[index].frame);
+  window->used--;
+  memmove(&window->slots[index], &window->slots[index + 1U],
+          (window->used - index) * sizeof(ZsiSerialWindowSlot_t));
+
+  /* Next frame may be sent */
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+}
+
+/******************************************************************************
+  \brief Moves postponed frames to the window while there are free slots.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialFillWindow(void)
+{
+  ZsiMemoryBuffer_t *buffer;
+
+  while (NULL != (buffer = getLinkedQueueElem(&zsiSerial()->txQueue)))
+  {
+    if (!zsiSerialWindowAccepts(&buffer->commandFrame))
+      break;
+
+    deleteHeadLinkedQueueElem(&zsiSerial()->txQueue);
+    zsiSerialBatchTxQueue(&buffer->commandFrame);
+    zsiSerialSend(&buffer->commandFrame);
+  }
+}
+
+/******************************************************************************
+  \brief Passes next frame to the medium, if it is free. ACKs are sent first,
+         then window frames in transmission order.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialKickMedium(void)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  uint8_t it;
+
+  if (zsiSerial()->mediumFrame)
+    return;
+
+  if (window->pendingAcksAmount)
+  {
+    ZsiAckFrame_t *const ackFrame = zsiAllocateMemory(ZSI_TX_ACK_MEMORY);
+    ZsiSerialPendingAck_t *const ack = &window->pendingAcks[window->pendingAckHead];
+
+    zsiPrepareAck(ack->status, ack->sequenceNumber, ackFrame);
+    window->pendingAckHead = (window->pendingAckHead + 1U) & (ZSI_SERIAL_WINDOW_SIZE - 1U);
+    window->pendingAcksAmount--;
+    ZSI_ACK_TX_IN_PROGRESS(ackTxState);
+    zsiSerialMediumSend(ackFrame);
+    return;
+  }
+
+  for (it = 0U; it < window->used; it++)
+  {
+    ZsiSerialWindowSlot_t *const slot = &window->slots[it];
+
+    if (slot->flags & ZSI_WINDOW_SLOT_SEND_PENDING)
+    {
+      slot->flags = ZSI_WINDOW_SLOT_ON_MEDIUM;
+      zsiSerialMediumSend(slot->frame);
+      return;
+    }
+  }
+}
+
+/******************************************************************************
+  \brief Stores ACK to be sent as soon as medium is free. If there are too
+         many ACKs pending the newest is dropped, remote device resends the
+         frame on ACK timeout.
+
+  \param[in] status - reception status.
+  \param[in] sequenceNumber - sequnece number associated with received frame.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialPostponeAck(uint8_t status, uint8_t sequenceNumber)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  ZsiSerialPendingAck_t *ack;
+
+  if (window->pendingAcksAmount >= ZSI_SERIAL_WINDOW_SIZE)
+    return;
+
+  ack = &window->pendingAcks[(window->pendingAckHead + window->pendingAcksAmount) &
+                             (ZSI_SERIAL_WINDOW_SIZE - 1U)];
+  ack->status = status;
+  ack->sequenceNumber = sequenceNumber;
+  window->pendingAcksAmount++;
+}
+
+/******************************************************************************
+  \brief Medium transmission finished in windowed mode.
+
+  \param[in] frame - frame which has been sent.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialWindowSendingDone(void *const frame)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  uint8_t it;
+
+  if (IS_ACK_CMD_FRAME((ZsiCommandFrame_t *)frame))
+  {
+    ZSI_ACK_TX_COMPLETE(ackTxState);
+    zsiSerialAckSent(frame);
+  }
+  else
+  {
+    for (it = 0U; it < window->used; it++)
+    {
+      ZsiSerialWindowSlot_t *const slot = &window->slots[it];
+
+      if (slot->frame != frame)
+        continue;
+
+      slot->flags &= ~ZSI_WINDOW_SLOT_ON_MEDIUM;
+      if (slot->flags & ZSI_WINDOW_SLOT_ACKED)
+        zsiSerialWindowRelease(it);
+      else if (!(slot->flags & ZSI_WINDOW_SLOT_SEND_PENDING))
+      {
+        /* Overflow delay has been started by ACK already */
+        if (!(slot->flags & ZSI_WINDOW_SLOT_OVERFLOW))
+          slot->ackDeadline = HAL_GetSystemTime() + ZSI_ACK_WAIT_PERIOD;
+        zsiSerialArmWindowTimer();
+      }
+      break;
+    }
+  }
+
+  zsiSerialKickMedium();
+}
+
+/******************************************************************************
+  \brief Received ACK handling in windowed mode. Each frame is acknowledged
+         individually and retransmitted on its own.
+
+  \param[in] ackFrame - pointer to ACK frame received from medium.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialWindowAckReceived(const ZsiAckFrame_t *const ackFrame)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  ZsiSerialWindowSlot_t *slot = NULL;
+  uint8_t it;
+
+  for (it = 0U; it < window->used; it++)
+    if (window->slots[it].frame->sequenceNumber == ackFrame->sequenceNumber)
+    {
+      slot = &window->slots[it];
+      break;
+    }
+
+  /* Late ACKs on already acknowledged frames are ignored */
+  if (!slot)
+    return;
+
+  if (IS_NO_ERROR_STATUS(ackFrame))
+  {
+    /* Frame is being resent, release it when medium is done with it */
+    if (slot->flags & ZSI_WINDOW_SLOT_ON_MEDIUM)
+      slot->flags |= ZSI_WINDOW_SLOT_ACKED;
+    else
+      zsiSerialWindowRelease(it);
+  }
+  /* Frame was corrupted - resend it, if it is not resent already */
+  else if (IS_INVALID_FCS_STATUS(ackFrame))
+  {
+    if (!(slot->flags & ZSI_WINDOW_SLOT_ON_MEDIUM))
+    {
+      slot->flags = ZSI_WINDOW_SLOT_SEND_PENDING;
+      zsiSerial()->stats.retransmissions++;
+    }
+  }
+  /* Remote device has no memory - wait appropriate period and resend frame */
+  else if (IS_OVERFLOW_STATUS(ackFrame))
+  {
+    slot->flags = (slot->flags & ZSI_WINDOW_SLOT_ON_MEDIUM) | ZSI_WINDOW_SLOT_OVERFLOW;
+    slot->ackDeadline = HAL_GetSystemTime() + ZSI_OVERFLOW_DELAY;
+    zsiSerialArmWindowTimer();
+  }
+
+  zsiSerialKickMedium();
 }
 
 /******************************************************************************
-  \brief Adds FCS in the end of the frame.
+  \brief Resends window frames which haven't been acknowledged in time.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialCheckWindowTimeouts(void)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  BcTime_t now = HAL_GetSystemTime();
+  bool resend = false;
+  uint8_t it;
+
+  for (it = 0U; it < window->used; it++)
+  {
+    ZsiSerialWindowSlot_t *const slot = &window->slots[it];
+
+    if ((slot->flags & (ZSI_WINDOW_SLOT_SEND_PENDING | ZSI_WINDOW_SLOT_ON_MEDIUM)) ||
+        (now < slot->ackDeadline))
+      continue;
+
+    /* Waiting for remote device's memory doesn't consume retries */
+    if (!(slot->flags & ZSI_WINDOW_SLOT_OVERFLOW))
+    {
+      /* All attempts are failed - raise LOST_SYNCHRONIZATION event */
+      if (!slot->ackRetries)
+      {
+        sysAssert(0U, ZSISERIALCONTROLLER_ZSISERIALWINDOWTIMEOUT0);
+        SYS_PostEvent(BC_ZSI_LOST_SYNCHRONIZATION, 0U);
+        return;
+      }
+      slot->ackRetries--;
+    }
+    slot->flags = ZSI_WINDOW_SLOT_SEND_PENDING;
+    zsiSerial()->stats.retransmissions++;
+    resend = true;
+  }
+
+  if (resend)
+  {
+    zsiSerialKickMedium();
+    zsiSerialArmWindowTimer();
+  }
+}
+
+/******************************************************************************
+  \brief Starts window timer for the earliest ACK deadline.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialArmWindowTimer(void)
+{
+  ZsiSerialWindow_t *const window = &zsiSerial()->window;
+  BcTime_t now = HAL_GetSystemTime();
+  BcTime_t earliest = 0ULL;
+  bool found = false;
+  uint8_t it;
+
+  for (it = 0U; it < window->used; it++)
+  {
+    ZsiSerialWindowSlot_t *const slot = &window->slots[it];
+
+    if (slot->flags & (ZSI_WINDOW_SLOT_SEND_PENDING | ZSI_WINDOW_SLOT_ON_MEDIUM))
+      continue;
+
+    if (!found || (slot->ackDeadline < earliest))
+    {
+      earliest = slot->ackDeadline;
+      found = true;
+    }
+  }
+
+  HAL_StopAppTimer(&window->timer);
+  if (found)
+  {
+    window->timer.interval = (earliest > now) ? (uint32_t)(earliest - now) : 1UL;
+    HAL_StartAppTimer(&window->timer);
+  }
+}
+
+/******************************************************************************
+  \brief Window timer expiration callback. Timeouts are checked by serial
+         controller task, which is run during synchronous mode as well.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialWindowTimerFired(void)
+{
+  zsiPostTask(ZSI_SERIAL_TASK_ID);
+}
+
+/******************************************************************************
+  \brief Packs AREQs waiting in transmission queue to the AREQ taken from the
+         queue head. Frame is turned to the batch frame only if there is at
+         least one AREQ to pack it with. Packed frames are released.
+
+  \param[in] cmdFrame - frame taken from the transmission queue head.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSerialBatchTxQueue(ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiMemoryBuffer_t *buffer = getLinkedQueueElem(&zsiSerial()->txQueue);
+  uint16_t length = LE16_TO_CPU(cmdFrame->length) - ZSI_COMMAND_FRAME_OVERHEAD;
+  uint8_t *record;
+
+  if (!ZSI_SERIAL_BATCHING || !zsiSerial()->remoteBatching ||
+      !IS_AREQ_CMD_FRAME(cmdFrame) || IS_BATCH_CMD_FRAME(cmdFrame) ||
+      !buffer || !IS_AREQ_CMD_FRAME(&buffer->commandFrame) ||
+      (length + ZSI_BATCH_RECORD_HEADER_SIZE > ZSI_MAX_FRAME_PAYLOAD) ||
+      (length > UINT8_MAX))
+    return;
+
+  /* Own command becomes the first record of the batch */
+  memmove(&cmdFrame->payload[ZSI_BATCH_RECORD_HEADER_SIZE], cmdFrame->payload, length);
+  cmdFrame->payload[0] = length;
+  cmdFrame->payload[1] = cmdFrame->sequenceNumber;
+  cmdFrame->payload[2] = cmdFrame->commandHeader.domain;
+  cmdFrame->payload[3] = cmdFrame->commandHeader.commandId;
+  length += ZSI_BATCH_RECORD_HEADER_SIZE;
+
+  /* Consecutive AREQs are appended while they fit. Sequence number of the
+     first command identifies the whole batch on the link. */
+  while ((NULL != (buffer = getLinkedQueueElem(&zsiSerial()->txQueue))) &&
+         IS_AREQ_CMD_FRAME(&buffer->commandFrame) &&
+         !IS_BATCH_CMD_FRAME(&buffer->commandFrame))
+  {
+    ZsiCommandFrame_t *const packed = &buffer->commandFrame;
+    uint16_t packedLength = LE16_TO_CPU(packed->length) - ZSI_COMMAND_FRAME_OVERHEAD;
+
+    if ((length + ZSI_BATCH_RECORD_HEADER_SIZE + packedLength > ZSI_MAX_FRAME_PAYLOAD) ||
+        (packedLength > UINT8_MAX))
+      break;
+
+    record = &cmdFrame->payload[length];
+    record[0] = packedLength;
+    record[1] = packed->sequenceNumber;
+    record[2] = packed->commandHeader.domain;
+    record[3] = packed->commandHeader.commandId;
+    memcpy(&record[ZSI_BATCH_RECORD_HEADER_SIZE], packed->payload, packedLength);
+    length += ZSI_BATCH_RECORD_HEADER_SIZE + packedLength;
+
+    deleteHeadLinkedQueueElem(&zsiSerial()->txQueue);
+    zsiFreeMemory(packed);
+  }
+
+  cmdFrame->length = CPU_TO_LE16(length + ZSI_COMMAND_FRAME_OVERHEAD);
+  cmdFrame->commandHeader.domain = ZSI_CMD_BATCH;
+  cmdFrame->commandHeader.commandId = 0U;
+}
+
+/******************************************************************************
+  \brief Adds FCS in the end of the frame. Command frames are protected by
+         CRC-16, if remote device verifies it, by XOR of frame bytes -
+         otherwise.
 
   \param[in] frame - frame, which keeps serialized data.
 
@@ -699,11 +1343,31 @@ static void zsiAddFrameFcs(void *const frame)
 {
   if (frame)
   {
+    ZsiCommandFrame_t *const cmdFrame = (ZsiCommandFrame_t *)frame;
+    uint8_t *fcs;
+
+    /* Frame is extended by the second FCS byte only once */
+    if (ZSI_SERIAL_CRC_FCS && zsiSerial()->remoteCrcFcs &&
+        !IS_ACK_CMD_FRAME(cmdFrame) && !IS_CRC_FCS_CMD_FRAME(cmdFrame))
+    {
+      cmdFrame->frameControl |= ZSI_CRC_FCS_FLAG;
+      cmdFrame->length =
+        CPU_TO_LE16(LE16_TO_CPU(cmdFrame->length) + (ZSI_CRC_FCS_SIZE - 1U));
+    }
+
     /* Obtain pointer to FCS field */
-    uint8_t *fcs = zsiGetFrameFcsField(frame);
+    fcs = zsiGetFrameFcsField(frame);
+
+    /* Put FCS in the end of the frame, CRC-16 goes LSB first */
+    if (IS_CRC_FCS_CMD_FRAME(cmdFrame))
+    {
+      uint16_t crc = zsiCalculateFrameCrc(frame);
 
-    /* Put FCS in the end of the frame */
-    *fcs = zsiCalculateFrameFcs(frame);
+      *(fcs - 1) = (uint8_t)crc;
+      *fcs = (uint8_t)(crc >> 8U);
+    }
+    else
+      *fcs = zsiCalculateFrameFcs(frame);
   }
 }
 
@@ -722,19 +1386,61 @@ void TEST_zsiAddFrameFcs(void *const frame)
 #endif /* ZSI_TEST */
 
 /******************************************************************************
-  \brief Frame validation by FCS calculating and checking routine.
+  \brief Starts FCS calculation of the frame being received. Frame control
+         field determines FCS type, so calculation starts after it is received.
 
-  \param[in] frame - frame, which keeps serialized data.
+  \param[out] fcs - running FCS of the frame.
+  \param[in] frameControl - frame control field of the frame.
 
-  \return True, if frame received with no errors, false - otherwise.
+  \return None.
  ******************************************************************************/
-static bool zsiCheckFrameFcs(const void *const frame)
+void zsiRxFcsStart(ZsiRxFcs_t *const fcs, uint8_t frameControl)
 {
-  if (!frame)
-    return false;
+  fcs->crc = (ZSI_ACK_CMD != (frameControl & ZSI_CMD_TYPE_FIELD_MASK)) &&
+             (frameControl & ZSI_CRC_FCS_FLAG);
+
+  if (fcs->crc)
+    fcs->value = zsiCrcFcsUpdate(zsiCrcFcsUpdate(ZSI_CRC_FCS_INIT, ZSI_SOF_SEQUENCE),
+                                 frameControl);
+  else
+    fcs->value = ZSI_SOF_SEQUENCE ^ frameControl;
+}
+
+/******************************************************************************
+  \brief Updates FCS of the frame being received by the next received bytes.
+         All bytes following frame control field, including FCS field, should
+         be passed.
+
+  \param[in, out] fcs - running FCS of the frame.
+  \param[in] data - received bytes.
+  \param[in] length - amount of received bytes.
+
+  \return None.
+ ******************************************************************************/
+void zsiRxFcsUpdate(ZsiRxFcs_t *const fcs, const uint8_t *data, uint16_t length)
+{
+  uint16_t value = fcs->value;
+
+  if (fcs->crc)
+    while (length--)
+      value = zsiCrcFcsUpdate(value, *data++);
+  else
+    while (length--)
+      value ^= *data++;
+
+  fcs->value = value;
+}
 
-  /* Calculate actual FCS and obtain pointer to FCS field */
-  return (zsiCalculateFrameFcs(frame) == *zsiGetFrameFcsField(frame));
+/******************************************************************************
+  \brief Returns link errors counters of the local device.
+
+  \param[out] stats - counters.
+
+  \return None.
+ ******************************************************************************/
+void zsiSerialGetLinkStats(ZsiLinkStats_t *const stats)
+{
+  *stats = zsiSerial()->stats;
 }
 
 /******************************************************************************
@@ -761,6 +1467,26 @@ static uint8_t zsiCalculateFrameFcs(const void *const frame)
   return fcs;
 }
 
+/******************************************************************************
+  \brief Frame CRC-16 calculation routine.
+
+  \param[in] frame - frame, which keeps serialized data.
+
+  \return CRC-16 of the frame excluding FCS field.
+ ******************************************************************************/
+static uint16_t zsiCalculateFrameCrc(const void *const frame)
+{
+  const uint8_t *ptr = (const uint8_t *)frame;
+  uint16_t frameLength = zsiActualFrameLength((ZsiCommandFrame_t *)frame) -
+                         ZSI_CRC_FCS_SIZE;
+  uint16_t crc = ZSI_CRC_FCS_INIT;
+
+  while (frameLength--)
+    crc = zsiCrcFcsUpdate(crc, *ptr++);
+
+  return crc;
+}
+
 /******************************************************************************
   \brief Returns pointer to FCS field in the frame.
 
@@ -70,7 +70,7 @@ void zsiSerializeUint32(ZsiSerializer_t *const serializer,
 {
   sysAssert(serializer->pow, ZSISERIALIZER_ZSISERIALIZEUINT320);
   ((u32Packed_t *)(serializer->pow))->val = CPU_TO_LE32(*value);
-  serializer->pow += sizeof(value);
+  serializer->pow += sizeof(*value);
 }
 
 /******************************************************************************
@@ -4,6 +4,14 @@
   \brief ZAppSI SPI adapter implementation.
          Should be compiled with application.
 
+         Master moves whole frames with bulk transfers: a frame to be sent is
+         written at once, a frame of the slave is read as preamble followed
+         by the rest of the frame. Slave's ready line replaces delays between
+         bytes: the line goes low when the slave has a frame to send and
+         rises when the frame is loaded after START_READ_MARKER.
+         The slave side is implemented for ATmega128RFA1 only, SAMR21 and
+         the Linux host can be masters only.
+
   \author
     Atmel Corporation: http://www.atmel.com \n
     Support email: avr@atmel.com
@@ -18,20 +26,26 @@
     $Id: zsiSpiAdapter.c 26866 2014-06-26 12:35:56Z mukesh.basrani $
  ******************************************************************************/
 
-#if APP_ZAPPSI_INTERFACE == APP_INTERFACE_SPI
+#include <zsiTrafficLog.h>
+
+#if (APP_ZAPPSI_INTERFACE == APP_INTERFACE_SPI) && \
+    (ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_DISABLED)
 
 /******************************************************************************
                                Includes section
  ******************************************************************************/
 #include <zsiSerialController.h>
 #include <spi.h>
-#include <halrfCtrl.h>
 #include <zsiMemoryManager.h>
 #include <appTimer.h>
 #include <zsiDbg.h>
 #include <sysUtils.h>
 #include <zsiDriver.h>
 #include <irq.h>
+#include <halTaskManager.h>
+#if !defined(BOARD_PC)
+  #include <halrfCtrl.h>
+#endif
 
 /******************************************************************************
                                Defines section
@@ -39,7 +53,9 @@
 #define ZSI_MEDIUM_CHANNEL APP_ZAPPSI_MEDIUM_CHANNEL
 #define LINK_SAFETY_TIMEOUT 100UL /* 100 ms */
 
-#if (APP_ZAPPSI_SPI_MASTER_MODE == 1) && defined(AT91SAM7X256)
+#if (APP_ZAPPSI_SPI_MASTER_MODE == 1) && \
+    (defined(AT91SAM7X256) || defined(ATSAMR21G18A) || defined(ATSAMR21E18A) || \
+     (defined(BOARD_PC) && defined(LINUX)))
   #define VALID_MASTER_SPI
 #endif
 
@@ -57,14 +73,49 @@
 #endif
 
 #if defined(VALID_MASTER_SPI)
-  // spi parametres
-  #define APP_SPI_MASTER_CLOCK_RATE         1000000ul
-  #define APP_DELAY_BETWEEN_CS_AND_CLOCK    0.000001
-  #define APP_DELAY_BETWEEN_CONS_TRANSFER   0.00016
-  #define APP_SOFT_USDELAY_BETWEEN_BYTES    200
+  // SPI clock rate, Hz
+  #ifndef APP_ZAPPSI_SPI_CLOCK_RATE
+    #define APP_ZAPPSI_SPI_CLOCK_RATE 2000000ul
+  #endif
+
+  // Interrupt of the slave's ready line
+  #ifndef APP_ZAPPSI_SPI_READY_IRQ
+    #if defined(AT91SAM7X256)
+      #define APP_ZAPPSI_SPI_READY_IRQ IRQ_0
+    #elif defined(ATSAMR21G18A) || defined(ATSAMR21E18A)
+      #define APP_ZAPPSI_SPI_READY_IRQ IRQ_EIC_EXTINT6
+    #else
+      #define APP_ZAPPSI_SPI_READY_IRQ IRQ_0
+    #endif
+  #endif
+
   #if defined(AT91SAM7X256)
-    #define SLAVE_IRQ    IRQ_0
+    #define APP_DELAY_BETWEEN_CS_AND_CLOCK  0.000001
+    // Gap the SPI controller inserts between bytes of a bulk transfer, sec.
+    // Gives byte interrupt driven slaves time to handle each byte.
+    #ifndef APP_ZAPPSI_SPI_BYTE_GAP
+      #define APP_ZAPPSI_SPI_BYTE_GAP       0.00016
+    #endif
+    // PDC transfers complete asynchronously
+    #define ZSI_SPI_SYNC_TRANSFERS          0
+    #define ZSI_SPI_SELECT()                GPIO_MASTER_CS_clr()
+    #define ZSI_SPI_DESELECT()              GPIO_MASTER_CS_set()
+  #elif defined(ATSAMR21G18A) || defined(ATSAMR21E18A)
+    #define ZSI_SPI_SYNC_TRANSFERS          1
+    #define ZSI_SPI_SELECT()                GPIO_clr(&zsiSpiDescriptor.tty->spiPinConfig[SPI_CS_SIG])
+    #define ZSI_SPI_DESELECT()              GPIO_set(&zsiSpiDescriptor.tty->spiPinConfig[SPI_CS_SIG])
+  #else
+    #define ZSI_SPI_SYNC_TRANSFERS          1
+    #define ZSI_SPI_SELECT()                HAL_SelectSpi(&zsiSpiDescriptor, true)
+    #define ZSI_SPI_DESELECT()              HAL_SelectSpi(&zsiSpiDescriptor, false)
   #endif
+
+  // SOF, frame control, length and sequence number fields
+  #define ZSI_SPI_RX_PREAMBLE_SIZE          (ZSI_COMMAND_FRAME_PREAMBLE_SIZE + 1U)
+  // Size of the chunks used to skip frames which could not be buffered
+  #define ZSI_SPI_RX_DISCARD_CHUNK_SIZE     16U
+  // Smallest valid value of frame length field: sequence number and FCS
+  #define ZSI_SPI_MIN_FRAME_LENGTH          2U
 #endif
 
 
@@ -79,28 +130,19 @@ typedef enum _SpiState_t
   WAITING_RX_LEN_LSB,
   WAITING_RX_LEN_MSB,
   WAITING_TX_FRAME_CONTROL,
+  WAITING_RX_FRAME_CONTROL,
+  WAITING_TSN,
 #endif
 #if defined(VALID_MASTER_SPI)
   SPI_IDLE,
-  //WAITING_TX_MARKER,
   WAITING_RX_MARKER,
-  WAITING_RX_LEN,
-  WAITING_RX_SOF,
+  WAITING_RX_PREAMBLE,
 #endif
   WAITING_RX_DATA,
   WAITING_TX_DATA,
-  WAITING_RX_FRAME_CONTROL,
-  WAITING_TSN,
 } SpiState_t;
 
 #ifdef VALID_MASTER_SPI
-typedef enum _SpiMasterTypeTransaction_t
-{
-  MASTER_READ_TRANSACTION,
-  MASTER_WRITE_TRANSACTION,
-  MASTER_LAST_BYTE
-} SpiMasterTypeTransaction_t;
-
 typedef enum _SpiSlaveDataState_t
 {
   SLAVE_THERE_IS_DATA,
@@ -118,11 +160,16 @@ void zsiMediumHandler(void);
                               Static functions prototypes section
 ******************************************************************************/
 #ifdef VALID_MASTER_SPI
+#if defined(AT91SAM7X256)
 HAL_ASSIGN_PIN(MASTER_CS, A, AT91C_PIO_PA21);
 HAL_ASSIGN_PIN(EXT_IRQ,  A, AT91C_PIO_PA29);
-static void masterSpiDelayer(void);
+#endif
 static void spiMasterHandler(void);
 static void slaveSpiDataInd(void);
+static void zsiSpiStartTransfer(uint8_t *buffer, uint16_t length, bool write);
+static void zsiSpiRxFrameStarted(void);
+static void zsiSpiReadNextChunk(void);
+static void zsiSpiListenReadyLine(HAL_IrqMode_t mode);
 #endif // VALID_MASTER_SPI
 
 #ifdef VALID_SLAVE_SPI
@@ -139,18 +186,21 @@ static HAL_SpiDescriptor_t zsiSpiDescriptor;
 static uint8_t    rxStatus = ZSI_NO_ERROR_STATUS;
 static uint8_t   *rxBuffer;
 static uint8_t   *poW;
+static ZsiRxFcs_t rxFcs;
 static SpiState_t spiState = SPI_ERR_OR_OFF;
 static uint8_t    sequenceNumber;
 
 #ifdef VALID_MASTER_SPI
-static uint16_t dataLength;
-static uint8_t *dataPointer;
 static bool     masterTransactionInProgress;
-static uint8_t  frameControl;
-static uint16_t length;
+static uint16_t bytesToReceive;
+static uint16_t chunkLength;
+static uint8_t  rxPreamble[ZSI_SPI_RX_PREAMBLE_SIZE];
+static uint8_t  rxDiscard[ZSI_SPI_RX_DISCARD_CHUNK_SIZE];
+// Frame passed for sending while a frame of the slave is being read
+static uint8_t *deferredFrame;
+static uint16_t deferredFrameSize;
 
 static volatile SpiSlaveDataState_t slaveIndReady = SLAVE_DATA_IS_EMPTY;
-static SpiMasterTypeTransaction_t transacType;
 
 static const HAL_IrqMode_t thereIsData = IRQ_LOW_LEVEL;
 static const HAL_IrqMode_t dataReady   = IRQ_RISING_EDGE;
@@ -183,11 +233,12 @@ int zsiMediumInit(void)
 {
   zsiSpiDescriptor.tty            = ZSI_MEDIUM_CHANNEL;
   zsiSpiDescriptor.clockMode      = SPI_CLOCK_MODE0;
+#if defined(AT91SAM7X256)
   zsiSpiDescriptor.symbolSize     = SPI_8BITS_SYMBOL;
-  zsiSpiDescriptor.pack_parameter = HAL_SPI_PACK_PARAMETER(APP_SPI_MASTER_CLOCK_RATE, \
+  zsiSpiDescriptor.pack_parameter = HAL_SPI_PACK_PARAMETER(APP_ZAPPSI_SPI_CLOCK_RATE, \
                                                            APP_DELAY_BETWEEN_CS_AND_CLOCK, \
-                                                           APP_DELAY_BETWEEN_CONS_TRANSFER);
-  zsiSpiDescriptor.callback       = masterSpiDelayer;
+                                                           APP_ZAPPSI_SPI_BYTE_GAP);
+  zsiSpiDescriptor.callback       = spiMasterHandler;
   // set up master irq line
   GPIO_MASTER_CS_set();
   GPIO_MASTER_CS_make_out();
@@ -205,20 +256,25 @@ int zsiMediumInit(void)
   (void)GPIO_EXT_IRQ_clr;
   (void)GPIO_EXT_IRQ_make_out;
   (void)GPIO_EXT_IRQ_toggle;
+#elif defined(ATSAMR21G18A) || defined(ATSAMR21E18A)
+  zsiSpiDescriptor.dataOrder      = SPI_DATA_MSB_FIRST;
+  zsiSpiDescriptor.baudRate       = (SpiBaudRate_t)((F_PERI / (2 * APP_ZAPPSI_SPI_CLOCK_RATE)) - 1);
+  // synchronous transfers
+  zsiSpiDescriptor.callback       = NULL;
+#else
+  zsiSpiDescriptor.dataOrder      = SPI_DATA_MSB_FIRST;
+  zsiSpiDescriptor.baudRate       = APP_ZAPPSI_SPI_CLOCK_RATE;
+  // synchronous transfers
+  zsiSpiDescriptor.callback       = NULL;
+#endif
 
-  if (0 != HAL_RegisterIrq(SLAVE_IRQ, thereIsData, slaveSpiDataInd))
-  {
-    /* registration failed */
-  }
-  
-  HAL_EnableIrq(SLAVE_IRQ);
+  if (-1 == HAL_OpenSpi(&zsiSpiDescriptor))
+    return -1;
 
-  if (-1 != HAL_OpenSpi(&zsiSpiDescriptor))
-  {
-    spiState = SPI_IDLE;
-    return 0;
-  }
-  return -1;
+  ZSI_SPI_DESELECT();
+  spiState = SPI_IDLE;
+  zsiSpiListenReadyLine(thereIsData);
+  return 0;
 }
 
 /******************************************************************************
@@ -231,13 +287,20 @@ int zsiMediumInit(void)
  ******************************************************************************/
 int zsiMediumSend(void *frame, uint16_t size)
 {
-  transacType = MASTER_WRITE_TRANSACTION;
-  dataPointer = frame;
-  dataLength  = size;
-  spiState    = WAITING_TX_DATA;
+  if (SPI_ERR_OR_OFF == spiState)
+    return -1;
 
-  GPIO_MASTER_CS_clr();
-  masterSpiDelayer();
+  /* Frame of the slave is being read - send when it is finished */
+  if (SPI_IDLE != spiState)
+  {
+    deferredFrame     = frame;
+    deferredFrameSize = size;
+    return 0;
+  }
+
+  spiState = WAITING_TX_DATA;
+  ZSI_SPI_SELECT();
+  zsiSpiStartTransfer(frame, size, true);
 
   if (SPI_ERR_OR_OFF == spiState)
     return -1;
@@ -253,7 +316,12 @@ int zsiMediumSend(void *frame, uint16_t size)
  ******************************************************************************/
 void zsiMediumPerformHalHoldTasks(void)
 {
+#if ZSI_SPI_SYNC_TRANSFERS == 1
+  /* Synchronous transfers do not use HAL tasks */
+  HAL_HoldOnTasks(0);
+#else
   HAL_HoldOnTasks(((HalTaskBitMask_t)1 << HAL_SPI1_RXBUFF) | ((HalTaskBitMask_t)1 << HAL_SPI1_TXBUFE));
+#endif
 }
 
 /******************************************************************************
@@ -267,43 +335,53 @@ void zsiMediumReleaseAllHeldTasks(void)
 }
 
 /******************************************************************************
-  \brief Add software delay between spi bytes.
+  \brief Starts bulk transfer. Completion is handled by spiMasterHandler().
+
+  \param[in] buffer - data to be written or buffer for data to be read.
+  \param[in] length - number of bytes.
+  \param[in] write - true to write, false to read.
 
   \return None.
  ******************************************************************************/
-static void masterSpiDelayer(void)
+static void zsiSpiStartTransfer(uint8_t *buffer, uint16_t length, bool write)
 {
   int transacState;
 
-  switch (transacType)
-  {
-    case MASTER_READ_TRANSACTION:
-      HAL_Delay(APP_SOFT_USDELAY_BETWEEN_BYTES);
-      transacState = HAL_ReadSpi(&zsiSpiDescriptor, dataPointer++, sizeof(uint8_t));
-      break;
-    case MASTER_WRITE_TRANSACTION:
-      HAL_Delay(APP_SOFT_USDELAY_BETWEEN_BYTES);
-      transacState = HAL_WriteSpi(&zsiSpiDescriptor, dataPointer++, sizeof(uint8_t));
-      break;
-
-    case MASTER_LAST_BYTE:
-      spiMasterHandler();
-      return;
-
-    default:
-      break;
-  }
+  masterTransactionInProgress = true;
+  chunkLength = length;
+  if (write)
+    transacState = HAL_WriteSpi(&zsiSpiDescriptor, buffer, length);
+  else
+    transacState = HAL_ReadSpi(&zsiSpiDescriptor, buffer, length);
 
-  if (transacState)
+  if (transacState < 0)
   {
+    ZSI_SPI_DESELECT();
+    masterTransactionInProgress = false;
     spiState = SPI_ERR_OR_OFF;
     return;
   }
 
-  masterTransactionInProgress = true;
+#if ZSI_SPI_SYNC_TRANSFERS == 1
+  spiMasterHandler();
+#endif
+}
+
+/******************************************************************************
+  \brief Registers slave's ready line interrupt with required mode.
 
-  if (!--dataLength)
-    transacType = MASTER_LAST_BYTE;
+  \param[in] mode - thereIsData or dataReady.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSpiListenReadyLine(HAL_IrqMode_t mode)
+{
+  HAL_UnregisterIrq(APP_ZAPPSI_SPI_READY_IRQ);
+  if (0 != HAL_RegisterIrq(APP_ZAPPSI_SPI_READY_IRQ, mode, slaveSpiDataInd))
+  {
+    /* registration failed */
+  }
+  HAL_EnableIrq(APP_ZAPPSI_SPI_READY_IRQ);
 }
 
 /******************************************************************************
@@ -318,10 +396,73 @@ static void slaveSpiDataInd(void)
   else if (SLAVE_THERE_IS_DATA == slaveIndReady)
     slaveIndReady = SLAVE_DATA_IS_READY;
 
-  HAL_DisableIrq(SLAVE_IRQ);
+  HAL_DisableIrq(APP_ZAPPSI_SPI_READY_IRQ);
   zsiPostTask(ZSI_SERIAL_TASK_ID);
 }
 
+/******************************************************************************
+  \brief Allocates buffer for the frame which preamble has been read.
+         The rest of the frame is read directly to the buffer.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSpiRxFrameStarted(void)
+{
+  const uint8_t frameControl = rxPreamble[1];
+
+  bytesToReceive = rxPreamble[2] | ((uint16_t)rxPreamble[3] << 8);
+  sequenceNumber = rxPreamble[ZSI_COMMAND_FRAME_PREAMBLE_SIZE];
+  rxStatus = ZSI_NO_ERROR_STATUS;
+
+  /* Detect non-AREQ frames on early stage */
+  if ((sizeof(ZsiAckFrame_t) - ZSI_COMMAND_FRAME_PREAMBLE_SIZE) == bytesToReceive)
+    rxBuffer = zsiAllocateMemory(ZSI_RX_ACK_MEMORY);
+  else if (ZSI_SREQ_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
+    rxBuffer = zsiAllocateMemory(ZSI_SREQ_CMD);
+  else if (ZSI_SRSP_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
+    rxBuffer = zsiAllocateFrameMemory(ZSI_SRSP_CMD,
+                                      ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive);
+  else
+    rxBuffer = zsiAllocateFrameMemory(ZSI_MUTUAL_MEMORY,
+                                      ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive);
+
+  /* Check for overflow */
+  if (sizeof(ZsiCommandFrame_t) < (ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive))
+  {
+    if (rxBuffer)
+      zsiFreeMemory(rxBuffer);
+    rxBuffer = NULL;
+  }
+
+  if (rxBuffer)
+  {
+    memcpy(rxBuffer, rxPreamble, sizeof(rxPreamble));
+    poW = rxBuffer + sizeof(rxPreamble);
+  }
+  else
+    rxStatus = ZSI_OVERFLOW_STATUS;
+
+  zsiRxFcsStart(&rxFcs, frameControl);
+  zsiRxFcsUpdate(&rxFcs, rxPreamble + 2U, sizeof(rxPreamble) - 2U);
+  /* Sequence number is already received */
+  bytesToReceive--;
+  spiState = WAITING_RX_DATA;
+}
+
+/******************************************************************************
+  \brief Reads the rest of the frame at once if it is buffered, or next chunk
+         of the frame to be skipped.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSpiReadNextChunk(void)
+{
+  if (rxBuffer)
+    zsiSpiStartTransfer(poW, bytesToReceive, false);
+  else
+    zsiSpiStartTransfer(rxDiscard, MIN(bytesToReceive, sizeof(rxDiscard)), false);
+}
+
 /******************************************************************************
   \brief Callback on spi transaction complete
 
@@ -329,114 +470,81 @@ static void slaveSpiDataInd(void)
  ******************************************************************************/
 static void spiMasterHandler(void)
 {
-  static uint16_t bytesToReceive;
-  static uint8_t  data;
+  uint8_t *chunk;
+
+  masterTransactionInProgress = false;
 
   switch (spiState)
   {
     case WAITING_RX_MARKER:
-      /* START_READ_MARKER transmission completed. Check for interrupt from slave
+      /* START_READ_MARKER transmission completed. Wait for interrupt from slave
          to continue. */
-      masterTransactionInProgress = false;
       break;
 
     case WAITING_TX_DATA:
-      GPIO_MASTER_CS_set();
+      ZSI_SPI_DESELECT();
       // Full packet was transmitted
       spiState = SPI_IDLE;
-      masterTransactionInProgress = false;
       zsiMediumSendingDone();
       break;
 
-    case WAITING_RX_SOF:
-      transacType = MASTER_READ_TRANSACTION;
-      spiState    = WAITING_RX_FRAME_CONTROL;
-      dataPointer = (uint8_t*)&frameControl;
-      dataLength  = sizeof(uint8_t);
-      masterSpiDelayer();
-      break;
-
-    case WAITING_RX_FRAME_CONTROL:
-      transacType = MASTER_READ_TRANSACTION;
-      dataPointer = (uint8_t*)&length;
-      dataLength  = sizeof(length);
-      spiState    = WAITING_RX_LEN;
-      masterSpiDelayer();
-      break;
-
-    case WAITING_RX_LEN:
-      transacType = MASTER_READ_TRANSACTION;
-      spiState = WAITING_TSN;
-      /* Adapt length to endiannes */
-      bytesToReceive = LE16_TO_CPU(length);
-      /* Detect non-AREQ frames on early stage */
-      if ((sizeof(ZsiAckFrame_t) - ZSI_COMMAND_FRAME_PREAMBLE_SIZE) == bytesToReceive)
-        rxBuffer = zsiAllocateMemory(ZSI_RX_ACK_MEMORY);
-      /* 'byte' still keeps FRAME_CONTROL field value */
-      else if (ZSI_SREQ_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
-        rxBuffer = zsiAllocateMemory(ZSI_SREQ_CMD);
-      else if (ZSI_SRSP_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
-        rxBuffer = zsiAllocateMemory(ZSI_SRSP_CMD);
-      else
-        rxBuffer = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
-     /* Check for overflow */
-      if (!rxBuffer ||
-         (sizeof(ZsiCommandFrame_t) <
-              (ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive))
-           )
-        rxStatus = ZSI_OVERFLOW_STATUS;
-        /* If ok, put frame's preamble to allocated buffer */
-      else
+    case WAITING_RX_PREAMBLE:
+      if ((ZSI_SOF_SEQUENCE != rxPreamble[0]) ||
+          (ZSI_SPI_MIN_FRAME_LENGTH > (uint16_t)(rxPreamble[2] | ((uint16_t)rxPreamble[3] << 8))))
       {
-        poW    = rxBuffer;
-        *poW++ = ZSI_SOF_SEQUENCE;
-        *poW++ = frameControl;
-        memcpy(poW, &length, sizeof(length));
-        poW   += sizeof(length);
+        /* Slave is out of sync - drop the transaction */
+        sysAssert(0U, ZSIMEDIUM_ZSIMEDIUMRXCALLBACK0);
+        ZSI_SPI_DESELECT();
+        spiState = SPI_IDLE;
+        break;
       }
-      dataPointer = (uint8_t*)&sequenceNumber;
-      dataLength  = sizeof(sequenceNumber);
-      masterSpiDelayer();
-      break;
-
-    case WAITING_TSN:
-      transacType = MASTER_READ_TRANSACTION;
-      spiState = WAITING_RX_DATA;
-      if (rxBuffer)
-        *poW++ = sequenceNumber;
-      bytesToReceive--;
-      dataPointer = (uint8_t*)&data;
-      dataLength  = sizeof(data);
-      masterSpiDelayer();
+      zsiSpiRxFrameStarted();
+      zsiSpiReadNextChunk();
       break;
 
     /* Pass the rest of the data to the buffer, if allocated */
     case WAITING_RX_DATA:
-      if (bytesToReceive-- && rxBuffer)
-        *poW++ = data;
-      /* Frame completely received - notify serial controller */
-      if (0U == bytesToReceive)
+      chunk = rxBuffer ? poW : rxDiscard;
+      zsiRxFcsUpdate(&rxFcs, chunk, chunkLength);
+      if (rxBuffer)
+        poW += chunkLength;
+      bytesToReceive -= chunkLength;
+
+      if (bytesToReceive)
       {
-        GPIO_MASTER_CS_set();
-        spiState = SPI_IDLE;
-        masterTransactionInProgress = false;
-        zsiMediumReceive(rxStatus, sequenceNumber, rxBuffer);
-        poW = rxBuffer = NULL;
+        zsiSpiReadNextChunk();
         return;
       }
-      else
-      {
-        dataPointer = (uint8_t*)&data;
-        dataLength  = sizeof(data);
-        transacType = MASTER_READ_TRANSACTION;
-        masterSpiDelayer();
-      }
+
+      /* Frame completely received - notify serial controller */
+      ZSI_SPI_DESELECT();
+      spiState = SPI_IDLE;
+      if ((ZSI_NO_ERROR_STATUS == rxStatus) && !zsiRxFcsIsValid(&rxFcs))
+        rxStatus = ZSI_INVALID_FCS_STATUS;
+      chunk = rxBuffer;
+      poW = rxBuffer = NULL;
+      zsiMediumReceive(rxStatus, sequenceNumber, chunk);
       break;
 
     case SPI_ERR_OR_OFF:
     default:
       return;
   }
+
+  if (SPI_IDLE != spiState)
+    return;
+
+  /* Send frame deferred while the frame of the slave was being read */
+  if (deferredFrame)
+  {
+    uint8_t *frame = deferredFrame;
+
+    deferredFrame = NULL;
+    zsiMediumSend(frame, deferredFrameSize);
+  }
+  /* Slave indicated a frame during the transaction */
+  else if (SLAVE_DATA_IS_EMPTY != slaveIndReady)
+    zsiPostTask(ZSI_SERIAL_TASK_ID);
 }
 
 /******************************************************************************
@@ -446,7 +554,7 @@ static void spiMasterHandler(void)
  ******************************************************************************/
 void zsiMediumHandler(void)
 {
-  static uint8_t startMarker = START_READ_MARKER;
+  static uint8_t startMarker;
 
   /* Deffer task execution until master current transaction finished */
   if (masterTransactionInProgress)
@@ -457,40 +565,25 @@ void zsiMediumHandler(void)
     case SLAVE_THERE_IS_DATA:
       if (SPI_IDLE == spiState)
       {
-        HAL_UnregisterIrq(SLAVE_IRQ);
-        if (0 != HAL_RegisterIrq(SLAVE_IRQ, dataReady, slaveSpiDataInd))
-        {
-          /* registration failed */
-        }
+        zsiSpiListenReadyLine(dataReady);
 
-        HAL_EnableIrq(SLAVE_IRQ);
-
-        GPIO_MASTER_CS_clr();
-        transacType = MASTER_WRITE_TRANSACTION;
-        dataPointer = &startMarker;
-        dataLength  = sizeof(uint8_t);
+        ZSI_SPI_SELECT();
+        startMarker = START_READ_MARKER;
         spiState    = WAITING_RX_MARKER;
-        masterSpiDelayer();
+        zsiSpiStartTransfer(&startMarker, sizeof(startMarker), true);
       }
       break;
 
     case SLAVE_DATA_IS_READY:
       if (WAITING_RX_MARKER == spiState)
       {
-        transacType = MASTER_READ_TRANSACTION;
-        dataPointer = &frameControl;
-        dataLength  = sizeof(frameControl);
-        spiState    = WAITING_RX_SOF;
-        masterSpiDelayer();
-
         slaveIndReady = SLAVE_DATA_IS_EMPTY;
         // enable irq from slave
-        HAL_UnregisterIrq(SLAVE_IRQ);
-        if (0 != HAL_RegisterIrq(SLAVE_IRQ, thereIsData, slaveSpiDataInd))
-        {
-          /* registration failed */
-        }
-        HAL_EnableIrq(SLAVE_IRQ);
+        zsiSpiListenReadyLine(thereIsData);
+
+        /* Whole frame is loaded by the slave - read its preamble */
+        spiState = WAITING_RX_PREAMBLE;
+        zsiSpiStartTransfer(rxPreamble, sizeof(rxPreamble), false);
       }
       break;
 
@@ -659,6 +752,7 @@ static void spiSlaveHandler(uint16_t bytesAmount)
           spiState = SPI_ERR_OR_OFF;
           return;
         }
+        zsiRxFcsStart(&rxFcs, data);
         spiState = WAITING_RX_LEN_LSB;
         bytesAmount--;
       }
@@ -671,6 +765,7 @@ static void spiSlaveHandler(uint16_t bytesAmount)
           spiState = SPI_ERR_OR_OFF;
           return;
         }
+        zsiRxFcsUpdate(&rxFcs, &byte, sizeof(byte));
         bytesAmount--;
         break;
 
@@ -682,6 +777,10 @@ static void spiSlaveHandler(uint16_t bytesAmount)
           return;
         }
         leLength = (leLength << 8) + byte;
+        {
+          uint8_t lengthMsb = (uint8_t)(leLength >> 8);
+          zsiRxFcsUpdate(&rxFcs, &lengthMsb, sizeof(lengthMsb));
+        }
         /* Adapt length to endiannes */
         bytesToReceive = LE16_TO_CPU(leLength);
         /* Detect non-AREQ frames on early stage */
@@ -691,9 +790,11 @@ static void spiSlaveHandler(uint16_t bytesAmount)
         else if (ZSI_SREQ_CMD == (data & ZSI_CMD_TYPE_FIELD_MASK))
           rxBuffer = zsiAllocateMemory(ZSI_SREQ_CMD);
         else if (ZSI_SRSP_CMD == (data & ZSI_CMD_TYPE_FIELD_MASK))
-          rxBuffer = zsiAllocateMemory(ZSI_SRSP_CMD);
+          rxBuffer = zsiAllocateFrameMemory(ZSI_SRSP_CMD,
+                                            ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive);
         else
-          rxBuffer = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
+          rxBuffer = zsiAllocateFrameMemory(ZSI_MUTUAL_MEMORY,
+                                            ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive);
 
         /* Check for overflow */
         if (!rxBuffer ||
@@ -723,30 +824,44 @@ static void spiSlaveHandler(uint16_t bytesAmount)
           return;
         }
 
+        zsiRxFcsUpdate(&rxFcs, &sequenceNumber, sizeof(sequenceNumber));
         if (rxBuffer)
           *poW++ = sequenceNumber;
         bytesAmount--;
         bytesToReceive--;
         break;
 
-      /* Pass the rest of the data to the buffer, if allocated */
+      /* Pass the rest of the data to the buffer, if allocated. All received
+         bytes of the frame are read at once. */
       case WAITING_RX_DATA:
-        if (bytesToReceive--)
+        if (bytesToReceive)
         {
-          if (HAL_ReadSpi(&zsiSpiDescriptor, &data, sizeof(data)) <= 0)
+          uint8_t  discard[8];
+          uint8_t *chunk = rxBuffer ? poW : discard;
+          uint16_t chunkSize = MIN(bytesAmount, bytesToReceive);
+          int      readCnt;
+
+          if (!rxBuffer)
+            chunkSize = MIN(chunkSize, sizeof(discard));
+          readCnt = HAL_ReadSpi(&zsiSpiDescriptor, chunk, chunkSize);
+          if (readCnt <= 0)
           {
             spiState = SPI_ERR_OR_OFF;
             return;
           }
 
+          zsiRxFcsUpdate(&rxFcs, chunk, readCnt);
           if (rxBuffer)
-            *poW++ = data;
-          bytesAmount--;
+            poW += readCnt;
+          bytesAmount -= readCnt;
+          bytesToReceive -= readCnt;
         }
         /* Frame completely received - notify serial controller */
         if (0U == bytesToReceive)
         {
           HAL_StopAppTimer(&spiLinkSafetyTimer);
+          if ((ZSI_NO_ERROR_STATUS == rxStatus) && !zsiRxFcsIsValid(&rxFcs))
+            rxStatus = ZSI_INVALID_FCS_STATUS;
           zsiMediumReceive(rxStatus, sequenceNumber, rxBuffer);
           poW = rxBuffer = NULL;
           spiState = WAITING_MARKER;
@@ -794,5 +909,5 @@ static void spiSlaveHandler(uint16_t bytesAmount)
 
 #endif // VALID_SLAVE_SPI
 
-#endif /* APP_ZAPPSI_INTERFACE == APP_INTERFACE_SPI */
+#endif /* (APP_ZAPPSI_INTERFACE == APP_INTERFACE_SPI) && (ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_DISABLED) */
 /* eof zsiSpiAdapter.c */
@@ -23,7 +23,28 @@
 #include <configServer.h>
 #include <zsiSysSerialization.h>
 #include <zsiDriver.h>
+#include <zsiMemoryManager.h>
 #include <zsiDbg.h>
+#ifdef ZAPPSI_NP
+#include <sysEvents.h>
+#endif /* ZAPPSI_NP */
+
+/******************************************************************************
+                              Types section
+******************************************************************************/
+#ifdef ZAPPSI_NP
+/* Tracking of parameters mirrored by the host */
+typedef struct _ZsiCsTracker_t
+{
+  /* Host has accessed parameters, their changes are reported */
+  bool                        started;
+  /* Changes are being reported, protects from recursion */
+  bool                        reporting;
+  /* Stack changes network parameters itself on these events */
+  SYS_EventReceiver_t         networkEventReceiver;
+  ZsiCsParametersChangedInd_t changedInd;
+} ZsiCsTracker_t;
+#endif /* ZAPPSI_NP */
 
 /******************************************************************************
                               Static variables section
@@ -33,9 +54,23 @@ static PROGMEM_DECLARE(ZsiProcessingRoutine_t zsiSysProcessingRoutines[]) =
   [ZSI_SYS_READ_PARAMETER_REQUEST] = zsiDeserializeCS_ReadParameterReq,
   [ZSI_SYS_READ_PARAMETER_CONFIRM] = zsiDeserializeCS_ReadParameterConf,
   [ZSI_SYS_WRITE_PARAMETER_REQUEST] = zsiDeserializeCS_WriteParameterReq,
-  [ZSI_SYS_WRITE_PARAMETER_CONFIRM] = zsiDeserializeCS_WriteParameterConf
+  [ZSI_SYS_WRITE_PARAMETER_CONFIRM] = zsiDeserializeCS_WriteParameterConf,
+  [ZSI_SYS_PARAMETERS_CHANGED_INDICATION] = zsiDeserializeCS_ParametersChangedInd,
+  [ZSI_SYS_GET_LINK_STATS_REQUEST] = zsiDeserializeZSI_GetLinkStatsReq,
+  [ZSI_SYS_GET_LINK_STATS_CONFIRM] = zsiDeserializeZSI_GetLinkStatsConf,
+  [ZSI_SYS_GET_MEMORY_STATS_REQUEST] = zsiDeserializeZSI_GetMemoryStatsReq,
+  [ZSI_SYS_GET_MEMORY_STATS_CONFIRM] = zsiDeserializeZSI_GetMemoryStatsConf
 };
 
+#ifdef ZAPPSI_NP
+static void zsiSysNetworkEventObserver(SYS_EventId_t eventId, SYS_EventData_t data);
+
+static ZsiCsTracker_t zsiCsTracker =
+{
+  .networkEventReceiver = {.func = zsiSysNetworkEventObserver}
+};
+#endif /* ZAPPSI_NP */
+
 ZsiCsParameter_t zsiCsParameter;
 
 /******************************************************************************
@@ -61,4 +96,132 @@ ZsiProcessingRoutine_t zsiSysFindProcessingRoutine(uint8_t commandId)
   return routine;
 }
 
+#ifdef ZAPPSI_HOST
+/**************************************************************************//**
+  \brief Returns link errors counters of the host and the network processor.
+
+  \param[out] localStats - host's counters, may be NULL.
+  \param[out] remoteStats - network processor's counters, may be NULL.
+                            Requested synchronously.
+
+  \return None.
+ ******************************************************************************/
+void ZSI_GetLinkStats(ZsiLinkStats_t *const localStats,
+  ZsiLinkStats_t *const remoteStats)
+{
+  if (localStats)
+    zsiSerialGetLinkStats(localStats);
+  if (remoteStats)
+    zsiProcessCommand(ZSI_SREQ_CMD, remoteStats, zsiSerializeZSI_GetLinkStatsReq,
+                      remoteStats);
+}
+
+/**************************************************************************//**
+  \brief Returns memory usage statistics of the host and the network processor.
+
+  \param[out] localStats - host's statistics, may be NULL.
+  \param[out] remoteStats - network processor's statistics, may be NULL.
+                            Requested synchronously.
+
+  \return None.
+ ******************************************************************************/
+void ZSI_GetMemoryStats(ZsiMemoryStats_t *const localStats,
+  ZsiMemoryStats_t *const remoteStats)
+{
+  if (localStats)
+    zsiGetMemoryStats(localStats);
+  if (remoteStats)
+    zsiProcessCommand(ZSI_SREQ_CMD, remoteStats, zsiSerializeZSI_GetMemoryStatsReq,
+                      remoteStats);
+}
+#endif /* ZAPPSI_HOST */
+
+#ifdef ZAPPSI_NP
+/**************************************************************************//**
+  \brief Notifies that the host has accessed network processor's parameter.
+         Changes of parameters are tracked since the first access.
+
+  \param[in] parameterId - ID of the accessed parameter.
+  \param[in] written - true if the host has written the parameter.
+
+  \return None.
+ ******************************************************************************/
+void zsiSysParameterAccessed(CS_MemoryItemId_t parameterId, bool written)
+{
+  if (!zsiCsTracker.started)
+  {
+    /* Host may have cached anything before, so everything is reported */
+    CS_StartParametersTracking();
+    zsiCsTracker.started = true;
+    zsiCsTracker.changedInd.amount = ZSI_CS_ALL_PARAMETERS_CHANGED;
+    zsiSysReportParametersChanges();
+    SYS_SubscribeToEvent(BC_EVENT_NETWORK_STARTED, &zsiCsTracker.networkEventReceiver);
+    SYS_SubscribeToEvent(BC_EVENT_NETWORK_ENTERED, &zsiCsTracker.networkEventReceiver);
+    SYS_SubscribeToEvent(BC_EVENT_NETWORK_LEFT, &zsiCsTracker.networkEventReceiver);
+    SYS_SubscribeToEvent(BC_EVENT_NETWORK_UPDATE, &zsiCsTracker.networkEventReceiver);
+    SYS_SubscribeToEvent(BC_EVENT_CHANNEL_CHANGED, &zsiCsTracker.networkEventReceiver);
+    SYS_SubscribeToEvent(BC_EVENT_NWK_UPDATEID_CHANGED, &zsiCsTracker.networkEventReceiver);
+  }
+  /* Host knows the value it has written */
+  else if (written)
+    CS_AcceptParameterChange(parameterId);
+}
+
+/**************************************************************************//**
+  \brief Network state change observer. Network parameters are changed by
+         the stack directly rather than by CS_WriteParameter(), so all of
+         them are reported.
+
+  \param[in] eventId - event identifier.
+  \param[in] data - event data, unused.
+
+  \return None.
+ ******************************************************************************/
+static void zsiSysNetworkEventObserver(SYS_EventId_t eventId, SYS_EventData_t data)
+{
+  (void)eventId;
+  (void)data;
+
+  zsiCsTracker.changedInd.amount = ZSI_CS_ALL_PARAMETERS_CHANGED;
+  zsiSysReportParametersChanges();
+}
+
+/**************************************************************************//**
+  \brief Reports changes of parameters to the host. Called before commands,
+         which may depend on the changed parameters, are sent to the host.
+
+  \return None.
+ ******************************************************************************/
+void zsiSysReportParametersChanges(void)
+{
+  ZsiCsParametersChangedInd_t *ind = &zsiCsTracker.changedInd;
+  uint8_t changed;
+
+  if (!zsiCsTracker.started || zsiCsTracker.reporting)
+    return;
+
+  if (ZSI_CS_ALL_PARAMETERS_CHANGED == ind->amount)
+    /* Forget particular changes */
+    CS_CollectChangedParameters(NULL, 0U);
+  else
+  {
+    changed = CS_CollectChangedParameters(&ind->parameterIds[ind->amount],
+      ZSI_CS_CHANGED_PARAMETERS_MAX_AMOUNT - ind->amount);
+    if (changed > ZSI_CS_CHANGED_PARAMETERS_MAX_AMOUNT - ind->amount)
+      ind->amount = ZSI_CS_ALL_PARAMETERS_CHANGED;
+    else
+      ind->amount += changed;
+  }
+
+  /* Postponed indication is sent with changes appended */
+  if (!ind->amount || ind->pending)
+    return;
+
+  ind->pending = true;
+  zsiCsTracker.reporting = true;
+  zsiProcessCommand(ZSI_AREQ_CMD, ind, zsiSerializeCS_ParametersChangedInd, NULL);
+  zsiCsTracker.reporting = false;
+}
+#endif /* ZAPPSI_NP */
+
 /* eof zsiSys.c */
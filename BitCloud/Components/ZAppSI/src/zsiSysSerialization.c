@@ -21,11 +21,26 @@
  ******************************************************************************/
 #include <zsiSysSerialization.h>
 #include <zsiSerializer.h>
+#include <zsiMemoryManager.h>
 #include <sysUtils.h>
 
 /******************************************************************************
                                Implementation section
  ******************************************************************************/
+/**************************************************************************//**
+  \brief Memory usage statistics confirm frame size calculation routine.
+         SOF and LENGTH fields are dismissed.
+
+  \return Memory usage statistics confirm frame size.
+ ******************************************************************************/
+INLINE uint16_t zsiZSI_GetMemoryStatsConfLength(void)
+{
+  return ZSI_COMMAND_FRAME_OVERHEAD +
+         ZSI_MEMORY_CLASSES_AMOUNT * 3U * sizeof(uint8_t) + /* total, used, highWaterMark */
+         ZSI_MEMORY_DOMAINS_AMOUNT * sizeof(uint8_t) +      /* domainHighWaterMarks */
+         sizeof(uint16_t) +                                 /* allocationFailures */
+         sizeof(uint16_t);                                  /* quotaRejections */
+}
 
 #ifdef ZAPPSI_HOST
 /**************************************************************************//**
@@ -190,6 +205,166 @@ ZsiProcessingResult_t zsiDeserializeCS_WriteParameterConf(void *memory,
   (void)cmdFrame;
   return result;
 }
+/**************************************************************************//**
+  \brief Parameters changes indication deserialization and processing
+         routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+    \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeCS_ParametersChangedInd(void *memory,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = false,
+    .keepMemory = false
+  };
+  ZsiSerializer_t serializer =
+  {
+    .por = cmdFrame->payload
+  };
+  uint8_t amount;
+  uint16_t parameterId;
+
+  (void)memory;
+
+  zsiDeserializeUint8(&serializer, &amount);
+  if (ZSI_CS_ALL_PARAMETERS_CHANGED == amount)
+    CS_InvalidateMirror();
+  else
+  {
+    while (amount--)
+    {
+      zsiDeserializeUint16(&serializer, &parameterId);
+      CS_InvalidateMirroredParameter((CS_MemoryItemId_t)parameterId);
+    }
+  }
+
+  return result;
+}
+
+/**************************************************************************//**
+  \brief Link errors counters request serialization routine.
+
+  \param[in] req - request parameters, unused.
+  \param[out] cmdFrame - frame, which keeps serialized data.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiSerializeZSI_GetLinkStatsReq(const void *const req,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = true,
+    .keepMemory = true
+  };
+  uint8_t sequenceNumber = zsiGetSequenceNumber();
+
+  (void)req;
+
+  zsiPrepareCommand(cmdFrame, ZSI_COMMAND_FRAME_OVERHEAD, sequenceNumber,
+    ZSI_SREQ_CMD, ZSI_CMD_SYS, ZSI_SYS_GET_LINK_STATS_REQUEST);
+
+  return result;
+}
+
+/**************************************************************************//**
+  \brief Link errors counters confirm deserialization and processing routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetLinkStatsConf(void *memory,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = false,
+    .keepMemory = true
+  };
+  ZsiSerializer_t serializer =
+  {
+    .por = cmdFrame->payload
+  };
+  ZsiLinkStats_t *const stats = (ZsiLinkStats_t *)memory;
+
+  zsiDeserializeUint32(&serializer, &stats->fcsFailures);
+  zsiDeserializeUint32(&serializer, &stats->overflowAcksSent);
+  zsiDeserializeUint32(&serializer, &stats->overflowAcksReceived);
+  zsiDeserializeUint32(&serializer, &stats->retransmissions);
+
+  return result;
+}
+
+/**************************************************************************//**
+  \brief Memory usage statistics request serialization routine.
+
+  \param[in] req - request parameters, unused.
+  \param[out] cmdFrame - frame, which keeps serialized data.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiSerializeZSI_GetMemoryStatsReq(const void *const req,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = true,
+    .keepMemory = true
+  };
+  uint8_t sequenceNumber = zsiGetSequenceNumber();
+
+  (void)req;
+
+  zsiPrepareCommand(cmdFrame, ZSI_COMMAND_FRAME_OVERHEAD, sequenceNumber,
+    ZSI_SREQ_CMD, ZSI_CMD_SYS, ZSI_SYS_GET_MEMORY_STATS_REQUEST);
+
+  return result;
+}
+
+/**************************************************************************//**
+  \brief Memory usage statistics confirm deserialization and processing
+         routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetMemoryStatsConf(void *memory,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = false,
+    .keepMemory = true
+  };
+  ZsiSerializer_t serializer =
+  {
+    .por = cmdFrame->payload
+  };
+  ZsiMemoryStats_t *const stats = (ZsiMemoryStats_t *)memory;
+  uint8_t it;
+
+  for (it = 0U; it < ZSI_MEMORY_CLASSES_AMOUNT; it++)
+  {
+    zsiDeserializeUint8(&serializer, &stats->classes[it].total);
+    zsiDeserializeUint8(&serializer, &stats->classes[it].used);
+    zsiDeserializeUint8(&serializer, &stats->classes[it].highWaterMark);
+  }
+  for (it = 0U; it < ZSI_MEMORY_DOMAINS_AMOUNT; it++)
+    zsiDeserializeUint8(&serializer, &stats->domainHighWaterMarks[it]);
+  zsiDeserializeUint16(&serializer, &stats->allocationFailures);
+  zsiDeserializeUint16(&serializer, &stats->quotaRejections);
+
+  return result;
+}
 #elif defined(ZAPPSI_NP)
 /**************************************************************************//**
   \brief CS_ReadParameter request primitive deserialization and processing
@@ -219,6 +394,7 @@ ZsiProcessingResult_t zsiDeserializeCS_ReadParameterReq(void *memory,
 
   csParameter->size = CS_GetItemSize(csParameter->parameterId);
   CS_ReadParameter(csParameter->parameterId, csParameter->payload);
+  zsiSysParameterAccessed(csParameter->parameterId, false);
 
   /* Prepare and send confirm frame at the same buffer, as request */
   {
@@ -310,6 +486,7 @@ ZsiProcessingResult_t zsiDeserializeCS_WriteParameterReq(void *memory,
   }
 
   CS_WriteParameter(csParameter->parameterId, csParameter->payload);
+  zsiSysParameterAccessed(csParameter->parameterId, true);
 
   /* Prepare and send confirm frame at the same buffer, as request */
   {
@@ -325,6 +502,129 @@ ZsiProcessingResult_t zsiDeserializeCS_WriteParameterReq(void *memory,
   return result;
 }
 
+/**************************************************************************//**
+  \brief Parameters changes indication serialization routine.
+
+  \param[in] ind - indication parameters.
+  \param[out] cmdFrame - frame, which keeps serialized data.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiSerializeCS_ParametersChangedInd(const void *const ind,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = true,
+    .keepMemory = true
+  };
+  ZsiCsParametersChangedInd_t *indication = (ZsiCsParametersChangedInd_t *)ind;
+  ZsiSerializer_t serializer =
+  {
+    .pow = cmdFrame->payload
+  };
+  uint16_t length = zsiCS_ParametersChangedIndLength(indication);
+  uint8_t sequenceNumber = zsiGetSequenceNumber();
+
+  zsiPrepareCommand(cmdFrame, length, sequenceNumber, ZSI_AREQ_CMD, ZSI_CMD_SYS,
+    ZSI_SYS_PARAMETERS_CHANGED_INDICATION);
+
+  zsiSerializeUint8(&serializer, indication->amount);
+  if (ZSI_CS_ALL_PARAMETERS_CHANGED != indication->amount)
+  {
+    for (uint8_t i = 0U; i < indication->amount; i++)
+      zsiSerializeUint16(&serializer, indication->parameterIds[i]);
+  }
+
+  /* Indication is static, following changes are collected from scratch */
+  indication->amount = 0U;
+  indication->pending = false;
+
+  return result;
+}
+
+/**************************************************************************//**
+  \brief Link errors counters request deserialization and processing routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetLinkStatsReq(void *memory,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = false,
+    .keepMemory = false
+  };
+  ZsiSerializer_t serializer =
+  {
+    .pow = cmdFrame->payload
+  };
+  ZsiLinkStats_t *const stats = (ZsiLinkStats_t *)memory;
+  uint8_t sequenceNumber = cmdFrame->sequenceNumber;
+
+  zsiSerialGetLinkStats(stats);
+
+  /* Prepare and send confirm frame at the same buffer, as request */
+  zsiPrepareCommand(cmdFrame, zsiZSI_GetLinkStatsConfLength(stats),
+    sequenceNumber, ZSI_SRSP_CMD, ZSI_CMD_SYS, ZSI_SYS_GET_LINK_STATS_CONFIRM);
+
+  zsiSerializeUint32(&serializer, &stats->fcsFailures);
+  zsiSerializeUint32(&serializer, &stats->overflowAcksSent);
+  zsiSerializeUint32(&serializer, &stats->overflowAcksReceived);
+  zsiSerializeUint32(&serializer, &stats->retransmissions);
+
+  return result;
+}
+
+/**************************************************************************//**
+  \brief Memory usage statistics request deserialization and processing
+         routine.
+
+  \param[out] memory - memory allocated for command processing.
+  \param[in] cmdFrame - frame which keeps serialized command.
+
+  \return Processing result.
+ ******************************************************************************/
+ZsiProcessingResult_t zsiDeserializeZSI_GetMemoryStatsReq(void *memory,
+  ZsiCommandFrame_t *const cmdFrame)
+{
+  ZsiProcessingResult_t result =
+  {
+    .keepCmdFrame = false,
+    .keepMemory = false
+  };
+  ZsiSerializer_t serializer =
+  {
+    .pow = cmdFrame->payload
+  };
+  ZsiMemoryStats_t *const stats = (ZsiMemoryStats_t *)memory;
+  uint8_t sequenceNumber = cmdFrame->sequenceNumber;
+  uint8_t it;
+
+  zsiGetMemoryStats(stats);
+
+  /* Prepare and send confirm frame at the same buffer, as request */
+  zsiPrepareCommand(cmdFrame, zsiZSI_GetMemoryStatsConfLength(),
+    sequenceNumber, ZSI_SRSP_CMD, ZSI_CMD_SYS, ZSI_SYS_GET_MEMORY_STATS_CONFIRM);
+
+  for (it = 0U; it < ZSI_MEMORY_CLASSES_AMOUNT; it++)
+  {
+    zsiSerializeUint8(&serializer, stats->classes[it].total);
+    zsiSerializeUint8(&serializer, stats->classes[it].used);
+    zsiSerializeUint8(&serializer, stats->classes[it].highWaterMark);
+  }
+  for (it = 0U; it < ZSI_MEMORY_DOMAINS_AMOUNT; it++)
+    zsiSerializeUint8(&serializer, stats->domainHighWaterMarks[it]);
+  zsiSerializeUint16(&serializer, stats->allocationFailures);
+  zsiSerializeUint16(&serializer, stats->quotaRejections);
+
+  return result;
+}
+
 #endif /* ZAPPSI_NP */
 
 /* eof zsiSysSerialization.c */
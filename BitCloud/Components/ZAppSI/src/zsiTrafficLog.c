@@ -0,0 +1,105 @@
+/***************************************************************************//**
+  \file zsiTrafficLog.c
+
+  \brief ZAppSI link traffic recorder implementation.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015, Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+   History:
+    2026-10-17  Created.
+ ******************************************************************************/
+
+/******************************************************************************
+                               Includes section
+ ******************************************************************************/
+#include <zsiTrafficLog.h>
+
+#if (ZSI_TRAFFIC_RECORDER == 1) || (ZSI_TRAFFIC_REPLAY != ZSI_TRAFFIC_REPLAY_DISABLED)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/******************************************************************************
+                              Static variables section
+******************************************************************************/
+#if ZSI_TRAFFIC_RECORDER == 1
+static FILE *zsiTrafficLog;
+static uint64_t zsiTrafficLastRecordTime;
+#endif /* ZSI_TRAFFIC_RECORDER == 1 */
+
+/******************************************************************************
+                              Implementations section
+******************************************************************************/
+/******************************************************************************
+  \brief Returns monotonic time used to timestamp log records.
+
+  \return Time in microseconds.
+ ******************************************************************************/
+uint64_t zsiTrafficTime(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000U;
+}
+
+#if ZSI_TRAFFIC_RECORDER == 1
+/******************************************************************************
+  \brief Writes frame passing the medium to the traffic log. The log file is
+         created on the first call.
+
+  \param[in] flags - ZSI_TRAFFIC_RECEIVED_FLAG and reception status.
+  \param[in] sequenceNumber - sequence number of the frame.
+  \param[in] frame - frame, NULL if it was not received because of overflow.
+  \param[in] length - frame size.
+
+  \return None.
+ ******************************************************************************/
+void zsiTrafficRecord(uint8_t flags, uint8_t sequenceNumber,
+  const void *const frame, uint16_t length)
+{
+  const uint64_t now = zsiTrafficTime();
+  ZsiTrafficRecord_t record;
+  uint64_t delta;
+
+  if (!zsiTrafficLog)
+  {
+    const uint8_t version = ZSI_TRAFFIC_LOG_VERSION;
+
+    zsiTrafficLog = fopen(ZSI_TRAFFIC_LOG_FILE, "wb");
+    if (!zsiTrafficLog)
+    {
+      fprintf(stderr, "Failed to create ZAppSI traffic log %s\n", ZSI_TRAFFIC_LOG_FILE);
+      exit(1);
+    }
+    fwrite(ZSI_TRAFFIC_LOG_MAGIC, ZSI_TRAFFIC_LOG_MAGIC_SIZE, 1U, zsiTrafficLog);
+    fwrite(&version, sizeof(version), 1U, zsiTrafficLog);
+    zsiTrafficLastRecordTime = now;
+  }
+
+  if (!frame)
+    length = 0U;
+
+  delta = now - zsiTrafficLastRecordTime;
+  zsiTrafficLastRecordTime = now;
+
+  record.delta = CPU_TO_LE32((delta > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta);
+  record.flags = flags;
+  record.sequenceNumber = sequenceNumber;
+  record.length = CPU_TO_LE16(length);
+  fwrite(&record, sizeof(record), 1U, zsiTrafficLog);
+  if (length)
+    fwrite(frame, length, 1U, zsiTrafficLog);
+  /* Log is kept complete for the case the host stalls or crashes */
+  fflush(zsiTrafficLog);
+}
+#endif /* ZSI_TRAFFIC_RECORDER == 1 */
+
+#endif /* (ZSI_TRAFFIC_RECORDER == 1) || (ZSI_TRAFFIC_REPLAY != ZSI_TRAFFIC_REPLAY_DISABLED) */
+/* eof zsiTrafficLog.c */
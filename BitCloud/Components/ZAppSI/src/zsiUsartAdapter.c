@@ -29,25 +29,29 @@
 #include <sysUtils.h>
 #include <zsiDriver.h>
 #include <halTaskManager.h>
+#include <zsiTrafficLog.h>
 
-#if (APP_ZAPPSI_INTERFACE == APP_INTERFACE_USART) || (APP_ZAPPSI_INTERFACE == APP_INTERFACE_USBFIFO)
+#if ((APP_ZAPPSI_INTERFACE == APP_INTERFACE_USART) || (APP_ZAPPSI_INTERFACE == APP_INTERFACE_USBFIFO)) && \
+    (ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_DISABLED)
 
 /******************************************************************************
                                Defines section
  ******************************************************************************/
 #define ZSI_MEDIUM_CHANNEL APP_ZAPPSI_MEDIUM_CHANNEL
 #define LINK_SAFETY_TIMEOUT 300UL /* 300 ms */
+/* SOF, frame control, length and sequence number fields */
+#define ZSI_USART_RX_PREAMBLE_SIZE (ZSI_COMMAND_FRAME_PREAMBLE_SIZE + 1U)
+/* Size of the chunks used to skip frames which could not be buffered */
+#define ZSI_USART_RX_DISCARD_CHUNK_SIZE 16U
+/* Smallest valid value of frame length field: sequence number and FCS */
+#define ZSI_USART_MIN_FRAME_LENGTH 2U
 
 /******************************************************************************
                                Types section
  ******************************************************************************/
 enum
 {
-  ZSI_USART_WAITING_SOF_STATE,
-  ZSI_USART_WAITING_FRAME_CONTROL_STATE,
-  ZSI_USART_RECEIVING_LENGTH_LSB_STATE,
-  ZSI_USART_RECEIVING_LENGTH_MSB_STATE,
-  ZSI_USART_RECEIVING_SEQUENCE_NUMBER_STATE,
+  ZSI_USART_RECEIVING_PREAMBLE_STATE,
   ZSI_USART_RECEIVING_DATA_STATE,
   ZSI_USART_ERROR_STATE
 };
@@ -63,15 +67,27 @@ void zsiMediumHandler(void);
 ******************************************************************************/
 static void zsiUsartRxCallback(uint16_t bytesAmount);
 static void zsiUsartLinkSafetyTimerFired(void);
+static void zsiUsartRxSync(uint8_t offset);
+static void zsiUsartRxFrameStarted(void);
+static void zsiUsartRxFrameFinished(void);
 
 /******************************************************************************
                               Static variables section
 ******************************************************************************/
 static HAL_UsartDescriptor_t zsiUsartDescriptor;
-static uint8_t rxState = ZSI_USART_WAITING_SOF_STATE;
+static uint8_t rxState = ZSI_USART_RECEIVING_PREAMBLE_STATE;
 static uint8_t rxStatus = ZSI_NO_ERROR_STATUS;
 static uint8_t *rxBuffer;
 static uint8_t *poW;
+static ZsiRxFcs_t rxFcs;
+static uint8_t rxPreamble[ZSI_USART_RX_PREAMBLE_SIZE];
+static uint8_t rxPreambleLength;
+static uint16_t bytesToReceive;
+#ifdef BOARD_PC
+/* Host reads the tty in big blocks, so cyclic buffer is not taken from
+   ZAppSI memory pool */
+static uint8_t zsiUsartRxRing[ZSI_MEDIUM_RX_BUFFER_LENGTH];
+#endif
 static HAL_AppTimer_t usartLinkSafetyTimer =
 {
   .interval = LINK_SAFETY_TIMEOUT,
@@ -107,7 +123,11 @@ int zsiMediumInit(void)
   zsiUsartDescriptor.dataLength     = USART_DATA8;
   zsiUsartDescriptor.parity         = USART_PARITY_NONE;
   zsiUsartDescriptor.stopbits       = USART_STOPBIT_1;
+#ifdef BOARD_PC
+  zsiUsartDescriptor.rxBuffer       = zsiUsartRxRing;
+#else
   zsiUsartDescriptor.rxBuffer       = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
+#endif
   zsiUsartDescriptor.rxBufferLength = ZSI_MEDIUM_RX_BUFFER_LENGTH;
   zsiUsartDescriptor.txBuffer       = NULL;
   zsiUsartDescriptor.txBufferLength = 0U;
@@ -130,7 +150,8 @@ static void zsiUsartLinkSafetyTimerFired(void)
   }
   sysAssert(0U, ZSIMEDIUM_ZSIMEDIUMLINKSAFETYTIMERFIRED0);
   poW = rxBuffer = NULL;
-  rxState = ZSI_USART_WAITING_SOF_STATE;
+  rxPreambleLength = 0U;
+  rxState = ZSI_USART_RECEIVING_PREAMBLE_STATE;
 }
 
 /******************************************************************************
@@ -171,7 +192,107 @@ void zsiMediumReleaseAllHeldTasks(void)
 }
 
 /******************************************************************************
-  \brief Callback for new data received from USART.
+  \brief Gets value of length field of the received preamble.
+
+  \return Frame length.
+ ******************************************************************************/
+INLINE uint16_t zsiUsartRxFrameLength(void)
+{
+  return rxPreamble[2] | ((uint16_t)rxPreamble[3] << 8);
+}
+
+/******************************************************************************
+  \brief Drops received preamble bytes up to the next SOF.
+
+  \param[in] offset - index of the first preamble byte which may be SOF.
+
+  \return None.
+ ******************************************************************************/
+static void zsiUsartRxSync(uint8_t offset)
+{
+  while ((offset < rxPreambleLength) && (ZSI_SOF_SEQUENCE != rxPreamble[offset]))
+    offset++;
+
+  rxPreambleLength -= offset;
+  memmove(rxPreamble, rxPreamble + offset, rxPreambleLength);
+}
+
+/******************************************************************************
+  \brief Allocates buffer for the frame which preamble has been received.
+         The rest of the frame is read directly to the buffer.
+
+  \return None.
+ ******************************************************************************/
+static void zsiUsartRxFrameStarted(void)
+{
+  const uint8_t frameControl = rxPreamble[1];
+
+  bytesToReceive = zsiUsartRxFrameLength();
+  rxStatus = ZSI_NO_ERROR_STATUS;
+
+  /* Detect non-AREQ frames on early stage */
+  if ((sizeof(ZsiAckFrame_t) - ZSI_COMMAND_FRAME_PREAMBLE_SIZE) == bytesToReceive)
+  {
+    rxBuffer = zsiAllocateMemory(ZSI_RX_ACK_MEMORY);
+  }
+  else if (ZSI_SREQ_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
+  {
+    rxBuffer = zsiAllocateMemory(ZSI_SREQ_CMD);
+  }
+  else if (ZSI_SRSP_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
+  {
+    rxBuffer = zsiAllocateFrameMemory(ZSI_SRSP_CMD,
+                                      ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive);
+  }
+  else
+  {
+    rxBuffer = zsiAllocateFrameMemory(ZSI_MUTUAL_MEMORY,
+                                      ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive);
+  }
+
+  /* Check for overflow */
+  if (sizeof(ZsiCommandFrame_t) < (ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive))
+  {
+    if (rxBuffer)
+      zsiFreeMemory(rxBuffer);
+    rxBuffer = NULL;
+  }
+
+  if (rxBuffer)
+  {
+    memcpy(rxBuffer, rxPreamble, sizeof(rxPreamble));
+    poW = rxBuffer + sizeof(rxPreamble);
+  }
+  else
+    rxStatus = ZSI_OVERFLOW_STATUS;
+
+  zsiRxFcsStart(&rxFcs, frameControl);
+  zsiRxFcsUpdate(&rxFcs, rxPreamble + 2U, sizeof(rxPreamble) - 2U);
+  /* Sequence number is already received */
+  bytesToReceive--;
+  rxState = ZSI_USART_RECEIVING_DATA_STATE;
+}
+
+/******************************************************************************
+  \brief Passes completely received frame to serial controller.
+
+  \return None.
+ ******************************************************************************/
+static void zsiUsartRxFrameFinished(void)
+{
+  HAL_StopAppTimer(&usartLinkSafetyTimer);
+  if ((ZSI_NO_ERROR_STATUS == rxStatus) && !zsiRxFcsIsValid(&rxFcs))
+    rxStatus = ZSI_INVALID_FCS_STATUS;
+  zsiMediumReceive(rxStatus, rxPreamble[ZSI_COMMAND_FRAME_PREAMBLE_SIZE], rxBuffer);
+  poW = rxBuffer = NULL;
+  rxPreambleLength = 0U;
+  rxState = ZSI_USART_RECEIVING_PREAMBLE_STATE;
+}
+
+/******************************************************************************
+  \brief Callback for new data received from USART. Received data is read in
+         blocks: frame preamble is collected first, then the rest of the frame
+         is read directly to the allocated frame buffer.
 
   \param[in] length - received data size.
 
@@ -179,154 +300,74 @@ void zsiMediumReleaseAllHeldTasks(void)
  ******************************************************************************/
 static void zsiUsartRxCallback(uint16_t bytesAmount)
 {
-  static uint16_t bytesToReceive;
-  static uint8_t byte;
-  static uint8_t sequenceNumber;
-  uint16_t leLength;
-  static uint8_t frameControl;
+  uint8_t discard[ZSI_USART_RX_DISCARD_CHUNK_SIZE];
+  uint8_t *chunk;
+  uint16_t chunkSize;
+  int bytesRead;
 
   while (bytesAmount)
   {
     switch (rxState)
     {
-      /* Check for valid SOF */
-      case ZSI_USART_WAITING_SOF_STATE:
-        if (READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, &byte, sizeof(byte)) <= 0)
+      /* Collect SOF, frame control, length and sequence number fields */
+      case ZSI_USART_RECEIVING_PREAMBLE_STATE:
+        chunkSize = MIN(bytesAmount, sizeof(rxPreamble) - rxPreambleLength);
+        bytesRead = READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor,
+                                          rxPreamble + rxPreambleLength, chunkSize);
+        if (bytesRead <= 0)
         {
           rxState = ZSI_USART_ERROR_STATE;
           return;
         }
+        bytesAmount -= bytesRead;
+        rxPreambleLength += bytesRead;
 
-        if (ZSI_SOF_SEQUENCE == byte)
+        if (ZSI_SOF_SEQUENCE != rxPreamble[0])
         {
-          /* SOF captured - reset rx status and switch to length waiting */
-          rxStatus = ZSI_NO_ERROR_STATUS;
-          rxState = ZSI_USART_WAITING_FRAME_CONTROL_STATE;
+          sysAssert(0U, ZSIMEDIUM_ZSIMEDIUMRXCALLBACK0);
+          zsiUsartRxSync(1U);
         }
-        else
+        else if (ZSI_COMMAND_FRAME_PREAMBLE_SIZE <= rxPreambleLength &&
+                 ZSI_USART_MIN_FRAME_LENGTH > zsiUsartRxFrameLength())
         {
+          /* False SOF - look for the next one */
           sysAssert(0U, ZSIMEDIUM_ZSIMEDIUMRXCALLBACK0);
+          zsiUsartRxSync(1U);
         }
-        bytesAmount--;
-        break;
-
-      /* Capture frame control and identify frame type */
-      case ZSI_USART_WAITING_FRAME_CONTROL_STATE:
-        if (READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, &frameControl, sizeof(frameControl)) <= 0)
+        else if (sizeof(rxPreamble) == rxPreambleLength)
         {
-          rxState = ZSI_USART_ERROR_STATE;
-          return;
+          zsiUsartRxFrameStarted();
+          if (0U == bytesToReceive)
+            zsiUsartRxFrameFinished();
         }
-
-        rxState = ZSI_USART_RECEIVING_LENGTH_LSB_STATE;
-        bytesAmount--;
         break;
 
-      /* Postpone length LSB reading */
-      case ZSI_USART_RECEIVING_LENGTH_LSB_STATE:
-        rxState = ZSI_USART_RECEIVING_LENGTH_MSB_STATE;
-        if (READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, (uint8_t *)&byte,
-                          sizeof(uint8_t)) <= 0)
-        {
-          rxState = ZSI_USART_ERROR_STATE;
-          return;
-        }
-        bytesAmount--;
-        break;
-
-      /* Read frame length */
-      case ZSI_USART_RECEIVING_LENGTH_MSB_STATE:
-        rxState = ZSI_USART_RECEIVING_SEQUENCE_NUMBER_STATE;
-
-        if (READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, (uint8_t *)&leLength,
-                          sizeof(uint8_t)) <= 0)
-        {
-          rxState = ZSI_USART_ERROR_STATE;
-          return;
-        }
-        leLength = (leLength << 8) + byte;
-
-        /* Adapt length to endiannes */
-        bytesToReceive = LE16_TO_CPU(leLength);
-        /* Detect non-AREQ frames on early stage */
-        if ((sizeof(ZsiAckFrame_t) - ZSI_COMMAND_FRAME_PREAMBLE_SIZE) == bytesToReceive)
-        {
-          rxBuffer = zsiAllocateMemory(ZSI_RX_ACK_MEMORY);
-        }
-        else if (ZSI_SREQ_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
-        {
-          rxBuffer = zsiAllocateMemory(ZSI_SREQ_CMD);
-        }
-        else if (ZSI_SRSP_CMD == (frameControl & ZSI_CMD_TYPE_FIELD_MASK))
-        {
-          rxBuffer = zsiAllocateMemory(ZSI_SRSP_CMD);
-        }
-        else
-        {
-          rxBuffer = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
-        }
-
-        /* Check for overflow */
-        if (!rxBuffer ||
-            (sizeof(ZsiCommandFrame_t) <
-             (ZSI_COMMAND_FRAME_PREAMBLE_SIZE + bytesToReceive))
-           )
-          rxStatus = ZSI_OVERFLOW_STATUS;
-        /* If ok, put frame's preamble to allocated buffer */
+      /* Read the rest of the frame to the buffer, if allocated */
+      case ZSI_USART_RECEIVING_DATA_STATE:
+        chunkSize = MIN(bytesAmount, bytesToReceive);
+        if (rxBuffer)
+          chunk = poW;
         else
         {
-          poW = rxBuffer;
-          *poW++ = ZSI_SOF_SEQUENCE;
-          *poW++ = frameControl;
-
-          SYS_BYTE_MEMCPY(poW, &leLength, sizeof(leLength));
-          poW += sizeof(leLength);
+          chunk = discard;
+          chunkSize = MIN(chunkSize, sizeof(discard));
         }
-        bytesAmount --;
-        break;
 
-      /* Read Sequence Number field and put it down to buffer, if allocated */
-      case ZSI_USART_RECEIVING_SEQUENCE_NUMBER_STATE:
-        rxState = ZSI_USART_RECEIVING_DATA_STATE;
-        if (READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, &sequenceNumber,
-                          sizeof(sequenceNumber)) <= 0)
+        bytesRead = READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, chunk, chunkSize);
+        if (bytesRead <= 0)
         {
           rxState = ZSI_USART_ERROR_STATE;
           return;
         }
-
+        zsiRxFcsUpdate(&rxFcs, chunk, bytesRead);
         if (rxBuffer)
-        {
-          *poW++ = sequenceNumber;
-        }
-        bytesAmount--;
-        bytesToReceive--;
-        break;
+          poW += bytesRead;
+        bytesAmount -= bytesRead;
+        bytesToReceive -= bytesRead;
 
-      /* Pass the rest of the data to the buffer, if allocated */
-      case ZSI_USART_RECEIVING_DATA_STATE:
-        if (bytesToReceive--)
-        {
-          if (READ_ZAPPSI_INTERFACE(&zsiUsartDescriptor, &byte, sizeof(byte)) <= 0)
-          {
-            rxState = ZSI_USART_ERROR_STATE;
-            return;
-          }
-
-          if (rxBuffer)
-          {
-            *poW++ = byte;
-          }
-          bytesAmount--;
-        }
         /* Frame completely received - notify serial controller */
         if (0U == bytesToReceive)
-        {
-          HAL_StopAppTimer(&usartLinkSafetyTimer);
-          zsiMediumReceive(rxStatus, sequenceNumber, rxBuffer);
-          poW = rxBuffer = NULL;
-          rxState = ZSI_USART_WAITING_SOF_STATE;
-        }
+          zsiUsartRxFrameFinished();
         break;
 
       case ZSI_USART_ERROR_STATE:
@@ -336,12 +377,12 @@ static void zsiUsartRxCallback(uint16_t bytesAmount)
   }
 
   /* Throw bone to link safety timer */
-  if (ZSI_USART_WAITING_SOF_STATE != rxState)
+  if ((ZSI_USART_RECEIVING_PREAMBLE_STATE != rxState) || rxPreambleLength)
   {
     HAL_StopAppTimer(&usartLinkSafetyTimer);
     HAL_StartAppTimer(&usartLinkSafetyTimer);
   }
 }
 
-#endif /* (APP_ZAPPSI_INTERFACE == APP_INTERFACE_USART) || (APP_ZAPPSI_INTERFACE == APP_INTERFACE_USBFIFO) */
+#endif /* ((APP_ZAPPSI_INTERFACE == APP_INTERFACE_USART) || (APP_ZAPPSI_INTERFACE == APP_INTERFACE_USBFIFO)) && (ZSI_TRAFFIC_REPLAY == ZSI_TRAFFIC_REPLAY_DISABLED) */
 /* eof zsiUsartAdapter.c */
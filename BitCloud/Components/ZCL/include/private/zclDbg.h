@@ -53,6 +53,8 @@ typedef enum
   ZCL_UNEXPECTED_ASDU_LENGTH                        = 0xC205,
   UNKNOWN_DAT_TYPE_DESCR                            = 0xC206,
   ZCL_UNBOUNDED_READ                                = 0xC207,
+  ZCL_REPORTING_SCHEDULE_OVERFLOW                   = 0xC208,
+  ZCL_REPORTING_UNKNOWN_CLUSTER                     = 0xC209,
   //ZCL Memory Manager        (0xC300 - 0xC3ff)
   ZCL_DATAIND_0                                     = 0xC300,
   ZCL_THERE_ARE_NO_BUFFERS                          = 0xC301,
@@ -123,6 +125,7 @@ typedef enum
   ZCL_MEMORY_CORRUPTION_1                           = 0xC601,
   ZCL_MEMORY_CORRUPTION_2                           = 0xC602,
   ZCL_MEMORY_CORRUPTION_3                           = 0xC603,
+  ZCL_MEMORY_DOUBLE_FREE                            = 0xC606,
 
   ZCLZLLSCAN_ZCLZLLSCANREQ0                         = 0xC604,
   ZCLZLLNETWORK_ZCLZLLSTARTNETWORKREQ0              = 0xC605,
@@ -101,6 +101,52 @@ hold the maximum possible APS data size
 #endif
 #endif
 
+/** \brief The number of entries in the attribute lookup index
+
+The index maps an endpoint, cluster, cluster side and attribute ID to the
+attribute descriptor. It is filled for clusters of endpoints registered with
+ZCL_RegisterEndpoint(), attributes which did not fit are found by walking
+cluster's descriptors. Must be a power of two; 0 disables the index.
+An entry takes a descriptor pointer and 4 bytes, so the index is disabled
+by default; devices with many attributes and spare RAM may enable it.
+<b>Value range:</b> 0 to 256 \n
+<b>C-type:</b> uint16_t \n
+<b>Can be set:</b> at compile time only
+*/
+#ifndef ZCL_ATTRIBUTES_INDEX_SIZE
+  #define ZCL_ATTRIBUTES_INDEX_SIZE 0U
+#endif
+
+/** \brief The maximum number of attributes configured for reporting
+
+Attributes which are configured for reporting are kept in a schedule ordered
+by the time of the next report, so the report timer handler processes only
+attributes due for reporting. Attributes exceeding the schedule are still
+reported, but found by walking all attributes of the registered endpoints,
+so the schedule should fit the reportable attributes of the device.
+<b>Value range:</b> 1 to 255 \n
+<b>C-type:</b> uint8_t \n
+<b>Can be set:</b> at compile time only
+*/
+#ifndef ZCL_REPORTING_SCHEDULE_SIZE
+  #define ZCL_REPORTING_SCHEDULE_SIZE 32U
+#endif
+
+/** \brief The maximum number of incoming frames parsed in place
+
+Incoming frames are parsed in the indication buffers borrowed from ZAppSI
+instead of being copied to ZCL buffers, and up to this number of frames is
+parsed per task run. Frames exceeding the limit are copied as usual. Each
+borrowed frame holds two ZAppSI memory buffers until it is parsed. Applies
+to ZAppSI host only; 0 disables borrowing.
+<b>Value range:</b> 0 to 255 \n
+<b>C-type:</b> uint8_t \n
+<b>Can be set:</b> at compile time only
+*/
+#ifndef ZCL_BORROWED_DATA_IND_AMOUNT
+  #define ZCL_BORROWED_DATA_IND_AMOUNT 0U
+#endif
+
 /******************************************************************************
                            Types section
 ******************************************************************************/
@@ -1650,6 +1696,13 @@ void zclStopResponseWaitTimer(void);
  *****************************************************************************/
 void zclStartReportTimer(void);
 
+/*************************************************************************//**
+  \brief Reschedules report of the attribute marked for reporting on change
+
+  \param[in] attr - attribute with ZCL_ON_CHANGE_REPORT property set
+ *****************************************************************************/
+void zclScheduleOnChangeReport(ZclAttribute_t *attr);
+
 #endif //_ZCL_H
 
 //eof zcl.h
@@ -136,6 +136,23 @@ ZCL_Status_t zclReadIndexedAttribute(const ZCL_Selector_t *selector,
 ******************************************************************************/
 ZclAttribute_t *jumpToNextAttribute(ZclAttribute_t *attr);
 
+#if ZCL_ATTRIBUTES_INDEX_SIZE > 0
+/**************************************************************************//**
+\brief Adds attributes of the endpoint's clusters to the attribute lookup index
+
+\param[in] endpoint - registered endpoint
+******************************************************************************/
+void zclAddEndpointToAttributesIndex(ZCL_DeviceEndpoint_t *endpoint);
+
+/**************************************************************************//**
+\brief Rebuilds the attribute lookup index from the registered endpoints
+******************************************************************************/
+void zclRebuildAttributesIndex(void);
+#else
+  #define zclAddEndpointToAttributesIndex(endpoint) ((void)(endpoint))
+  #define zclRebuildAttributesIndex() ((void)0)
+#endif // ZCL_ATTRIBUTES_INDEX_SIZE > 0
+
 
 /**************************************************************************//**
 \brief Get Next command
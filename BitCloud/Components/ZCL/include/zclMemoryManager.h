@@ -64,17 +64,35 @@ typedef struct
   uint8_t *frame;
 } ZclMmBuffer_t;
 
-typedef struct
+typedef struct _ZclMmBufferDescriptor_t
 {
   uint32_t        timeout;
   ZclBufferType_t type;
   ZCL_Request_t   *link;
   ZclMmBuffer_t   buf;
+  /** Next free descriptor, for internal use only */
+  struct _ZclMmBufferDescriptor_t *nextFree;
 } ZclMmBufferDescriptor_t;
 
+#ifdef _ZCL_MEMORY_STATS_
+/** Usage statistics of buffers of one type */
+typedef struct
+{
+  uint8_t  used;            //!< Number of buffers currently in use
+  uint8_t  maxUsed;         //!< High-water mark of buffers in use
+  uint16_t quotaRejections; //!< Allocations rejected because of the type quota
+  uint16_t noFreeBuffer;    //!< Allocations rejected because all buffers were busy
+} ZclMmStats_t;
+#endif // _ZCL_MEMORY_STATS_
+
 /******************************************************************************
                    Prototypes section
 ******************************************************************************/
+/*************************************************************************//**
+\brief Puts all zcl memory buffers to the free list
+*****************************************************************************/
+void zclMmInit(void);
+
 /*************************************************************************//**
 \brief Looks for and returns free zcl memory buffer
 
@@ -102,6 +120,30 @@ void zclMmFreeMem(ZclMmBuffer_t *mem);
 *****************************************************************************/
 ZclMmBufferDescriptor_t *zclMmGetNextOutputMemDescriptor(ZclMmBufferDescriptor_t *descr);
 
+/*************************************************************************//**
+\brief Checks if memory belongs to zcl memory buffers
+
+\param[in] mem - pointer to memory
+
+\returns true if mem points to a zcl memory buffer, false otherwise
+*****************************************************************************/
+bool zclMmIsBuffer(const void *mem);
+
+#ifdef _ZCL_MEMORY_STATS_
+/*************************************************************************//**
+\brief Gets usage statistics of zcl memory buffers
+
+\param[in] type - the type of buffers, ZCL_UNKNOWN_BUFFER for all buffers
+\param[out] stats - pointer to the statistics to be filled
+*****************************************************************************/
+void zclMmGetStats(ZclBufferType_t type, ZclMmStats_t *stats);
+
+/*************************************************************************//**
+\brief Resets high-water marks and rejection counters of zcl memory buffers
+*****************************************************************************/
+void zclMmResetStats(void);
+#endif // _ZCL_MEMORY_STATS_
+
 #endif  //#ifndef _ZCLMEMORYMANAGER_H
 
 //eof zclMemoryManager.h
@@ -66,16 +66,43 @@
   GET_STRUCT_BY_FIELD_POINTER(ZclMmBufferDescriptor_t, buf, buffer);
 
 #define REPOST_TASK_TIMER_PERIOD   10
+// Period of report retry if there was no free buffer, ms
+#define REPORT_RETRY_PERIOD        1000UL
+// Reports older than the maximum reporting interval are not distinguished, ms
+#define REPORT_MAX_AGE             (0xFFFFUL * 1000UL)
 
 /******************************************************************************
                             Types section
 ******************************************************************************/
+// Attribute configured for reporting. Cluster is kept by ID since descriptors
+// returned for APP_CLUSTERS_IN_FLASH share one image and are valid until the next lookup.
+typedef struct
+{
+  ZclAttribute_t       *attr;
+  ZCL_DeviceEndpoint_t *endpoint;
+  ClusterId_t           clusterId;
+  uint8_t               clusterSide;
+  uint32_t              lastReportTime; // ms, time of the last report
+  uint32_t              dueTime;        // ms, time of the next report, valid if scheduled
+  bool                  scheduled;      // false if there is nothing to report until value changes
+} ZclReportEntry_t;
+
 typedef struct
 {
   SYS_Timer_t       waitTimer;
   SYS_Timer_t       reportTimer;
   SYS_Timer_t       repostTaskTimer;
   QueueDescriptor_t requestQueue;
+  // Binary min-heap of reportable attributes ordered by the time of the next report
+  ZclReportEntry_t  reports[ZCL_REPORTING_SCHEDULE_SIZE];
+  uint8_t           reportsAmount;
+  // Reportable attributes did not fit into the schedule and are found by scanning
+  bool              reportsOverflow;
+  // ms, time up to which report counters of attributes out of the schedule are updated
+  uint32_t          overflowScanTime;
+  // ms, time of the next report of attributes out of the schedule, valid if overflowScheduled
+  uint32_t          overflowDueTime;
+  bool              overflowScheduled;
 } ZclModuleMem_t;
 
 /******************************************************************************
@@ -93,6 +120,25 @@ static void zclWaitTimerFired(void);
 static void zclReportTimerFired(void);
 static void zclRepostTaskTimerFired(void);
 static uint8_t addToReportPayload(uint8_t *reportPayload, ZclAttribute_t *attr);
+static ZclMmBuffer_t *zclStartReportFrame(uint8_t **reportPayload);
+static void zclAddAttributeToReportFrame(ZclAttribute_t *attr, uint8_t **reportPayload);
+static void zclSendReportFrame(ZclMmBuffer_t *reportFrame, uint8_t *reportPayload,
+                               ZCL_DeviceEndpoint_t *endpoint, ZCL_Cluster_t *cluster);
+static ZclReportableAttributeTail_t *zclGetReportableAttributeTail(ZclAttribute_t *attr, uint8_t attrLength);
+static void zclStoreReportsProgress(void);
+static void zclBuildReportSchedule(void);
+static void zclAddClusterToReportSchedule(ZCL_DeviceEndpoint_t *endpoint, ZCL_Cluster_t *cluster, uint32_t now);
+static bool zclIsAttributeInReportSchedule(const ZclAttribute_t *attr);
+static bool zclScanOverflowedReports(uint32_t now, bool send);
+static void zclUpdateReportDueTime(ZclReportEntry_t *entry, uint32_t now);
+static bool zclIsReportBefore(const ZclReportEntry_t *first, const ZclReportEntry_t *second);
+static bool zclIsReportDue(const ZclReportEntry_t *entry, uint32_t now);
+static void zclSwapReports(uint8_t first, uint8_t second);
+static void zclReportsSiftUp(uint8_t index);
+static void zclReportsSiftDown(uint8_t index, uint8_t heapSize);
+static uint8_t zclGroupDueReports(uint8_t first);
+static bool zclSendReport(uint8_t first, uint8_t last, uint32_t now);
+static void zclArmReportTimer(uint32_t minDelay);
 static void zclVerifyConfirmResponseOrder(APS_DataConf_t *conf);
 #ifndef ZAPPSI_HOST
 static void isZclBusyOrPollRequest(SYS_EventId_t eventId, SYS_EventData_t data);
@@ -136,8 +182,11 @@ void ZCL_ResetReq(void)
   SYS_StopTimer(&zclModuleMem.repostTaskTimer);
   SYS_InitTimer(&zclModuleMem.repostTaskTimer, TIMER_ONE_SHOT_MODE, REPOST_TASK_TIMER_PERIOD, zclRepostTaskTimerFired);
   SYS_StopTimer(&zclModuleMem.reportTimer);
+  zclModuleMem.reportsAmount = 0;
 
+  zclMmInit();
   zclParserInit();
+  zclRebuildAttributesIndex();
 
 #if (defined _LINK_SECURITY_) && (!defined _LIGHT_LINK_PROFILE_)
   ZCL_ResetSecurity();
@@ -156,6 +205,8 @@ void ZCL_RegisterEndpoint(ZCL_DeviceEndpoint_t *endpoint)
   endpoint->service.apsEndpoint.APS_DataInd = zclDataInd;
 
   APS_RegisterEndpointReq(&endpoint->service.apsEndpoint);
+  if (APS_SUCCESS_STATUS == endpoint->service.apsEndpoint.status)
+    zclAddEndpointToAttributesIndex(endpoint);
 }
 
 /**************************************************************************//**
@@ -168,6 +219,9 @@ void ZCL_UnregisterEndpoint(ZCL_DeviceEndpoint_t *endpoint)
 {
   endpoint->service.unregEpReq.endpoint = endpoint->simpleDescriptor.endpoint;
   APS_UnregisterEndpointReq(&endpoint->service.unregEpReq);
+  // Attribute descriptors of the endpoint must not be found anymore
+  zclRebuildAttributesIndex();
+  zclStartReportTimer();
 }
 
 /**************************************************************************//**
@@ -205,9 +259,10 @@ void ZCL_CommandReq(ZCL_Request_t *req)
 *****************************************************************************/
 void ZCL_StartReporting(void)
 {
-  uint32_t  minTimeout = ~0ul;
   ApsBindingEntry_t *bindingEntry = NULL;
 
+  zclStoreReportsProgress();
+
   /* Go through binding table to activate default attribute reporting */
   while (NULL != (bindingEntry = APS_NextBindingEntry(bindingEntry)))
   {
@@ -233,18 +288,13 @@ void ZCL_StartReporting(void)
 
           attr->properties |= ZCL_REPORTING_CONFIGURED;
           tail->reportCounter = 0;
-          minTimeout = MIN(minTimeout, tail->maxReportInterval);
         }
         attr = jumpToNextAttribute(attr);
       }
     }
   }
 
-  if (~0ul != minTimeout)
-  {
-    SYS_InitTimer(&zclModuleMem.reportTimer, TIMER_ONE_SHOT_MODE, minTimeout * 1000, zclReportTimerFired);
-    SYS_StartTimer(&zclModuleMem.reportTimer);
-  }
+  zclBuildReportSchedule();
 }
 
 /**************************************************************************//**
@@ -1062,158 +1112,171 @@ static void zclWaitTimerFired(void)
 }
 
 /**************************************************************************//**
-\brief Callback for ZCL periodic report timer
+\brief Callback for ZCL periodic report timer. Reports attributes which are due,
+attributes of the same cluster are reported in one frame.
 ******************************************************************************/
 static void zclReportTimerFired(void)
 {
-  ZclMmBuffer_t *reportFrame = NULL;
-  ZCL_DeviceEndpoint_t *endpoint = NULL;
-  ZCL_Cluster_t *cluster = NULL;
-  uint8_t clusterCounter;
-  uint32_t minTimeout = ~0ul;
+  const uint32_t now = (uint32_t)HAL_GetSystemTime();
+  uint8_t heapSize = zclModuleMem.reportsAmount;
+  uint32_t minDelay = 0;
+  uint8_t last;
 
-  // For all endpoints
-  while (NULL != (endpoint = zclNextEndpoint(endpoint)))
+  // Move due attributes behind the heap
+  while (heapSize && zclIsReportDue(&zclModuleMem.reports[0], now))
   {
-    clusterCounter = endpoint->simpleDescriptor.AppInClustersCount;
-    // For all clusters
-    if (clusterCounter)
-      cluster = ZCL_GetHeadCluster(endpoint, ZCL_CLUSTER_SIDE_SERVER);
+    zclSwapReports(0, --heapSize);
+    zclReportsSiftDown(0, heapSize);
+  }
 
-    while (clusterCounter--)
-    {
-      uint8_t *reportPayload = NULL;
-      uint8_t *attrPtr = cluster->attributes;
-      ZclCommand_t *command = NULL;
-      // For all attributes from this cluster
-      for (uint8_t attrIndex = 0; attrIndex < cluster->attributesAmount; attrIndex++)
-      {
-        ZclAttribute_t *attr = (ZclAttribute_t *)attrPtr;
-        uint8_t attrLength = ZCL_GetAttributeLength(attr->type, (uint8_t *)&attr->value);
-		uint8_t boundaryCheckParamLength = 0;
-		if (attr->properties & ZCL_BOUNDARY_CHECK)
-        {
-          if (attr->properties & ZCL_CHECK_OTHER_ATTR)
-            boundaryCheckParamLength = sizeof(ZCL_AttributeId_t) * 2;
-		  else
-            boundaryCheckParamLength = attrLength * 2;
-		}
-        // Advance to next attribute (length of attribute struct = size of common fields + size of value)
-        attrPtr += SLICE_SIZE(ZclAttribute_t, id, properties) + attrLength;
-
-        if (!(attr->properties & ZCL_REPORTABLE_ATTRIBUTE))
-        {
-          attrPtr += boundaryCheckParamLength;
-          continue;
-        }
-        if (!isReportingPermitted(attr))
-        {
-          attrPtr += sizeof(ZclReportableAttributeTail_t) + attrLength + sizeof(ZCL_ReportTime_t) + attrLength + boundaryCheckParamLength; // tail + reportableChange + timeoutPeriod + value + boundary check parameters
-          continue;
-        }
+  // Report the most overdue attributes first, so ones left without a buffer are not starved
+  for (uint8_t i = heapSize, j = zclModuleMem.reportsAmount - 1; i < j; i++, j--)
+    zclSwapReports(i, j);
 
-        // Reportable attributes have an extra fields - attributePointer in fact points to them
-        ZclReportableAttributeTail_t *tail = (ZclReportableAttributeTail_t *)attrPtr;
-        uint8_t *pLastRepValue = attrPtr + sizeof(ZclReportableAttributeTail_t) + attrLength + sizeof(ZCL_ReportTime_t);
+  for (uint8_t first = heapSize; first < zclModuleMem.reportsAmount; first = last)
+  {
+    last = zclGroupDueReports(first);
 
-        attrPtr += sizeof(ZclReportableAttributeTail_t) + attrLength + sizeof(ZCL_ReportTime_t) + attrLength + boundaryCheckParamLength; // tail + reportableChange + timeoutPeriod + value + boundary check parameters
-        tail->reportCounter += zclModuleMem.reportTimer.timer.interval / 1000;
+    if (!zclSendReport(first, last, now))
+      // Attributes remain due, report will be retried later
+      minDelay = REPORT_RETRY_PERIOD;
+  }
 
-        if (attr->properties & ZCL_ON_CHANGE_REPORT)
-        {
-          if (tail->reportCounter < tail->minReportInterval)
-          {
-            minTimeout = MIN(minTimeout, (uint32_t)(tail->minReportInterval - tail->reportCounter));
-            continue;
-          }
-          attr->properties &= ~ZCL_ON_CHANGE_REPORT;
-          // Need to send report and check for maxReportInterval to schedulethe next report
-          if (tail->maxReportInterval)
-            minTimeout = MIN(minTimeout, tail->maxReportInterval);
-        }
-        else if(tail->maxReportInterval)
-        {
-          if (tail->reportCounter < tail->maxReportInterval)
-          {
-          minTimeout = MIN(minTimeout, (uint32_t)(tail->maxReportInterval - tail->reportCounter));
-          continue;
-        }
-          // scheduling next report after sending the current report
-        minTimeout = MIN(minTimeout, tail->maxReportInterval);
-        }
-        else
-        {
-          // maxReportInterval is zero & change report is not enabled so nothing to do
-          continue;
-        }
-        tail->reportCounter = 0;
+  // Put reported attributes back to the heap
+  while (heapSize < zclModuleMem.reportsAmount)
+  {
+    zclUpdateReportDueTime(&zclModuleMem.reports[heapSize], now);
+    zclReportsSiftUp(heapSize++);
+  }
 
-        if (NULL == reportFrame)
-        {
-          // First attribute in report - construct header
-          uint8_t headerLength;
+  if (zclModuleMem.reportsOverflow && zclModuleMem.overflowScheduled &&
+      ((int32_t)(now - zclModuleMem.overflowDueTime) >= 0))
+  {
+    if (!zclScanOverflowedReports(now, true))
+      minDelay = REPORT_RETRY_PERIOD;
+  }
 
-          reportFrame = zclMmGetMem(ZCL_OUTPUT_REPORT_BUFFER);
-          if (NULL == reportFrame)
-          {
-            //skip attribute reporting
-            //report will be postponed to next iteration
-            break;
-          }
-          reportFrame->primitive.apsDataReq.asdu = reportFrame->frame + getZclAsduOffset();
-          reportFrame->primitive.apsDataReq.APS_DataConf = reportConfirm;
-
-          // form request header
-          headerLength = zclFormRequest(&reportFrame->primitive.apsDataReq,
-                                        ZCL_STANDARD_REQ_TYPE,
-                                        ZCL_FRAME_CONTROL_DIRECTION_SERVER_TO_CLIENT,
-                                        ZCL_REPORT_ATTRIBUTES_COMMAND_ID,
-                                        ZCL_FRAME_CONTROL_DISABLE_DEFAULT_RESPONSE,
-                                        ZCL_FRAME_CONTROL_MANUFACTURER_NONSPECIFIC,
-                                        ZCL_GetNextSeqNumber());
-
-          reportPayload = reportFrame->primitive.apsDataReq.asdu + headerLength;
-        }
+  zclArmReportTimer(minDelay);
+}
 
-        memcpy(pLastRepValue, attr->value, attrLength);
-        tail->reportCounter = 0;
-        reportPayload += addToReportPayload(reportPayload, attr);
-      }
+/**************************************************************************//**
+\brief Sends report of the due attributes of one cluster
 
-      //if there is something to send
-      if (reportPayload)
-      {
-        reportFrame->primitive.apsDataReq.dstAddrMode = APS_NO_ADDRESS;
-        reportFrame->primitive.apsDataReq.clusterId = cluster->id;
-        reportFrame->primitive.apsDataReq.profileId = endpoint->simpleDescriptor.AppProfileId;
-        reportFrame->primitive.apsDataReq.txOptions.acknowledgedTransmission = 0;
-        command = zclGetCommandByCluster(cluster,
-                                         ZCL_FRAME_CONTROL_DIRECTION_SERVER_TO_CLIENT,
-                                         ZCL_REPORT_ATTRIBUTES_COMMAND_ID);
-        if (command && command->options.ackRequest)
-          reportFrame->primitive.apsDataReq.txOptions.acknowledgedTransmission = 1;
-
-        reportFrame->primitive.apsDataReq.txOptions.doNotDecrypt = 0;
-        reportFrame->primitive.apsDataReq.txOptions.noRouteDiscovery = 0;
-        reportFrame->primitive.apsDataReq.radius = 0;
-        reportFrame->primitive.apsDataReq.srcEndpoint = endpoint->simpleDescriptor.endpoint;
-        // set frame payload size
-        reportFrame->primitive.apsDataReq.asduLength = reportPayload - reportFrame->primitive.apsDataReq.asdu;
-        cluster->isReporting = 1;
-        zclApsDataReq(&reportFrame->primitive.apsDataReq, cluster->options.security);
-        reportFrame = NULL; //allocate new frame if needed
-      }
-      if (clusterCounter)
-        cluster = ZCL_GetNextCluster(cluster);
-    }
+\param[in] first - index of the first attribute in the schedule
+\param[in] last - index following the last attribute in the schedule
+\param[in] now - current time, ms
+\return false if there was no free buffer for the report, true otherwise
+******************************************************************************/
+static bool zclSendReport(uint8_t first, uint8_t last, uint32_t now)
+{
+  ZCL_DeviceEndpoint_t *endpoint = zclModuleMem.reports[first].endpoint;
+  ZclMmBuffer_t *reportFrame = NULL;
+  uint8_t *reportPayload;
+  ZCL_Cluster_t *cluster = ZCL_GetCluster(endpoint->simpleDescriptor.endpoint,
+                                          zclModuleMem.reports[first].clusterId,
+                                          zclModuleMem.reports[first].clusterSide);
+
+  SYS_E_ASSERT_WARN(cluster, ZCL_REPORTING_UNKNOWN_CLUSTER);
+  if (cluster)
+  {
+    reportFrame = zclStartReportFrame(&reportPayload);
+    if (NULL == reportFrame)
+      return false;
   }
-  if (~0ul != minTimeout)
+
+  for (uint8_t i = first; i < last; i++)
   {
-    SYS_InitTimer(&zclModuleMem.reportTimer, TIMER_ONE_SHOT_MODE, minTimeout * 1000, zclReportTimerFired);
-    SYS_StartTimer(&zclModuleMem.reportTimer);
+    ZclReportEntry_t *entry = &zclModuleMem.reports[i];
+
+    entry->lastReportTime = now;
+    if (reportFrame)
+      zclAddAttributeToReportFrame(entry->attr, &reportPayload);
   }
-  else
-    SYS_StopTimer(&zclModuleMem.reportTimer);
+
+  if (reportFrame)
+    zclSendReportFrame(reportFrame, reportPayload, endpoint, cluster);
+  return true;
+}
+
+/**************************************************************************//**
+\brief Allocates a buffer for a report and forms its header
+
+\param[out] reportPayload - pointer to the payload of the report
+\return buffer for the report or NULL if there is no free buffer
+******************************************************************************/
+static ZclMmBuffer_t *zclStartReportFrame(uint8_t **reportPayload)
+{
+  ZclMmBuffer_t *reportFrame = zclMmGetMem(ZCL_OUTPUT_REPORT_BUFFER);
+  uint8_t headerLength;
+
+  if (NULL == reportFrame)
+    return NULL;
+
+  reportFrame->primitive.apsDataReq.asdu = reportFrame->frame + getZclAsduOffset();
+  reportFrame->primitive.apsDataReq.APS_DataConf = reportConfirm;
+
+  // form request header
+  headerLength = zclFormRequest(&reportFrame->primitive.apsDataReq,
+                                ZCL_STANDARD_REQ_TYPE,
+                                ZCL_FRAME_CONTROL_DIRECTION_SERVER_TO_CLIENT,
+                                ZCL_REPORT_ATTRIBUTES_COMMAND_ID,
+                                ZCL_FRAME_CONTROL_DISABLE_DEFAULT_RESPONSE,
+                                ZCL_FRAME_CONTROL_MANUFACTURER_NONSPECIFIC,
+                                ZCL_GetNextSeqNumber());
+  *reportPayload = reportFrame->primitive.apsDataReq.asdu + headerLength;
+  return reportFrame;
+}
+
+/**************************************************************************//**
+\brief Adds attribute to the report and restarts its reporting intervals
+
+\param[in] attr - reported attribute
+\param[in, out] reportPayload - pointer to the end of the report payload
+******************************************************************************/
+static void zclAddAttributeToReportFrame(ZclAttribute_t *attr, uint8_t **reportPayload)
+{
+  uint8_t attrLength = ZCL_GetAttributeLength(attr->type, attr->value);
+  ZclReportableAttributeTail_t *tail = zclGetReportableAttributeTail(attr, attrLength);
+  // tail + reportableChange + timeoutPeriod
+  uint8_t *pLastRepValue = (uint8_t *)tail + sizeof(ZclReportableAttributeTail_t) + attrLength + sizeof(ZCL_ReportTime_t);
+
+  attr->properties &= ~ZCL_ON_CHANGE_REPORT;
+  memcpy(pLastRepValue, attr->value, attrLength);
+  tail->reportCounter = 0;
+  *reportPayload += addToReportPayload(*reportPayload, attr);
+}
+
+/**************************************************************************//**
+\brief Sends the report of the cluster's attributes
+
+\param[in] reportFrame - buffer of the report
+\param[in] reportPayload - end of the report payload
+\param[in] endpoint - endpoint of the cluster
+\param[in] cluster - reported cluster
+******************************************************************************/
+static void zclSendReportFrame(ZclMmBuffer_t *reportFrame, uint8_t *reportPayload,
+                               ZCL_DeviceEndpoint_t *endpoint, ZCL_Cluster_t *cluster)
+{
+  ZclCommand_t *command;
+
+  reportFrame->primitive.apsDataReq.dstAddrMode = APS_NO_ADDRESS;
+  reportFrame->primitive.apsDataReq.clusterId = cluster->id;
+  reportFrame->primitive.apsDataReq.profileId = endpoint->simpleDescriptor.AppProfileId;
+  reportFrame->primitive.apsDataReq.txOptions.acknowledgedTransmission = 0;
+  command = zclGetCommandByCluster(cluster,
+                                   ZCL_FRAME_CONTROL_DIRECTION_SERVER_TO_CLIENT,
+                                   ZCL_REPORT_ATTRIBUTES_COMMAND_ID);
+  if (command && command->options.ackRequest)
+    reportFrame->primitive.apsDataReq.txOptions.acknowledgedTransmission = 1;
+
+  reportFrame->primitive.apsDataReq.txOptions.doNotDecrypt = 0;
+  reportFrame->primitive.apsDataReq.txOptions.noRouteDiscovery = 0;
+  reportFrame->primitive.apsDataReq.radius = 0;
+  reportFrame->primitive.apsDataReq.srcEndpoint = endpoint->simpleDescriptor.endpoint;
+  // set frame payload size
+  reportFrame->primitive.apsDataReq.asduLength = reportPayload - reportFrame->primitive.apsDataReq.asdu;
+  cluster->isReporting = 1;
+  zclApsDataReq(&reportFrame->primitive.apsDataReq, cluster->options.security);
 }
 
 /**************************************************************************//**
@@ -1452,53 +1515,426 @@ static void zclStartWaitResponseTimer(ZclMmBufferDescriptor_t *descriptor)
  *****************************************************************************/
 void zclStartReportTimer(void)
 {
+  zclStoreReportsProgress();
+  zclBuildReportSchedule();
+}
+
+/*************************************************************************//**
+  \brief Reschedules report of the attribute marked for reporting on change
+
+  \param[in] attr - attribute with ZCL_ON_CHANGE_REPORT property set
+ *****************************************************************************/
+void zclScheduleOnChangeReport(ZclAttribute_t *attr)
+{
+  for (uint8_t i = 0; i < zclModuleMem.reportsAmount; i++)
+  {
+    if (zclModuleMem.reports[i].attr == attr)
+    {
+      zclUpdateReportDueTime(&zclModuleMem.reports[i], (uint32_t)HAL_GetSystemTime());
+      zclReportsSiftUp(i);
+      zclReportsSiftDown(i, zclModuleMem.reportsAmount);
+      zclArmReportTimer(0);
+      return;
+    }
+  }
+
+  // Attribute is not scheduled yet
+  zclStartReportTimer();
+}
+
+/*************************************************************************//**
+  \brief Stores time passed since the last report of scheduled attributes
+    in their report counters, so it survives rebuilding of the schedule
+ *****************************************************************************/
+static void zclStoreReportsProgress(void)
+{
+  const uint32_t now = (uint32_t)HAL_GetSystemTime();
+
+  for (uint8_t i = 0; i < zclModuleMem.reportsAmount; i++)
+  {
+    ZclReportEntry_t *entry = &zclModuleMem.reports[i];
+    ZclReportableAttributeTail_t *tail =
+      zclGetReportableAttributeTail(entry->attr, ZCL_GetAttributeLength(entry->attr->type, entry->attr->value));
+
+    tail->reportCounter = MIN(now - entry->lastReportTime, REPORT_MAX_AGE) / 1000UL;
+  }
+
+  if (zclModuleMem.reportsOverflow)
+    zclScanOverflowedReports(now, false);
+}
+
+/*************************************************************************//**
+  \brief Collects attributes configured for reporting from all endpoints
+    and starts the report timer for the closest report
+ *****************************************************************************/
+static void zclBuildReportSchedule(void)
+{
+  const uint32_t now = (uint32_t)HAL_GetSystemTime();
   ZCL_DeviceEndpoint_t *endpoint = NULL;
-  uint32_t  minTimeout = ~0ul;
-  uint32_t curTime     = halGetTimeOfAppTimer();
 
-  // look for the closest reporting time
+  zclModuleMem.reportsAmount = 0;
+  zclModuleMem.reportsOverflow = false;
+
   // For all endpoints
   while (NULL != (endpoint = zclNextEndpoint(endpoint)))
   {
-    ZCL_Cluster_t *cluster = ZCL_GetHeadCluster(endpoint, ZCL_CLUSTER_SIDE_SERVER);
+    uint8_t clusterCounter = endpoint->simpleDescriptor.AppInClustersCount;
+    ZCL_Cluster_t *cluster = NULL;
+
+    if (clusterCounter)
+      cluster = ZCL_GetHeadCluster(endpoint, ZCL_CLUSTER_SIDE_SERVER);
 
     // For all server side clusters
-    for (uint8_t clusterIndex = 0; clusterIndex < endpoint->simpleDescriptor.AppInClustersCount; clusterIndex++)
+    while (clusterCounter--)
+    {
+      zclAddClusterToReportSchedule(endpoint, cluster, now);
+      if (clusterCounter)
+        cluster = ZCL_GetNextCluster(cluster);
+    }
+  }
+
+  if (zclModuleMem.reportsOverflow)
+  {
+    // Report counters of attributes out of the schedule are up to date
+    zclModuleMem.overflowScanTime = now;
+    zclScanOverflowedReports(now, false);
+  }
+
+  zclArmReportTimer(0);
+}
+
+/*************************************************************************//**
+  \brief Adds attributes of the cluster configured for reporting to the schedule
+
+  \param[in] endpoint - endpoint of the cluster
+  \param[in] cluster - server side cluster
+  \param[in] now - current time, ms
+ *****************************************************************************/
+static void zclAddClusterToReportSchedule(ZCL_DeviceEndpoint_t *endpoint, ZCL_Cluster_t *cluster, uint32_t now)
+{
+  ZclAttribute_t *attr = (ZclAttribute_t *)cluster->attributes;
+
+  for (uint8_t attrIndex = 0; attrIndex < cluster->attributesAmount; attrIndex++)
+  {
+    if ((attr->properties & ZCL_REPORTABLE_ATTRIBUTE) && isReportingPermitted(attr))
     {
-      ZclAttribute_t *attr = (ZclAttribute_t *)cluster->attributes;
-      uint8_t attrLength;
-      uint8_t *reportCounterPtr;
       ZclReportableAttributeTail_t *tail;
-      // For all attributes
+      ZclReportEntry_t *entry;
+
+      if (ZCL_REPORTING_SCHEDULE_SIZE == zclModuleMem.reportsAmount)
+      {
+        // The rest of attributes is reported by zclScanOverflowedReports()
+        SYS_E_ASSERT_WARN(false, ZCL_REPORTING_SCHEDULE_OVERFLOW);
+        zclModuleMem.reportsOverflow = true;
+        return;
+      }
+
+      tail = zclGetReportableAttributeTail(attr, ZCL_GetAttributeLength(attr->type, attr->value));
+      entry = &zclModuleMem.reports[zclModuleMem.reportsAmount];
+      entry->attr = attr;
+      entry->endpoint = endpoint;
+      entry->clusterId = cluster->id;
+      entry->clusterSide = ZCL_CLUSTER_SIDE_SERVER;
+      entry->lastReportTime = now - tail->reportCounter * 1000UL;
+      zclUpdateReportDueTime(entry, now);
+      zclReportsSiftUp(zclModuleMem.reportsAmount++);
+    }
+    attr = jumpToNextAttribute(attr);
+  }
+}
+
+/*************************************************************************//**
+  \brief Calculates time of the next report of the attribute
+
+  \param[in] entry - scheduled attribute
+  \param[in] now - current time, ms
+ *****************************************************************************/
+static void zclUpdateReportDueTime(ZclReportEntry_t *entry, uint32_t now)
+{
+  ZclAttribute_t *attr = entry->attr;
+  ZclReportableAttributeTail_t *tail =
+    zclGetReportableAttributeTail(attr, ZCL_GetAttributeLength(attr->type, attr->value));
+
+  // Keep due time comparable with current time for long unreported attributes
+  if (now - entry->lastReportTime > REPORT_MAX_AGE)
+    entry->lastReportTime = now - REPORT_MAX_AGE;
+
+  entry->scheduled = false;
+  if (!isReportingPermitted(attr))
+    return;
+
+  if (attr->properties & ZCL_ON_CHANGE_REPORT)
+  {
+    entry->dueTime = entry->lastReportTime + tail->minReportInterval * 1000UL;
+    entry->scheduled = true;
+  }
+  else if (tail->maxReportInterval)
+  {
+    entry->dueTime = entry->lastReportTime + tail->maxReportInterval * 1000UL;
+    entry->scheduled = true;
+  }
+  // maxReportInterval is zero & change report is not enabled so nothing to do
+}
+
+/*************************************************************************//**
+  \brief Starts the report timer for the closest report
+
+  \param[in] minDelay - minimum delay of the timer, ms
+ *****************************************************************************/
+static void zclArmReportTimer(uint32_t minDelay)
+{
+  const ZclReportEntry_t *next = &zclModuleMem.reports[0];
+  const uint32_t now = (uint32_t)HAL_GetSystemTime();
+  bool scheduled = zclModuleMem.reportsAmount && next->scheduled;
+  uint32_t dueTime = next->dueTime;
+  uint32_t delay = 0;
+
+  if (zclModuleMem.reportsOverflow && zclModuleMem.overflowScheduled &&
+      (!scheduled || ((int32_t)(zclModuleMem.overflowDueTime - dueTime) < 0)))
+  {
+    dueTime = zclModuleMem.overflowDueTime;
+    scheduled = true;
+  }
+
+  if (!scheduled)
+  {
+    SYS_StopTimer(&zclModuleMem.reportTimer);
+    return;
+  }
+
+  if ((int32_t)(dueTime - now) > 0)
+    delay = dueTime - now;
+
+  SYS_InitTimer(&zclModuleMem.reportTimer, TIMER_ONE_SHOT_MODE, MAX(delay, minDelay), zclReportTimerFired);
+  SYS_StartTimer(&zclModuleMem.reportTimer);
+}
+
+/*************************************************************************//**
+  \brief Gets extra fields of the reportable attribute
+
+  \param[in] attr - reportable attribute
+  \param[in] attrLength - length of attribute's value
+  \return pointer to the fields following attribute's value
+ *****************************************************************************/
+static ZclReportableAttributeTail_t *zclGetReportableAttributeTail(ZclAttribute_t *attr, uint8_t attrLength)
+{
+  return (ZclReportableAttributeTail_t *)((uint8_t *)attr + SLICE_SIZE(ZclAttribute_t, id, properties) + attrLength);
+}
+
+/*************************************************************************//**
+  \brief Checks if the first attribute should be reported before the second one
+
+  \param[in] first - first scheduled attribute
+  \param[in] second - second scheduled attribute
+  \return true if the first attribute is reported earlier
+ *****************************************************************************/
+static bool zclIsReportBefore(const ZclReportEntry_t *first, const ZclReportEntry_t *second)
+{
+  if (first->scheduled != second->scheduled)
+    return first->scheduled;
+
+  return first->scheduled && ((int32_t)(first->dueTime - second->dueTime) < 0);
+}
+
+/*************************************************************************//**
+  \brief Checks if attribute should be reported now
+
+  \param[in] entry - scheduled attribute
+  \param[in] now - current time, ms
+  \return true if report is due
+ *****************************************************************************/
+static bool zclIsReportDue(const ZclReportEntry_t *entry, uint32_t now)
+{
+  return entry->scheduled && ((int32_t)(now - entry->dueTime) >= 0);
+}
+
+/*************************************************************************//**
+  \brief Swaps two attributes in the schedule
+
+  \param[in] first - index of the first attribute
+  \param[in] second - index of the second attribute
+ *****************************************************************************/
+static void zclSwapReports(uint8_t first, uint8_t second)
+{
+  ZclReportEntry_t tmp = zclModuleMem.reports[first];
+
+  zclModuleMem.reports[first] = zclModuleMem.reports[second];
+  zclModuleMem.reports[second] = tmp;
+}
+
+/*************************************************************************//**
+  \brief Moves attribute towards the heap root while it is reported earlier
+    than its parent
+
+  \param[in] index - index of the attribute
+ *****************************************************************************/
+static void zclReportsSiftUp(uint8_t index)
+{
+  ZclReportEntry_t entry = zclModuleMem.reports[index];
+
+  while (index)
+  {
+    uint8_t parent = (index - 1) / 2;
+
+    if (!zclIsReportBefore(&entry, &zclModuleMem.reports[parent]))
+      break;
+    zclModuleMem.reports[index] = zclModuleMem.reports[parent];
+    index = parent;
+  }
+  zclModuleMem.reports[index] = entry;
+}
+
+/*************************************************************************//**
+  \brief Moves attribute towards the heap leaves while any of its children
+    is reported earlier
+
+  \param[in] index - index of the attribute
+  \param[in] heapSize - number of attributes in the heap
+ *****************************************************************************/
+static void zclReportsSiftDown(uint8_t index, uint8_t heapSize)
+{
+  ZclReportEntry_t entry = zclModuleMem.reports[index];
+
+  for (;;)
+  {
+    uint16_t child = 2 * index + 1;
+
+    if (child >= heapSize)
+      break;
+    if (child + 1 < heapSize && zclIsReportBefore(&zclModuleMem.reports[child + 1], &zclModuleMem.reports[child]))
+      child++;
+    if (!zclIsReportBefore(&zclModuleMem.reports[child], &entry))
+      break;
+    zclModuleMem.reports[index] = zclModuleMem.reports[child];
+    index = child;
+  }
+  zclModuleMem.reports[index] = entry;
+}
+
+/*************************************************************************//**
+  \brief Places due attributes of the same cluster next to the first one
+
+  \param[in] first - index of the first due attribute to be reported
+  \return index following the last due attribute of the same cluster
+ *****************************************************************************/
+static uint8_t zclGroupDueReports(uint8_t first)
+{
+  const ZclReportEntry_t *entry = &zclModuleMem.reports[first];
+  uint8_t last = first + 1;
+
+  for (uint8_t i = last; i < zclModuleMem.reportsAmount; i++)
+  {
+    if ((zclModuleMem.reports[i].endpoint == entry->endpoint) &&
+        (zclModuleMem.reports[i].clusterId == entry->clusterId) &&
+        (zclModuleMem.reports[i].clusterSide == entry->clusterSide))
+    {
+      if (i != last)
+        zclSwapReports(i, last);
+      last++;
+    }
+  }
+
+  return last;
+}
+
+/*************************************************************************//**
+  \brief Checks if the attribute is in the report schedule
+
+  \param[in] attr - reportable attribute
+  \return true if the attribute is scheduled
+ *****************************************************************************/
+static bool zclIsAttributeInReportSchedule(const ZclAttribute_t *attr)
+{
+  for (uint8_t i = 0; i < zclModuleMem.reportsAmount; i++)
+    if (zclModuleMem.reports[i].attr == attr)
+      return true;
+
+  return false;
+}
+
+/*************************************************************************//**
+  \brief Updates report counters of attributes which did not fit into the
+    schedule, reports due ones and calculates time of their next report.
+    Attributes of the same cluster are reported in one frame.
+
+  \param[in] now - current time, ms
+  \param[in] send - true to report due attributes, false to update counters only
+  \return false if there was no free buffer for a report, true otherwise
+ *****************************************************************************/
+static bool zclScanOverflowedReports(uint32_t now, bool send)
+{
+  ZCL_DeviceEndpoint_t *endpoint = NULL;
+  uint32_t minTimeout = 0xFFFFFFFFUL;
+  uint32_t elapsed;
+  bool result = true;
+
+  if (now - zclModuleMem.overflowScanTime > REPORT_MAX_AGE)
+    zclModuleMem.overflowScanTime = now - REPORT_MAX_AGE;
+  elapsed = (now - zclModuleMem.overflowScanTime) / 1000UL;
+  zclModuleMem.overflowScanTime += elapsed * 1000UL;
+
+  // For all endpoints
+  while (NULL != (endpoint = zclNextEndpoint(endpoint)))
+  {
+    uint8_t clusterCounter = endpoint->simpleDescriptor.AppInClustersCount;
+    ZCL_Cluster_t *cluster = NULL;
+
+    if (clusterCounter)
+      cluster = ZCL_GetHeadCluster(endpoint, ZCL_CLUSTER_SIDE_SERVER);
+
+    // For all server side clusters
+    while (clusterCounter--)
+    {
+      ZclAttribute_t *attr = (ZclAttribute_t *)cluster->attributes;
+      ZclMmBuffer_t *reportFrame = NULL;
+      uint8_t *reportPayload = NULL;
+
       for (uint8_t attrIndex = 0; attrIndex < cluster->attributesAmount; attrIndex++)
       {
-        if ((attr->properties & ZCL_REPORTABLE_ATTRIBUTE) && isReportingPermitted(attr))
+        if ((attr->properties & ZCL_REPORTABLE_ATTRIBUTE) && isReportingPermitted(attr) &&
+            !zclIsAttributeInReportSchedule(attr))
         {
-          attrLength = ZCL_GetAttributeLength(attr->type, (uint8_t *)&attr->value);
-          reportCounterPtr = (uint8_t *)attr + ATTRIBUTE_ID_SIZE + ATTRIBUTE_TYPE_SIZE +
-                                      sizeof(uint8_t) + attrLength; // properties + value
-          tail = (ZclReportableAttributeTail_t *)reportCounterPtr;
+          ZclReportableAttributeTail_t *tail =
+            zclGetReportableAttributeTail(attr, ZCL_GetAttributeLength(attr->type, attr->value));
+          ZCL_ReportTime_t interval = tail->maxReportInterval;
 
-          if (0xFFFFu != tail->minReportInterval)
+          tail->reportCounter = MIN(tail->reportCounter + elapsed, REPORT_MAX_AGE / 1000UL);
+          if (attr->properties & ZCL_ON_CHANGE_REPORT)
+            interval = tail->minReportInterval;
+
+          // If maxReportInterval is zero & change report is not enabled there is nothing to do
+          if ((attr->properties & ZCL_ON_CHANGE_REPORT) || interval)
           {
-            tail->reportCounter += (curTime - zclModuleMem.reportTimer.timer.service.sysTimeLabel) / 1000;
-            if (attr->properties & ZCL_ON_CHANGE_REPORT)
-              minTimeout = ((tail->reportCounter >= tail->minReportInterval) ? 0 : MIN(minTimeout,  (uint32_t)(tail->minReportInterval - tail->reportCounter)));
-            else if (tail->maxReportInterval)
-              minTimeout = ((tail->reportCounter >= tail->maxReportInterval) ? 0 : MIN(minTimeout,  (uint32_t)(tail->maxReportInterval - tail->reportCounter)));
+            if (tail->reportCounter < interval)
+              minTimeout = MIN(minTimeout, (uint32_t)(interval - tail->reportCounter));
+            else if (send && (reportFrame || (reportFrame = zclStartReportFrame(&reportPayload))))
+            {
+              zclAddAttributeToReportFrame(attr, &reportPayload);
+              if (tail->maxReportInterval)
+                minTimeout = MIN(minTimeout, tail->maxReportInterval);
+            }
+            else
+            {
+              // Report is due now, it is retried later if there was no free buffer
+              if (send)
+                result = false;
+              minTimeout = 0;
+            }
           }
         }
         attr = jumpToNextAttribute(attr);
       }
-      cluster = ZCL_GetNextCluster(cluster);
+
+      if (reportFrame)
+        zclSendReportFrame(reportFrame, reportPayload, endpoint, cluster);
+      if (clusterCounter)
+        cluster = ZCL_GetNextCluster(cluster);
     }
   }
-  
-  if (minTimeout != 0xFFFFFFFFul)
-  {
-  SYS_InitTimer(&zclModuleMem.reportTimer, TIMER_ONE_SHOT_MODE, minTimeout * 1000, zclReportTimerFired);
-  SYS_StartTimer(&zclModuleMem.reportTimer);
-  }
+
+  zclModuleMem.overflowScheduled = (0xFFFFFFFFUL != minTimeout);
+  zclModuleMem.overflowDueTime = zclModuleMem.overflowScanTime + minTimeout * 1000UL;
+  return result;
 }
 
 #endif // ZCL_SUPPORT == 1
@@ -44,6 +44,31 @@ static bool zclIsAttributeTypeUnsigned(uint8_t typeId);
 ZclCommand_t * zclGetNextCommand(ZclCommand_t *command);
 static bool isOnChangeReportingNeeded(const ZclAttribute_t *pAttr);
 static void zclReportOnChangeIfNeeded(ZclAttribute_t *attr, ZCL_DataTypeDescriptor_t *desc);
+#if ZCL_ATTRIBUTES_INDEX_SIZE > 0
+static uint16_t zclGetAttributesIndexHash(Endpoint_t endpointId, ClusterId_t clusterId, uint8_t clusterSide,
+                                          ZCL_AttributeId_t attributeId);
+static void zclAddClustersToAttributesIndex(ZCL_DeviceEndpoint_t *endpoint, uint8_t clusterSide);
+#endif // ZCL_ATTRIBUTES_INDEX_SIZE > 0
+
+/******************************************************************************
+                   Types section
+******************************************************************************/
+#if ZCL_ATTRIBUTES_INDEX_SIZE > 0
+#if (ZCL_ATTRIBUTES_INDEX_SIZE & (ZCL_ATTRIBUTES_INDEX_SIZE - 1U)) || (ZCL_ATTRIBUTES_INDEX_SIZE > 256U)
+  #error ZCL_ATTRIBUTES_INDEX_SIZE must be a power of two not greater than 256
+#endif
+
+/* Entry of the attribute lookup index. Attribute ID is taken from the descriptor.
+   Descriptor pointers are valid for APP_CLUSTERS_IN_FLASH too since attributes
+   are always kept in RAM, only cluster descriptors are restored to the image. */
+typedef struct
+{
+  ZclAttribute_t *attr;
+  ClusterId_t     clusterId;
+  Endpoint_t      endpointId;
+  uint8_t         clusterSide;
+} ZclAttributesIndexEntry_t;
+#endif // ZCL_ATTRIBUTES_INDEX_SIZE > 0
 
 /******************************************************************************
                    Implementation section
@@ -51,6 +76,11 @@ static void zclReportOnChangeIfNeeded(ZclAttribute_t *attr, ZCL_DataTypeDescript
 #if APP_CLUSTERS_IN_FLASH == 1
 static zclClusterImage_t clusterImage;
 #endif // APP_CLUSTERS_IN_FLASH == 1
+#if ZCL_ATTRIBUTES_INDEX_SIZE > 0
+// Open addressing hash table, filled up to 3/4 to keep probe sequences short
+static ZclAttributesIndexEntry_t attributesIndex[ZCL_ATTRIBUTES_INDEX_SIZE];
+static uint16_t attributesIndexUsed;
+#endif // ZCL_ATTRIBUTES_INDEX_SIZE > 0
 /*************************************************************************//**
   \brief  ZCL Data Type Unsigness get by Type Id function.
   \param  Id - ZCL Data Type Id (unsigned 8-bit integer)
@@ -90,7 +120,7 @@ static void zclReportOnChangeIfNeeded(ZclAttribute_t *attr, ZCL_DataTypeDescript
       return;
 
     attr->properties |= ZCL_ON_CHANGE_REPORT;
-    zclStartReportTimer();
+    zclScheduleOnChangeReport(attr);
   }
 }
 
@@ -742,6 +772,19 @@ ZclAttribute_t * zclGetAttribute(Endpoint_t endpointId, ClusterId_t clusterId, u
   ZCL_Cluster_t *cluster;
   ZclAttribute_t *attr;
 
+#if ZCL_ATTRIBUTES_INDEX_SIZE > 0
+  for (uint16_t i = zclGetAttributesIndexHash(endpointId, clusterId, clusterSide, attributeId);
+       attributesIndex[i].attr; i = (i + 1U) & (ZCL_ATTRIBUTES_INDEX_SIZE - 1U))
+  {
+    ZclAttributesIndexEntry_t *entry = &attributesIndex[i];
+
+    if ((entry->attr->id == attributeId) && (entry->clusterId == clusterId) &&
+        (entry->endpointId == endpointId) && (entry->clusterSide == clusterSide))
+      return entry->attr;
+  }
+  // Not indexed: endpoint is registered bypassing ZCL, index is full or there is no such attribute
+#endif // ZCL_ATTRIBUTES_INDEX_SIZE > 0
+
   cluster = ZCL_GetCluster(endpointId, clusterId, clusterSide);
   if (!cluster)
     return NULL;
@@ -761,6 +804,98 @@ ZclAttribute_t * zclGetAttribute(Endpoint_t endpointId, ClusterId_t clusterId, u
   return NULL;
 }
 
+#if ZCL_ATTRIBUTES_INDEX_SIZE > 0
+/**************************************************************************//**
+\brief Adds attributes of the endpoint's clusters to the attribute lookup index
+
+\param[in] endpoint - registered endpoint
+******************************************************************************/
+void zclAddEndpointToAttributesIndex(ZCL_DeviceEndpoint_t *endpoint)
+{
+  zclAddClustersToAttributesIndex(endpoint, ZCL_CLUSTER_SIDE_SERVER);
+  zclAddClustersToAttributesIndex(endpoint, ZCL_CLUSTER_SIDE_CLIENT);
+}
+
+/**************************************************************************//**
+\brief Rebuilds the attribute lookup index from the registered endpoints
+******************************************************************************/
+void zclRebuildAttributesIndex(void)
+{
+  ZCL_DeviceEndpoint_t *endpoint = NULL;
+
+  memset(attributesIndex, 0, sizeof(attributesIndex));
+  attributesIndexUsed = 0U;
+
+  while (NULL != (endpoint = zclNextEndpoint(endpoint)))
+    zclAddEndpointToAttributesIndex(endpoint);
+}
+
+/**************************************************************************//**
+\brief Adds attributes of the endpoint's clusters of one side to the index
+
+\param[in] endpoint - registered endpoint
+\param[in] clusterSide - cluster side (client or server)
+******************************************************************************/
+static void zclAddClustersToAttributesIndex(ZCL_DeviceEndpoint_t *endpoint, uint8_t clusterSide)
+{
+  const Endpoint_t endpointId = endpoint->simpleDescriptor.endpoint;
+  uint8_t clusterCounter = (ZCL_CLUSTER_SIDE_CLIENT == clusterSide) ?
+    endpoint->simpleDescriptor.AppOutClustersCount : endpoint->simpleDescriptor.AppInClustersCount;
+  ZCL_Cluster_t *cluster = NULL;
+
+  if (clusterCounter)
+    cluster = ZCL_GetHeadCluster(endpoint, clusterSide);
+
+  while (cluster && clusterCounter--)
+  {
+    ZclAttribute_t *attr = (ZclAttribute_t *)cluster->attributes;
+
+    for (uint8_t i = attr ? cluster->attributesAmount : 0U; i; i--)
+    {
+      uint16_t pos;
+
+      // Remaining attributes are found by the descriptors walk
+      if (attributesIndexUsed >= ZCL_ATTRIBUTES_INDEX_SIZE * 3U / 4U)
+        return;
+
+      pos = zclGetAttributesIndexHash(endpointId, cluster->id, clusterSide, attr->id);
+      while (attributesIndex[pos].attr)
+        pos = (pos + 1U) & (ZCL_ATTRIBUTES_INDEX_SIZE - 1U);
+
+      attributesIndex[pos].attr = attr;
+      attributesIndex[pos].clusterId = cluster->id;
+      attributesIndex[pos].endpointId = endpointId;
+      attributesIndex[pos].clusterSide = clusterSide;
+      attributesIndexUsed++;
+
+      attr = jumpToNextAttribute(attr);
+    }
+
+    if (clusterCounter)
+      cluster = ZCL_GetNextCluster(cluster);
+  }
+}
+
+/**************************************************************************//**
+\brief Calculates the home position of an attribute in the lookup index
+
+\param[in] endpointId - endpoint unique identifier.
+\param[in] clusterId - cluster unique identifier.
+\param[in] clusterSide - cluster side (client or server).
+\param[in] attributeId - attribute unique identifier.
+\return position in the index
+******************************************************************************/
+static uint16_t zclGetAttributesIndexHash(Endpoint_t endpointId, ClusterId_t clusterId, uint8_t clusterSide,
+                                          ZCL_AttributeId_t attributeId)
+{
+  // Fibonacci hashing: top bits of the product are well mixed for sequential IDs
+  uint32_t key = ((uint32_t)clusterId << 16) | attributeId;
+
+  key ^= ((uint32_t)endpointId << 8) | clusterSide;
+  return (uint16_t)((key * 2654435769UL) >> 24) & (ZCL_ATTRIBUTES_INDEX_SIZE - 1U);
+}
+#endif // ZCL_ATTRIBUTES_INDEX_SIZE > 0
+
 /*************************************************************************//**
   \brief Finds next attribute descriptor.
 
@@ -30,6 +30,21 @@
  ******************************************************************************/
 typedef uint8_t ZclQuota_t;
 
+typedef struct
+{
+  ZclMmBufferDescriptor_t *descriptors;
+  ZclMmBufferDescriptor_t *freeDescriptors;
+  uint16_t frameSize;
+  uint8_t bufferAmount;
+  // Number of busy buffers and the maximum allowed for every buffer type
+  uint8_t typeAmount[ZCL_BUFFER_TYPE_LAST];
+  uint8_t typeQuota[ZCL_BUFFER_TYPE_LAST];
+#ifdef _ZCL_MEMORY_STATS_
+  // Index 0 (ZCL_UNKNOWN_BUFFER) accumulates all buffer types
+  ZclMmStats_t stats[ZCL_BUFFER_TYPE_LAST];
+#endif
+} ZclMmMem_t;
+
 /******************************************************************************
                                Definitions section
  ******************************************************************************/
@@ -52,14 +67,63 @@ quotas[ZCL_MAX_BUF_WITH_QUOTAS + 1U][ZCL_BUFFER_TYPE_LAST - 1U]) =
   {  2U,      3U,      2U,       2U    }, /* totalAmount == 5 */
 };
 
+/******************************************************************************
+                   Static variables section
+******************************************************************************/
+static ZclMmMem_t zclMmMem;
+
 /******************************************************************************
                    Implementation section
 ******************************************************************************/
-static bool checkBufferQuotas(ZclBufferType_t type, uint8_t typeAmount, uint8_t totalAmount);
+static uint8_t getBufferQuota(ZclBufferType_t type, uint8_t totalAmount);
 
 /******************************************************************************
                    Implementation section
 ******************************************************************************/
+/*************************************************************************//**
+\brief Puts all zcl memory buffers to the free list
+*****************************************************************************/
+void zclMmInit(void)
+{
+  uint8_t bufferSize;
+  uint8_t *frame = NULL;
+
+  CS_ReadParameter(CS_ZCL_MEMORY_BUFFERS_AMOUNT_ID, (void *)&zclMmMem.bufferAmount);
+  CS_ReadParameter(CS_ZCL_BUFFER_SIZE_ID, (void *)&bufferSize);
+  CS_GetMemory(CS_ZCL_BUFFER_DESCRIPTORS_ID, (void *)&zclMmMem.descriptors);
+  CS_GetMemory(CS_ZCL_BUFFERS_ID, (void *)&frame);
+  zclMmMem.frameSize = bufferSize + APS_AFFIX_LENGTH + 2U;
+  zclMmMem.freeDescriptors = NULL;
+
+  if (NULL == zclMmMem.descriptors)
+    return;
+
+  // Push in reverse order, so buffers are allocated from the first one
+  for (uint8_t i = zclMmMem.bufferAmount; i--;)
+  {
+    ZclMmBufferDescriptor_t *descriptor = &zclMmMem.descriptors[i];
+
+    descriptor->type = ZCL_UNKNOWN_BUFFER;
+    descriptor->link = NULL;
+    descriptor->timeout = 0;
+    descriptor->buf.frame = frame + i * zclMmMem.frameSize;
+    descriptor->nextFree = zclMmMem.freeDescriptors;
+    zclMmMem.freeDescriptors = descriptor;
+  }
+
+  zclMmMem.typeAmount[ZCL_UNKNOWN_BUFFER] = 0U;
+  zclMmMem.typeQuota[ZCL_UNKNOWN_BUFFER] = zclMmMem.bufferAmount;
+  for (uint8_t type = ZCL_UNKNOWN_BUFFER + 1U; type < ZCL_BUFFER_TYPE_LAST; type++)
+  {
+    zclMmMem.typeAmount[type] = 0U;
+    zclMmMem.typeQuota[type] = getBufferQuota((ZclBufferType_t)type, zclMmMem.bufferAmount);
+  }
+
+#ifdef _ZCL_MEMORY_STATS_
+  memset(zclMmMem.stats, 0U, sizeof(zclMmMem.stats));
+#endif
+}
+
 /*************************************************************************//**
 \brief Looks for and returns free zcl memory buffer
 
@@ -69,48 +133,52 @@ static bool checkBufferQuotas(ZclBufferType_t type, uint8_t typeAmount, uint8_t
 *****************************************************************************/
 ZclMmBuffer_t *zclMmGetMem(ZclBufferType_t type)
 {
-  uint8_t bufferAmount;
-  uint8_t bufferSize;
-  ZclMmBufferDescriptor_t *descriptor, *freeBuffer = NULL;
-  uint8_t *tmp = NULL;
-  uint8_t typeAmount = 0U;
+  ZclMmBufferDescriptor_t *freeBuffer;
 
-  CS_ReadParameter(CS_ZCL_MEMORY_BUFFERS_AMOUNT_ID, (void *)&bufferAmount);
-  CS_ReadParameter(CS_ZCL_BUFFER_SIZE_ID, (void *)&bufferSize);
-  CS_GetMemory(CS_ZCL_BUFFER_DESCRIPTORS_ID, (void *)&descriptor);
-  CS_GetMemory(CS_ZCL_BUFFERS_ID, (void *)&tmp);
-  if (NULL == descriptor)
+  // Pool is set up on ZCL reset, but may be used before it
+  if (NULL == zclMmMem.descriptors)
+    zclMmInit();
+  if (NULL == zclMmMem.descriptors)
   {
     SYS_E_ASSERT_ERROR(false, ZCL_THERE_ARE_NO_BUFFERS);
     return NULL;
   }
-  /* if descriptor is NULL, control breaks here */
 
-  // Look for free buffer
-  for (uint8_t i = 0U; i < bufferAmount; i++)
+  freeBuffer = zclMmMem.freeDescriptors;
+
+  if (NULL == freeBuffer)
   {
-    if (descriptor->type == type)
-      typeAmount++;
-    if (ZCL_UNKNOWN_BUFFER == descriptor->type)
-    {
-      freeBuffer = descriptor;
-      freeBuffer->buf.frame = tmp;
-    }
-    tmp += bufferSize + APS_AFFIX_LENGTH + 2U;
-    descriptor++;
+#ifdef _ZCL_MEMORY_STATS_
+    zclMmMem.stats[type].noFreeBuffer++;
+    zclMmMem.stats[ZCL_UNKNOWN_BUFFER].noFreeBuffer++;
+#endif
+    return NULL;
   }
 
-  if (freeBuffer && checkBufferQuotas(type, typeAmount, bufferAmount))
+  if (zclMmMem.typeAmount[type] >= zclMmMem.typeQuota[type])
   {
-    freeBuffer->type = type;
-    memset((void *)&(freeBuffer->buf.primitive), 0U, sizeof(freeBuffer->buf.primitive));
-    memset(freeBuffer->buf.frame, 0U, bufferSize + APS_AFFIX_LENGTH + 2U);
-    freeBuffer->buf.frame[0U] = TOP_GUARD_VALUE;
-    freeBuffer->buf.frame[bufferSize + APS_AFFIX_LENGTH + 1U] = BOTTOM_GUARD_VALUE;
-    return &freeBuffer->buf;
+#ifdef _ZCL_MEMORY_STATS_
+    zclMmMem.stats[type].quotaRejections++;
+    zclMmMem.stats[ZCL_UNKNOWN_BUFFER].quotaRejections++;
+#endif
+    return NULL;
   }
 
-  return NULL;
+  zclMmMem.freeDescriptors = freeBuffer->nextFree;
+  zclMmMem.typeAmount[type]++;
+  zclMmMem.typeAmount[ZCL_UNKNOWN_BUFFER]++;
+#ifdef _ZCL_MEMORY_STATS_
+  zclMmMem.stats[type].maxUsed = MAX(zclMmMem.stats[type].maxUsed, zclMmMem.typeAmount[type]);
+  zclMmMem.stats[ZCL_UNKNOWN_BUFFER].maxUsed = MAX(zclMmMem.stats[ZCL_UNKNOWN_BUFFER].maxUsed,
+                                                   zclMmMem.typeAmount[ZCL_UNKNOWN_BUFFER]);
+#endif
+
+  freeBuffer->type = type;
+  memset((void *)&(freeBuffer->buf.primitive), 0U, sizeof(freeBuffer->buf.primitive));
+  // Frame content is always written by the owner, only guards are restored
+  freeBuffer->buf.frame[0U] = TOP_GUARD_VALUE;
+  freeBuffer->buf.frame[zclMmMem.frameSize - 1U] = BOTTOM_GUARD_VALUE;
+  return &freeBuffer->buf;
 }
 
 /*************************************************************************//**
@@ -121,15 +189,24 @@ ZclMmBuffer_t *zclMmGetMem(ZclBufferType_t type)
 void zclMmFreeMem(ZclMmBuffer_t *mem)
 {
   ZclMmBufferDescriptor_t *descriptor = GET_STRUCT_BY_FIELD_POINTER(ZclMmBufferDescriptor_t, buf, mem);
-  uint8_t bufferSize;
 
-  CS_ReadParameter(CS_ZCL_BUFFER_SIZE_ID, (void *)&bufferSize);
   SYS_E_ASSERT_FATAL(((TOP_GUARD_VALUE == descriptor->buf.frame[0U]) &&
-    (BOTTOM_GUARD_VALUE == descriptor->buf.frame[bufferSize + APS_AFFIX_LENGTH + 1U])),
+    (BOTTOM_GUARD_VALUE == descriptor->buf.frame[zclMmMem.frameSize - 1U])),
     ZCL_MEMORY_CORRUPTION_0);
+  if (ZCL_UNKNOWN_BUFFER == descriptor->type)
+  {
+    // Buffer is in the free list already
+    SYS_E_ASSERT_WARN(false, ZCL_MEMORY_DOUBLE_FREE);
+    return;
+  }
+
+  zclMmMem.typeAmount[descriptor->type]--;
+  zclMmMem.typeAmount[ZCL_UNKNOWN_BUFFER]--;
   descriptor->link = NULL;
   descriptor->type = ZCL_UNKNOWN_BUFFER;
   descriptor->timeout = 0;
+  descriptor->nextFree = zclMmMem.freeDescriptors;
+  zclMmMem.freeDescriptors = descriptor;
 }
 
 /*************************************************************************//**
@@ -143,19 +220,19 @@ void zclMmFreeMem(ZclMmBuffer_t *mem)
 *****************************************************************************/
 ZclMmBufferDescriptor_t *zclMmGetNextOutputMemDescriptor(ZclMmBufferDescriptor_t *descr)
 {
-  uint8_t bufferAmount;
+  ZclMmBufferDescriptor_t *descriptor = zclMmMem.descriptors;
+  ZclMmBufferDescriptor_t *iter;
   bool bool_exp;
-  ZclMmBufferDescriptor_t *descriptor, *iter;
- 
-  CS_ReadParameter(CS_ZCL_MEMORY_BUFFERS_AMOUNT_ID, (void *)&bufferAmount);
-  CS_GetMemory(CS_ZCL_BUFFER_DESCRIPTORS_ID, (void *)&descriptor);
-  bool_exp = (((descr >= descriptor) && (descr < descriptor + bufferAmount)) || (NULL == descr));
+
+  bool_exp = (((descr >= descriptor) && (descr < descriptor + zclMmMem.bufferAmount)) || (NULL == descr));
   if (false == bool_exp)
   {
     SYS_E_ASSERT_ERROR(false,ZCLMEMORYMANAGER_ZCLMMGETNEXTBUSYDESCRIPTOR_0);
     return NULL;
   }
-  if ((descr < descriptor) && (descr >= descriptor + bufferAmount))
+
+  // Avoid the scan when there are no output requests at all
+  if (0U == zclMmMem.typeAmount[ZCL_OUTPUT_DATA_BUFFER])
     return NULL;
 
   if (descr)
@@ -163,7 +240,7 @@ ZclMmBufferDescriptor_t *zclMmGetNextOutputMemDescriptor(ZclMmBufferDescriptor_t
   else
     iter = descriptor;
 
-  while (iter < (descriptor + bufferAmount))
+  while (iter < (descriptor + zclMmMem.bufferAmount))
   {
     if (ZCL_OUTPUT_DATA_BUFFER == iter->type)
       return iter;
@@ -173,28 +250,67 @@ ZclMmBufferDescriptor_t *zclMmGetNextOutputMemDescriptor(ZclMmBufferDescriptor_t
   return NULL;
 }
 
+/*************************************************************************//**
+\brief Checks if memory belongs to zcl memory buffers
+
+\param[in] mem - pointer to memory
+
+\returns true if mem points to a zcl memory buffer, false otherwise
+*****************************************************************************/
+bool zclMmIsBuffer(const void *mem)
+{
+  return ((const void *)zclMmMem.descriptors <= mem) &&
+         (mem < (const void *)(zclMmMem.descriptors + zclMmMem.bufferAmount));
+}
+
+#ifdef _ZCL_MEMORY_STATS_
+/*************************************************************************//**
+\brief Gets usage statistics of zcl memory buffers
+
+\param[in] type - the type of buffers, ZCL_UNKNOWN_BUFFER for all buffers
+\param[out] stats - pointer to the statistics to be filled
+*****************************************************************************/
+void zclMmGetStats(ZclBufferType_t type, ZclMmStats_t *stats)
+{
+  *stats = zclMmMem.stats[type];
+  stats->used = zclMmMem.typeAmount[type];
+}
+
+/*************************************************************************//**
+\brief Resets high-water marks and rejection counters of zcl memory buffers
+*****************************************************************************/
+void zclMmResetStats(void)
+{
+  for (uint8_t type = ZCL_UNKNOWN_BUFFER; type < ZCL_BUFFER_TYPE_LAST; type++)
+  {
+    zclMmMem.stats[type].maxUsed = zclMmMem.typeAmount[type];
+    zclMmMem.stats[type].quotaRejections = 0U;
+    zclMmMem.stats[type].noFreeBuffer = 0U;
+  }
+}
+#endif // _ZCL_MEMORY_STATS_
+
 /**************************************************************************//**
-\brief Checks quotas for buffer with given type
+\brief Calculates the maximum number of buffers with given type
 
 \param[in] type - type of input packet;
-\param[in] typeAmount - current number of packet with given type;
 \param[in] totalAmount - maximum packet buffers
 
-\returns 'true' if quotas are not exceeded otherwise 'false'
+\returns the maximum number of busy buffers with given type
  ******************************************************************************/
-static bool checkBufferQuotas(ZclBufferType_t type, uint8_t typeAmount, uint8_t totalAmount)
+static uint8_t getBufferQuota(ZclBufferType_t type, uint8_t totalAmount)
 {
   ZclQuota_t quota;
 
   if (totalAmount <= ZCL_MAX_BUF_WITH_QUOTAS)
   {
     ZCL_READ_BUF_QUOTA(&quota, totalAmount, type);
-    return typeAmount < quota;
+    return quota;
   }
   else
   {
     ZCL_READ_BUF_QUOTA(&quota, 0U, type);
-    return typeAmount < ((quota * totalAmount) >> 2U);
+    return (quota * totalAmount) >> 2U;
   }
 }
 
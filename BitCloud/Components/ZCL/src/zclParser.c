@@ -38,6 +38,14 @@
 ******************************************************************************/
 #define ZCL_DEFAULT_RESPONSE_PAYLOAD_SIZE   2
 
+#if defined(ZAPPSI_HOST) && (ZCL_BORROWED_DATA_IND_AMOUNT > 0)
+  #define ZCL_BORROW_DATA_IND
+  // Borrowed frames are parsed in a burst, they don't wait for ZCL buffers
+  #define DATA_IND_BURST_SIZE ZCL_BORROWED_DATA_IND_AMOUNT
+#else
+  #define DATA_IND_BURST_SIZE 1U
+#endif
+
 //! Cluster Security Descriptor
 //! Defined the security type related to ClusterId
 /******************************************************************************
@@ -46,6 +54,11 @@
 typedef struct
 {
   uint8_t dataIndAmount;
+#ifdef ZCL_BORROW_DATA_IND
+  uint8_t borrowedDataIndAmount;
+#endif
+  uint8_t bufferAmount;
+  uint8_t bufferSize;
   QueueDescriptor_t dataIndQueue;
 } ZclParserMem_t;
 
@@ -54,6 +67,7 @@ typedef struct
 ******************************************************************************/
 static bool parseDataInd(APS_DataInd_t *ind);
 static void processDataInd(void);
+static void releaseDataInd(APS_DataInd_t *ind);
 static void zclParserDataConf(APS_DataConf_t *conf);
 static void sendDefaultResponse(ZclAuxParseData_t *auxData);
 static void sendRelevantResponse(ZclFrameDescriptor_t *dsc, ZclMmBuffer_t *buf, APS_DataInd_t *ind, uint8_t cmd);
@@ -107,6 +121,8 @@ void zclParserInit(void)
 {
   memset(&parserMem, 0, sizeof(parserMem));
   resetQueue(&parserMem.dataIndQueue);
+  CS_ReadParameter(CS_ZCL_MEMORY_BUFFERS_AMOUNT_ID, (void *)&parserMem.bufferAmount);
+  CS_ReadParameter(CS_ZCL_BUFFER_SIZE_ID, (void *)&parserMem.bufferSize);
 }
 
 /**************************************************************************//**
@@ -229,14 +245,25 @@ static void zclParserDataConf(APS_DataConf_t *conf)
 void zclDataInd(APS_DataInd_t *ind)
 {
   ZclMmBuffer_t *indBuffer;
-  uint8_t bufferAmount;
-  uint8_t bufferSize;
+  uint8_t copiedDataIndAmount = parserMem.dataIndAmount;
 
-  CS_ReadParameter(CS_ZCL_MEMORY_BUFFERS_AMOUNT_ID, (void *)&bufferAmount);
-  CS_ReadParameter(CS_ZCL_BUFFER_SIZE_ID, (void *)&bufferSize);
-  if ((bufferAmount - 1) > parserMem.dataIndAmount)
+#ifdef ZCL_BORROW_DATA_IND
+  if (parserMem.borrowedDataIndAmount < ZCL_BORROWED_DATA_IND_AMOUNT)
   {
-    if (ind->asduLength > bufferSize)
+    // Frame is parsed in place and released when processed
+    APS_KeepDataInd(ind);
+    putQueueElem(&parserMem.dataIndQueue, ind);
+    zclPostTask(ZCL_PARSER_TASK_ID);
+    parserMem.borrowedDataIndAmount++;
+    parserMem.dataIndAmount++;
+    return;
+  }
+  copiedDataIndAmount -= parserMem.borrowedDataIndAmount;
+#endif
+
+  if ((parserMem.bufferAmount - 1) > copiedDataIndAmount)
+  {
+    if (ind->asduLength > parserMem.bufferSize)
     {
       SYS_E_ASSERT_ERROR(false, ZCL_BUFFER_SIZE_IS_TOO_LOW);
       return;
@@ -1040,19 +1067,38 @@ static void sendDefaultResponse(ZclAuxParseData_t *auxData)
 ******************************************************************************/
 static void processDataInd(void)
 {
-  APS_DataInd_t *apsDataInd = getQueueElem(&parserMem.dataIndQueue);
+  for (uint8_t burst = DATA_IND_BURST_SIZE; burst; burst--)
+  {
+    APS_DataInd_t *apsDataInd = getQueueElem(&parserMem.dataIndQueue);
 
-  if (!apsDataInd)
-    return;
+    // Frame remains queued if it couldn't be processed now
+    if (!apsDataInd || !parseDataInd(apsDataInd))
+      return;
 
-  if (parseDataInd(apsDataInd))
-  {
     deleteHeadQueueElem(&parserMem.dataIndQueue);
-    zclMmFreeMem((ZclMmBuffer_t *)apsDataInd);
+    releaseDataInd(apsDataInd);
     parserMem.dataIndAmount--;
   }
 }
 
+/**************************************************************************//**
+\brief Frees memory of the processed data indication
+
+\param[in] ind - processed data indication
+******************************************************************************/
+static void releaseDataInd(APS_DataInd_t *ind)
+{
+#ifdef ZCL_BORROW_DATA_IND
+  if (!zclMmIsBuffer(ind))
+  {
+    APS_ReleaseDataInd(ind);
+    parserMem.borrowedDataIndAmount--;
+    return;
+  }
+#endif
+  zclMmFreeMem((ZclMmBuffer_t *)ind);
+}
+
 /*************************************************************************************//**
   \brief Incoming commands validation routine.
 
@@ -23,6 +23,7 @@ $Id: N_Timer-Internal.h 24615 2013-02-27 05:14:24Z arazinkov $
 * INCLUDE FILES
 ***************************************************************************************************/
 
+#include "N_Timer.h"
 #include "N_Types.h"
 
 /***************************************************************************************************
@@ -37,24 +38,34 @@ extern "C" {
 * EXPORTED FUNCTIONS
 ***************************************************************************************************/
 
-/** Update the running timers.
+/** Handle the expiration of a timer, which is already removed from the platform timers queue.
+    \param pTimer The expired timer.
 
     Implemented by the common code, called by the platform specific code.
 */
-void N_Timer_Internal_Update(void);
+void N_Timer_Internal_Expired(N_Timer_t* pTimer);
 
-/** Start a timer on the underlying platform.
-    \param timeoutMs The timer delay in milliseconds.
+/** Add a timer to the platform timers queue.
+    \param pTimer The timer to add, its start time and timeout are set. It is not running.
 
     Implemented by the platform specific code, called by the common code.
 */
-void N_Timer_Internal_SetTimer(int32_t timeoutMs);
+void N_Timer_Internal_Start(N_Timer_t* pTimer);
 
-/** Stop the platform timer on the bitcloud stack.
+/** Remove a running timer from the platform timers queue.
+    \param pTimer The timer to remove, queue.pLink is set to NULL.
 
-    Implemented by the common code, called by the platform specific code.
+    Implemented by the platform specific code, called by the common code.
+*/
+void N_Timer_Internal_Stop(N_Timer_t* pTimer);
+
+/** Find a running timer by its task and event.
+    \returns The timer or NULL if there is no such running timer.
+
+    Implemented by the platform specific code, called by the common code.
+    Only used if N_TIMER_ENABLE_EXPIRE is defined.
 */
-void N_Timer_Internal_Stop(void);
+N_Timer_t* N_Timer_Internal_Find(N_Task_Id_t task, N_Task_Event_t evt);
 
 /***************************************************************************************************
 * END OF C++ DECLARATION WRAPPER
@@ -42,8 +42,16 @@ typedef struct N_Timer_t N_Timer_t;
 
 struct N_Timer_t
 {
-    N_Timer_t* pNext;
-    uint32_t timestamp;
+    /** Platform timers queue fields, maintained by the platform specific code. */
+    struct
+    {
+        /** Link in the queue, NULL if the timer is not running. */
+        void* pLink;
+        /** The time the timer was started at. */
+        uint32_t startTime;
+    } queue;
+    /** The timer interval in milliseconds. */
+    uint32_t timeoutMs;
     N_Task_Id_t task;
     N_Task_Event_t evt;
 };
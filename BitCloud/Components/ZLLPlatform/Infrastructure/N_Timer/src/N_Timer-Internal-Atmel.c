@@ -30,37 +30,61 @@ $Id: N_Timer-Internal-Atmel.c 24615 2013-02-27 05:14:24Z arazinkov $
 ***************************************************************************************************/
 
 #include "N_Types.h"
+#include "N_Util.h"
 
 #include <appTimer.h>
+#include <stddef.h>
 
 /***************************************************************************************************
-* LOCAL VARIABLES
+* LOCAL FUNCTIONS
 ***************************************************************************************************/
 
-static HAL_AppTimer_t s_halTimer;
+/* N_Timer_t is started as a HAL event timer, which only accesses the leading fields of the
+   HAL_AppTimer_t: queue and timeoutMs take the place of service and interval. */
+
+static void TimerExpired(HAL_AppTimer_t* pAppTimer)
+{
+    N_Timer_Internal_Expired((N_Timer_t*) pAppTimer);
+}
+
+#if defined(N_TIMER_ENABLE_EXPIRE)
+static bool IsTimerOf(const HAL_AppTimer_t* pAppTimer, const void* pContext)
+{
+    const N_Timer_t* pTimer = (const N_Timer_t*) pAppTimer;
+    const N_Timer_t* pSearched = (const N_Timer_t*) pContext;
+
+    return (pTimer->task == pSearched->task) && (pTimer->evt == pSearched->evt);
+}
+#endif
 
 /***************************************************************************************************
 * EXPORTED FUNCTIONS
 ***************************************************************************************************/
 
-void N_Timer_Internal_SetTimer(int32_t timeoutMs)
+void N_Timer_Internal_Start(N_Timer_t* pTimer)
 {
-    // NOTE: this code is untested because the ZigBee Platform does not yet have a build that integrates the BitCloud.
-
-    // stopping the timer because it is unclear if it is possible
-    // to restart an already running timer.
-    (void) HAL_StopAppTimer(&s_halTimer);
-
-    if ( timeoutMs <= 0 )
-    {
-        s_halTimer.interval = 0u;
-    }
-    else
-    {
-        s_halTimer.interval = (uint32_t) timeoutMs;
-    }
-
-    (void) HAL_StartAppTimer(&s_halTimer);
+    (void) HAL_StartAppEventTimer((HAL_AppTimer_t*) pTimer);
+}
+
+void N_Timer_Internal_Stop(N_Timer_t* pTimer)
+{
+    (void) HAL_StopAppTimer((HAL_AppTimer_t*) pTimer);
+}
+
+N_Timer_t* N_Timer_Internal_Find(N_Task_Id_t task, N_Task_Event_t evt)
+{
+#if defined(N_TIMER_ENABLE_EXPIRE)
+    N_Timer_t searched;
+
+    searched.task = task;
+    searched.evt = evt;
+
+    return (N_Timer_t*) HAL_FindAppEventTimer(IsTimerOf, &searched);
+#else
+    (void)task;
+    (void)evt;
+    return NULL;
+#endif
 }
 
 uint32_t N_Timer_GetSystemTime_Impl(void)
@@ -70,13 +94,9 @@ uint32_t N_Timer_GetSystemTime_Impl(void)
 
 void N_Timer_Init(void)
 {
-    // NOTE: this code is untested because the ZigBee Platform does not yet have a build that integrates the BitCloud.
+    N_UTIL_COMPILE_ASSERT((offsetof(N_Timer_t, queue.pLink) == offsetof(HAL_AppTimer_t, service.next)) &&
+                          (offsetof(N_Timer_t, queue.startTime) == offsetof(HAL_AppTimer_t, service.sysTimeLabel)) &&
+                          (offsetof(N_Timer_t, timeoutMs) == offsetof(HAL_AppTimer_t, interval)));
 
-    s_halTimer.mode = TIMER_ONE_SHOT_MODE;
-    s_halTimer.callback = N_Timer_Internal_Update;
+    HAL_SetAppEventTimerHandler(TimerExpired);
 }
-
-void N_Timer_Internal_Stop(void)
-{
-    HAL_StopAppTimer(&s_halTimer);
-}
\ No newline at end of file
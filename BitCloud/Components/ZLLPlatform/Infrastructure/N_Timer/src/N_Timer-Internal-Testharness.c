@@ -50,12 +50,53 @@ $Id: N_Timer-Internal-Testharness.c 24615 2013-02-27 05:14:24Z arazinkov $
 
 static uint32_t s_systemTime = 0uL;
 
+/** Running timers in order of expiration, linked by queue.pLink. */
+static N_Timer_t* s_pTimerList;
+
+/** Terminates the list, so queue.pLink of a running timer is never NULL. */
+static N_Timer_t s_listEnd;
+
 static bool s_setTimerLoggingEnabled = FALSE;
 
 /***************************************************************************************************
 * LOCAL FUNCTIONS
 ***************************************************************************************************/
 
+static inline int32_t GetRemaining(N_Timer_t* pTimer, uint32_t now)
+{
+    return (int32_t) (pTimer->queue.startTime + pTimer->timeoutMs - now);
+}
+
+static inline N_Timer_t* GetNext(N_Timer_t* pTimer)
+{
+    return (pTimer->queue.pLink == &s_listEnd) ? NULL : (N_Timer_t*) pTimer->queue.pLink;
+}
+
+static void SetTimer(int32_t timeoutMs)
+{
+    if ( s_setTimerLoggingEnabled )
+    {
+        S_SerialComm_TxMessage(TXID, "SetTimer", "%ld", timeoutMs);
+    }
+}
+
+static void Update(void)
+{
+    while ( (s_pTimerList != NULL) && (GetRemaining(s_pTimerList, s_systemTime) <= 0) )
+    {
+        N_Timer_t* pTimer = s_pTimerList;
+
+        s_pTimerList = GetNext(pTimer);
+        pTimer->queue.pLink = NULL;
+        N_Timer_Internal_Expired(pTimer);
+    }
+
+    if ( s_pTimerList != NULL )
+    {
+        SetTimer(GetRemaining(s_pTimerList, s_systemTime));
+    }
+}
+
 static int8_t N_Timer_Internal_SerialCommCallback(const char* function, char* arguments)
 {
     int8_t result = RESULT_FAILURE;
@@ -70,7 +111,7 @@ static int8_t N_Timer_Internal_SerialCommCallback(const char* function, char* ar
         if ( !error )
         {
             s_systemTime += (uint32_t) elapsedMs;
-            N_Timer_Internal_Update();
+            Update();
             result = RESULT_SUCCESS;
         }
     }
@@ -92,12 +133,67 @@ static int8_t N_Timer_Internal_SerialCommCallback(const char* function, char* ar
 * EXPORTED FUNCTIONS
 ***************************************************************************************************/
 
-void N_Timer_Internal_SetTimer(int32_t timeoutMs)
+void N_Timer_Internal_Start(N_Timer_t* pTimer)
 {
-    if ( s_setTimerLoggingEnabled )
+    int32_t timeoutMs = GetRemaining(pTimer, s_systemTime);
+    N_Timer_t* pPrevious = NULL;
+    N_Timer_t* pIterator;
+
+    for ( pIterator = s_pTimerList; pIterator != NULL; pIterator = GetNext(pIterator) )
     {
-        S_SerialComm_TxMessage(TXID, "SetTimer", "%ld", timeoutMs);
+        if ( GetRemaining(pIterator, s_systemTime) > timeoutMs )
+        {
+            break;
+        }
+        pPrevious = pIterator;
+    }
+
+    pTimer->queue.pLink = (pIterator != NULL) ? pIterator : &s_listEnd;
+    if ( pPrevious == NULL )
+    {
+        s_pTimerList = pTimer;
+        SetTimer(timeoutMs);
+    }
+    else
+    {
+        pPrevious->queue.pLink = pTimer;
+    }
+}
+
+void N_Timer_Internal_Stop(N_Timer_t* pTimer)
+{
+    N_Timer_t* pPrevious = NULL;
+
+    for ( N_Timer_t* pIterator = s_pTimerList; pIterator != NULL; pIterator = GetNext(pIterator) )
+    {
+        if ( pIterator == pTimer )
+        {
+            if ( pPrevious == NULL )
+            {
+                s_pTimerList = GetNext(pTimer);
+            }
+            else
+            {
+                pPrevious->queue.pLink = pTimer->queue.pLink;
+            }
+            break;
+        }
+        pPrevious = pIterator;
+    }
+
+    pTimer->queue.pLink = NULL;
+}
+
+N_Timer_t* N_Timer_Internal_Find(N_Task_Id_t task, N_Task_Event_t evt)
+{
+    for ( N_Timer_t* pIterator = s_pTimerList; pIterator != NULL; pIterator = GetNext(pIterator) )
+    {
+        if ( (pIterator->task == task) && (pIterator->evt == evt) )
+        {
+            return pIterator;
+        }
     }
+    return NULL;
 }
 
 uint32_t N_Timer_GetSystemTime_Impl(void)
@@ -45,70 +45,32 @@ $Id: N_Timer.c 24615 2013-02-27 05:14:24Z arazinkov $
 
 #define EVENT_TIMER 0x0001u
 
-/***************************************************************************************************
-* LOCAL VARIABLES
-***************************************************************************************************/
-
-static N_Timer_t* s_pTimerList;
-
 /***************************************************************************************************
 * LOCAL FUNCTIONS
 ***************************************************************************************************/
 
-static inline int32_t GetRemaining(uint32_t timestamp, uint32_t now)
+static inline int32_t GetRemaining(N_Timer_t* pTimer, uint32_t now)
 {
-    return (int32_t) timestamp - (int32_t) now;
+    return (int32_t) (pTimer->queue.startTime + pTimer->timeoutMs - now);
 }
 
 static void StopTimer(N_Timer_t* pTimer)
 {
-    if ( s_pTimerList != NULL )
+    if ( pTimer->queue.pLink != NULL )
     {
-        if ( s_pTimerList == pTimer )
-        {
-            s_pTimerList = pTimer->pNext;
-        }
-        else
-        {
-            N_Timer_t* pPrevious = s_pTimerList;
-            for ( N_Timer_t* pIterator = s_pTimerList->pNext; pIterator != NULL; pIterator = pIterator->pNext )
-            {
-                if ( pTimer == pIterator )
-                {
-                    pPrevious->pNext = pIterator->pNext;
-                    break;
-                }
-                pPrevious = pIterator;
-            }
-        }
+        N_Timer_Internal_Stop(pTimer);
     }
 
     N_Task_ClearEvent(pTimer->task, pTimer->evt);
-
-    if ( s_pTimerList == NULL )
-    {
-         N_Timer_Internal_Stop();
-    }
 }
 
 /***************************************************************************************************
 * EXPORTED FUNCTIONS
 ***************************************************************************************************/
 
-void N_Timer_Internal_Update(void)
+void N_Timer_Internal_Expired(N_Timer_t* pTimer)
 {
-    uint32_t now = N_Timer_GetSystemTime();
-
-    while ( (s_pTimerList != NULL) && (GetRemaining(s_pTimerList->timestamp, now) <= 0) )
-    {
-        N_Task_SetEvent(s_pTimerList->task, s_pTimerList->evt);
-        s_pTimerList = s_pTimerList->pNext;
-    }
-
-    if (s_pTimerList != NULL)
-    {
-        N_Timer_Internal_SetTimer(GetRemaining(s_pTimerList->timestamp, now));
-    }
+    N_Task_SetEvent(pTimer->task, pTimer->evt);
 }
 
 /** Interface function, see \ref N_Timer_Start32. */
@@ -121,29 +83,20 @@ void N_Timer_Start32_Impl(int32_t timeoutMs, N_Timer_t* pTimer)
     StopTimer(pTimer);
 
     uint32_t now = N_Timer_GetSystemTime();
-    pTimer->timestamp = now + (uint32_t) timeoutMs;
-
-    N_Timer_t* pPrevious = NULL;
-    N_Timer_t* pIterator;
-    for ( pIterator = s_pTimerList; pIterator != NULL; pIterator = pIterator->pNext )
-    {
-        if ( GetRemaining(pIterator->timestamp, now) > timeoutMs )
-        {
-            break;
-        }
-        pPrevious = pIterator;
-    }
 
-    pTimer->pNext = pIterator;
-    if ( pPrevious == NULL )
+    if ( timeoutMs < 0 )
     {
-        s_pTimerList = pTimer;
-        N_Timer_Internal_SetTimer(timeoutMs);
+        // a negative delay expires immediately: treat the timer as started in the past
+        pTimer->queue.startTime = now + (uint32_t) timeoutMs;
+        pTimer->timeoutMs = 0u;
     }
     else
     {
-        pPrevious->pNext = pTimer;
+        pTimer->queue.startTime = now;
+        pTimer->timeoutMs = (uint32_t) timeoutMs;
     }
+
+    N_Timer_Internal_Start(pTimer);
 }
 
 /** Interface function, see \ref N_Timer_Start16. */
@@ -167,48 +120,19 @@ bool N_Timer_IsRunning_Impl(N_Timer_t* pTimer)
 #if defined(N_TIMER_ENABLE_LOGGING)
     S_SerialComm_TxMessage(COMPID, "IsRunning", "%hu,%hu", pTimer->task, pTimer->evt);
 #endif
-    for ( N_Timer_t* pIterator = s_pTimerList; pIterator != NULL; pIterator = pIterator->pNext )
-    {
-        if ( pTimer == pIterator )
-        {
-            return TRUE;
-        }
-    }
-    return FALSE;
+    return (pTimer->queue.pLink != NULL) ? TRUE : FALSE;
 }
 
 /** Interface function, see \ref N_Timer_GetRemaining. */
 int32_t N_Timer_GetRemaining_Impl(N_Timer_t* pTimer)
 {
-    return GetRemaining(pTimer->timestamp, N_Timer_GetSystemTime());
+    return GetRemaining(pTimer, N_Timer_GetSystemTime());
 }
 
 bool N_Timer_Expire(N_Task_Id_t task, N_Task_Event_t evt)
 {
 #if defined(N_TIMER_ENABLE_EXPIRE)
-    N_Timer_t* pTimer = NULL;
-
-    if ( s_pTimerList != NULL )
-    {
-        if ( (s_pTimerList->task == task) && (s_pTimerList->evt == evt) )
-        {
-            pTimer = s_pTimerList;
-            s_pTimerList = pTimer->pNext;
-        }
-        else
-        {
-            N_Timer_t* pPrevious = s_pTimerList;
-            for ( pTimer = s_pTimerList->pNext; pTimer != NULL; pTimer = pTimer->pNext )
-            {
-                if ( (pTimer->task == task) && (pTimer->evt == evt) )
-                {
-                    pPrevious->pNext = pTimer->pNext;
-                    break;
-                }
-                pPrevious = pTimer;
-            }
-        }
-    }
+    N_Timer_t* pTimer = N_Timer_Internal_Find(task, evt);
 
     if ( pTimer != NULL )
     {
@@ -216,6 +140,7 @@ bool N_Timer_Expire(N_Task_Id_t task, N_Task_Event_t evt)
         S_SerialComm_TxMessage(COMPID, "Expire", "%hu,%hu", pTimer->task, pTimer->evt);
     #endif
 
+        N_Timer_Internal_Stop(pTimer);
         N_Task_SetEvent(pTimer->task, pTimer->evt);
         return TRUE;
     }
@@ -186,6 +186,16 @@ bool S_Nv_IsItemAvailable(S_Nv_ItemId_t id);
 */
 void S_Nv_SetPowerSupplyCheckingFunction(S_Nv_PowerSupplyCheckingFunction_t pf);
 
+/** Returns the longest time spent in one step of the last compact sector operation.
+
+    \param pBytes Returns the number of bytes copied in the longest step. Can be NULL.
+    \returns The time in milliseconds.
+
+    A compact sector operation copies the items to the next sector in steps, bounded by
+    S_NV_COMPACT_STEP_BYTES, while the items stay accessible in the active sector.
+*/
+uint32_t S_Nv_MaxCompactStepTime(uint16_t* pBytes);
+
 /***************************************************************************************************
 * END OF C++ DECLARATION WRAPPER
 ***************************************************************************************************/
@@ -8,6 +8,7 @@
 #define S_Nv_Delete S_Nv_Delete_Impl
 #define S_Nv_SetPowerSupplyCheckingFunction S_Nv_SetPowerSupplyCheckingFunction_Impl
 #define S_Nv_IsItemAvailable S_Nv_IsItemAvailable_Impl
+#define S_Nv_MaxCompactStepTime S_Nv_MaxCompactStepTime_Impl
 
 // used interfaces
 #if defined(TESTHARNESS)
@@ -40,6 +40,7 @@
 #include "N_Types.h"
 #include "wlPdsMemIds.h"
 #include <sysTimer.h>
+#include <string.h>
 
 //#include "S_Nv_Platform_Ids.h" // layering violation!
 
@@ -78,8 +79,26 @@
 /** Perform a compact item operation if the number of partial writes is larger than this. */
 #define COMPACT_ITEM_THRESHOLD 100u
 
-/** Perform a compact sector operation with a delay if the sector has less free space than this. */
-#define PREEMPTIVE_COMPACT_SECTOR_THRESHOLD  (MAX_ITEM_LENGTH + BLOCK_HEADER_SIZE)
+/** Start a compact sector operation with a delay if the sector has less free space than
+    \ref GetPreemptiveCompactThreshold. The threshold leaves room for writes while the items are
+    copied in steps, but never exceeds a quarter of the free space the operation regains, so a sector
+    holding much live data is not compacted over and over. It is never below the minimum. */
+#define PREEMPTIVE_COMPACT_SECTOR_THRESHOLD      (4u * (MAX_ITEM_LENGTH + BLOCK_HEADER_SIZE))
+#define PREEMPTIVE_COMPACT_SECTOR_MIN_THRESHOLD  (MAX_ITEM_LENGTH + BLOCK_HEADER_SIZE)
+
+/** The number of bytes after which a step of the compact sector operation ends. This bounds
+    the time the task is blocked by a step. At least one item is copied per step. */
+#if !defined(S_NV_COMPACT_STEP_BYTES)
+#define S_NV_COMPACT_STEP_BYTES 256u
+#endif
+
+/** Delay between the steps of a compact sector operation. */
+#if !defined(S_NV_COMPACT_STEP_INTERVAL_MS)
+#define S_NV_COMPACT_STEP_INTERVAL_MS 10u
+#endif
+
+/** Value of \ref s_compactSector when no compact sector operation is running. */
+#define NO_COMPACT_SECTOR 0xFFu
 
 #define SECTOR_SIZE   D_NV_SECTOR_SIZE
 #define FIRST_SECTOR  D_NV_FIRST_SECTOR
@@ -145,6 +164,12 @@ typedef struct Item_t
     uint16_t id;
     /** Pointer to the last written block for this item. */
     uint16_t lastBlock;
+    /** Length of the complete item. */
+    uint16_t itemLength : 15;
+    /** Whether \ref lastBlock holds the complete item, so reads need not walk the blocks. */
+    uint16_t isLastBlockFull : 1;
+    /** Pointer to the copy in the destination sector of the compact sector operation, 0x0000u if not copied. */
+    uint16_t compactBlock;
 } Item_t;
 
 // back to the default packing
@@ -168,6 +193,7 @@ static uint16_t s_sectorHead;
 
 /** The number of read, and thus cached, items */
 static uint8_t s_itemCount = 0u;
+/** Cached items, sorted by id. */
 static Item_t s_itemCache[MAX_ITEM_COUNT];
 
 /** The sector to erase in the EVENT_ERASE_SECTOR handler. */
@@ -177,12 +203,25 @@ static uint8_t s_sectorToErase = 0xFFu;
 static uint16_t s_compactItemId = 0x0000u;
 static uint16_t s_compactItemLength = 0x0000u;
 
+/** The destination sector of the running compact sector operation and the location of its first
+    unprogrammed byte. */
+static uint8_t s_compactSector = NO_COMPACT_SECTOR;
+static uint16_t s_compactSectorHead;
+/** Whether the destination sector holds copies that were changed again, or deleted. */
+static bool s_compactSectorHasStaleCopies = FALSE;
+
+/** Statistics of the compact sector operation. */
+static uint16_t s_compactSteps = 0u;
+static uint32_t s_maxCompactStepTime = 0uL;
+static uint16_t s_maxCompactStepBytes = 0u;
+
 /** Callback function called before changing flash contents. */
 static S_Nv_PowerSupplyCheckingFunction_t s_powerSupplyCheckingFunction = NULL;
 
 static HAL_AppTimer_t eraseSectorTimer;
 static SYS_Timer_t compactSectorTimer;
 static SYS_Timer_t compactItemTimer;
+static SYS_Timer_t compactStepTimer;
 
 /** Check if the early init function is called already. */
 static bool s_earlyInitDone = FALSE;
@@ -193,7 +232,10 @@ static bool s_earlyInitDone = FALSE;
 static void eraseSectorTimerFired(void);
 static void compactSectorTimerFired(void);
 static void compactItemTimerFired(void);
+static void compactStepTimerFired(void);
 static bool PowerSupplyTooLow(void);
+static bool StartCompactSector(void);
+static bool CompactSectorStep(uint16_t maxBytes);
 static bool CompactSector(void);
 static S_Nv_ReturnValue_t CompactItem(void);
 
@@ -213,8 +255,26 @@ static void eraseSectorTimerFired(void)
 static void compactSectorTimerFired(void)
 {
     if (!PowerSupplyTooLow())
-        if (!CompactSector())
+    {
+        if (!StartCompactSector())
             N_ERRH_FATAL();
+        SYS_InitTimer(&compactStepTimer, TIMER_ONE_SHOT_MODE, S_NV_COMPACT_STEP_INTERVAL_MS, compactStepTimerFired);
+    }
+}
+
+/** Compact sector step timer callback.
+*/
+static void compactStepTimerFired(void)
+{
+    if (s_compactSector == NO_COMPACT_SECTOR)
+        return;
+
+    if (!PowerSupplyTooLow())
+        if (!CompactSectorStep(S_NV_COMPACT_STEP_BYTES))
+            N_ERRH_FATAL();
+
+    if (s_compactSector != NO_COMPACT_SECTOR)
+        SYS_InitTimer(&compactStepTimer, TIMER_ONE_SHOT_MODE, S_NV_COMPACT_STEP_INTERVAL_MS, compactStepTimerFired);
 }
 
 /** Compact item timer callback.
@@ -277,20 +337,46 @@ static void UpdateSectorHead(uint16_t increment)
     s_sectorHead = (s_sectorHead + increment + 0x000Fu) & 0xFFF0u;
 }
 
+/** Binary search of the item in the cache.
+    \param id The id to find
+    \param pIndex Returns the index of the item, or the index to insert the item at
+    \returns TRUE if the item was found, FALSE otherwise
+*/
+static bool FindItemIndex(uint16_t id, uint8_t* pIndex)
+{
+    uint8_t low = 0u;
+    uint8_t high = s_itemCount;
+
+    while ( low < high )
+    {
+        uint8_t middle = (uint8_t) ((low + high) / 2u);
+        if ( s_itemCache[middle].id < id )
+        {
+            low = middle + 1u;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    *pIndex = low;
+    return (low < s_itemCount) && (s_itemCache[low].id == id);
+}
+
 /** Return a pointer to the cache for the item.
     \param id The id to find
     \returns A pointer to the cache for the ID, or NULL if it was not found
 */
 static Item_t *FindItemCache(uint16_t id)
 {
-    for ( uint8_t cacheIndex = 0u; cacheIndex < s_itemCount; cacheIndex++ )
+    uint8_t cacheIndex;
+
+    if ( FindItemIndex(id, &cacheIndex) )
     {
         Item_t *cache = &s_itemCache[cacheIndex];
-        if ( cache->id == id )
-        {
-            N_ERRH_ASSERT_FATAL(cache->lastBlock != 0x0000);
-            return cache;
-        }
+        N_ERRH_ASSERT_FATAL(cache->lastBlock != 0x0000);
+        return cache;
     }
     return NULL;
 }
@@ -301,11 +387,18 @@ static Item_t *FindItemCache(uint16_t id)
 */
 static Item_t *CreateItemCache(uint16_t id)
 {
-    N_ERRH_ASSERT_FATAL(FindItemCache(id) == NULL);
+    uint8_t cacheIndex;
+
+    N_ERRH_ASSERT_FATAL(!FindItemIndex(id, &cacheIndex));
     N_ERRH_ASSERT_FATAL(s_itemCount < MAX_ITEM_COUNT);
 
-    Item_t *cache = &s_itemCache[s_itemCount++];
+    // keep the cache sorted
+    Item_t *cache = &s_itemCache[cacheIndex];
+    memmove(cache + 1, cache, (s_itemCount - cacheIndex) * sizeof(Item_t));
+    s_itemCount++;
     cache->id = id;
+    cache->isLastBlockFull = 0u;
+    cache->compactBlock = 0x0000u;
 
     return cache;
 }
@@ -315,11 +408,53 @@ static Item_t *CreateItemCache(uint16_t id)
 */
 static void DeleteItemCache(uint16_t id)
 {
-    N_ERRH_ASSERT_FATAL(FindItemCache(id) != NULL);
+    uint8_t cacheIndex;
 
-    // Overwrite specified item cache with the last one
-    Item_t *cache = FindItemCache(id);
-    *cache = s_itemCache[--s_itemCount];
+    N_ERRH_ASSERT_FATAL(FindItemIndex(id, &cacheIndex));
+
+    if ( s_itemCache[cacheIndex].compactBlock != 0x0000u )
+    {
+        s_compactSectorHasStaleCopies = TRUE;
+    }
+
+    s_itemCount--;
+    memmove(&s_itemCache[cacheIndex], &s_itemCache[cacheIndex + 1u], (s_itemCount - cacheIndex) * sizeof(Item_t));
+}
+
+/** Marks the item as changed since it was copied by the compact sector operation.
+    \param cache The cache of the item
+*/
+static void InvalidateCompactBlock(Item_t* cache)
+{
+    if ( cache->compactBlock != 0x0000u )
+    {
+        cache->compactBlock = 0x0000u;
+        s_compactSectorHasStaleCopies = TRUE;
+    }
+}
+
+/** Updates the cache after a block holding the complete item was written.
+    \param cache The cache of the item
+    \param blockPointer Pointer to the block
+    \param itemLength Length of the item
+*/
+static void SetFullBlock(Item_t* cache, uint16_t blockPointer, uint16_t itemLength)
+{
+    cache->lastBlock = blockPointer;
+    cache->itemLength = itemLength;
+    cache->isLastBlockFull = 1u;
+    InvalidateCompactBlock(cache);
+}
+
+/** Updates the cache after a block holding a part of the item was written.
+    \param cache The cache of the item
+    \param blockPointer Pointer to the block
+*/
+static void SetPartialBlock(Item_t* cache, uint16_t blockPointer)
+{
+    cache->lastBlock = blockPointer;
+    cache->isLastBlockFull = 0u;
+    InvalidateCompactBlock(cache);
 }
 
 /** Return a pointer to the last written block for the item.
@@ -442,9 +577,45 @@ static bool WriteDataBlock(BlockHeader_t* pBlockHeader, uint8_t* pData)
     return TRUE;
 }
 
+/** Copy a range of bytes of a block for a read or compact operation.
+    \param sourceSector The sector holding the block
+    \param sourcePointer Pointer to the first byte to copy
+    \param position Position of the bytes in the range requested from \ref GatherData
+    \param count The number of bytes to copy
+    \param pData Pointer to destination buffer in RAM for a read operation. NULL for a compact operation.
+*/
+static bool CopyData(uint8_t sourceSector, uint16_t sourcePointer, uint16_t position, uint16_t count, uint8_t* pData)
+{
+    if ( pData != NULL )
+    {
+        // this is for a read operation, so copy to buffer in RAM
+        D_Nv_Read(sourceSector, sourcePointer, pData + position, count);
+        return TRUE;
+    }
+
+    // this is for a compact operation, so copy to the destination sector in flash
+    uint16_t destinationPointer = s_sectorHead + position;
+    while ( count > 0u )
+    {
+        uint8_t buffer[16];
+        uint16_t c = (count > sizeof(buffer)) ? (uint16_t) sizeof(buffer) : count;
+
+        D_Nv_Read(sourceSector, sourcePointer, buffer, c);
+        if ( !WriteAndCheck(destinationPointer, buffer, c) )
+        {
+            return FALSE;
+        }
+        sourcePointer += c;
+        destinationPointer += c;
+        count -= c;
+    }
+
+    return TRUE;
+}
+
 /** Gather data from an item for a read or compact operation.
     \param sourceSector
-    \param lastBlockPointer Pointer to the last block written for the item
+    \param pItem The cache of the item
     \param offset The start of the range of bytes to copy from the item
     \param length The size of the range of bytes to copy from the item
     \param pData Pointer to destination buffer in RAM for a read operation. NULL for a compact operation.
@@ -454,22 +625,25 @@ static bool WriteDataBlock(BlockHeader_t* pBlockHeader, uint8_t* pData)
      - For a compact operation, pBuffer parameter is NULL and the data will
        be copied to the flash memory \ref s_sectorHead in sector \ref s_sector.
 
+    If the last written block holds the complete item, the data is copied from that
+    block at once. Otherwise the blocks are walked from the last written one back.
 */
-static bool GatherData(uint8_t sourceSector, uint16_t lastBlockPointer, uint16_t offset, uint16_t length, void* pData)
+static bool GatherData(uint8_t sourceSector, const Item_t* pItem, uint16_t offset, uint16_t length, void* pData)
 {
-    // pointer to end of destination in RAM
-    uint8_t* pDestination = NULL;
-    // pointer to end of destination in flash
-    uint16_t destinationPointer = 0u;
-
-    // prepare the correct pointer
-    if ( pData != NULL )
+    if ( length == 0u )
     {
-        pDestination = (uint8_t*) pData + length;
+        return TRUE;
     }
-    else
+    if ( (offset + length) > pItem->itemLength )
     {
-        destinationPointer = s_sectorHead + length;
+        // read beyond the item length
+        return FALSE;
+    }
+
+    if ( pItem->isLastBlockFull )
+    {
+        // the item was not written partially since its last complete write
+        return CopyData(sourceSector, pItem->lastBlock + BLOCK_HEADER_SIZE + offset, 0u, length, (uint8_t*) pData);
     }
 
     BlockHeader_t blockHeader;
@@ -478,7 +652,7 @@ static bool GatherData(uint8_t sourceSector, uint16_t lastBlockPointer, uint16_t
     uint16_t count;
 
     // start with the last written block
-    uint16_t currentBlockPointer = lastBlockPointer;
+    uint16_t currentBlockPointer = pItem->lastBlock;
 
     // [readStart, readEnd> is the range of data that can be read during the current
     // pass over the blocks (the range includes readStart, but not readEnd).
@@ -494,8 +668,7 @@ static bool GatherData(uint8_t sourceSector, uint16_t lastBlockPointer, uint16_t
         {
             if ( currentBlockPointer == 0x0000u )
             {
-                // reached first block without finding the data.
-                // either the flash is corrupt, or this is a read beyond the item length
+                // reached first block without finding the data: the flash is corrupt
                 return FALSE;
             }
 
@@ -531,10 +704,8 @@ static bool GatherData(uint8_t sourceSector, uint16_t lastBlockPointer, uint16_t
 
         // ...read all data that we can from this block
 
-        // pointer to the last byte that we want to read
-        uint16_t sourcePointer = (currentBlockPointer + BLOCK_HEADER_SIZE) + (readEnd - blockStart);
-
         // check how many of the bytes that we want are in this block
+        uint16_t sourceBlockPointer = currentBlockPointer;
         if ( readStart < blockStart )
         {
             // the block does not contain all data we want to read this pass
@@ -549,45 +720,16 @@ static bool GatherData(uint8_t sourceSector, uint16_t lastBlockPointer, uint16_t
             count = readEnd - readStart;
 
             // start with a new pass after reading this block (unless we have all requested data)
-            currentBlockPointer = lastBlockPointer;
+            currentBlockPointer = pItem->lastBlock;
             readStart = offset;
         }
         readEnd -= count;
 
-        // read the data that we want from the source sector
-        if ( pDestination != NULL )
-        {
-            // this is for a read operation, so copy to buffer in RAM
-            sourcePointer -= count;
-            pDestination -= count;
-            D_Nv_Read(s_sector, sourcePointer, pDestination, count);
-        }
-        else
+        // copy the bytes [readEnd, readEnd + count> of the item from this block
+        if ( !CopyData(sourceSector, sourceBlockPointer + BLOCK_HEADER_SIZE + (readEnd - blockStart),
+                       readEnd - offset, count, (uint8_t*) pData) )
         {
-            // this is for a compact operation, so copy to the destination sector in flash
-            while ( count > 0u )
-            {
-                uint8_t buffer[16];
-                uint16_t c;
-                if ( count > sizeof(buffer) )
-                {
-                    c = sizeof(buffer);
-                    count -= (uint16_t) sizeof(buffer);
-                }
-                else
-                {
-                    c = count;
-                    count = 0u;
-                }
-
-                destinationPointer -= c;
-                sourcePointer -= c;
-                D_Nv_Read(sourceSector, sourcePointer, buffer, c);
-                if ( !WriteAndCheck(destinationPointer, buffer, c) )
-                {
-                    return FALSE;
-                }
-            }
+            return FALSE;
         }
     }
 
@@ -628,6 +770,21 @@ static bool InitSector(uint32_t sequenceNumber)
     return TRUE;
 }
 
+/** Check the signature and the sequence number parity of a sector header.
+    \param pSectorHeader The sector header
+    \returns TRUE if the header is valid, FALSE otherwise
+*/
+static bool IsValidSectorHeader(const SectorHeader_t* pSectorHeader)
+{
+    return (pSectorHeader->signature[0] == (uint8_t) 'A') &&
+           (pSectorHeader->signature[1] == (uint8_t) 'T') &&
+           (pSectorHeader->signature[2] == (uint8_t) 'S') &&
+           (pSectorHeader->signature[3] == (uint8_t) 'N') &&
+           (pSectorHeader->signature[4] == (uint8_t) 'v') &&
+           (pSectorHeader->signature[5] == (uint8_t) '1') &&
+           ((pSectorHeader->sequenceNumber ^ pSectorHeader->sequenceParity) == 0xFFFFFFFFuL);
+}
+
 static bool ActivateSector(void)
 {
     // activate sector header
@@ -679,7 +836,15 @@ static void LoadSector(void)
                 cache = CreateItemCache(id);
             }
 
-            cache->lastBlock = s_sectorHead;
+            if ( (blockHeader.blockOffset == 0u) && (blockHeader.blockLength == blockHeader.itemLength) )
+            {
+                SetFullBlock(cache, s_sectorHead, blockHeader.itemLength);
+            }
+            else
+            {
+                cache->itemLength = blockHeader.itemLength;
+                SetPartialBlock(cache, s_sectorHead);
+            }
 
             // If item length is zero, the item had been deleted -- remove the cache
             if ( blockHeader.itemLength == 0u )
@@ -692,12 +857,57 @@ static void LoadSector(void)
     }
 }
 
-/* Important: if CompactSector fails, the only fix is to reinitialize!
- * This is because the itemCache, sector head and sector selector will
- * be messed up.
- */
-static bool CompactSector(void)
+/** Swaps the active sector with the destination sector of the running compact sector
+    operation, so the block functions write to the destination sector. Called again to
+    swap back.
+*/
+static void SwapCompactSector(void)
+{
+    uint8_t sector = s_sector;
+    uint16_t sectorHead = s_sectorHead;
+
+    s_sector = s_compactSector;
+    s_sectorHead = s_compactSectorHead;
+    s_compactSector = sector;
+    s_compactSectorHead = sectorHead;
+}
+
+/** Writes an active block with zero length, which marks the item as deleted.
+    \param id The id of the item
+*/
+static bool WriteDeleteBlock(uint16_t id)
 {
+    BlockHeader_t blockHeader;
+
+    blockHeader.id = id;
+    blockHeader.blockOffset = 0x0000u;
+    blockHeader.blockLength = 0;
+    blockHeader.itemLength = 0u;
+    blockHeader.previousBlock = 0x0000u;
+    blockHeader.writeCount = 0u;
+
+    uint16_t blockPointer = s_sectorHead;
+
+    if ( !WriteBlockHeader(&blockHeader) )
+    {
+        return FALSE;
+    }
+
+    return ActivateBlock(blockPointer);
+}
+
+/** Starts a compact sector operation: prepares the next sector as the destination.
+    The items are copied by \ref CompactSectorStep, the active sector stays in use
+    until all items are copied.
+*/
+static bool StartCompactSector(void)
+{
+    if ( s_compactSector != NO_COMPACT_SECTOR )
+    {
+        // already running
+        return TRUE;
+    }
+
 #if defined(ENABLE_NV_COMPACT_LOGGING)
     N_LOG_ALWAYS(("CompactSector(s=%hu)", s_sector));
 #endif
@@ -709,6 +919,7 @@ static bool CompactSector(void)
     s_compactItemLength = 0u;
 
     uint8_t sourceSector = s_sector;
+    uint16_t sourceSectorHead = s_sectorHead;
 
     // get the sector header for the source sector
     SectorHeader_t sectorHeader;
@@ -730,58 +941,300 @@ static bool CompactSector(void)
             // all sector failed to initialize
             N_ERRH_FATAL();
         }
+
+        if ( s_sector == s_sectorToErase )
+        {
+            // the sector is erased by InitSector if needed, the scheduled erase must not hit it later
+            HAL_StopAppTimer(&eraseSectorTimer);
+        }
     }
     while ( !InitSector(nextSequenceNumber) );
 
-    // Traverse the item cache, writing all items to the new sector
-    for (uint8_t cacheIndex = 0; cacheIndex < s_itemCount; cacheIndex++) {
+    // continue to use the source sector until the compact operation is done
+    s_compactSector = sourceSector;
+    s_compactSectorHead = sourceSectorHead;
+    SwapCompactSector();
+
+    for ( uint8_t cacheIndex = 0u; cacheIndex < s_itemCount; cacheIndex++ )
+    {
+        s_itemCache[cacheIndex].compactBlock = 0x0000u;
+    }
+
+    s_compactSectorHasStaleCopies = FALSE;
+    s_compactSteps = 0u;
+    s_maxCompactStepTime = 0u;
+    s_maxCompactStepBytes = 0u;
+
+    return TRUE;
+}
+
+/** Stops the compact sector operation. The destination sector is left inactive. */
+static void AbortCompactSector(void)
+{
+    SYS_StopTimer(&compactStepTimer);
+    s_compactSector = NO_COMPACT_SECTOR;
+}
+
+/** Completes the compact sector operation: activates the destination sector and
+    switches all items to the copies.
+*/
+static bool FinishCompactSector(void)
+{
+    uint8_t sourceSector = s_sector;
+
+    SwapCompactSector();
+
+    // All items moved, so now we just need to activate the sector
+    if ( !ActivateSector() )
+    {
+        return FALSE;
+    }
+
+    for ( uint8_t cacheIndex = 0u; cacheIndex < s_itemCount; cacheIndex++ )
+    {
         Item_t *cache = &s_itemCache[cacheIndex];
+        SetFullBlock(cache, cache->compactBlock, cache->itemLength);
+    }
 
-        // Start by reading out header of last block
-        BlockHeader_t blockHeader;
-        D_Nv_Read(sourceSector, cache->lastBlock, (uint8_t*) &blockHeader, BLOCK_HEADER_SIZE);
+    AbortCompactSector();
 
-        // Construct header for a single block with contiguous data
-        blockHeader.blockOffset = 0x0000u;
-        blockHeader.blockLength = blockHeader.itemLength;
-        blockHeader.previousBlock = 0x0000u;
-        blockHeader.writeCount = 0u;
+#if defined(ENABLE_NV_COMPACT_LOGGING)
+    N_LOG_ALWAYS(("CompactSector done (s=%hu, steps=%hu, max step %lu ms/%u bytes)",
+        s_sector, s_compactSteps, s_maxCompactStepTime, s_maxCompactStepBytes));
+#endif
 
-        uint16_t blockPointer = s_sectorHead;
+    // schedule an erase of the source sector,Restart the timer if it is already running.
+    s_sectorToErase = sourceSector;
+    HAL_StopAppTimer(&eraseSectorTimer);
+    HAL_StartAppTimer(&eraseSectorTimer);
 
-        // Now write the data block header, move its data and activate
-        if ( !WriteBlockHeader(&blockHeader) )
+    return TRUE;
+}
+
+/** Copies the complete item to the destination sector of the compact sector operation.
+    The previousBlock field of the copy refers to the block in the source sector it was
+    made from, so a copy made before a reset can be checked when the operation is resumed.
+    \param cache The cache of the item
+*/
+static bool CopyItemToCompactSector(Item_t* cache)
+{
+    uint8_t sourceSector = s_sector;
+
+    SwapCompactSector();
+
+    // Construct header for a single block with contiguous data
+    BlockHeader_t blockHeader;
+    blockHeader.id = cache->id;
+    blockHeader.blockOffset = 0x0000u;
+    blockHeader.blockLength = cache->itemLength;
+    blockHeader.itemLength = cache->itemLength;
+    blockHeader.previousBlock = cache->lastBlock;
+    blockHeader.writeCount = 0u;
+
+    uint16_t blockPointer = s_sectorHead;
+
+    // Now write the data block header, move its data and activate
+    bool result = WriteBlockHeader(&blockHeader) &&
+                  GatherData(sourceSector, cache, 0u, blockHeader.itemLength, NULL);
+    if ( result )
+    {
+        UpdateSectorHead(blockHeader.blockLength);
+        result = ActivateBlock(blockPointer);
+    }
+
+    SwapCompactSector();
+
+    if ( result )
+    {
+        cache->compactBlock = blockPointer;
+    }
+    return result;
+}
+
+/** Copies items that are not copied yet to the destination sector, and completes the
+    compact sector operation when all items are copied.
+    \param maxBytes The number of bytes after which the step ends. At least one item is copied.
+*/
+static bool CompactSectorStep(uint16_t maxBytes)
+{
+    uint32_t bytes = 0uL;
+    bool allCopied = TRUE;
+    BcTime_t startTime = HAL_GetSystemTime();
+
+    for ( uint8_t cacheIndex = 0u; cacheIndex < s_itemCount; cacheIndex++ )
+    {
+        Item_t *cache = &s_itemCache[cacheIndex];
+
+        if ( cache->compactBlock != 0x0000u )
         {
-            return FALSE;
+            // copied already and not changed since
+            continue;
         }
 
-        if ( !GatherData(sourceSector, cache->lastBlock, 0u, blockHeader.itemLength, NULL) )
+        if ( bytes >= maxBytes )
         {
-            return FALSE;
+            // continue with this item in the next step
+            allCopied = FALSE;
+            break;
         }
 
-        UpdateSectorHead(blockHeader.blockLength);
+        if ( ((uint32_t) s_compactSectorHead + BLOCK_HEADER_SIZE + cache->itemLength) > SECTOR_SIZE )
+        {
+            // the destination sector is filled with copies of items that were changed again.
+            // start over and copy all items at once
+            N_ERRH_ASSERT_FATAL(s_compactSectorHasStaleCopies);
+            AbortCompactSector();
+            return CompactSector();
+        }
 
-        if ( !ActivateBlock(blockPointer) )
+        if ( !CopyItemToCompactSector(cache) )
         {
             return FALSE;
         }
+        bytes += BLOCK_HEADER_SIZE + cache->itemLength;
+    }
 
-        cache->lastBlock = blockPointer;
+    s_compactSteps++;
+    if ( bytes > s_maxCompactStepBytes )
+    {
+        s_maxCompactStepBytes = (uint16_t) bytes;
     }
 
-    // All items moved, so now we just need to activate the sector
-    if ( !ActivateSector() )
+    bool result = TRUE;
+    if ( allCopied )
+    {
+        // no item changed since it was copied. switch to the destination sector
+        result = FinishCompactSector();
+    }
+
+    uint32_t stepTime = (uint32_t) (HAL_GetSystemTime() - startTime);
+    if ( stepTime > s_maxCompactStepTime )
+    {
+        s_maxCompactStepTime = stepTime;
+    }
+
+    return result;
+}
+
+/* Important: if CompactSector fails, the only fix is to reinitialize!
+ * This is because the itemCache, sector head and sector selector will
+ * be messed up.
+ */
+static bool CompactSector(void)
+{
+    if ( !StartCompactSector() )
     {
         return FALSE;
     }
 
-    // schedule an erase of the source sector,Restart the timer if it is already running.
-    s_sectorToErase = sourceSector;
-    HAL_StopAppTimer(&eraseSectorTimer);
-    HAL_StartAppTimer(&eraseSectorTimer);
+    // copy all remaining items at once
+    return CompactSectorStep(0xFFFFu);
+}
 
-    return TRUE;
+/** Continues a compact sector operation that was interrupted by a reset.
+    Copies in the destination sector are reused if the item did not change since.
+    \param sector The inactive destination sector
+*/
+static void ResumeCompactSector(uint8_t sector)
+{
+    s_compactSector = sector;
+    s_compactSectorHead = SECTOR_HEADER_SIZE;
+    SwapCompactSector();
+
+    for ( uint8_t cacheIndex = 0u; cacheIndex < s_itemCount; cacheIndex++ )
+    {
+        s_itemCache[cacheIndex].compactBlock = 0x0000u;
+    }
+    s_compactSectorHasStaleCopies = TRUE;
+    s_compactSteps = 0u;
+    s_maxCompactStepTime = 0u;
+    s_maxCompactStepBytes = 0u;
+    bool resumed = TRUE;
+
+    // find the copies that are still valid and the end of the written blocks
+    while ( s_sectorHead < SECTOR_SIZE )
+    {
+        BlockHeader_t blockHeader;
+        D_Nv_Read(s_sector, s_sectorHead, (uint8_t*) &blockHeader, BLOCK_HEADER_SIZE);
+
+        if ( IsEmpty((uint8_t*) &blockHeader, BLOCK_HEADER_SIZE) )
+        {
+            break;
+        }
+        else if ( blockHeader.headerCrc != ComputeHeaderCrc(&blockHeader) )
+        {
+            UpdateSectorHead(BLOCK_HEADER_SIZE);
+        }
+        else
+        {
+            Item_t *cache = FindItemCache(blockHeader.id);
+
+            if ( (cache != NULL) && (blockHeader.isActive == 0x0000u) )
+            {
+                // a copy is valid if it was made from the last written block of the item
+                bool valid = (blockHeader.itemLength != 0u) && (blockHeader.previousBlock == cache->lastBlock);
+                cache->compactBlock = valid ? s_sectorHead : 0x0000u;
+            }
+            UpdateSectorHead(BLOCK_HEADER_SIZE + blockHeader.blockLength);
+        }
+    }
+
+    // items that were deleted after they were copied must not come back with the destination sector
+    uint16_t end = s_sectorHead;
+    uint16_t blockPointer = SECTOR_HEADER_SIZE;
+    while ( blockPointer < end )
+    {
+        BlockHeader_t blockHeader;
+        D_Nv_Read(s_sector, blockPointer, (uint8_t*) &blockHeader, BLOCK_HEADER_SIZE);
+
+        if ( blockHeader.headerCrc != ComputeHeaderCrc(&blockHeader) )
+        {
+            blockPointer = (blockPointer + BLOCK_HEADER_SIZE + 0x000Fu) & 0xFFF0u;
+            continue;
+        }
+
+        if ( (blockHeader.isActive == 0x0000u) && (blockHeader.itemLength != 0u) &&
+             (FindItemCache(blockHeader.id) == NULL) )
+        {
+            if ( ((uint32_t) s_sectorHead + BLOCK_HEADER_SIZE > SECTOR_SIZE) || !WriteDeleteBlock(blockHeader.id) )
+            {
+                resumed = FALSE;
+                break;
+            }
+        }
+        blockPointer = (blockPointer + BLOCK_HEADER_SIZE + blockHeader.blockLength + 0x000Fu) & 0xFFF0u;
+    }
+
+    SwapCompactSector();
+
+    if ( !resumed )
+    {
+        // the next compact sector operation starts from the beginning and erases the sector
+        AbortCompactSector();
+    }
+}
+
+/** Returns the free space below which a preemptive compact sector operation is started. */
+static uint16_t GetPreemptiveCompactThreshold(void)
+{
+    uint32_t liveBytes = SECTOR_HEADER_SIZE;
+
+    for ( uint8_t cacheIndex = 0u; cacheIndex < s_itemCount; cacheIndex++ )
+    {
+        liveBytes += BLOCK_HEADER_SIZE + s_itemCache[cacheIndex].itemLength;
+    }
+
+    uint32_t threshold = (liveBytes < SECTOR_SIZE) ? ((SECTOR_SIZE - liveBytes) / 4u) : 0u;
+
+    if ( threshold < PREEMPTIVE_COMPACT_SECTOR_MIN_THRESHOLD )
+    {
+        return PREEMPTIVE_COMPACT_SECTOR_MIN_THRESHOLD;
+    }
+    if ( threshold > PREEMPTIVE_COMPACT_SECTOR_THRESHOLD )
+    {
+        return PREEMPTIVE_COMPACT_SECTOR_THRESHOLD;
+    }
+    return (uint16_t) threshold;
 }
 
 static void CompactSectorIfNeeded(uint16_t immediateThreshold)
@@ -796,7 +1249,17 @@ static void CompactSectorIfNeeded(uint16_t immediateThreshold)
         }
         return;
     }
-    if ( freeSpace < PREEMPTIVE_COMPACT_SECTOR_THRESHOLD )
+    if ( s_compactSector != NO_COMPACT_SECTOR )
+    {
+        // keep the compact sector operation ahead of the writes that fill the sector
+        if ( !CompactSectorStep(S_NV_COMPACT_STEP_BYTES + immediateThreshold) )
+        {
+            N_ERRH_FATAL();
+        }
+        return;
+    }
+    if ( (freeSpace < PREEMPTIVE_COMPACT_SECTOR_THRESHOLD) &&
+         (freeSpace < GetPreemptiveCompactThreshold()) )
     {
         if (SYS_TIMER_STOPPED == compactSectorTimer.state)
             SYS_InitTimer(&compactSectorTimer, TIMER_ONE_SHOT_MODE, COMPACT_SECTOR_DELAY_MS, compactSectorTimerFired);
@@ -823,7 +1286,15 @@ static S_Nv_ReturnValue_t CompactItem(void)
     }
 
     if (s_compactItemLength != 0)
+    {
+        // a compact sector operation started here drops the compact item, but the resize is still needed
+        uint16_t resizeItemId = s_compactItemId;
+        uint16_t resizeItemLength = s_compactItemLength;
+
         CompactSectorIfNeeded(s_compactItemLength + BLOCK_HEADER_SIZE);
+        s_compactItemId = resizeItemId;
+        s_compactItemLength = resizeItemLength;
+    }
 
     Item_t *cache = FindItemCache(s_compactItemId);
     if ( cache == NULL )
@@ -841,6 +1312,11 @@ static S_Nv_ReturnValue_t CompactItem(void)
     if (s_compactItemLength == 0)
     {
         CompactSectorIfNeeded(blockHeader.itemLength + BLOCK_HEADER_SIZE);
+        if ( s_compactItemId == 0u )
+        {
+            // the compact sector operation has merged the blocks of the item
+            return S_Nv_ReturnValue_Ok;
+        }
 
         cache = FindItemCache(s_compactItemId);
         N_ERRH_ASSERT_FATAL(cache != NULL);
@@ -878,7 +1354,7 @@ static S_Nv_ReturnValue_t CompactItem(void)
     }
 
     // gather all data of the item and copy it to a new block
-    if ( !GatherData(s_sector, blockPointer, 0u, bytesToGather, NULL) )
+    if ( !GatherData(s_sector, cache, 0u, bytesToGather, NULL) )
     {
         N_LOG_NONFATAL();
         return S_Nv_ReturnValue_Failure;
@@ -895,7 +1371,7 @@ static S_Nv_ReturnValue_t CompactItem(void)
     s_compactItemId = 0u;
     s_compactItemLength = 0u;
 
-    cache->lastBlock = lastBlock;
+    SetFullBlock(cache, lastBlock, blockHeader.itemLength);
 
     return S_Nv_ReturnValue_Ok;
 }
@@ -907,6 +1383,7 @@ static S_Nv_ReturnValue_t CompactItem(void)
 void S_Nv_EarlyInit(void)
 {
     s_itemCount = 0u;
+    s_compactSector = NO_COMPACT_SECTOR;
 
     SectorHeader_t sectorHeader;
 
@@ -917,13 +1394,7 @@ void S_Nv_EarlyInit(void)
     {
         D_Nv_Read(sector, 0u, (uint8_t*) &sectorHeader, SECTOR_HEADER_SIZE);
         if ( (sectorHeader.isActive == 0x0000u) &&
-             (sectorHeader.signature[0] == (uint8_t) 'A') &&
-             (sectorHeader.signature[1] == (uint8_t) 'T') &&
-             (sectorHeader.signature[2] == (uint8_t) 'S') &&
-             (sectorHeader.signature[3] == (uint8_t) 'N') &&
-             (sectorHeader.signature[4] == (uint8_t) 'v') &&
-             (sectorHeader.signature[5] == (uint8_t) '1') &&
-             ((sectorHeader.sequenceNumber ^ sectorHeader.sequenceParity) == 0xFFFFFFFFuL) )
+             IsValidSectorHeader(&sectorHeader) )
         {
             // active sector
             if ( sectorHeader.sequenceNumber < lastSectorSequence )
@@ -965,6 +1436,19 @@ void S_Nv_EarlyInit(void)
         s_sector = lastSector;
 
         LoadSector();
+
+        // a compact sector operation interrupted by a reset leaves the next sector prepared, but inactive
+        for ( uint8_t sector = FIRST_SECTOR; sector < (FIRST_SECTOR + SECTOR_COUNT); sector++ )
+        {
+            D_Nv_Read(sector, 0u, (uint8_t*) &sectorHeader, SECTOR_HEADER_SIZE);
+            if ( (sectorHeader.isActive == 0xFFFFu) &&
+                 IsValidSectorHeader(&sectorHeader) &&
+                 (sectorHeader.sequenceNumber == (lastSectorSequence - 1uL)) )
+            {
+                ResumeCompactSector(sector);
+                break;
+            }
+        }
     }
     s_earlyInitDone = TRUE;
 }
@@ -979,6 +1463,12 @@ void S_Nv_Init(void)
     eraseSectorTimer.mode     = TIMER_ONE_SHOT_MODE;
     eraseSectorTimer.callback = eraseSectorTimerFired;
     eraseSectorTimer.interval = ERASE_SECTOR_DELAY_MS;
+
+    if ( s_compactSector != NO_COMPACT_SECTOR )
+    {
+        // continue the compact sector operation resumed by the early init
+        SYS_InitTimer(&compactStepTimer, TIMER_ONE_SHOT_MODE, S_NV_COMPACT_STEP_INTERVAL_MS, compactStepTimerFired);
+    }
 }
 
 /** Interface function, see \ref S_Nv_ItemInit. */
@@ -1046,7 +1536,7 @@ S_Nv_ReturnValue_t S_Nv_ItemInit_Impl(S_Nv_ItemId_t id, uint16_t itemLength, voi
 
     // After successful write, create the cache
     Item_t *newItemCache = CreateItemCache(newItemId);
-    newItemCache->lastBlock = newItemPointer;
+    SetFullBlock(newItemCache, newItemPointer, itemLength);
 
     return S_Nv_ReturnValue_DidNotExist;
 }
@@ -1112,7 +1602,14 @@ S_Nv_ReturnValue_t S_Nv_Write_Impl(S_Nv_ItemId_t id, uint16_t offset, uint16_t d
     }
 
     // Write succeeded, so update the cache
-    cache->lastBlock = newBlockPointer;
+    if ( blockHeader.blockLength == blockHeader.itemLength )
+    {
+        SetFullBlock(cache, newBlockPointer, blockHeader.itemLength);
+    }
+    else
+    {
+        SetPartialBlock(cache, newBlockPointer);
+    }
 
     if ( blockHeader.writeCount > COMPACT_ITEM_THRESHOLD )
     {
@@ -1141,9 +1638,9 @@ S_Nv_ReturnValue_t S_Nv_Read_Impl(S_Nv_ItemId_t id, uint16_t offset, uint16_t da
 {
     N_ERRH_ASSERT_FATAL((id != 0u) && (pData != NULL));
 
-    // get the pointer to the last written block for the item
-    uint16_t lastBlockPointer = FindItem(id);
-    if ( lastBlockPointer == 0x0000u )
+    // get the cache of the item
+    Item_t *cache = FindItemCache(id);
+    if ( cache == NULL )
     {
         // item does not exist
         return S_Nv_ReturnValue_DoesNotExist;
@@ -1156,7 +1653,7 @@ S_Nv_ReturnValue_t S_Nv_Read_Impl(S_Nv_ItemId_t id, uint16_t offset, uint16_t da
     }
 
     // gather the data into the destination buffer
-    if ( !GatherData(s_sector, lastBlockPointer, offset, dataLength, pData) )
+    if ( !GatherData(s_sector, cache, offset, dataLength, pData) )
     {
         return S_Nv_ReturnValue_BeyondEnd;
     }
@@ -1169,17 +1666,14 @@ uint16_t S_Nv_ItemLength_Impl(S_Nv_ItemId_t id)
 {
     N_ERRH_ASSERT_FATAL(id != 0u);
 
-    uint16_t blockPointer = FindItem(id);
-    if ( blockPointer == 0x0000u )
+    Item_t *cache = FindItemCache(id);
+    if ( cache == NULL )
     {
         // item does not exist
         return 0u;
     }
 
-    // read last written item block header
-    BlockHeader_t blockHeader;
-    D_Nv_Read(s_sector, blockPointer, (uint8_t*) &blockHeader, BLOCK_HEADER_SIZE);
-    return blockHeader.itemLength;
+    return cache->itemLength;
 }
 
 /** Interface function, see \ref S_Nv_Delete. */
@@ -1200,26 +1694,31 @@ S_Nv_ReturnValue_t S_Nv_Delete_Impl(S_Nv_ItemId_t id)
     CompactSectorIfNeeded(BLOCK_HEADER_SIZE);
 
     // Delete item by writing a new header for it, stating 0 length
-    BlockHeader_t blockHeader;
-
-    blockHeader.id = id;
-    blockHeader.blockOffset = 0x0000u;
-    blockHeader.blockLength = 0;
-    blockHeader.itemLength = 0u;
-    blockHeader.previousBlock = 0x0000u;
-    blockHeader.writeCount = 0u;
-
-    uint16_t blockPointer = s_sectorHead;
-
-    if ( !WriteBlockHeader(&blockHeader) )
+    if ( !WriteDeleteBlock(id) )
     {
         return S_Nv_ReturnValue_Failure;
     }
 
-    if ( !ActivateBlock(blockPointer) )
+    if ( (s_compactSector != NO_COMPACT_SECTOR) && (FindItemCache(id)->compactBlock != 0x0000u) )
     {
-        // failed to activate the block
-        return S_Nv_ReturnValue_Failure;
+        // the item is copied by the running compact sector operation already.
+        // delete the copy too, otherwise it is found again after the switch to that sector
+        if ( ((uint32_t) s_compactSectorHead + BLOCK_HEADER_SIZE) > SECTOR_SIZE )
+        {
+            AbortCompactSector();
+        }
+        else
+        {
+            SwapCompactSector();
+            bool deleted = WriteDeleteBlock(id);
+            SwapCompactSector();
+
+            if ( !deleted )
+            {
+                // the next compact sector operation starts from the beginning
+                AbortCompactSector();
+            }
+        }
     }
 
     DeleteItemCache(id);
@@ -1243,6 +1742,10 @@ S_Nv_ReturnValue_t S_Nv_EraseAll_Impl(bool includingPersistentItems)
         return S_Nv_ReturnValue_PowerSupplyTooLow;
     }
 
+    // items are deleted from the cache only, so copies made by a running compact
+    // sector operation would be found again
+    AbortCompactSector();
+
     if ( includingPersistentItems )
     {
         for ( uint8_t sector = FIRST_SECTOR; sector < (FIRST_SECTOR + SECTOR_COUNT); sector++ )
@@ -1253,10 +1756,10 @@ S_Nv_ReturnValue_t S_Nv_EraseAll_Impl(bool includingPersistentItems)
     else
     {
         uint8_t deletedItems = 0;
-        uint8_t totalItems = s_itemCount;
 
-        // Traverse the item cache, removing all the non-persistent
-        for ( uint8_t cacheIndex = 0; cacheIndex < totalItems; cacheIndex++ )
+        // Traverse the item cache, removing all the non-persistent.
+        // Deleting shifts the next items down, so the index only advances past kept items
+        for ( uint8_t cacheIndex = 0; cacheIndex < s_itemCount; /* empty */ )
         {
             uint16_t id = s_itemCache[cacheIndex].id;
 
@@ -1265,6 +1768,10 @@ S_Nv_ReturnValue_t S_Nv_EraseAll_Impl(bool includingPersistentItems)
                 DeleteItemCache(id);
                 deletedItems++;
             }
+            else
+            {
+                cacheIndex++;
+            }
         }
 
         // Were any items deleted? If so, do sector compaction!
@@ -1286,6 +1793,16 @@ void S_Nv_SetPowerSupplyCheckingFunction_Impl(S_Nv_PowerSupplyCheckingFunction_t
 {
     s_powerSupplyCheckingFunction = pf;
 }
+/** Interface function, see \ref S_Nv_MaxCompactStepTime. */
+uint32_t S_Nv_MaxCompactStepTime_Impl(uint16_t* pBytes)
+{
+    if ( pBytes != NULL )
+    {
+        *pBytes = s_maxCompactStepBytes;
+    }
+    return s_maxCompactStepTime;
+}
+
 /** Interface function, see \ref S_Nv_IsItemAvailable.
  *
  * Important: This will check whether the item is found in the storage area
@@ -0,0 +1,163 @@
+#ifndef NONE_OS
+#define NONE_OS
+#endif
+#ifndef RELEASE
+#define RELEASE
+#endif
+#ifndef _IEEE_ZIGBEE_COMPLIANCE_
+#define _IEEE_ZIGBEE_COMPLIANCE_
+#endif
+#ifndef _SYS_MAC_PHY_HWD_TASK_
+#define _SYS_MAC_PHY_HWD_TASK_
+#endif
+#ifndef _SYS_HAL_TASK_
+#define _SYS_HAL_TASK_
+#endif
+#ifndef _SYS_MAC_HWI_TASK_
+#define _SYS_MAC_HWI_TASK_
+#endif
+#ifndef _SYS_BSP_TASK_
+#define _SYS_BSP_TASK_
+#endif
+#ifndef _SYS_APL_TASK_
+#define _SYS_APL_TASK_
+#endif
+#ifndef _SYS_NWK_TASK_
+#define _SYS_NWK_TASK_
+#endif
+#ifndef _SYS_APS_TASK_
+#define _SYS_APS_TASK_
+#endif
+#ifndef _SYS_SSP_TASK_
+#define _SYS_SSP_TASK_
+#endif
+#ifndef _SYS_TC_TASK_
+#define _SYS_TC_TASK_
+#endif
+#ifndef _SYS_ZDO_TASK_
+#define _SYS_ZDO_TASK_
+#endif
+#ifndef _SECURITY_
+#define _SECURITY_
+#endif
+#ifndef _NWK_ALLOCATOR_
+#define _NWK_ALLOCATOR_
+#endif
+#ifndef _SSP_SW_AES_
+#define _SSP_SW_AES_
+#endif
+#ifndef _TRUST_CENTRE_
+#define _TRUST_CENTRE_
+#endif
+#ifndef _DISTRIBUTED_TRUST_CENTER_
+#define _DISTRIBUTED_TRUST_CENTER_
+#endif
+#ifndef _COORDINATOR_
+#define _COORDINATOR_
+#endif
+#ifndef _ROUTER_
+#define _ROUTER_
+#endif
+#ifndef _ENDDEVICE_
+#define _ENDDEVICE_
+#endif
+#ifndef _FFD_
+#define _FFD_
+#endif
+#ifndef _MAC_BAN_NODE_
+#define _MAC_BAN_NODE_
+#endif
+#ifndef _RF_REG_ACCESS_
+#define _RF_REG_ACCESS_
+#endif
+#ifndef _CONTROL_FRAME_PENDING_BIT_
+#define _CONTROL_FRAME_PENDING_BIT_
+#endif
+#ifndef _PENDING_EMPTY_DATA_FRAME_
+#define _PENDING_EMPTY_DATA_FRAME_
+#endif
+#ifndef _NWK_FAST_ROUTE_DISCOVERY_
+#define _NWK_FAST_ROUTE_DISCOVERY_
+#endif
+#ifndef _NWK_NONSTANDARD_BEACON_FILTER_
+#define _NWK_NONSTANDARD_BEACON_FILTER_
+#endif
+#ifndef _NWK_GROUP_
+#define _NWK_GROUP_
+#endif
+#ifndef _GROUP_TABLE_
+#define _GROUP_TABLE_
+#endif
+#ifndef _NWK_CHECK_OUT_BROADCAST_
+#define _NWK_CHECK_OUT_BROADCAST_
+#endif
+#ifndef _NWK_ROUTING_OPTIMIZATION_
+#define _NWK_ROUTING_OPTIMIZATION_ 2
+#endif
+#ifndef _NWK_STOCHASTIC_ADDRESSING_
+#define _NWK_STOCHASTIC_ADDRESSING_
+#endif
+#ifndef _RESOLVE_ADDR_CONFLICT_
+#define _RESOLVE_ADDR_CONFLICT_
+#endif
+#ifndef _NWK_MESH_ROUTING_
+#define _NWK_MESH_ROUTING_
+#endif
+#ifndef _APS_FRAGMENTATION_
+#define _APS_FRAGMENTATION_
+#endif
+#ifndef _APS_MULTICAST_
+#define _APS_MULTICAST_
+#endif
+#ifndef _GROUP_TABLE_
+#define _GROUP_TABLE_
+#endif
+#ifndef _BINDING_
+#define _BINDING_
+#endif
+#ifndef _COMMISSIONING_
+#define _COMMISSIONING_
+#endif
+#ifndef _INTERPAN_
+#define _INTERPAN_
+#endif
+#ifndef _NWK_ORPHAN_JOIN_
+#define _NWK_ORPHAN_JOIN_
+#endif
+#ifndef _NWK_PASSIVE_ACK_
+#define _NWK_PASSIVE_ACK_
+#endif
+#ifndef _CUSTOM_PASSIVE_ACK_THRESHOLD_
+#define _CUSTOM_PASSIVE_ACK_THRESHOLD_
+#endif
+#ifndef _ZAPPSI_
+#define _ZAPPSI_
+#endif
+#ifndef _SILENT_LEAVE_WITHOUT_NETWORK_LEFT_
+#define _SILENT_LEAVE_WITHOUT_NETWORK_LEFT_
+#endif
+#ifndef _NWK_NEIGHBOR_ENTRY_ADDITION_UPON_RX_FRAME_
+#define _NWK_NEIGHBOR_ENTRY_ADDITION_UPON_RX_FRAME_
+#endif
+#ifndef _NWK_ROUTE_REQUEST_RETRIES_BASED_ON_MAC_CONF_
+#define _NWK_ROUTE_REQUEST_RETRIES_BASED_ON_MAC_CONF_
+#endif
+#ifndef _LEAVE_NETWORK_IMMEDIATE_WITH_NO_TANSACTIONS_LEFT_
+#define _LEAVE_NETWORK_IMMEDIATE_WITH_NO_TANSACTIONS_LEFT_
+#endif
+#ifndef _SLEEP_WHEN_IDLE_
+#define _SLEEP_WHEN_IDLE_
+#endif
+#ifndef _NWK_IN_FRAME_COUNTERS_
+#define _NWK_IN_FRAME_COUNTERS_
+#endif
+#ifndef RELEASE
+#define RELEASE
+#endif
+#ifndef _RF_BAT_MON_
+#define _RF_BAT_MON_
+#endif
+#ifndef _SLEEP_WHEN_IDLE_
+#define _SLEEP_WHEN_IDLE_
+#endif
+#include <configuration.h>
@@ -54,7 +54,7 @@
 #  endif
 #endif
 #ifdef BOARD_PC
-#  if !defined(WIN)
+#  if !defined(WIN) && !defined(LINUX)
 #    error invalid HAL
 #  endif
 #endif
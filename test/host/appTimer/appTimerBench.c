@@ -0,0 +1,95 @@
+/******************************************************************************
+  \file appTimerBench.c
+
+  \brief
+    HAL application timers benchmark: restart of a random timer with 10, 100
+    and 1000 timers started.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <appTimer.h>
+#include <hostTest.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define MAX_TIMERS_AMOUNT 1000
+#define ITERATIONS        200000
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+void halAppTimerHandler(void);
+
+/******************************************************************************
+                    External variables section
+******************************************************************************/
+extern uint32_t appTimerStubTime;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static HAL_AppTimer_t timers[MAX_TIMERS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+static void timerFired(void)
+{
+}
+
+int main(void)
+{
+  static const int amounts[] = {10, 100, MAX_TIMERS_AMOUNT};
+
+  for (unsigned k = 0U; k < sizeof(amounts) / sizeof(amounts[0]); k++)
+  {
+    int amount = amounts[k];
+    double start;
+
+    srand(1);
+    for (int i = 0; i < amount; i++)
+    {
+      timers[i].interval = 1000U + rand() % 100000U;
+      timers[i].mode = TIMER_ONE_SHOT_MODE;
+      timers[i].callback = timerFired;
+      HAL_StartAppTimer(&timers[i]);
+    }
+
+    start = hostTestNow();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+      HAL_AppTimer_t *timer = &timers[rand() % amount];
+
+      HAL_StopAppTimer(timer);
+      timer->interval = 1000U + rand() % 100000U;
+      HAL_StartAppTimer(timer);
+      appTimerStubTime++;
+      if (0 == (i & 1023))
+        halAppTimerHandler();
+    }
+    printf("%5d timers: %.1f ns per stop and start\n", amount,
+           (hostTestNow() - start) / ITERATIONS);
+
+    for (int i = 0; i < amount; i++)
+      HAL_StopAppTimer(&timers[i]);
+  }
+
+  return 0;
+}
+
+/* eof appTimerBench.c */
@@ -0,0 +1,53 @@
+/******************************************************************************
+  \file appTimerStubs.c
+
+  \brief
+    Application timer clock and HAL services emulated for the host tests.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+                    Global variables section
+******************************************************************************/
+/* Emulated application timer clock, in milliseconds */
+uint32_t appTimerStubTime;
+uint8_t halAppTimeOvfw;
+volatile uint16_t SYS_taskFlag;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+uint32_t halGetTimeOfAppTimer(void)
+{
+  return appTimerStubTime;
+}
+
+uint32_t halGetTimeOfAppTimerUs(void)
+{
+  return appTimerStubTime * 1000ul;
+}
+
+void halStartAtomic(void)
+{
+}
+
+void halEndAtomic(void)
+{
+}
+
+/* eof appTimerStubs.c */
@@ -0,0 +1,164 @@
+/******************************************************************************
+  \file appTimerTest.c
+
+  \brief
+    HAL application timers test. Timers are started, stopped and fired in
+    random order with the clock crossing the 32-bit wrap, both in short ticks
+    and in long sleeps. Results are compared with a brute-force model: firing
+    order, no timer fired early or missed, time to the next timer.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <appTimer.h>
+#include <hostTest.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define TIMERS_AMOUNT 300
+#define STEPS_AMOUNT  2000000
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+void halAppTimerHandler(void);
+uint32_t halGetTimeToNextAppTimer(void);
+
+/******************************************************************************
+                    External variables section
+******************************************************************************/
+extern uint32_t appTimerStubTime;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static HAL_AppTimer_t timers[TIMERS_AMOUNT];
+/* Model: timer is started */
+static bool started[TIMERS_AMOUNT];
+static uint32_t lastOverdue;
+static unsigned firedInHandler;
+static unsigned fired;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Timer callback. Fired one-shot timer is the one started in the model
+       and stopped in the queue. Timers are fired from the most overdue one.
+******************************************************************************/
+static void timerFired(void)
+{
+  int firedTimer = -1;
+
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (started[i] && !HAL_IsAppTimerStarted(&timers[i]))
+    {
+      HOST_CHECK(firedTimer < 0);
+      firedTimer = i;
+    }
+  }
+  if (!HOST_CHECK(firedTimer >= 0))
+    return;
+
+  uint32_t overdue = appTimerStubTime - timers[firedTimer].service.sysTimeLabel -
+    timers[firedTimer].interval;
+
+  HOST_CHECK(!firedInHandler || overdue <= lastOverdue);
+  lastOverdue = overdue;
+  firedInHandler++;
+  fired++;
+  started[firedTimer] = false;
+}
+
+/******************************************************************************
+\brief Runs timers handler after the clock is advanced and checks the result.
+
+\param[in] delta - time elapsed since the previous run.
+******************************************************************************/
+static void runHandler(uint32_t delta)
+{
+  unsigned due = 0U;
+  uint32_t timeToNext = UINT32_MAX;
+
+  appTimerStubTime += delta;
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (started[i] &&
+        appTimerStubTime - timers[i].service.sysTimeLabel >= timers[i].interval)
+      due++;
+  }
+
+  firedInHandler = 0U;
+  halAppTimerHandler();
+  HOST_CHECK(firedInHandler == due);
+
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (started[i])
+    {
+      uint32_t left = timers[i].service.sysTimeLabel + timers[i].interval - appTimerStubTime;
+
+      if (left < timeToNext)
+        timeToNext = left;
+    }
+  }
+  HOST_CHECK(halGetTimeToNextAppTimer() == timeToNext);
+}
+
+int main(void)
+{
+  srand(7);
+  appTimerStubTime = 0xFFFF0000u;
+
+  for (int step = 0; step < STEPS_AMOUNT; step++)
+  {
+    int i = rand() % TIMERS_AMOUNT;
+
+    switch (rand() % 4)
+    {
+      case 0:
+        if (started[i])
+          break;
+        timers[i].interval = (rand() % 8) ? 1U + rand() % 5000U : rand() % 200000U;
+        timers[i].mode = TIMER_ONE_SHOT_MODE;
+        timers[i].callback = timerFired;
+        HOST_CHECK(0 == HAL_StartAppTimer(&timers[i]));
+        started[i] = true;
+        break;
+
+      case 1:
+        HOST_CHECK(HAL_StopAppTimer(&timers[i]) == (started[i] ? 0 : -1));
+        started[i] = false;
+        break;
+
+      case 2:
+        HOST_CHECK(HAL_IsAppTimerStarted(&timers[i]) == started[i]);
+        break;
+
+      default:
+        /* 10 ms ticks, sometimes a long sleep */
+        runHandler((rand() % 500) ? rand() % 30U : rand() % 100000U);
+        break;
+    }
+  }
+
+  printf("%u timers fired\n", fired);
+  return hostTestResult();
+}
+
+/* eof appTimerTest.c */
@@ -0,0 +1,31 @@
+/******************************************************************************
+  \file configuration.h
+
+  \brief
+    Application configuration of the host tests. Stack components are built
+    with their default parameters.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+#ifndef _CONFIGURATION_H_
+#define _CONFIGURATION_H_
+
+#define ZCL_SUPPORT 1
+
+/* S_Nv items kept by S_Nv_EraseAll(), the same as in the applications */
+#define PERSISTENT_NV_ITEMS_PLATFORM    NWK_SECURITY_COUNTERS_MEM_ID
+#define PERSISTENT_NV_ITEMS_APPLICATION 0xFFFu
+
+#endif /* _CONFIGURATION_H_ */
+
+/* eof configuration.h */
@@ -0,0 +1,83 @@
+/******************************************************************************
+  \file hostTest.c
+
+  \brief
+    Helpers shared by the host tests of BitCloud components. Assert callbacks
+    of the stack fail the test.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <hostTest.h>
+#include <stdlib.h>
+#include <time.h>
+
+/******************************************************************************
+                    Global variables section
+******************************************************************************/
+uint16_t gAssertDbgCode;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static unsigned hostTestChecks;
+static unsigned hostTestFailures;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+bool hostTestCheck(bool passed, const char *expression, const char *file, int line)
+{
+  hostTestChecks++;
+  if (!passed)
+  {
+    hostTestFailures++;
+    if (hostTestFailures <= 10U)
+      printf("%s:%d: check failed: %s\n", file, line, expression);
+  }
+  return passed;
+}
+
+int hostTestResult(void)
+{
+  printf("%u checks, %u failed\n", hostTestChecks, hostTestFailures);
+  return hostTestFailures ? 1 : 0;
+}
+
+double hostTestNow(void)
+{
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+void SYS_DefAssertCallbackFatal(void)
+{
+  printf("fatal assert 0x%04x\n", gAssertDbgCode);
+  exit(1);
+}
+
+void SYS_DefAssertCallbackError(void)
+{
+  printf("error assert 0x%04x\n", gAssertDbgCode);
+  hostTestFailures++;
+}
+
+void SYS_DefAssertCallbackWarn(void)
+{
+}
+
+/* eof hostTest.c */
@@ -0,0 +1,69 @@
+/******************************************************************************
+  \file hostTest.h
+
+  \brief
+    Helpers shared by the host tests of BitCloud components
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+#ifndef _HOSTTEST_H_
+#define _HOSTTEST_H_
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+/* Counts a failure and reports its location, test goes on */
+#define HOST_CHECK(condition) \
+  hostTestCheck((condition), #condition, __FILE__, __LINE__)
+
+/* Checks the condition and stops the test if it fails */
+#define HOST_REQUIRE(condition) \
+  do { if (!HOST_CHECK(condition)) return hostTestResult(); } while (0)
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+/******************************************************************************
+\brief Counts a failed check.
+
+\param[in] passed - result of the check.
+\param[in] expression, file, line - failed check description.
+
+\return the passed value.
+******************************************************************************/
+bool hostTestCheck(bool passed, const char *expression, const char *file, int line);
+
+/******************************************************************************
+\brief Reports test result.
+
+\return exit code of the test: 0 if all checks have passed, 1 otherwise.
+******************************************************************************/
+int hostTestResult(void);
+
+/******************************************************************************
+\brief Returns monotonic time for benchmarks.
+
+\return time in nanoseconds.
+******************************************************************************/
+double hostTestNow(void);
+
+#endif /* _HOSTTEST_H_ */
+
+/* eof hostTest.h */
@@ -0,0 +1,246 @@
+/******************************************************************************
+  \file nTimerTest.c
+
+  \brief
+    N_Timer test on the HAL application timers queue. Timers are started with
+    positive and negative delays, stopped, expired and run in random order
+    together with application timers, with the system time crossing the 32-bit
+    wrap. Results are compared with a model: running state, remaining time,
+    task events, application timer callbacks and the time left to the earliest
+    timer of the queue.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <N_Timer_Bindings.h>
+#include <N_Timer_Init.h>
+#include <N_Timer.h>
+#include <appTimer.h>
+#include <hostTest.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define TASKS_AMOUNT      8
+#define TIMERS_AMOUNT     (TASKS_AMOUNT * 8)
+#define APP_TIMERS_AMOUNT 8
+#define STEPS_AMOUNT      1000000
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+void halAppTimerHandler(void);
+uint32_t halGetTimeToNextAppTimer(void);
+
+/******************************************************************************
+                    External variables section
+******************************************************************************/
+extern uint32_t appTimerStubTime;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static N_Task_Event_t taskEvents[TASKS_AMOUNT];
+static N_Timer_t timers[TIMERS_AMOUNT];
+/* Application timers with callbacks sharing the queue */
+static HAL_AppTimer_t appTimers[APP_TIMERS_AMOUNT];
+static uint32_t appTimerFires;
+
+/* Model: timer is running, its expiration time and the task events */
+static bool running[TIMERS_AMOUNT];
+static uint32_t expiration[TIMERS_AMOUNT];
+static N_Task_Event_t modelEvents[TASKS_AMOUNT];
+static bool appRunning[APP_TIMERS_AMOUNT];
+static uint32_t appExpiration[APP_TIMERS_AMOUNT];
+static uint32_t modelAppTimerFires;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+void N_Task_SetEvent(N_Task_Id_t task, N_Task_Event_t evt)
+{
+  taskEvents[task] |= evt;
+}
+
+void N_Task_ClearEvent(N_Task_Id_t task, N_Task_Event_t evt)
+{
+  taskEvents[task] &= ~evt;
+}
+
+void N_ErrH_Fatal(const char* compId, uint16_t line)
+{
+  printf("%s:%u: fatal error\n", compId, line);
+  exit(1);
+}
+
+static void appTimerFired(void)
+{
+  appTimerFires++;
+}
+
+/******************************************************************************
+\brief Updates the earliest time left with the model timer.
+
+\param[in, out] timeToNext - the earliest time left.
+\param[in] timerExpiration - expiration time of the timer.
+******************************************************************************/
+static void updateTimeToNext(uint32_t *timeToNext, uint32_t timerExpiration)
+{
+  int32_t remaining = (int32_t)(timerExpiration - appTimerStubTime);
+  uint32_t timeLeft = (remaining > 0) ? (uint32_t)remaining : 0u;
+
+  if (timeLeft < *timeToNext)
+    *timeToNext = timeLeft;
+}
+
+/******************************************************************************
+\brief Checks the timers, the task events and the application timers against
+       the model.
+******************************************************************************/
+static void checkTimers(void)
+{
+  uint32_t timeToNext = UINT32_MAX;
+
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    HOST_CHECK(N_Timer_IsRunning(&timers[i]) == running[i]);
+    if (running[i])
+    {
+      HOST_CHECK(N_Timer_GetRemaining(&timers[i]) == (int32_t)(expiration[i] - appTimerStubTime));
+      updateTimeToNext(&timeToNext, expiration[i]);
+    }
+  }
+  for (int i = 0; i < APP_TIMERS_AMOUNT; i++)
+  {
+    HOST_CHECK(HAL_IsAppTimerStarted(&appTimers[i]) == appRunning[i]);
+    if (appRunning[i])
+      updateTimeToNext(&timeToNext, appExpiration[i]);
+  }
+  /* the application timer clock wakes up the queue when the earliest timer expires */
+  HOST_CHECK(halGetTimeToNextAppTimer() == timeToNext);
+  HOST_CHECK(appTimerFires == modelAppTimerFires);
+  for (int task = 0; task < TASKS_AMOUNT; task++)
+    HOST_CHECK(taskEvents[task] == modelEvents[task]);
+}
+
+/******************************************************************************
+\brief Advances the system time and runs the application timer handler as
+       the application timer clock does.
+
+\param[in] delta - time elapsed since the previous update.
+******************************************************************************/
+static void updateTimers(uint32_t delta)
+{
+  appTimerStubTime += delta;
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (running[i] && (int32_t)(expiration[i] - appTimerStubTime) <= 0)
+    {
+      running[i] = false;
+      modelEvents[timers[i].task] |= timers[i].evt;
+    }
+  }
+  for (int i = 0; i < APP_TIMERS_AMOUNT; i++)
+  {
+    if (appRunning[i] && (int32_t)(appExpiration[i] - appTimerStubTime) <= 0)
+    {
+      appRunning[i] = false;
+      modelAppTimerFires++;
+    }
+  }
+  halAppTimerHandler();
+}
+
+int main(void)
+{
+  srand(3);
+  appTimerStubTime = 0xFFF00000u;
+  N_Timer_Init();
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    timers[i].task = i % TASKS_AMOUNT;
+    timers[i].evt = 1u << (i / TASKS_AMOUNT);
+  }
+  for (int i = 0; i < APP_TIMERS_AMOUNT; i++)
+  {
+    appTimers[i].mode = TIMER_ONE_SHOT_MODE;
+    appTimers[i].callback = appTimerFired;
+  }
+
+  for (int step = 0; step < STEPS_AMOUNT; step++)
+  {
+    int i = rand() % TIMERS_AMOUNT;
+    int32_t timeout;
+
+    switch (rand() % 6)
+    {
+      case 0:
+        /* negative delays expire on the next update */
+        timeout = (rand() % 16) ? rand() % 100000 : -(rand() % 1000);
+        N_Timer_Start32(timeout, &timers[i]);
+        running[i] = true;
+        expiration[i] = appTimerStubTime + (uint32_t)timeout;
+        modelEvents[timers[i].task] &= ~timers[i].evt;
+        break;
+
+      case 1:
+        timeout = rand() % 1000;
+        N_Timer_Start16((uint16_t)timeout, &timers[i]);
+        running[i] = true;
+        expiration[i] = appTimerStubTime + (uint32_t)timeout;
+        modelEvents[timers[i].task] &= ~timers[i].evt;
+        break;
+
+      case 2:
+        N_Timer_Stop(&timers[i]);
+        running[i] = false;
+        modelEvents[timers[i].task] &= ~timers[i].evt;
+        break;
+
+      case 3:
+        HOST_CHECK(N_Timer_Expire(timers[i].task, timers[i].evt) == running[i]);
+        if (running[i])
+          modelEvents[timers[i].task] |= timers[i].evt;
+        running[i] = false;
+        break;
+
+      case 4:
+        i %= APP_TIMERS_AMOUNT;
+        if (appRunning[i])
+        {
+          HAL_StopAppTimer(&appTimers[i]);
+          appRunning[i] = false;
+        }
+        else
+        {
+          appTimers[i].interval = rand() % 5000;
+          HAL_StartAppTimer(&appTimers[i]);
+          appRunning[i] = true;
+          appExpiration[i] = appTimerStubTime + appTimers[i].interval;
+        }
+        break;
+
+      default:
+        updateTimers((rand() % 100) ? rand() % 3000U : rand() % 200000U);
+        break;
+    }
+    checkTimers();
+  }
+
+  return hostTestResult();
+}
+
+/* eof nTimerTest.c */
@@ -0,0 +1,124 @@
+/******************************************************************************
+  \file sNvBench.c
+
+  \brief
+    S_Nv benchmark. Items are written completely, then a number of partial
+    writes per item fragments them into several blocks. Measures complete
+    item reads with the amount of flash reads they take and item lookups,
+    half of them for unknown items.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <N_Types.h>
+#include <S_Nv_Bindings.h>
+#include <S_Nv.h>
+#include <S_Nv_Init.h>
+#include <hostTest.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define ITEM_LENGTH        48
+#define PARTIAL_LENGTH     4
+#define READS_AMOUNT       200000
+#define LOOKUPS_AMOUNT     2000000
+/* Item ids are spread over the id range the way PDS uses it */
+#define ITEM_ID(index)     (0x0100U + (index) * 37U)
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  unsigned itemsAmount;
+  unsigned partialWrites;
+} BenchConfig_t;
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+void sNvStubEraseFlash(void);
+void sNvStubReset(void);
+
+/******************************************************************************
+                    External variables section
+******************************************************************************/
+extern unsigned long sNvStubFlashReads;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static const BenchConfig_t configs[] =
+{
+  {16, 0}, {64, 0}, {8, 12}, {16, 12}, {8, 24}
+};
+static volatile unsigned sink;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Creates fragmented items and measures them.
+
+\param[in] config - amount of items and partial writes per item.
+******************************************************************************/
+static void measure(const BenchConfig_t *config)
+{
+  uint8_t data[ITEM_LENGTH];
+  double start, readTime, lookupTime;
+  unsigned long flashReads;
+
+  sNvStubEraseFlash();
+  sNvStubReset();
+
+  for (unsigned i = 0U; i < config->itemsAmount; i++)
+  {
+    for (unsigned k = 0U; k < ITEM_LENGTH; k++)
+      data[k] = rand();
+    S_Nv_ItemInit(ITEM_ID(i), ITEM_LENGTH, data);
+  }
+  for (unsigned w = 0U; w < config->partialWrites; w++)
+    for (unsigned i = 0U; i < config->itemsAmount; i++)
+      S_Nv_Write(ITEM_ID(i), rand() % (ITEM_LENGTH - PARTIAL_LENGTH), PARTIAL_LENGTH, data);
+
+  sNvStubFlashReads = 0U;
+  start = hostTestNow();
+  for (unsigned r = 0U; r < READS_AMOUNT; r++)
+    sink = S_Nv_Read(ITEM_ID(r % config->itemsAmount), 0U, ITEM_LENGTH, data);
+  readTime = (hostTestNow() - start) / READS_AMOUNT;
+  flashReads = sNvStubFlashReads;
+
+  start = hostTestNow();
+  for (unsigned r = 0U; r < LOOKUPS_AMOUNT; r++)
+    sink = S_Nv_IsItemAvailable(ITEM_ID(r % (2U * config->itemsAmount)));
+  lookupTime = (hostTestNow() - start) / LOOKUPS_AMOUNT;
+
+  printf("items %3u, partial writes %2u: read %7.1f ns, %5.1f flash reads; lookup %5.1f ns\n",
+         config->itemsAmount, config->partialWrites, readTime, (double)flashReads / READS_AMOUNT,
+         lookupTime);
+}
+
+int main(void)
+{
+  srand(1);
+  for (unsigned i = 0U; i < sizeof(configs) / sizeof(configs[0]); i++)
+    measure(&configs[i]);
+
+  return 0;
+}
+
+/* eof sNvBench.c */
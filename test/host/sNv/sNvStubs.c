@@ -0,0 +1,227 @@
+/******************************************************************************
+  \file sNvStubs.c
+
+  \brief
+    Flash driver, timers and platform services emulated for the S_Nv host
+    tests. Flash sectors are kept in RAM: programming only clears bits, erase
+    sets them. Timers never expire by themselves, they are fired by the test.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <N_Types.h>
+#include <N_ErrH.h>
+#include <N_Log.h>
+#include <D_Nv_Bindings.h>
+#include <D_Nv.h>
+#include <S_Nv_Init.h>
+#include <sysTimer.h>
+#include <appTimer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define COMPID "sNvStubs"
+#define MAX_PENDING_TIMERS_AMOUNT 4
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  void *timer;
+  void (*callback)(void);
+  /* NULL for HAL application timers */
+  SYS_Timer_t *sysTimer;
+} PendingTimer_t;
+
+/******************************************************************************
+                    Global variables section
+******************************************************************************/
+/* Amount of D_Nv_Read() calls */
+unsigned long sNvStubFlashReads;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static uint8_t flash[D_NV_FIRST_SECTOR + D_NV_SECTOR_COUNT][D_NV_SECTOR_SIZE];
+static PendingTimer_t pendingTimers[MAX_PENDING_TIMERS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+void D_Nv_Read(uint8_t sector, uint16_t offset, uint8_t *pBuffer, D_Nv_Size_t numberOfBytes)
+{
+  N_ERRH_ASSERT_FATAL(offset + numberOfBytes <= D_NV_SECTOR_SIZE);
+  sNvStubFlashReads++;
+  memcpy(pBuffer, &flash[sector][offset], numberOfBytes);
+}
+
+void D_Nv_Write(uint8_t sector, uint16_t offset, uint8_t *pBuffer, D_Nv_Size_t numberOfBytes)
+{
+  N_ERRH_ASSERT_FATAL(offset + numberOfBytes <= D_NV_SECTOR_SIZE);
+  for (D_Nv_Size_t i = 0U; i < numberOfBytes; i++)
+    flash[sector][offset + i] &= pBuffer[i];
+}
+
+void D_Nv_EraseSector(uint8_t sector)
+{
+  memset(flash[sector], 0xFF, D_NV_SECTOR_SIZE);
+}
+
+bool D_Nv_IsEmpty(uint8_t sector, uint16_t offset, D_Nv_Size_t numberOfBytes)
+{
+  for (D_Nv_Size_t i = 0U; i < numberOfBytes; i++)
+    if (0xFF != flash[sector][offset + i])
+      return false;
+  return true;
+}
+
+bool D_Nv_IsEqual(uint8_t sector, uint16_t offset, uint8_t *pBuffer, D_Nv_Size_t numberOfBytes)
+{
+  return !memcmp(&flash[sector][offset], pBuffer, numberOfBytes);
+}
+
+/******************************************************************************
+\brief Adds the timer to the pending ones, restarted timer keeps its place.
+******************************************************************************/
+static void startTimer(void *timer, SYS_Timer_t *sysTimer, void (*callback)(void))
+{
+  PendingTimer_t *free = NULL;
+
+  for (unsigned i = 0U; i < MAX_PENDING_TIMERS_AMOUNT; i++)
+  {
+    if (pendingTimers[i].timer == timer)
+    {
+      pendingTimers[i].callback = callback;
+      pendingTimers[i].sysTimer = sysTimer;
+      return;
+    }
+    if (!pendingTimers[i].timer && !free)
+      free = &pendingTimers[i];
+  }
+  N_ERRH_ASSERT_FATAL(free);
+  free->timer = timer;
+  free->callback = callback;
+  free->sysTimer = sysTimer;
+}
+
+static void stopTimer(void *timer)
+{
+  for (unsigned i = 0U; i < MAX_PENDING_TIMERS_AMOUNT; i++)
+    if (pendingTimers[i].timer == timer)
+      pendingTimers[i].timer = NULL;
+}
+
+int HAL_StartAppTimer(HAL_AppTimer_t *appTimer)
+{
+  startTimer(appTimer, NULL, appTimer->callback);
+  return 0;
+}
+
+int HAL_StopAppTimer(HAL_AppTimer_t *appTimer)
+{
+  stopTimer(appTimer);
+  return 0;
+}
+
+void SYS_InitTimer(SYS_Timer_t *const sysTimer, const TimerMode_t mode,
+                   const uint32_t interval, void (*handler)(void))
+{
+  (void)mode;
+  (void)interval;
+  sysTimer->state = SYS_TIMER_STARTED;
+  startTimer(sysTimer, sysTimer, handler);
+}
+
+void SYS_StopTimer(SYS_Timer_t *const sysTimer)
+{
+  sysTimer->state = SYS_TIMER_STOPPED;
+  stopTimer(sysTimer);
+}
+
+BcTime_t HAL_GetSystemTime(void)
+{
+  return 0U;
+}
+
+void N_ErrH_Fatal(const char *compId, uint16_t line)
+{
+  printf("S_Nv fatal error %s:%u\n", compId, line);
+  exit(1);
+}
+
+void N_Log_Prepare(const char *compId, N_Log_Level_t level, const char *func)
+{
+  (void)compId;
+  (void)level;
+  (void)func;
+}
+
+void N_Log_Trace(const char *format, ...)
+{
+  (void)format;
+}
+
+void PDS_EraseSecureItems(void)
+{
+}
+
+/******************************************************************************
+\brief Fires the pending timer started first.
+
+\return true if a timer has been fired, false if none was pending.
+******************************************************************************/
+bool sNvStubFireTimer(void)
+{
+  for (unsigned i = 0U; i < MAX_PENDING_TIMERS_AMOUNT; i++)
+  {
+    if (pendingTimers[i].timer)
+    {
+      void (*callback)(void) = pendingTimers[i].callback;
+
+      pendingTimers[i].timer = NULL;
+      if (pendingTimers[i].sysTimer)
+        pendingTimers[i].sysTimer->state = SYS_TIMER_STOPPED;
+      callback();
+      return true;
+    }
+  }
+  return false;
+}
+
+/******************************************************************************
+\brief Erases the flash.
+******************************************************************************/
+void sNvStubEraseFlash(void)
+{
+  memset(flash, 0xFF, sizeof(flash));
+}
+
+/******************************************************************************
+\brief Emulates a device reset: pending timers are lost, S_Nv loads the items
+  from the flash.
+******************************************************************************/
+void sNvStubReset(void)
+{
+  memset(pendingTimers, 0, sizeof(pendingTimers));
+  S_Nv_EarlyInit();
+  S_Nv_Init();
+}
+
+/* eof sNvStubs.c */
@@ -0,0 +1,262 @@
+/******************************************************************************
+  \file sNvTest.c
+
+  \brief
+    S_Nv test. Items of random length are created, written completely and
+    partially, resized, read by random ranges, deleted and erased in random
+    order. Background compaction timers fire in between and the device is
+    reset from time to time, also in the middle of a compaction, so S_Nv
+    reloads the items from the flash. Every result is compared with a RAM
+    model of the items.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <N_Types.h>
+#include <S_Nv_Bindings.h>
+#include <S_Nv.h>
+#include <S_Nv_Init.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define ITEMS_AMOUNT    32
+#define MAX_ITEM_LENGTH 120
+#define STEPS_AMOUNT    300000
+/* Item kept by S_Nv_EraseAll(false), see PERSISTENT_NV_ITEMS_APPLICATION */
+#define PERSISTENT_ITEM_ID 0x0FFFU
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  S_Nv_ItemId_t id;
+  bool exists;
+  uint16_t length;
+  uint8_t data[MAX_ITEM_LENGTH];
+} TestItem_t;
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+bool sNvStubFireTimer(void);
+void sNvStubEraseFlash(void);
+void sNvStubReset(void);
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static TestItem_t items[ITEMS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Picks distinct random item ids, lookups by id shall not depend on the
+  order of creation.
+******************************************************************************/
+static void initItemIds(void)
+{
+  items[0].id = PERSISTENT_ITEM_ID;
+  for (int i = 1; i < ITEMS_AMOUNT; i++)
+  {
+    bool used;
+
+    do
+    {
+      items[i].id = 1U + rand() % 0xEFFEU;
+      used = false;
+      for (int k = 0; k < i; k++)
+        used = used || items[k].id == items[i].id;
+    } while (used);
+  }
+}
+
+/******************************************************************************
+\brief Fills the buffer with random bytes.
+******************************************************************************/
+static void randomData(uint8_t *data, uint16_t length)
+{
+  for (uint16_t i = 0U; i < length; i++)
+    data[i] = rand();
+}
+
+/******************************************************************************
+\brief Checks a random range of the item and its availability.
+
+\param[in] item - item to check.
+******************************************************************************/
+static void checkItem(const TestItem_t *item)
+{
+  uint8_t data[MAX_ITEM_LENGTH];
+  uint16_t offset, length;
+
+  HOST_CHECK(S_Nv_IsItemAvailable(item->id) == item->exists);
+  if (!item->exists)
+  {
+    HOST_CHECK(S_Nv_ReturnValue_DoesNotExist == S_Nv_Read(item->id, 0U, 1U, data));
+    return;
+  }
+
+  HOST_CHECK(S_Nv_ItemLength(item->id) == item->length);
+  offset = rand() % (item->length + 1U);
+  length = rand() % (item->length - offset + 1U);
+  if (HOST_CHECK(S_Nv_ReturnValue_Ok == S_Nv_Read(item->id, offset, length, data)))
+    HOST_CHECK(!memcmp(data, &item->data[offset], length));
+  HOST_CHECK(S_Nv_ReturnValue_BeyondEnd == S_Nv_Read(item->id, offset, item->length - offset + 1U, data));
+}
+
+/******************************************************************************
+\brief Checks all items completely.
+******************************************************************************/
+static void checkAllItems(void)
+{
+  uint8_t data[MAX_ITEM_LENGTH];
+
+  for (int i = 0; i < ITEMS_AMOUNT; i++)
+  {
+    const TestItem_t *item = &items[i];
+
+    HOST_CHECK(S_Nv_IsItemAvailable(item->id) == item->exists);
+    if (item->exists)
+    {
+      HOST_CHECK(S_Nv_ItemLength(item->id) == item->length);
+      HOST_CHECK(S_Nv_ReturnValue_Ok == S_Nv_Read(item->id, 0U, item->length, data));
+      HOST_CHECK(!memcmp(data, item->data, item->length));
+    }
+  }
+}
+
+/******************************************************************************
+\brief Creates the item or initializes the existing one with another length.
+
+\param[in] item - item to initialize.
+******************************************************************************/
+static void initItem(TestItem_t *item)
+{
+  uint16_t length = 1U + rand() % MAX_ITEM_LENGTH;
+  uint8_t data[MAX_ITEM_LENGTH];
+
+  randomData(data, length);
+  if (!item->exists)
+  {
+    HOST_CHECK(S_Nv_ReturnValue_DidNotExist == S_Nv_ItemInit(item->id, length, data));
+    memcpy(item->data, data, length);
+  }
+  else
+  {
+    /* existing data is kept, the part of a grown item is not defined */
+    HOST_CHECK(S_Nv_ReturnValue_Ok == S_Nv_ItemInit(item->id, length, data));
+    HOST_CHECK(!memcmp(data, item->data, (length < item->length) ? length : item->length));
+    memcpy(item->data, data, length);
+  }
+  item->exists = true;
+  item->length = length;
+}
+
+/******************************************************************************
+\brief Writes the item completely or partially.
+
+\param[in] item - item to write.
+******************************************************************************/
+static void writeItem(TestItem_t *item)
+{
+  uint16_t offset = 0U;
+  uint16_t length = item->length;
+  uint8_t data[MAX_ITEM_LENGTH + 1U];
+
+  if (!item->exists)
+  {
+    HOST_CHECK(S_Nv_ReturnValue_DoesNotExist == S_Nv_Write(item->id, 0U, 1U, data));
+    return;
+  }
+
+  if (rand() % 2)
+  {
+    offset = rand() % item->length;
+    length = 1U + rand() % (item->length - offset);
+  }
+  randomData(data, item->length - offset + 1U);
+
+  HOST_CHECK(S_Nv_ReturnValue_BeyondEnd == S_Nv_Write(item->id, offset, item->length - offset + 1U, data));
+  HOST_CHECK(S_Nv_ReturnValue_Ok == S_Nv_Write(item->id, offset, length, data));
+  memcpy(&item->data[offset], data, length);
+}
+
+/******************************************************************************
+\brief Erases the items, the persistent one is kept if asked.
+
+\param[in] includingPersistentItems - true to erase the persistent item too.
+******************************************************************************/
+static void eraseAll(bool includingPersistentItems)
+{
+  HOST_CHECK(S_Nv_ReturnValue_Ok == S_Nv_EraseAll(includingPersistentItems));
+  /* complete erase clears the flash only, the device is reset after it */
+  if (includingPersistentItems)
+    sNvStubReset();
+  for (int i = 0; i < ITEMS_AMOUNT; i++)
+    if (includingPersistentItems || PERSISTENT_ITEM_ID != items[i].id)
+      items[i].exists = false;
+}
+
+int main(void)
+{
+  srand(23);
+  initItemIds();
+  sNvStubEraseFlash();
+  sNvStubReset();
+
+  for (int step = 0; step < STEPS_AMOUNT; step++)
+  {
+    TestItem_t *item = &items[rand() % ITEMS_AMOUNT];
+    int action = rand() % 1000;
+
+    if (action < 60)
+      initItem(item);
+    else if (action < 80)
+    {
+      if (item->exists)
+        HOST_CHECK(S_Nv_ReturnValue_Ok == S_Nv_Delete(item->id));
+      item->exists = false;
+    }
+    else if (action < 500)
+      writeItem(item);
+    else if (action < 800)
+      checkItem(item);
+    else if (action < 997)
+      sNvStubFireTimer();
+    else if (action < 999)
+    {
+      sNvStubReset();
+      checkAllItems();
+    }
+    else
+      eraseAll(rand() % 2);
+  }
+
+  while (sNvStubFireTimer())
+    ;
+  checkAllItems();
+  sNvStubReset();
+  checkAllItems();
+
+  return hostTestResult();
+}
+
+/* eof sNvTest.c */
@@ -0,0 +1,83 @@
+/******************************************************************************
+  \file sspAesBench.c
+
+  \brief
+    Software AES benchmark. Measures sspAesEncrypt() for blocks encrypted
+    with one key, with several keys in turn and with keys changed on every
+    block, so the key schedule is always expanded.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sspAesHandler.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define KEYS_AMOUNT 8
+#define ITERATIONS  1000000
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static uint8_t keys[KEYS_AMOUNT][SECURITY_KEY_SIZE];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Encrypts blocks with keys taken in turn.
+
+\param[in] keysAmount - amount of keys in use.
+
+\return time per block, ns.
+******************************************************************************/
+static double measure(int keysAmount)
+{
+  SspAesEncryptReq_t req;
+  uint8_t text[SECURITY_BLOCK_SIZE] = {0};
+  double start;
+
+  memset(&req, 0, sizeof(req));
+  req.text = text;
+  sspAesResetKeyCache();
+
+  start = hostTestNow();
+  for (int i = 0; i < ITERATIONS; i++)
+  {
+    req.key = keys[i % keysAmount];
+    sspAesEncrypt(&req);
+  }
+  return (hostTestNow() - start) / ITERATIONS;
+}
+
+int main(void)
+{
+  srand(1);
+  for (int i = 0; i < KEYS_AMOUNT; i++)
+    for (int k = 0; k < SECURITY_KEY_SIZE; k++)
+      keys[i][k] = rand();
+
+  printf("one key:    %.1f ns\n", measure(1));
+  printf("three keys: %.1f ns\n", measure(3));
+  printf("eight keys: %.1f ns\n", measure(KEYS_AMOUNT));
+
+  return 0;
+}
+
+/* eof sspAesBench.c */
@@ -0,0 +1,39 @@
+/******************************************************************************
+  \file sspAesStubs.c
+
+  \brief
+    Security Service Provider services emulated for the software AES host
+    tests.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sspMem.h>
+#include <sspManager.h>
+
+/******************************************************************************
+                    Global variables section
+******************************************************************************/
+SspMem_t sspMem;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+void sspPostTask(SspTaskId_t taskID)
+{
+  (void)taskID;
+}
+
+/* eof sspAesStubs.c */
@@ -0,0 +1,244 @@
+/******************************************************************************
+  \file sspAesTest.c
+
+  \brief
+    Software AES test. Checks the FIPS-197 vectors, then compares random
+    blocks encrypted with random keys against a straightforward reference
+    implementation. Keys are interleaved to hit and miss the key schedule
+    cache, changed in place between requests and the cache is reset on the
+    way.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sspAesHandler.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define KEYS_AMOUNT 8
+#define ITERATIONS  500000
+#define AES_ROUNDS  10
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  uint8_t key[SECURITY_KEY_SIZE];
+  uint8_t plainText[SECURITY_BLOCK_SIZE];
+  uint8_t cipherText[SECURITY_BLOCK_SIZE];
+} AesVector_t;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+/* FIPS-197 Appendix B and Appendix C.1 */
+static const AesVector_t vectors[] =
+{
+  {
+    {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c},
+    {0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34},
+    {0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb, 0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32}
+  },
+  {
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f},
+    {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff},
+    {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a}
+  }
+};
+
+static uint8_t refSbox[256];
+static uint8_t keys[KEYS_AMOUNT][SECURITY_KEY_SIZE];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Multiplies two elements of GF(2^8).
+******************************************************************************/
+static uint8_t refMultiply(uint8_t a, uint8_t b)
+{
+  uint8_t product = 0U;
+
+  while (b)
+  {
+    if (b & 1U)
+      product ^= a;
+    a = (a << 1) ^ ((a & 0x80U) ? 0x1bU : 0x00U);
+    b >>= 1;
+  }
+  return product;
+}
+
+/******************************************************************************
+\brief Computes the S-box from its definition: multiplicative inverse
+  followed by the affine transformation.
+******************************************************************************/
+static void refInitSbox(void)
+{
+  for (unsigned x = 0U; x < 256U; x++)
+  {
+    uint8_t inverse = 0U;
+    uint8_t s;
+
+    for (unsigned y = 1U; y < 256U && x; y++)
+      if (1U == refMultiply(x, y))
+        inverse = y;
+
+    s = inverse;
+    for (unsigned i = 1U; i < 5U; i++)
+      s ^= (uint8_t)((inverse << i) | (inverse >> (8U - i)));
+    refSbox[x] = s ^ 0x63U;
+  }
+}
+
+/******************************************************************************
+\brief Encrypts a block the way FIPS-197 describes it.
+
+\param[in] key - AES-128 key.
+\param[in, out] state - block to encrypt.
+******************************************************************************/
+static void refEncrypt(const uint8_t *key, uint8_t *state)
+{
+  uint8_t roundKeys[(AES_ROUNDS + 1) * SECURITY_KEY_SIZE];
+  uint8_t rcon = 1U;
+
+  memcpy(roundKeys, key, SECURITY_KEY_SIZE);
+  for (unsigned i = SECURITY_KEY_SIZE; i < sizeof(roundKeys); i += 4U)
+  {
+    uint8_t t[4];
+
+    memcpy(t, &roundKeys[i - 4U], sizeof(t));
+    if (0U == i % SECURITY_KEY_SIZE)
+    {
+      uint8_t first = t[0];
+
+      t[0] = refSbox[t[1]] ^ rcon;
+      t[1] = refSbox[t[2]];
+      t[2] = refSbox[t[3]];
+      t[3] = refSbox[first];
+      rcon = refMultiply(rcon, 2U);
+    }
+    for (unsigned k = 0U; k < 4U; k++)
+      roundKeys[i + k] = roundKeys[i + k - SECURITY_KEY_SIZE] ^ t[k];
+  }
+
+  for (unsigned k = 0U; k < SECURITY_BLOCK_SIZE; k++)
+    state[k] ^= roundKeys[k];
+
+  for (unsigned round = 1U; round <= AES_ROUNDS; round++)
+  {
+    uint8_t shifted[SECURITY_BLOCK_SIZE];
+
+    /* SubBytes and ShiftRows, byte k is row k % 4 of column k / 4 */
+    for (unsigned k = 0U; k < SECURITY_BLOCK_SIZE; k++)
+      shifted[k] = refSbox[state[(k + 4U * (k % 4U)) % SECURITY_BLOCK_SIZE]];
+
+    for (unsigned c = 0U; c < 4U; c++)
+    {
+      const uint8_t *s = &shifted[4U * c];
+
+      for (unsigned r = 0U; r < 4U; r++)
+      {
+        if (AES_ROUNDS == round)
+          state[4U * c + r] = s[r];
+        else
+          state[4U * c + r] = refMultiply(s[r], 2U) ^ refMultiply(s[(r + 1U) % 4U], 3U) ^
+                              s[(r + 2U) % 4U] ^ s[(r + 3U) % 4U];
+      }
+    }
+
+    for (unsigned k = 0U; k < SECURITY_BLOCK_SIZE; k++)
+      state[k] ^= roundKeys[round * SECURITY_KEY_SIZE + k];
+  }
+}
+
+/******************************************************************************
+\brief Encrypts a block with sspAesEncrypt().
+
+\param[in] key - AES-128 key.
+\param[in, out] text - block to encrypt.
+******************************************************************************/
+static void encrypt(uint8_t *key, uint8_t *text)
+{
+  SspAesEncryptReq_t req;
+
+  memset(&req, 0, sizeof(req));
+  req.key = key;
+  req.text = text;
+  sspAesEncrypt(&req);
+}
+
+int main(void)
+{
+  refInitSbox();
+
+  for (unsigned i = 0U; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+  {
+    uint8_t key[SECURITY_KEY_SIZE];
+    uint8_t text[SECURITY_BLOCK_SIZE];
+
+    memcpy(key, vectors[i].key, sizeof(key));
+    memcpy(text, vectors[i].plainText, sizeof(text));
+    refEncrypt(key, text);
+    HOST_REQUIRE(!memcmp(text, vectors[i].cipherText, sizeof(text)));
+
+    memcpy(text, vectors[i].plainText, sizeof(text));
+    encrypt(key, text);
+    HOST_CHECK(!memcmp(text, vectors[i].cipherText, sizeof(text)));
+  }
+
+  srand(21);
+  for (int i = 0; i < KEYS_AMOUNT; i++)
+    for (int k = 0; k < SECURITY_KEY_SIZE; k++)
+      keys[i][k] = rand();
+
+  for (int iteration = 0; iteration < ITERATIONS; iteration++)
+  {
+    /* mostly few keys in turn, sometimes all of them */
+    uint8_t *key = keys[rand() % ((rand() % 4) ? 2 : KEYS_AMOUNT)];
+    uint8_t text[SECURITY_BLOCK_SIZE];
+    uint8_t expected[SECURITY_BLOCK_SIZE];
+
+    switch (rand() % 1000)
+    {
+      case 0:
+        /* key changed in place shall not be served with the old schedule */
+        key[rand() % SECURITY_KEY_SIZE] ^= 1U << (rand() % 8);
+        break;
+
+      case 1:
+        sspAesResetKeyCache();
+        break;
+
+      default:
+        break;
+    }
+
+    for (int k = 0; k < SECURITY_BLOCK_SIZE; k++)
+      text[k] = expected[k] = rand();
+    refEncrypt(key, expected);
+    encrypt(key, text);
+    HOST_CHECK(!memcmp(text, expected, sizeof(text)));
+  }
+
+  return hostTestResult();
+}
+
+/* eof sspAesTest.c */
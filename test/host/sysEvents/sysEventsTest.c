@@ -0,0 +1,369 @@
+/******************************************************************************
+  \file sysEventsTest.c
+
+  \brief
+    System events test. Receivers subscribe to and unsubscribe from events in
+    random order, posted events are compared with a model: every subscriber
+    is called exactly once, in order of subscribing. Receivers subscribe,
+    unsubscribe themselves and other receivers and post events from their
+    callbacks during delivery. Built with the default and with a small number
+    of subscriptions, so events are also delivered by checking all receivers.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sysEvents.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define RECEIVERS_AMOUNT 30
+#define EVENTS_AMOUNT    8
+#define STEPS_AMOUNT     200000
+#define LOG_SIZE         256
+
+#define RECEIVER(n) \
+  static void received##n(SYS_EventId_t id, SYS_EventData_t data) { received(n, id, data); }
+#define RECEIVERS_10(d) \
+  RECEIVER(d##0) RECEIVER(d##1) RECEIVER(d##2) RECEIVER(d##3) RECEIVER(d##4) \
+  RECEIVER(d##5) RECEIVER(d##6) RECEIVER(d##7) RECEIVER(d##8) RECEIVER(d##9)
+#define CALLBACKS_10(d) \
+  received##d##0, received##d##1, received##d##2, received##d##3, received##d##4, \
+  received##d##5, received##d##6, received##d##7, received##d##8, received##d##9
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  uint8_t receiver;
+  SYS_EventId_t id;
+  SYS_EventData_t data;
+} Delivery_t;
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+static void received(uint8_t receiver, SYS_EventId_t id, SYS_EventData_t data);
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static SYS_EventReceiver_t receivers[RECEIVERS_AMOUNT];
+static Delivery_t deliveries[LOG_SIZE];
+static unsigned deliveriesAmount;
+/* Action performed by the callback, if any */
+static void (*onDelivery)(uint8_t receiver, SYS_EventId_t id);
+
+/* Model: subscribers of each event in order of subscribing */
+static uint8_t subscribers[EVENTS_AMOUNT][RECEIVERS_AMOUNT];
+static uint8_t subscribersAmount[EVENTS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+RECEIVERS_10()
+RECEIVERS_10(1)
+RECEIVERS_10(2)
+
+static void (* const callbacks[RECEIVERS_AMOUNT])(SYS_EventId_t id, SYS_EventData_t data) =
+{
+  CALLBACKS_10(), CALLBACKS_10(1), CALLBACKS_10(2)
+};
+
+/******************************************************************************
+\brief Common part of the receiver callbacks.
+******************************************************************************/
+static void received(uint8_t receiver, SYS_EventId_t id, SYS_EventData_t data)
+{
+  if (deliveriesAmount < LOG_SIZE)
+  {
+    deliveries[deliveriesAmount].receiver = receiver;
+    deliveries[deliveriesAmount].id = id;
+    deliveries[deliveriesAmount].data = data;
+  }
+  deliveriesAmount++;
+
+  if (onDelivery)
+    onDelivery(receiver, id);
+}
+
+/******************************************************************************
+\brief Checks the deliveries logged since the log was cleared.
+
+\param[in] id - ID of the expected events.
+\param[in] expected - receivers in expected order of calls.
+\param[in] amount - number of the expected calls.
+******************************************************************************/
+static void checkDeliveries(SYS_EventId_t id, const uint8_t *expected, unsigned amount)
+{
+  HOST_CHECK(deliveriesAmount == amount);
+  for (unsigned i = 0; i < amount && i < deliveriesAmount; i++)
+  {
+    HOST_CHECK(deliveries[i].receiver == expected[i]);
+    HOST_CHECK(deliveries[i].id == id);
+  }
+  deliveriesAmount = 0;
+}
+
+/******************************************************************************
+\brief Model operations.
+******************************************************************************/
+static void modelSubscribe(SYS_EventId_t id, uint8_t receiver)
+{
+  for (unsigned i = 0; i < subscribersAmount[id]; i++)
+  {
+    if (subscribers[id][i] == receiver)
+      return;
+  }
+  subscribers[id][subscribersAmount[id]++] = receiver;
+}
+
+static void modelUnsubscribe(SYS_EventId_t id, uint8_t receiver)
+{
+  for (unsigned i = 0; i < subscribersAmount[id]; i++)
+  {
+    if (subscribers[id][i] == receiver)
+    {
+      memmove(&subscribers[id][i], &subscribers[id][i + 1], subscribersAmount[id] - i - 1);
+      subscribersAmount[id]--;
+      return;
+    }
+  }
+}
+
+/******************************************************************************
+\brief Subscribes and unsubscribes receivers in random order. Delivered events
+must reach every subscriber once, in order of subscribing unless the event is
+delivered by checking all receivers.
+******************************************************************************/
+static void testRandom(void)
+{
+  for (int step = 0; step < STEPS_AMOUNT; step++)
+  {
+    SYS_EventId_t id = rand() % EVENTS_AMOUNT;
+    uint8_t receiver = rand() % RECEIVERS_AMOUNT;
+
+    switch (rand() % 4)
+    {
+      case 0:
+        SYS_SubscribeToEvent(id, &receivers[receiver]);
+        modelSubscribe(id, receiver);
+        break;
+
+      case 1:
+        SYS_UnsubscribeFromEvent(id, &receivers[receiver]);
+        modelUnsubscribe(id, receiver);
+        break;
+
+      case 2:
+        HOST_CHECK(SYS_IsEventSubscriber(id, &receivers[receiver]) ==
+                   (NULL != memchr(subscribers[id], receiver, subscribersAmount[id])));
+        HOST_CHECK(SYS_IsEventDeliverable(id) == (0 != subscribersAmount[id]));
+        break;
+
+      default:
+      {
+        bool seen[RECEIVERS_AMOUNT] = {false};
+        bool ordered = true;
+
+        deliveriesAmount = 0;
+        SYS_PostEvent(id, step);
+        HOST_CHECK(deliveriesAmount == subscribersAmount[id]);
+        for (unsigned i = 0; i < deliveriesAmount && i < LOG_SIZE; i++)
+        {
+          HOST_CHECK(NULL != memchr(subscribers[id], deliveries[i].receiver, subscribersAmount[id]));
+          HOST_CHECK(!seen[deliveries[i].receiver]);
+          HOST_CHECK(deliveries[i].data == (SYS_EventData_t)step);
+          seen[deliveries[i].receiver] = true;
+          ordered = ordered && (deliveries[i].receiver == subscribers[id][i]);
+        }
+#if SYS_MAX_EVENT_SUBSCRIPTIONS >= EVENTS_AMOUNT * RECEIVERS_AMOUNT
+        HOST_CHECK(ordered);
+#else
+        (void)ordered;
+#endif
+        break;
+      }
+    }
+  }
+
+  // Leave all receivers idle
+  for (SYS_EventId_t id = 0; id < EVENTS_AMOUNT; id++)
+  {
+    while (subscribersAmount[id])
+    {
+      SYS_UnsubscribeFromEvent(id, &receivers[subscribers[id][0]]);
+      modelUnsubscribe(id, subscribers[id][0]);
+    }
+    HOST_CHECK(!SYS_IsEventDeliverable(id));
+  }
+  deliveriesAmount = 0;
+}
+
+/******************************************************************************
+\brief Receiver 1 unsubscribes itself and receiver 3, receiver 2 unsubscribes
+receiver 0 which has been already called.
+******************************************************************************/
+static void unsubscribeOnDelivery(uint8_t receiver, SYS_EventId_t id)
+{
+  if (1 == receiver)
+  {
+    SYS_UnsubscribeFromEvent(id, &receivers[1]);
+    SYS_UnsubscribeFromEvent(id, &receivers[3]);
+  }
+  else if (2 == receiver)
+    SYS_UnsubscribeFromEvent(id, &receivers[0]);
+}
+
+static void testUnsubscribeDuringDelivery(void)
+{
+  static const uint8_t first[] = {0, 1, 2, 4};
+  static const uint8_t second[] = {2, 4};
+
+  for (uint8_t i = 0; i < 5; i++)
+    SYS_SubscribeToEvent(0, &receivers[i]);
+
+  onDelivery = unsubscribeOnDelivery;
+  SYS_PostEvent(0, 0);
+  checkDeliveries(0, first, sizeof(first));
+  SYS_PostEvent(0, 0);
+  checkDeliveries(0, second, sizeof(second));
+  onDelivery = NULL;
+
+  // Unsubscribed receivers may subscribe again
+  SYS_SubscribeToEvent(0, &receivers[1]);
+  SYS_SubscribeToEvent(0, &receivers[0]);
+  {
+    static const uint8_t third[] = {2, 4, 1, 0};
+
+    SYS_PostEvent(0, 0);
+    checkDeliveries(0, third, sizeof(third));
+  }
+
+  for (uint8_t i = 0; i < 5; i++)
+    SYS_UnsubscribeFromEvent(0, &receivers[i]);
+  SYS_PostEvent(0, 0);
+  checkDeliveries(0, NULL, 0);
+}
+
+/******************************************************************************
+\brief Receiver 0 unsubscribes from the event and subscribes again, receiver 1
+subscribes receiver 3 to the event being delivered.
+******************************************************************************/
+static void resubscribeOnDelivery(uint8_t receiver, SYS_EventId_t id)
+{
+  if (0 == receiver)
+  {
+    SYS_UnsubscribeFromEvent(id, &receivers[0]);
+    SYS_SubscribeToEvent(id, &receivers[0]);
+  }
+  else if (1 == receiver)
+    SYS_SubscribeToEvent(id, &receivers[3]);
+}
+
+static void testResubscribeDuringDelivery(void)
+{
+  static const uint8_t first[] = {0, 1, 2, 3};
+
+  SYS_SubscribeToEvent(1, &receivers[0]);
+  SYS_SubscribeToEvent(1, &receivers[1]);
+  SYS_SubscribeToEvent(1, &receivers[2]);
+
+  onDelivery = resubscribeOnDelivery;
+  SYS_PostEvent(1, 0);
+  checkDeliveries(1, first, sizeof(first));
+  onDelivery = NULL;
+
+  // Receiver 0 is delivered to once
+  SYS_PostEvent(1, 0);
+  checkDeliveries(1, first, sizeof(first));
+
+  for (uint8_t i = 0; i < 4; i++)
+    SYS_UnsubscribeFromEvent(1, &receivers[i]);
+  HOST_CHECK(!SYS_IsEventDeliverable(1));
+}
+
+/******************************************************************************
+\brief Receiver 1 posts event 3 while event 2 is being delivered, receiver 4 of
+event 3 unsubscribes receiver 2 from event 2.
+******************************************************************************/
+static void postOnDelivery(uint8_t receiver, SYS_EventId_t id)
+{
+  if (2 == id && 1 == receiver)
+    SYS_PostEvent(3, 0);
+  else if (3 == id && 4 == receiver)
+    SYS_UnsubscribeFromEvent(2, &receivers[2]);
+}
+
+static void testPostDuringDelivery(void)
+{
+  SYS_SubscribeToEvent(2, &receivers[0]);
+  SYS_SubscribeToEvent(2, &receivers[1]);
+  SYS_SubscribeToEvent(2, &receivers[2]);
+  SYS_SubscribeToEvent(2, &receivers[3]);
+  SYS_SubscribeToEvent(3, &receivers[4]);
+  SYS_SubscribeToEvent(3, &receivers[2]);
+
+  onDelivery = postOnDelivery;
+  SYS_PostEvent(2, 0);
+  onDelivery = NULL;
+
+  // Nested event is delivered completely before the outer one goes on
+  HOST_CHECK(5 == deliveriesAmount);
+  HOST_CHECK(0 == deliveries[0].receiver && 2 == deliveries[0].id);
+  HOST_CHECK(1 == deliveries[1].receiver && 2 == deliveries[1].id);
+  HOST_CHECK(4 == deliveries[2].receiver && 3 == deliveries[2].id);
+  HOST_CHECK(2 == deliveries[3].receiver && 3 == deliveries[3].id);
+  HOST_CHECK(3 == deliveries[4].receiver && 2 == deliveries[4].id);
+  deliveriesAmount = 0;
+
+  HOST_CHECK(!SYS_IsEventSubscriber(2, &receivers[2]));
+  HOST_CHECK(SYS_IsEventSubscriber(3, &receivers[2]));
+  {
+    static const uint8_t expected[] = {0, 1, 3};
+
+    SYS_PostEvent(2, 0);
+    checkDeliveries(2, expected, sizeof(expected));
+  }
+
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    SYS_UnsubscribeFromEvent(2, &receivers[i]);
+    SYS_UnsubscribeFromEvent(3, &receivers[i]);
+  }
+}
+
+int main(void)
+{
+  srand(7);
+  for (unsigned i = 0; i < RECEIVERS_AMOUNT; i++)
+    receivers[i].func = callbacks[i];
+
+  testUnsubscribeDuringDelivery();
+  testResubscribeDuringDelivery();
+  testPostDuringDelivery();
+  testRandom();
+  // Subscriptions released by the random test are taken again
+  testUnsubscribeDuringDelivery();
+  testPostDuringDelivery();
+
+  return hostTestResult();
+}
+
+/* eof sysEventsTest.c */
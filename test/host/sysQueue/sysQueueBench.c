@@ -0,0 +1,103 @@
+/******************************************************************************
+  \file sysQueueBench.c
+
+  \brief
+    System queues benchmark. Measures removing a random element and putting
+    it back to the tail, and a FIFO put and get, for the singly linked queue
+    and for the linked queue with a tail pointer.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sysQueue.h>
+#include <hostTest.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define MAX_ELEMENTS_AMOUNT 1000
+#define ITERATIONS          200000
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static QueueElement_t elements[MAX_ELEMENTS_AMOUNT];
+static LinkedQueueElement_t linkedElements[MAX_ELEMENTS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+int main(void)
+{
+  static const int amounts[] = {10, 100, MAX_ELEMENTS_AMOUNT};
+
+  printf("elements   remove+put: queue / linked   fifo put+get: queue / linked\n");
+  for (unsigned k = 0U; k < sizeof(amounts) / sizeof(amounts[0]); k++)
+  {
+    int amount = amounts[k];
+    DECLARE_QUEUE(queue);
+    DECLARE_LINKED_QUEUE(linkedQueue);
+    double start, removePut, linkedRemovePut, fifo, linkedFifo;
+
+    for (int i = 0; i < amount; i++)
+    {
+      putQueueElem(&queue, &elements[i]);
+      putLinkedQueueElem(&linkedQueue, &linkedElements[i]);
+    }
+
+    srand(1);
+    start = hostTestNow();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+      QueueElement_t *element = &elements[rand() % amount];
+
+      deleteQueueElem(&queue, element);
+      putQueueElem(&queue, element);
+    }
+    removePut = (hostTestNow() - start) / ITERATIONS;
+
+    srand(1);
+    start = hostTestNow();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+      LinkedQueueElement_t *element = &linkedElements[rand() % amount];
+
+      deleteLinkedQueueElem(&linkedQueue, element);
+      putLinkedQueueElem(&linkedQueue, element);
+    }
+    linkedRemovePut = (hostTestNow() - start) / ITERATIONS;
+
+    start = hostTestNow();
+    for (int i = 0; i < ITERATIONS; i++)
+      putQueueElem(&queue, deleteHeadQueueElem(&queue));
+    fifo = (hostTestNow() - start) / ITERATIONS;
+
+    start = hostTestNow();
+    for (int i = 0; i < ITERATIONS; i++)
+      putLinkedQueueElem(&linkedQueue, deleteHeadLinkedQueueElem(&linkedQueue));
+    linkedFifo = (hostTestNow() - start) / ITERATIONS;
+
+    printf("%8d   %10.1f / %6.1f ns   %12.1f / %6.1f ns\n", amount,
+           removePut, linkedRemovePut, fifo, linkedFifo);
+
+    /* owner tags of the elements are released for the next queue */
+    resetLinkedQueue(&linkedQueue);
+  }
+
+  return 0;
+}
+
+/* eof sysQueueBench.c */
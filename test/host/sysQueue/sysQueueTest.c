@@ -0,0 +1,255 @@
+/******************************************************************************
+  \file sysQueueTest.c
+
+  \brief
+    System queues test. Elements are put to the tail and to the head, removed
+    from the head and from the middle of several queues in random order,
+    queues are reset. Queue contents, membership of every element and
+    return values are compared with a model after each operation, both for
+    the singly linked queue and for the linked queue.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sysQueue.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define QUEUES_AMOUNT   3
+#define ELEMENTS_AMOUNT 64
+#define STEPS_AMOUNT    300000
+#define NO_QUEUE        (-1)
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  QueueElement_t next;
+  int id;
+} Element_t;
+
+typedef struct
+{
+  LinkedQueueElement_t next;
+  int id;
+} LinkedElement_t;
+
+/* Model of a queue: identifiers of the elements from the head */
+typedef struct
+{
+  int ids[ELEMENTS_AMOUNT];
+  int amount;
+} QueueModel_t;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static QueueDescriptor_t queues[QUEUES_AMOUNT];
+static Element_t elements[ELEMENTS_AMOUNT];
+static LinkedQueueDescriptor_t linkedQueues[QUEUES_AMOUNT];
+static LinkedElement_t linkedElements[ELEMENTS_AMOUNT];
+
+static QueueModel_t models[QUEUES_AMOUNT];
+/* Model: queue the element belongs to */
+static int owners[ELEMENTS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Model operations.
+******************************************************************************/
+static void modelPut(int queue, int id, bool toHead)
+{
+  QueueModel_t *model = &models[queue];
+
+  if (toHead)
+  {
+    memmove(&model->ids[1], &model->ids[0], model->amount * sizeof(int));
+    model->ids[0] = id;
+  }
+  else
+    model->ids[model->amount] = id;
+  model->amount++;
+  owners[id] = queue;
+}
+
+static void modelRemove(int queue, int id)
+{
+  QueueModel_t *model = &models[queue];
+  int i = 0;
+
+  while (model->ids[i] != id)
+    i++;
+  model->amount--;
+  memmove(&model->ids[i], &model->ids[i + 1], (model->amount - i) * sizeof(int));
+  owners[id] = NO_QUEUE;
+}
+
+static void modelReset(int queue)
+{
+  for (int i = 0; i < models[queue].amount; i++)
+    owners[models[queue].ids[i]] = NO_QUEUE;
+  models[queue].amount = 0;
+}
+
+/******************************************************************************
+\brief Checks the queues against the model.
+
+\param[in] linked - true to check the linked queues, false - the singly
+                    linked ones.
+******************************************************************************/
+static void checkQueues(bool linked)
+{
+  for (int queue = 0; queue < QUEUES_AMOUNT; queue++)
+  {
+    const QueueModel_t *model = &models[queue];
+    int amount = 0;
+
+    if (linked)
+    {
+      const LinkedElement_t *last = NULL;
+
+      for (const LinkedElement_t *it = getLinkedQueueElem(&linkedQueues[queue]); it;
+           it = getNextLinkedQueueElem(it))
+      {
+        if (!HOST_CHECK(amount < model->amount && it->id == model->ids[amount]))
+          break;
+        HOST_CHECK(last ? it->next.prev == &last->next : !it->next.prev);
+        last = it;
+        amount++;
+      }
+      HOST_CHECK(linkedQueues[queue].tail == (last ? &last->next : NULL));
+    }
+    else
+    {
+      for (const Element_t *it = getQueueElem(&queues[queue]); it; it = getNextQueueElem(it))
+      {
+        if (!HOST_CHECK(amount < model->amount && it->id == model->ids[amount]))
+          break;
+        amount++;
+      }
+    }
+    HOST_CHECK(amount == model->amount);
+  }
+
+  for (int id = 0; id < ELEMENTS_AMOUNT; id++)
+  {
+    for (int queue = 0; queue < QUEUES_AMOUNT; queue++)
+    {
+      bool member = linked ? isLinkedQueueElem(&linkedQueues[queue], &linkedElements[id]) :
+                             isQueueElem(&queues[queue], &elements[id]);
+      HOST_CHECK(member == (owners[id] == queue));
+    }
+  }
+}
+
+/******************************************************************************
+\brief Runs random operations on the queues.
+
+\param[in] linked - true to run the linked queues, false - the singly linked
+                    ones.
+******************************************************************************/
+static void runQueues(bool linked)
+{
+  memset(models, 0, sizeof(models));
+  for (int id = 0; id < ELEMENTS_AMOUNT; id++)
+  {
+    owners[id] = NO_QUEUE;
+    elements[id].id = id;
+    linkedElements[id].id = id;
+  }
+  for (int queue = 0; queue < QUEUES_AMOUNT; queue++)
+  {
+    resetQueue(&queues[queue]);
+    resetLinkedQueue(&linkedQueues[queue]);
+  }
+
+  for (int step = 0; step < STEPS_AMOUNT; step++)
+  {
+    int queue = rand() % QUEUES_AMOUNT;
+    int id = rand() % ELEMENTS_AMOUNT;
+    void *element = linked ? (void *)&linkedElements[id] : (void *)&elements[id];
+    const void *removed;
+
+    switch (rand() % 8)
+    {
+      case 0:
+      case 1:
+        /* an element is put to one queue at a time */
+        if (NO_QUEUE != owners[id])
+          break;
+        HOST_CHECK(linked ? putLinkedQueueElem(&linkedQueues[queue], element) :
+                            putQueueElem(&queues[queue], element));
+        modelPut(queue, id, false);
+        break;
+
+      case 2:
+        if (!linked || NO_QUEUE != owners[id])
+          break;
+        HOST_CHECK(putHeadLinkedQueueElem(&linkedQueues[queue], element));
+        modelPut(queue, id, true);
+        break;
+
+      case 3:
+      case 4:
+        removed = linked ? deleteHeadLinkedQueueElem(&linkedQueues[queue]) :
+                           deleteHeadQueueElem(&queues[queue]);
+        if (models[queue].amount)
+        {
+          id = models[queue].ids[0];
+          HOST_CHECK(removed == (linked ? (void *)&linkedElements[id] : (void *)&elements[id]));
+          modelRemove(queue, id);
+        }
+        else
+          HOST_CHECK(NULL == removed);
+        break;
+
+      case 5:
+      case 6:
+        HOST_CHECK((linked ? deleteLinkedQueueElem(&linkedQueues[queue], element) :
+                             deleteQueueElem(&queues[queue], element)) == (owners[id] == queue));
+        if (owners[id] == queue)
+          modelRemove(queue, id);
+        break;
+
+      default:
+        if (rand() % 16)
+          break;
+        if (linked)
+          resetLinkedQueue(&linkedQueues[queue]);
+        else
+          resetQueue(&queues[queue]);
+        modelReset(queue);
+        break;
+    }
+    checkQueues(linked);
+  }
+}
+
+int main(void)
+{
+  srand(5);
+  runQueues(false);
+  runQueues(true);
+  return hostTestResult();
+}
+
+/* eof sysQueueTest.c */
@@ -0,0 +1,74 @@
+/******************************************************************************
+  \file sysTaskManagerStubs.c
+
+  \brief
+    HAL and system services emulated for the task manager host tests.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+                    Global variables section
+******************************************************************************/
+/* Emulated microsecond clock */
+uint32_t sysTaskManagerStubTimeUs;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+uint32_t HAL_GetSystemTimeUs(void)
+{
+  return sysTaskManagerStubTimeUs;
+}
+
+void HAL_Init(void)
+{
+}
+
+bool RF_Init(void)
+{
+  return true;
+}
+
+void SYS_PostEvent(uint8_t eventId, uintptr_t data)
+{
+  (void)eventId;
+  (void)data;
+}
+
+void SYS_IdleHandler(void)
+{
+}
+
+void MAC_PHY_HWD_ForceTaskHandler(void)
+{
+}
+
+void MAC_HWI_ForceTaskHandler(void)
+{
+}
+
+void halStartAtomic(void)
+{
+}
+
+void halEndAtomic(void)
+{
+}
+
+/* eof sysTaskManagerStubs.c */
@@ -0,0 +1,277 @@
+/******************************************************************************
+  \file sysTaskManagerTest.c
+
+  \brief
+    Task manager test. Tasks are posted with different priority levels and
+    dispatched one per call: tasks of a higher level run first, tasks of a
+    level run in order of their IDs, tasks posted by a running handler and
+    bits without a task handler do not starve lower levels. Task statistics
+    are checked against the emulated clock.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <sysTaskManager.h>
+#include <hostTest.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define TASKS_AMOUNT   14
+#define LOG_SIZE       64
+#define ALL_TASK_IDS   ((uint16_t)((1U << TASKS_AMOUNT) - 1U))
+/* Bits of SYS_taskFlag without a task handler */
+#define STRAY_TASK_IDS ((uint16_t)~ALL_TASK_IDS)
+
+/******************************************************************************
+                    External variables section
+******************************************************************************/
+extern uint32_t sysTaskManagerStubTimeUs;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+/* IDs of the task handlers in order of calls */
+static uint16_t runLog[LOG_SIZE];
+static unsigned runAmount;
+/* Tasks posted by the handler of the task with the index, if any */
+static uint16_t postOnRun[TASKS_AMOUNT];
+/* Emulated duration of the handler of the task with the index, us */
+static uint32_t runTime[TASKS_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Common part of the task handlers.
+******************************************************************************/
+static void taskRun(uint8_t index)
+{
+  uint16_t tasks = postOnRun[index];
+
+  if (runAmount < LOG_SIZE)
+    runLog[runAmount] = 1U << index;
+  runAmount++;
+  sysTaskManagerStubTimeUs += runTime[index];
+
+  postOnRun[index] = 0;
+  while (tasks)
+  {
+    SYS_PostTask((SYS_TaskId_t)(tasks & -tasks));
+    tasks &= tasks - 1U;
+  }
+}
+
+void MAC_PHY_HWD_TaskHandler(void) { taskRun(0); }
+void HAL_TaskHandler(void)         { taskRun(1); }
+void MAC_HWI_TaskHandler(void)     { taskRun(2); }
+void NWK_TaskHandler(void)         { taskRun(3); }
+void ZDO_TaskHandler(void)         { taskRun(4); }
+void APS_TaskHandler(void)         { taskRun(5); }
+void SSP_TaskHandler(void)         { taskRun(6); }
+void TC_TaskHandler(void)          { taskRun(7); }
+void BSP_TaskHandler(void)         { taskRun(8); }
+void ZSI_TaskHandler(void)         { taskRun(9); }
+void ZCL_TaskHandler(void)         { taskRun(10); }
+void ZLL_TaskHandler(void)         { taskRun(11); }
+void APL_TaskHandler(void)         { taskRun(12); }
+void PDS_TaskHandler(void)         { taskRun(13); }
+
+/******************************************************************************
+\brief Brings the task manager and the log to the initial state.
+******************************************************************************/
+static void reset(void)
+{
+  SYS_taskFlag = 0;
+  SYS_taskMask = 0xFFFF;
+  SYS_SetTaskPriority(0xFFFF, SYS_TASK_PRIORITY_NORMAL);
+  memset(postOnRun, 0, sizeof(postOnRun));
+  memset(runTime, 0, sizeof(runTime));
+  runAmount = 0;
+}
+
+/******************************************************************************
+\brief Dispatches tasks until nothing is pending and checks the order of calls.
+
+\param[in] expected - IDs of the tasks in expected order of calls.
+\param[in] amount - number of the expected calls.
+******************************************************************************/
+static void runAndCheck(const uint16_t *expected, unsigned amount)
+{
+  runAmount = 0;
+  for (unsigned i = 0; i < 2 * LOG_SIZE && (SYS_taskFlag & SYS_taskMask & ALL_TASK_IDS); i++)
+    SYS_ForceRunTask();
+
+  HOST_CHECK(runAmount == amount);
+  for (unsigned i = 0; i < amount && i < runAmount; i++)
+    HOST_CHECK(runLog[i] == expected[i]);
+}
+
+/******************************************************************************
+\brief Tasks of a level are run in order of their IDs, one task per call.
+******************************************************************************/
+static void testIdOrder(void)
+{
+  static const uint16_t expected[] =
+    {HAL_TASK_ID, NWK_TASK_ID, APS_TASK_ID, ZCL_TASK_ID, APL_TASK_ID, PDS_TASK_ID};
+
+  reset();
+  SYS_PostTask(PDS_TASK_ID);
+  SYS_PostTask(APL_TASK_ID);
+  SYS_PostTask(NWK_TASK_ID);
+  SYS_PostTask(ZCL_TASK_ID);
+  SYS_PostTask(HAL_TASK_ID);
+  SYS_PostTask(APS_TASK_ID);
+
+  SYS_ForceRunTask();
+  HOST_CHECK(1 == runAmount);
+  HOST_CHECK(SYS_taskFlag == (NWK_TASK_ID | APS_TASK_ID | ZCL_TASK_ID | APL_TASK_ID | PDS_TASK_ID));
+
+  SYS_PostTask(HAL_TASK_ID);
+  runAndCheck(expected, sizeof(expected) / sizeof(expected[0]));
+  HOST_CHECK(0 == SYS_taskFlag);
+}
+
+/******************************************************************************
+\brief Tasks of a higher level are run first, disabled tasks are skipped.
+******************************************************************************/
+static void testPriorityOrder(void)
+{
+  static const uint16_t expected[] =
+    {APL_TASK_ID, PDS_TASK_ID, MAC_HWI_TASK_ID, NWK_TASK_ID, HAL_TASK_ID, ZDO_TASK_ID};
+
+  reset();
+  SYS_SetTaskPriority(APL_TASK_ID | PDS_TASK_ID, SYS_TASK_PRIORITY_HIGH);
+  SYS_SetTaskPriority(HAL_TASK_ID | ZDO_TASK_ID, SYS_TASK_PRIORITY_LOW);
+  SYS_PostTask(ZDO_TASK_ID);
+  SYS_PostTask(NWK_TASK_ID);
+  SYS_PostTask(HAL_TASK_ID);
+  SYS_PostTask(PDS_TASK_ID);
+  SYS_PostTask(MAC_HWI_TASK_ID);
+  SYS_PostTask(APL_TASK_ID);
+  SYS_PostTask(ZCL_TASK_ID);
+  SYS_DisableTask(ZCL_TASK_ID);
+  runAndCheck(expected, sizeof(expected) / sizeof(expected[0]));
+  HOST_CHECK(SYS_taskFlag == ZCL_TASK_ID);
+
+  // Reassigned task leaves its previous level
+  SYS_SetTaskPriority(APL_TASK_ID, SYS_TASK_PRIORITY_LOW);
+  SYS_EnableTask(ZCL_TASK_ID);
+  SYS_PostTask(APL_TASK_ID);
+  SYS_PostTask(HAL_TASK_ID);
+  {
+    static const uint16_t reassigned[] = {ZCL_TASK_ID, HAL_TASK_ID, APL_TASK_ID};
+    runAndCheck(reassigned, sizeof(reassigned) / sizeof(reassigned[0]));
+  }
+}
+
+/******************************************************************************
+\brief Tasks posted by a running handler are dispatched by their levels: a task
+of a higher level preempts pending tasks, a lower level still gets its turn.
+******************************************************************************/
+static void testPostDuringRun(void)
+{
+  static const uint16_t expected[] =
+    {NWK_TASK_ID, HAL_TASK_ID, ZDO_TASK_ID, APS_TASK_ID, HAL_TASK_ID, APL_TASK_ID};
+
+  reset();
+  SYS_SetTaskPriority(HAL_TASK_ID, SYS_TASK_PRIORITY_HIGH);
+  SYS_SetTaskPriority(APL_TASK_ID, SYS_TASK_PRIORITY_LOW);
+  postOnRun[3] = HAL_TASK_ID | APL_TASK_ID; // NWK
+  postOnRun[5] = HAL_TASK_ID;               // APS
+  SYS_PostTask(NWK_TASK_ID);
+  SYS_PostTask(APS_TASK_ID);
+  SYS_PostTask(ZDO_TASK_ID);
+  runAndCheck(expected, sizeof(expected) / sizeof(expected[0]));
+  HOST_CHECK(0 == SYS_taskFlag);
+}
+
+/******************************************************************************
+\brief Bits without a task handler neither run nor hide lower levels.
+******************************************************************************/
+static void testStrayBits(void)
+{
+  static const uint16_t expected[] = {NWK_TASK_ID, APL_TASK_ID};
+
+  reset();
+  SYS_SetTaskPriority(STRAY_TASK_IDS, SYS_TASK_PRIORITY_HIGH);
+  SYS_SetTaskPriority(APL_TASK_ID, SYS_TASK_PRIORITY_LOW);
+  SYS_taskFlag = STRAY_TASK_IDS;
+  SYS_PostTask(APL_TASK_ID);
+  SYS_PostTask(NWK_TASK_ID);
+  runAndCheck(expected, sizeof(expected) / sizeof(expected[0]));
+  HOST_CHECK(SYS_taskFlag == STRAY_TASK_IDS);
+
+  // Nothing to run: no handler is called
+  SYS_ForceRunTask();
+  HOST_CHECK(2 == runAmount);
+  SYS_taskFlag = 0;
+}
+
+/******************************************************************************
+\brief Run count, total and worst time of the task handlers.
+******************************************************************************/
+static void testStats(void)
+{
+  SYS_TaskStats_t stats;
+
+  reset();
+  SYS_ResetTaskStats();
+  runTime[12] = 150; // APL
+  runTime[3] = 40;   // NWK
+
+  SYS_PostTask(APL_TASK_ID);
+  SYS_PostTask(NWK_TASK_ID);
+  SYS_ForceRunTask();
+  SYS_ForceRunTask();
+  runTime[12] = 500;
+  SYS_PostTask(APL_TASK_ID);
+  SYS_ForceRunTask();
+
+  if (!HOST_CHECK(SYS_GetTaskStats(APL_TASK_ID, &stats)))
+    return;
+  HOST_CHECK(2 == stats.runCount);
+  HOST_CHECK(650 == stats.totalTime);
+  HOST_CHECK(500 == stats.worstTime);
+
+  if (!HOST_CHECK(SYS_GetTaskStats(NWK_TASK_ID, &stats)))
+    return;
+  HOST_CHECK(1 == stats.runCount);
+  HOST_CHECK(40 == stats.totalTime);
+  HOST_CHECK(40 == stats.worstTime);
+
+  HOST_CHECK(!SYS_GetTaskStats(APL_TASK_ID | NWK_TASK_ID, &stats));
+  HOST_CHECK(!SYS_GetTaskStats((SYS_TaskId_t)0x8000, &stats));
+
+  SYS_ResetTaskStats();
+  HOST_CHECK(SYS_GetTaskStats(APL_TASK_ID, &stats) && 0 == stats.runCount);
+}
+
+int main(void)
+{
+  // Clock wraps while the handlers run
+  sysTaskManagerStubTimeUs = 0xFFFFFF00u;
+
+  testIdOrder();
+  testPriorityOrder();
+  testPostDuringRun();
+  testStrayBits();
+  testStats();
+
+  return hostTestResult();
+}
+
+/* eof sysTaskManagerTest.c */
@@ -0,0 +1,118 @@
+/******************************************************************************
+  \file zclAttributesBench.c
+
+  \brief
+    ZCL attribute lookup benchmark. A device endpoint has 12 server clusters
+    with 8 U16 attributes each, every third attribute is reportable.
+    Measures zclGetAttribute() and ZCL_ReadAttributeValue() for existing
+    attributes and the lookup of an unknown attribute.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zcl.h>
+#include <clusters.h>
+#include <zclParser.h>
+#include <zclAttributes.h>
+#include <hostTest.h>
+#include <stdlib.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define CLUSTERS_AMOUNT   12
+#define ATTRIBUTES_AMOUNT 8
+/* U16 attribute with reporting */
+#define DESCRIPTOR_SIZE   (4 + 2 + 3 * 2 + 2 + 2 + 2)
+#define ITERATIONS        2000000
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+void zclStubRegisterEndpoint(ZCL_DeviceEndpoint_t *endpoint, bool viaZcl);
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static ZCL_DeviceEndpoint_t endpoint;
+static ZCL_Cluster_t clusters[CLUSTERS_AMOUNT];
+static uint8_t descriptors[CLUSTERS_AMOUNT][ATTRIBUTES_AMOUNT * DESCRIPTOR_SIZE];
+static volatile uintptr_t sink;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+static void fillEndpoint(void)
+{
+  for (int c = 0; c < CLUSTERS_AMOUNT; c++)
+  {
+    uint8_t *p = descriptors[c];
+
+    clusters[c].id = 0x0400 + c;
+    clusters[c].attributesAmount = ATTRIBUTES_AMOUNT;
+    clusters[c].attributes = p;
+    for (int i = 0; i < ATTRIBUTES_AMOUNT; i++)
+    {
+      ZclAttribute_t *attr = (ZclAttribute_t *)p;
+
+      attr->id = i;
+      attr->type = ZCL_U16BIT_DATA_TYPE_ID;
+      attr->properties = (i % 3) ? ZCL_READWRITE_ATTRIBUTE : ZCL_REPORTABLE_ATTRIBUTE;
+      p = (uint8_t *)jumpToNextAttribute(attr);
+    }
+  }
+
+  endpoint.simpleDescriptor.endpoint = 1;
+  endpoint.simpleDescriptor.AppInClustersCount = CLUSTERS_AMOUNT;
+  endpoint.serverCluster = clusters;
+  zclStubRegisterEndpoint(&endpoint, true);
+}
+
+int main(void)
+{
+  static uint16_t ids[ITERATIONS];
+  uint8_t type;
+  uint16_t value;
+  double start;
+
+  fillEndpoint();
+  srand(1);
+  for (int i = 0; i < ITERATIONS; i++)
+    ids[i] = rand() % (CLUSTERS_AMOUNT * ATTRIBUTES_AMOUNT);
+
+  printf("index size %u\n", ZCL_ATTRIBUTES_INDEX_SIZE);
+
+  start = hostTestNow();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink = (uintptr_t)zclGetAttribute(1, 0x0400 + ids[i] / ATTRIBUTES_AMOUNT, ZCL_CLUSTER_SIDE_SERVER,
+                                      ids[i] % ATTRIBUTES_AMOUNT);
+  printf("zclGetAttribute:        %.1f ns\n", (hostTestNow() - start) / ITERATIONS);
+
+  start = hostTestNow();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink = ZCL_ReadAttributeValue(1, 0x0400 + ids[i] / ATTRIBUTES_AMOUNT, ZCL_CLUSTER_SIDE_SERVER,
+                                  ids[i] % ATTRIBUTES_AMOUNT, &type, (uint8_t *)&value);
+  printf("ZCL_ReadAttributeValue: %.1f ns\n", (hostTestNow() - start) / ITERATIONS);
+
+  start = hostTestNow();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink = (uintptr_t)zclGetAttribute(1, 0x0400 + ids[i] / ATTRIBUTES_AMOUNT, ZCL_CLUSTER_SIDE_SERVER,
+                                      ATTRIBUTES_AMOUNT + ids[i] % ATTRIBUTES_AMOUNT);
+  printf("unknown attribute:      %.1f ns\n", (hostTestNow() - start) / ITERATIONS);
+
+  return 0;
+}
+
+/* eof zclAttributesBench.c */
@@ -0,0 +1,110 @@
+/******************************************************************************
+  \file zclAttributesStubs.c
+
+  \brief
+    APS endpoints and ZCL services emulated for the ZCL attributes host tests.
+    Endpoints are registered the way ZCL_RegisterEndpoint() and
+    ZCL_UnregisterEndpoint() do it.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zcl.h>
+#include <clusters.h>
+#include <zclParser.h>
+#include <zclAttributes.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define MAX_ENDPOINTS_AMOUNT 16
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+/* Registered APS endpoints in the registration order */
+static APS_RegisterEndpointReq_t *apsEndpoints[MAX_ENDPOINTS_AMOUNT];
+static unsigned apsEndpointsAmount;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+APS_RegisterEndpointReq_t* APS_NextEndpoint(const APS_RegisterEndpointReq_t *const prev)
+{
+  unsigned i = 0U;
+
+  if (prev)
+  {
+    while (apsEndpoints[i] != prev)
+      i++;
+    i++;
+  }
+  return (i < apsEndpointsAmount) ? apsEndpoints[i] : NULL;
+}
+
+void zclDataInd(APS_DataInd_t *ind)
+{
+  (void)ind;
+}
+
+static void apsDataInd(APS_DataInd_t *ind)
+{
+  (void)ind;
+}
+
+void zclScheduleOnChangeReport(ZclAttribute_t *attr)
+{
+  (void)attr;
+}
+
+void SYS_PostEvent(SYS_EventId_t id, SYS_EventData_t data)
+{
+  (void)id;
+  (void)data;
+}
+
+/******************************************************************************
+\brief Registers the endpoint.
+
+\param[in] endpoint - endpoint to register.
+\param[in] viaZcl - true to register with ZCL, false - directly with APS.
+******************************************************************************/
+void zclStubRegisterEndpoint(ZCL_DeviceEndpoint_t *endpoint, bool viaZcl)
+{
+  endpoint->service.apsEndpoint.simpleDescriptor = &endpoint->simpleDescriptor;
+  endpoint->service.apsEndpoint.APS_DataInd = viaZcl ? zclDataInd : apsDataInd;
+  apsEndpoints[apsEndpointsAmount++] = &endpoint->service.apsEndpoint;
+  if (viaZcl)
+    zclAddEndpointToAttributesIndex(endpoint);
+}
+
+/******************************************************************************
+\brief Unregisters the endpoint.
+
+\param[in] endpoint - registered endpoint.
+******************************************************************************/
+void zclStubUnregisterEndpoint(ZCL_DeviceEndpoint_t *endpoint)
+{
+  unsigned i = 0U;
+
+  while (apsEndpoints[i] != &endpoint->service.apsEndpoint)
+    i++;
+  apsEndpointsAmount--;
+  for (; i < apsEndpointsAmount; i++)
+    apsEndpoints[i] = apsEndpoints[i + 1];
+  zclRebuildAttributesIndex();
+}
+
+/* eof zclAttributesStubs.c */
@@ -0,0 +1,243 @@
+/******************************************************************************
+  \file zclAttributesTest.c
+
+  \brief
+    ZCL attribute lookup test. Endpoints with random server and client
+    clusters are registered and unregistered in random order, some of them
+    directly with APS. Descriptors of different length are used: reportable
+    attributes and attributes with boundaries. Memory of unregistered
+    endpoints is reused for the new descriptors. Every attribute lookup is
+    compared with a brute-force model of the registered endpoints, so stale
+    and missed index entries are both caught.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zcl.h>
+#include <clusters.h>
+#include <zclParser.h>
+#include <zclAttributes.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define ENDPOINTS_AMOUNT      6
+#define MAX_CLUSTERS_AMOUNT   4
+#define MAX_ATTRIBUTES_AMOUNT 10
+#define CLUSTER_IDS_AMOUNT    8
+#define ATTRIBUTE_IDS_AMOUNT  16
+/* Largest descriptor: U32 attribute with reporting and boundaries */
+#define MAX_DESCRIPTOR_SIZE   (4 + 4 + 3 * 2 + 4 + 2 + 4 + 2 * 4)
+#define STEPS_AMOUNT          1000000
+#define SIDES_AMOUNT          2
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  ZCL_Cluster_t clusters[MAX_CLUSTERS_AMOUNT];
+  uint8_t descriptors[MAX_CLUSTERS_AMOUNT][MAX_ATTRIBUTES_AMOUNT * MAX_DESCRIPTOR_SIZE];
+  /* Model: attribute descriptors by cluster and attribute ID */
+  ZclAttribute_t *attributes[CLUSTER_IDS_AMOUNT][ATTRIBUTE_IDS_AMOUNT];
+} ClusterSide_t;
+
+typedef struct
+{
+  ZCL_DeviceEndpoint_t endpoint;
+  ClusterSide_t sides[SIDES_AMOUNT];
+  bool registered;
+  bool viaZcl;
+} TestEndpoint_t;
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+void zclStubRegisterEndpoint(ZCL_DeviceEndpoint_t *endpoint, bool viaZcl);
+void zclStubUnregisterEndpoint(ZCL_DeviceEndpoint_t *endpoint);
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static TestEndpoint_t endpoints[ENDPOINTS_AMOUNT];
+static const uint8_t clusterSides[SIDES_AMOUNT] = {ZCL_CLUSTER_SIDE_SERVER, ZCL_CLUSTER_SIDE_CLIENT};
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Fills a cluster with random attribute descriptors.
+
+\param[in] side - clusters of one side of the endpoint.
+\param[in] cluster - cluster to fill.
+\param[in] clusterIndex - cluster index on the side.
+******************************************************************************/
+static void fillCluster(ClusterSide_t *side, ZCL_Cluster_t *cluster, int clusterIndex)
+{
+  static const uint8_t types[] = {ZCL_U8BIT_DATA_TYPE_ID, ZCL_U16BIT_DATA_TYPE_ID, ZCL_U32BIT_DATA_TYPE_ID};
+  static const uint8_t lengths[] = {1, 2, 4};
+  uint8_t *p = side->descriptors[clusterIndex];
+  bool used[ATTRIBUTE_IDS_AMOUNT] = {false};
+
+  memset(p, 0xA5, sizeof(side->descriptors[clusterIndex]));
+  cluster->attributes = p;
+  cluster->attributesAmount = rand() % (MAX_ATTRIBUTES_AMOUNT + 1);
+
+  for (int i = 0; i < cluster->attributesAmount; i++)
+  {
+    ZclAttribute_t *attr = (ZclAttribute_t *)p;
+    int type = rand() % 3;
+    int id;
+
+    do
+      id = rand() % ATTRIBUTE_IDS_AMOUNT;
+    while (used[id]);
+    used[id] = true;
+    side->attributes[cluster->id][id] = attr;
+
+    attr->id = id;
+    attr->type = types[type];
+    attr->properties = ((rand() % 3) ? 0U : ZCL_REPORTABLE_ATTRIBUTE) |
+                       ((rand() % 4) ? 0U : ZCL_BOUNDARY_CHECK);
+    for (int k = 0; k < lengths[type]; k++)
+      attr->value[k] = rand();
+
+    p = (uint8_t *)jumpToNextAttribute(attr);
+  }
+}
+
+/******************************************************************************
+\brief Fills the endpoint with random clusters.
+
+\param[in] index - endpoint index.
+******************************************************************************/
+static void fillEndpoint(int index)
+{
+  TestEndpoint_t *ep = &endpoints[index];
+
+  memset(&ep->endpoint, 0, sizeof(ep->endpoint));
+  ep->endpoint.simpleDescriptor.endpoint = index + 1;
+
+  for (int s = 0; s < SIDES_AMOUNT; s++)
+  {
+    ClusterSide_t *side = &ep->sides[s];
+    int amount = rand() % (MAX_CLUSTERS_AMOUNT + 1);
+    bool used[CLUSTER_IDS_AMOUNT] = {false};
+
+    memset(side->attributes, 0, sizeof(side->attributes));
+    for (int c = 0; c < amount; c++)
+    {
+      ZCL_Cluster_t *cluster = &side->clusters[c];
+      int id;
+
+      do
+        id = rand() % CLUSTER_IDS_AMOUNT;
+      while (used[id]);
+      used[id] = true;
+
+      cluster->id = id;
+      fillCluster(side, cluster, c);
+    }
+
+    if (ZCL_CLUSTER_SIDE_SERVER == clusterSides[s])
+    {
+      ep->endpoint.simpleDescriptor.AppInClustersCount = amount;
+      ep->endpoint.serverCluster = side->clusters;
+    }
+    else
+    {
+      ep->endpoint.simpleDescriptor.AppOutClustersCount = amount;
+      ep->endpoint.clientCluster = side->clusters;
+    }
+  }
+}
+
+/******************************************************************************
+\brief Checks lookup of an attribute against the model.
+
+\param[in] index - endpoint index.
+\param[in] side - cluster side index.
+\param[in] clusterId, attributeId - attribute to look up.
+******************************************************************************/
+static void checkLookup(int index, int side, int clusterId, int attributeId)
+{
+  const TestEndpoint_t *ep = &endpoints[index];
+  ZclAttribute_t *expected = NULL;
+  uint8_t type = 0U;
+  uint8_t value[4] = {0};
+
+  /* endpoints registered directly with APS are not ZCL endpoints */
+  if (ep->registered && ep->viaZcl)
+    expected = ep->sides[side].attributes[clusterId][attributeId];
+
+  HOST_CHECK(zclGetAttribute(index + 1, clusterId, clusterSides[side], attributeId) == expected);
+
+  if (ZCL_SUCCESS_STATUS == ZCL_ReadAttributeValue(index + 1, clusterId, clusterSides[side],
+                                                   attributeId, &type, value))
+  {
+    if (HOST_CHECK(expected))
+    {
+      HOST_CHECK(type == expected->type);
+      HOST_CHECK(!memcmp(value, expected->value, ZCL_GetAttributeLength(type, value)));
+    }
+  }
+  else
+    HOST_CHECK(!expected);
+}
+
+int main(void)
+{
+  srand(11);
+
+  for (int step = 0; step < STEPS_AMOUNT; step++)
+  {
+    int index = rand() % ENDPOINTS_AMOUNT;
+    TestEndpoint_t *ep = &endpoints[index];
+
+    switch (rand() % 16)
+    {
+      case 0:
+        if (ep->registered)
+          break;
+        fillEndpoint(index);
+        ep->viaZcl = rand() % 8;
+        zclStubRegisterEndpoint(&ep->endpoint, ep->viaZcl);
+        ep->registered = true;
+        break;
+
+      case 1:
+        if (!ep->registered)
+          break;
+        zclStubUnregisterEndpoint(&ep->endpoint);
+        ep->registered = false;
+        /* descriptors are overwritten, stale lookups would find them */
+        fillEndpoint(index);
+        break;
+
+      default:
+        /* unknown endpoints, clusters and attributes are looked up too */
+        checkLookup(index, rand() % SIDES_AMOUNT, rand() % CLUSTER_IDS_AMOUNT,
+                    rand() % ATTRIBUTE_IDS_AMOUNT);
+        break;
+    }
+  }
+
+  return hostTestResult();
+}
+
+/* eof zclAttributesTest.c */
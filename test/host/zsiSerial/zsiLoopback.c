@@ -0,0 +1,420 @@
+/******************************************************************************
+  \file zsiLoopback.c
+
+  \brief
+    ZAppSI serial link loopback. Takes place of the medium adapter and of the
+    HAL services used by ZAppSI. Events of the emulated UART, the network
+    processor and the application timers are processed in the order of
+    their virtual time.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zsiLoopback.h>
+#include <zsiMem.h>
+#include <zsiSerialController.h>
+#include <zsiMemoryManager.h>
+#include <zsiTaskManager.h>
+#include <zsiInit.h>
+#include <zsiDriver.h>
+#include <appTimer.h>
+#include <sysTaskManager.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define TIMERS_AMOUNT 8
+#define EVENTS_AMOUNT 256
+#define NO_TIME       UINT64_MAX
+/* Amount of task handler runs while ZAppSI tasks are pending */
+#define TASK_RUNS_AMOUNT 64
+#define MAX_FRAMES_AMOUNT 100000U
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef enum
+{
+  LOOPBACK_HOST_TX_DONE,
+  LOOPBACK_REMOTE_RX,
+  LOOPBACK_HOST_RX
+} LoopbackEventType_t;
+
+typedef struct
+{
+  bool used;
+  LoopbackEventType_t type;
+  uint64_t time;
+  uint16_t length;
+  uint8_t data[sizeof(ZsiCommandFrame_t)];
+} LoopbackEvent_t;
+
+/******************************************************************************
+                    Global variables section
+******************************************************************************/
+volatile uint16_t SYS_taskFlag;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static const ZsiLoopbackParams_t *loopbackParams;
+static ZsiLoopbackResult_t *loopbackResult;
+/* Virtual time, us */
+static uint64_t loopbackTime;
+static double byteTime;
+
+static HAL_AppTimer_t *timers[TIMERS_AMOUNT];
+static uint64_t timerExpirations[TIMERS_AMOUNT];
+static LoopbackEvent_t events[EVENTS_AMOUNT];
+
+static uint64_t hostTxEndTime;
+static uint64_t remoteTxEndTime;
+/* Frames received by the network processor, by the number in the payload */
+static bool received[MAX_FRAMES_AMOUNT];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief HAL and system services used by ZAppSI.
+******************************************************************************/
+BcTime_t HAL_GetSystemTime(void)
+{
+  return loopbackTime / 1000U;
+}
+
+int HAL_StartAppTimer(HAL_AppTimer_t *appTimer)
+{
+  int slot = -1;
+
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (timers[i] == appTimer || (slot < 0 && !timers[i]))
+      slot = i;
+  }
+  if (slot < 0)
+  {
+    printf("loopback: too many timers\n");
+    exit(1);
+  }
+  timers[slot] = appTimer;
+  timerExpirations[slot] = loopbackTime + (uint64_t)appTimer->interval * 1000U;
+  return 0;
+}
+
+int HAL_StopAppTimer(HAL_AppTimer_t *appTimer)
+{
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (timers[i] == appTimer)
+      timers[i] = NULL;
+  }
+  return 0;
+}
+
+void halStartAtomic(void)
+{
+}
+
+void halEndAtomic(void)
+{
+}
+
+void SYS_ForceRunTask(void)
+{
+}
+
+void SYS_PostEvent(SYS_EventId_t id, SYS_EventData_t data)
+{
+  (void)id;
+  (void)data;
+}
+
+void zsiInitTaskHandler(void)
+{
+}
+
+/******************************************************************************
+\brief Commands are not processed, the link is measured only.
+******************************************************************************/
+#define LOOPBACK_NO_PROCESSING_ROUTINE(domain) \
+  ZsiProcessingRoutine_t domain(uint8_t commandId) \
+  { \
+    (void)commandId; \
+    return NULL; \
+  }
+
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiSysFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiApsFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiZdoFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiZdpFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiNwkFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiMacFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiHalFindProcessingRoutine)
+LOOPBACK_NO_PROCESSING_ROUTINE(zsiBspFindProcessingRoutine)
+
+/******************************************************************************
+\brief Posts an event of the emulated link.
+
+\param[in] time - event time.
+\param[in] type - event type.
+\param[in] data, length - frame carried by the event, if any.
+******************************************************************************/
+static void loopbackPostEvent(uint64_t time, LoopbackEventType_t type, const void *data, uint16_t length)
+{
+  for (int i = 0; i < EVENTS_AMOUNT; i++)
+  {
+    if (!events[i].used)
+    {
+      events[i].used = true;
+      events[i].type = type;
+      events[i].time = time;
+      events[i].length = length;
+      if (data)
+        memcpy(events[i].data, data, length);
+      return;
+    }
+  }
+  printf("loopback: too many events\n");
+  exit(1);
+}
+
+/******************************************************************************
+\brief Medium adapter. Frames are transmitted byte by byte at the baud rate.
+******************************************************************************/
+int zsiMediumInit(void)
+{
+  return 0;
+}
+
+void zsiMediumHandler(void)
+{
+}
+
+void zsiMediumPerformHalHoldTasks(void)
+{
+}
+
+void zsiMediumReleaseAllHeldTasks(void)
+{
+}
+
+int zsiMediumSend(void *frame, uint16_t size)
+{
+  if (hostTxEndTime > loopbackTime)
+    loopbackResult->overlaps++;
+  hostTxEndTime = loopbackTime + (uint64_t)(size * byteTime);
+
+  if (!IS_ACK_CMD_FRAME((ZsiCommandFrame_t *)frame))
+    loopbackResult->transmitted++;
+  loopbackPostEvent(hostTxEndTime, LOOPBACK_HOST_TX_DONE, NULL, 0U);
+  loopbackPostEvent(hostTxEndTime, LOOPBACK_REMOTE_RX, frame, size);
+  return size;
+}
+
+/******************************************************************************
+\brief Network processor sends an ACK frame to the host.
+
+\param[in] status - ACK status.
+\param[in] sequenceNumber - sequence number of the acknowledged frame.
+******************************************************************************/
+static void loopbackRemoteSendAck(uint8_t status, uint8_t sequenceNumber)
+{
+  ZsiAckFrame_t ack;
+  uint8_t *p = (uint8_t *)&ack;
+  uint8_t fcs = 0U;
+  uint64_t startTime = loopbackTime + loopbackParams->turnaroundTime;
+
+  ack.sof = ZSI_SOF_SEQUENCE;
+  ack.length = sizeof(ack) - ZSI_COMMAND_FRAME_PREAMBLE_SIZE;
+  ack.sequenceNumber = sequenceNumber;
+  /* error ACKs never advertise the window */
+  ack.frameControl = ZSI_ACK_CMD | status;
+  if (ZSI_NO_ERROR_STATUS == status)
+    ack.frameControl |= loopbackParams->remoteWindowField << ZSI_WINDOW_FIELD_POS;
+  for (unsigned i = 0U; i < sizeof(ack) - 1U; i++)
+    fcs ^= p[i];
+  ack.fcs = fcs;
+
+  if (startTime < remoteTxEndTime)
+    startTime = remoteTxEndTime;
+  remoteTxEndTime = startTime + (uint64_t)(sizeof(ack) * byteTime);
+
+  if (drand48() < loopbackParams->ackLossRate)
+    return;
+  loopbackPostEvent(remoteTxEndTime, LOOPBACK_HOST_RX, &ack, sizeof(ack));
+}
+
+/******************************************************************************
+\brief Network processor receives a frame from the host.
+
+\param[in] frame - received frame.
+******************************************************************************/
+static void loopbackRemoteReceive(const ZsiCommandFrame_t *frame)
+{
+  if (drand48() < loopbackParams->fcsErrorRate)
+  {
+    loopbackRemoteSendAck(ZSI_INVALID_FCS_STATUS, frame->sequenceNumber);
+    return;
+  }
+
+  uint32_t number;
+
+  memcpy(&number, frame->payload, sizeof(number));
+  if (received[number])
+    loopbackResult->duplicates++;
+  else
+    loopbackResult->delivered++;
+  received[number] = true;
+  loopbackRemoteSendAck(ZSI_NO_ERROR_STATUS, frame->sequenceNumber);
+}
+
+/******************************************************************************
+\brief Runs pending ZAppSI tasks.
+******************************************************************************/
+static void loopbackRunTasks(void)
+{
+  for (int i = 0; i < TASK_RUNS_AMOUNT && zsiTaskManager()->pendingTasks; i++)
+    ZSI_TaskHandler();
+}
+
+/******************************************************************************
+\brief Submits AREQ frames while ZAppSI memory is available.
+******************************************************************************/
+static void loopbackSubmitFrames(void)
+{
+  while (loopbackResult->submitted < loopbackParams->framesAmount && zsiIsMemoryAvailable())
+  {
+    ZsiCommandFrame_t *frame = zsiAllocateMemory(ZSI_MUTUAL_MEMORY);
+    uint8_t sequenceNumber = zsiGetSequenceNumber();
+
+    frame->sof = ZSI_SOF_SEQUENCE;
+    frame->frameControl = ZSI_AREQ_CMD;
+    frame->length = CPU_TO_LE16(ZSI_COMMAND_FRAME_OVERHEAD + loopbackParams->payloadLength);
+    frame->sequenceNumber = sequenceNumber;
+    frame->commandHeader.domain = ZSI_CMD_APS;
+    frame->commandHeader.commandId = 0U;
+    /* frames are told apart by their numbers, sequence numbers wrap */
+    memset(frame->payload, 0x5A, loopbackParams->payloadLength);
+    memcpy(frame->payload, &loopbackResult->submitted, sizeof(loopbackResult->submitted));
+    zsiDriverSendCommand(frame, NULL);
+    loopbackResult->submitted++;
+  }
+}
+
+/******************************************************************************
+\brief Processes the earliest event or timer.
+
+\return false if there are no events and timers, true otherwise.
+******************************************************************************/
+static bool loopbackProcessEvent(void)
+{
+  LoopbackEvent_t *event = NULL;
+  int timer = -1;
+  uint64_t time = NO_TIME;
+
+  for (int i = 0; i < EVENTS_AMOUNT; i++)
+  {
+    if (events[i].used && events[i].time < time)
+    {
+      event = &events[i];
+      time = events[i].time;
+    }
+  }
+  for (int i = 0; i < TIMERS_AMOUNT; i++)
+  {
+    if (timers[i] && timerExpirations[i] < time)
+    {
+      timer = i;
+      time = timerExpirations[i];
+    }
+  }
+  if (NO_TIME == time)
+    return false;
+
+  loopbackTime = time;
+  if (timer >= 0)
+  {
+    HAL_AppTimer_t *appTimer = timers[timer];
+
+    timers[timer] = NULL;
+    appTimer->callback();
+    return true;
+  }
+
+  event->used = false;
+  switch (event->type)
+  {
+    case LOOPBACK_HOST_TX_DONE:
+      zsiMediumSendingDone();
+      break;
+
+    case LOOPBACK_REMOTE_RX:
+      loopbackRemoteReceive((const ZsiCommandFrame_t *)event->data);
+      break;
+
+    case LOOPBACK_HOST_RX:
+    {
+      ZsiAckFrame_t *ack = zsiAllocateMemory(ZSI_RX_ACK_MEMORY);
+
+      memcpy(ack, event->data, event->length);
+      zsiMediumReceive(ZSI_NO_ERROR_STATUS, ack->sequenceNumber, ack);
+      break;
+    }
+  }
+  return true;
+}
+
+void zsiLoopbackRun(const ZsiLoopbackParams_t *params, ZsiLoopbackResult_t *result)
+{
+  if (params->framesAmount > MAX_FRAMES_AMOUNT)
+  {
+    printf("loopback: too many frames\n");
+    exit(1);
+  }
+  loopbackParams = params;
+  loopbackResult = result;
+  memset(result, 0, sizeof(*result));
+  loopbackTime = 0U;
+  byteTime = 10e6 / params->baudRate;
+  hostTxEndTime = 0U;
+  remoteTxEndTime = 0U;
+  memset(timers, 0, sizeof(timers));
+  memset(events, 0, sizeof(events));
+  memset(received, 0, sizeof(received));
+  srand48(1);
+
+  zsiResetTaskManager();
+  zsiResetMemoryManager();
+  zsiResetSerial();
+  zsiResetDriver();
+
+  do
+  {
+    loopbackRunTasks();
+    loopbackSubmitFrames();
+    loopbackRunTasks();
+  } while (loopbackProcessEvent());
+
+  result->windowSize = zsiSerial()->window.size;
+  result->time = loopbackTime / 1e6;
+  for (unsigned i = 0U; i < ZSI_MEMORY_BUFFERS_AMOUNT; i++)
+    result->busyBuffers += zsiMemoryManager()->memoryPool.buffers[i].busy;
+}
+
+/* eof zsiLoopback.c */
@@ -0,0 +1,86 @@
+/******************************************************************************
+  \file zsiLoopback.h
+
+  \brief
+    ZAppSI serial link loopback: the host serial controller sends AREQ frames
+    over an emulated UART to an emulated network processor, which
+    acknowledges them. Time is virtual, so the results do not depend on the
+    build machine.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+#ifndef _ZSILOOPBACK_H_
+#define _ZSILOOPBACK_H_
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  /* UART baud rate, 10 bits per byte */
+  uint32_t baudRate;
+  /* AREQ payload length */
+  uint8_t payloadLength;
+  /* Receive window advertised by the network processor: 0 - legacy
+     stop-and-wait device, 1, 2, 3 - up to 2, 4 or 8 frames */
+  uint8_t remoteWindowField;
+  /* Time from the frame reception to the ACK transmission, us */
+  uint32_t turnaroundTime;
+  /* Probability of a frame received with invalid FCS */
+  double fcsErrorRate;
+  /* Probability of a lost ACK */
+  double ackLossRate;
+  /* Amount of AREQ frames to send */
+  uint32_t framesAmount;
+} ZsiLoopbackParams_t;
+
+typedef struct
+{
+  /* Negotiated window size */
+  uint8_t windowSize;
+  /* Virtual time of the transmission, s */
+  double time;
+  /* Frames submitted by the host */
+  uint32_t submitted;
+  /* Frames passed to the medium by the host, ACKs excluded */
+  uint32_t transmitted;
+  /* Different frames received by the network processor */
+  uint32_t delivered;
+  /* Frames received by the network processor again */
+  uint32_t duplicates;
+  /* Frames passed to the medium while it was busy */
+  uint32_t overlaps;
+  /* ZAppSI buffers busy after the transmission */
+  uint32_t busyBuffers;
+} ZsiLoopbackResult_t;
+
+/******************************************************************************
+                    Prototypes section
+******************************************************************************/
+/******************************************************************************
+\brief Resets ZAppSI and sends the frames through the loopback.
+
+\param[in] params - link parameters.
+\param[out] result - transmission result.
+******************************************************************************/
+void zsiLoopbackRun(const ZsiLoopbackParams_t *params, ZsiLoopbackResult_t *result);
+
+#endif /* _ZSILOOPBACK_H_ */
+
+/* eof zsiLoopback.h */
@@ -0,0 +1,94 @@
+/******************************************************************************
+  \file zsiSerialBench.c
+
+  \brief
+    ZAppSI serial link benchmark. Measures AREQ throughput through the
+    loopback with 1 ms turnaround of the network processor, in stop-and-wait
+    mode against a legacy network processor and in windowed mode.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zsiLoopback.h>
+#include <stdio.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define FRAMES_AMOUNT 5000U
+/* Window advertised by a legacy and by a windowed network processor */
+#define LEGACY_WINDOW_FIELD   0U
+#define WINDOWED_WINDOW_FIELD 3U
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef struct
+{
+  uint32_t baudRate;
+  uint8_t payloadLength;
+  double errorRate;
+} LinkCase_t;
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Measures throughput of the link.
+
+\param[in] link - link parameters.
+\param[in] remoteWindowField - window advertised by the network processor.
+
+\return frames per second.
+******************************************************************************/
+static double measure(const LinkCase_t *link, uint8_t remoteWindowField)
+{
+  ZsiLoopbackParams_t params =
+  {
+    .baudRate = link->baudRate,
+    .payloadLength = link->payloadLength,
+    .remoteWindowField = remoteWindowField,
+    .turnaroundTime = 1000U,
+    .fcsErrorRate = link->errorRate,
+    .ackLossRate = link->errorRate,
+    .framesAmount = FRAMES_AMOUNT
+  };
+  ZsiLoopbackResult_t result;
+
+  zsiLoopbackRun(&params, &result);
+  return result.delivered / result.time;
+}
+
+int main(void)
+{
+  static const LinkCase_t links[] =
+  {
+    {38400U, 40U, 0.0},
+    {115200U, 20U, 0.0},
+    {115200U, 20U, 0.05}
+  };
+
+  printf("  baud  payload  errors   stop-and-wait / windowed, frames/s\n");
+  for (unsigned i = 0U; i < sizeof(links) / sizeof(links[0]); i++)
+  {
+    printf("%6u  %7u  %5.0f%%   %13.1f / %.1f\n", links[i].baudRate, links[i].payloadLength,
+           links[i].errorRate * 100.0, measure(&links[i], LEGACY_WINDOW_FIELD),
+           measure(&links[i], WINDOWED_WINDOW_FIELD));
+  }
+
+  return 0;
+}
+
+/* eof zsiSerialBench.c */
@@ -0,0 +1,83 @@
+/******************************************************************************
+  \file zsiSerialTest.c
+
+  \brief
+    ZAppSI serial link test. AREQ frames are sent through the loopback to
+    a legacy stop-and-wait network processor and to a windowed one, over
+    a clean link and over a link with corrupted frames and lost ACKs.
+    Every frame shall be delivered, the medium shall never be written while
+    busy and no ZAppSI buffers shall leak.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zsiLoopback.h>
+#include <hostTest.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define FRAMES_AMOUNT 5000U
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Sends the frames through the loopback and checks the result.
+
+\param[in] remoteWindowField - window advertised by the network processor.
+\param[in] errorRate - probability of a corrupted frame and of a lost ACK.
+******************************************************************************/
+static void checkLink(uint8_t remoteWindowField, double errorRate)
+{
+  ZsiLoopbackParams_t params =
+  {
+    .baudRate = 115200U,
+    .payloadLength = 20U,
+    .remoteWindowField = remoteWindowField,
+    .turnaroundTime = 1000U,
+    .fcsErrorRate = errorRate,
+    .ackLossRate = errorRate,
+    .framesAmount = FRAMES_AMOUNT
+  };
+  ZsiLoopbackResult_t result;
+
+  zsiLoopbackRun(&params, &result);
+  printf("remote window %u, error rate %.2f: window %u, %u frames delivered, %u sent again\n",
+         remoteWindowField ? 1U << remoteWindowField : 1U, errorRate, result.windowSize,
+         result.delivered, result.transmitted - result.submitted);
+
+  HOST_CHECK(FRAMES_AMOUNT == result.submitted);
+  HOST_CHECK(FRAMES_AMOUNT == result.delivered);
+  HOST_CHECK(0U == result.overlaps);
+  HOST_CHECK(0U == result.busyBuffers);
+  if (remoteWindowField)
+    HOST_CHECK(result.windowSize > 1U);
+  else
+    HOST_CHECK(result.windowSize <= 1U);
+  if (0.0 == errorRate)
+    HOST_CHECK(result.transmitted == result.submitted && 0U == result.duplicates);
+}
+
+int main(void)
+{
+  checkLink(0U, 0.0);
+  checkLink(3U, 0.0);
+  checkLink(0U, 0.05);
+  checkLink(3U, 0.05);
+  return hostTestResult();
+}
+
+/* eof zsiSerialTest.c */
@@ -0,0 +1,224 @@
+/******************************************************************************
+  \file zsiSerializerTest.c
+
+  \brief
+    ZAppSI serializer test. Random sequences of integer fields and data blocks
+    are serialized and deserialized back. Every field shall be written in
+    little endian byte order right after the previous one, bytes beyond the
+    payload shall stay untouched and deserialized values shall match.
+
+  \author
+    Atmel Corporation: http://www.atmel.com \n
+    Support email: avr@atmel.com
+
+  Copyright (c) 2008-2015 , Atmel Corporation. All rights reserved.
+  Licensed under Atmel's Limited License Agreement (BitCloudTM).
+
+  \internal
+    History:
+    17.10.26 - Created.
+******************************************************************************/
+
+/******************************************************************************
+                    Includes section
+******************************************************************************/
+#include <zsiSerializer.h>
+#include <hostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+                    Definitions section
+******************************************************************************/
+#define MAX_FIELDS_AMOUNT 40
+#define MAX_DATA_SIZE     20
+#define PAYLOAD_SIZE      (MAX_FIELDS_AMOUNT * MAX_DATA_SIZE)
+#define GUARD_SIZE        16
+#define GUARD_VALUE       0xA5
+#define ITERATIONS        200000
+
+/******************************************************************************
+                    Types section
+******************************************************************************/
+typedef enum
+{
+  FIELD_UINT8,
+  FIELD_UINT16,
+  FIELD_UINT32,
+  FIELD_UINT64,
+  FIELD_DATA,
+  FIELD_POINTER,
+  FIELD_TYPES_AMOUNT
+} FieldType_t;
+
+typedef struct
+{
+  FieldType_t type;
+  uint64_t value;
+  uint16_t size;
+  uint8_t data[MAX_DATA_SIZE];
+} Field_t;
+
+/******************************************************************************
+                    Static variables section
+******************************************************************************/
+static Field_t fields[MAX_FIELDS_AMOUNT];
+static uint8_t payload[PAYLOAD_SIZE + GUARD_SIZE];
+
+/******************************************************************************
+                    Implementation section
+******************************************************************************/
+/******************************************************************************
+\brief Returns a random value with all bits of the given width random.
+
+\param[in] width - value width in bytes.
+******************************************************************************/
+static uint64_t randomValue(uint8_t width)
+{
+  uint64_t value = 0U;
+
+  for (uint8_t i = 0U; i < width; i++)
+    value = (value << 8) | (uint8_t)rand();
+  return value;
+}
+
+/******************************************************************************
+\brief Returns the width of a field on the wire.
+
+\param[in] field - field description.
+******************************************************************************/
+static uint16_t fieldSize(const Field_t *field)
+{
+  switch (field->type)
+  {
+    case FIELD_UINT8:  return 1U;
+    case FIELD_UINT16: return 2U;
+    case FIELD_UINT32: return 4U;
+    case FIELD_UINT64: return 8U;
+    default:           return field->size;
+  }
+}
+
+/******************************************************************************
+\brief Serializes a field and checks its wire format.
+
+\param[in] serializer - serializer context.
+\param[in] field - field to serialize.
+******************************************************************************/
+static void serializeField(ZsiSerializer_t *serializer, const Field_t *field)
+{
+  uint8_t *start = serializer->pow;
+  uint32_t value32 = (uint32_t)field->value;
+  uint64_t value64 = field->value;
+  uint16_t size = fieldSize(field);
+
+  switch (field->type)
+  {
+    case FIELD_UINT8:  zsiSerializeUint8(serializer, (uint8_t)field->value); break;
+    case FIELD_UINT16: zsiSerializeUint16(serializer, (uint16_t)field->value); break;
+    case FIELD_UINT32: zsiSerializeUint32(serializer, &value32); break;
+    case FIELD_UINT64: zsiSerializeUint64(serializer, &value64); break;
+    default:           zsiSerializeData(serializer, field->data, field->size); break;
+  }
+
+  HOST_CHECK(serializer->pow == start + size);
+  if (FIELD_DATA == field->type || FIELD_POINTER == field->type)
+    HOST_CHECK(!memcmp(start, field->data, size));
+  else
+  {
+    for (uint16_t i = 0U; i < size; i++)
+      HOST_CHECK(start[i] == (uint8_t)(field->value >> (8U * i)));
+  }
+}
+
+/******************************************************************************
+\brief Deserializes a field and checks its value.
+
+\param[in] serializer - serializer context.
+\param[in] field - expected field.
+******************************************************************************/
+static void deserializeField(ZsiSerializer_t *serializer, const Field_t *field)
+{
+  const uint8_t *start = serializer->por;
+  uint8_t value8;
+  uint16_t value16;
+  uint32_t value32;
+  uint64_t value64;
+  uint8_t data[MAX_DATA_SIZE];
+  uint8_t *pointer;
+
+  switch (field->type)
+  {
+    case FIELD_UINT8:
+      zsiDeserializeUint8(serializer, &value8);
+      HOST_CHECK(value8 == field->value);
+      break;
+
+    case FIELD_UINT16:
+      zsiDeserializeUint16(serializer, &value16);
+      HOST_CHECK(value16 == field->value);
+      break;
+
+    case FIELD_UINT32:
+      zsiDeserializeUint32(serializer, &value32);
+      HOST_CHECK(value32 == field->value);
+      break;
+
+    case FIELD_UINT64:
+      zsiDeserializeUint64(serializer, &value64);
+      HOST_CHECK(value64 == field->value);
+      break;
+
+    case FIELD_DATA:
+      zsiDeserializeData(serializer, data, field->size);
+      HOST_CHECK(!memcmp(data, field->data, field->size));
+      break;
+
+    default:
+      zsiDeserializeToPointer(serializer, &pointer, field->size);
+      HOST_CHECK(pointer == start);
+      break;
+  }
+  HOST_CHECK(serializer->por == start + fieldSize(field));
+}
+
+int main(void)
+{
+  srand(17);
+
+  for (int iteration = 0; iteration < ITERATIONS; iteration++)
+  {
+    int amount = 1 + rand() % MAX_FIELDS_AMOUNT;
+    ZsiSerializer_t serializer;
+    uint16_t length = 0U;
+
+    for (int i = 0; i < amount; i++)
+    {
+      Field_t *field = &fields[i];
+
+      field->type = rand() % FIELD_TYPES_AMOUNT;
+      field->size = 1U + rand() % MAX_DATA_SIZE;
+      for (uint16_t k = 0U; k < field->size; k++)
+        field->data[k] = rand();
+      if (field->type <= FIELD_UINT64)
+        field->value = randomValue(fieldSize(field));
+      length += fieldSize(field);
+    }
+
+    memset(payload, GUARD_VALUE, sizeof(payload));
+    serializer.pow = payload;
+    for (int i = 0; i < amount; i++)
+      serializeField(&serializer, &fields[i]);
+    HOST_CHECK(serializer.pow == payload + length);
+    for (int i = length; i < (int)sizeof(payload); i++)
+      HOST_CHECK(GUARD_VALUE == payload[i]);
+
+    serializer.por = payload;
+    for (int i = 0; i < amount; i++)
+      deserializeField(&serializer, &fields[i]);
+  }
+
+  return hostTestResult();
+}
+
+/* eof zsiSerializerTest.c */